@@ -15,7 +15,10 @@ CPP_SRCS += \
 ../src/instr_decoder.cpp \
 ../src/interface_unit.cpp \
 ../src/pc_unit.cpp \
-../src/srf.cpp 
+../src/perf_counters.cpp \
+../src/self_profile.cpp \
+../src/srf.cpp \
+../src/timeline.cpp 
 
 CPP_DEPS += \
 ./src/control_unit.d \
@@ -29,7 +32,10 @@ CPP_DEPS += \
 ./src/instr_decoder.d \
 ./src/interface_unit.d \
 ./src/pc_unit.d \
-./src/srf.d 
+./src/perf_counters.d \
+./src/self_profile.d \
+./src/srf.d \
+./src/timeline.d 
 
 OBJS += \
 ./src/control_unit.o \
@@ -43,7 +49,10 @@ OBJS += \
 ./src/instr_decoder.o \
 ./src/interface_unit.o \
 ./src/pc_unit.o \
-./src/srf.o 
+./src/perf_counters.o \
+./src/self_profile.o \
+./src/srf.o \
+./src/timeline.o 
 
 
 # Each subdirectory must supply rules for building sources it contributes
@@ -58,7 +67,7 @@ src/%.o: ../src/%.cpp src/subdir.mk
 clean: clean-src
 
 clean-src:
-	-$(RM) ./src/control_unit.d ./src/control_unit.o ./src/crf.d ./src/crf.o ./src/fp_adder.d ./src/fp_adder.o ./src/fp_multiplier.d ./src/fp_multiplier.o ./src/fpu.d ./src/fpu.o ./src/grf.d ./src/grf.o ./src/imc_core.d ./src/imc_core.o ./src/imc_pch.d ./src/imc_pch.o ./src/instr_decoder.d ./src/instr_decoder.o ./src/interface_unit.d ./src/interface_unit.o ./src/pc_unit.d ./src/pc_unit.o ./src/srf.d ./src/srf.o
+	-$(RM) ./src/control_unit.d ./src/control_unit.o ./src/crf.d ./src/crf.o ./src/fp_adder.d ./src/fp_adder.o ./src/fp_multiplier.d ./src/fp_multiplier.o ./src/fpu.d ./src/fpu.o ./src/grf.d ./src/grf.o ./src/imc_core.d ./src/imc_core.o ./src/imc_pch.d ./src/imc_pch.o ./src/instr_decoder.d ./src/instr_decoder.o ./src/interface_unit.d ./src/interface_unit.o ./src/pc_unit.d ./src/pc_unit.o ./src/perf_counters.d ./src/perf_counters.o ./src/self_profile.d ./src/self_profile.o ./src/srf.d ./src/srf.o ./src/timeline.d ./src/timeline.o
 
 .PHONY: clean-src
 
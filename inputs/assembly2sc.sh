@@ -1,15 +1,41 @@
 #!/bin/bash
 
-bin/nmc_assembler assembly-input/$1.asm raw/$1.seq data-input/$1.data address-input/$1.addr
+# Usage: assembly2sc.sh <name> [<number-channels>]
+
+# Ramulator config of the simulated memory, replaced by the run scripts for other memories. The energy
+# per event is read from the config of the same memory in energy-config, unless ENERGY_CONFIG is given
+RAMULATOR_CONFIG=configs/HBM_AB-config.cfg
+ENERGY_CONFIG=${ENERGY_CONFIG:-energy-config/$(basename $RAMULATOR_CONFIG -config.cfg).cfg}
+
+if [ -f assembly-input/$1.parts ]; then
+    # Kernel partitioned across channels, ranks and bank groups by map_kernel, assemble every partition
+    # for its channel, rank and bank group and merge them into a single raw sequence
+    PARTS=""
+    while read -r P CH RA BG; do
+        bin/nmc_assembler assembly-input/$1_p$P.asm raw/$1_p$P.seq data-input/$1_p$P.data address-input/$1_p$P.addr "$CH" "$RA" "$BG" || exit 1
+        PARTS="$PARTS raw/$1_p$P.seq"
+    done < assembly-input/$1.parts
+    bin/merge_seq raw/$1.seq $PARTS
+    CHANNELS=${2:-$(awk 'BEGIN {n = 0} $2 >= n {n = $2 + 1} END {print n}' assembly-input/$1.parts)}
+else
+    bin/nmc_assembler assembly-input/$1.asm raw/$1.seq data-input/$1.data address-input/$1.addr || exit 1
+    CHANNELS=${2:-1}
+fi
 
 bin/raw2ramulator raw/$1.seq ramulator-in/$1.trace
 
-${RAMULATOR_ROOT}/ramulator ${RAMULATOR_ROOT}/configs/HBM_AB-config.cfg --mode=dram ramulator-in/$1.trace > ramulator-out/$1.cmd
+${RAMULATOR_ROOT}/ramulator ${RAMULATOR_ROOT}/$RAMULATOR_CONFIG --mode=dram ramulator-in/$1.trace > ramulator-out/$1.cmd
 
-bin/ramulator2sc raw/$1.seq ramulator-out/$1.cmd SystemC/$1.sci 1
+bin/ramulator2sc raw/$1.seq ramulator-out/$1.cmd SystemC/$1.sci $CHANNELS
 
 cd ..
-build/pim-cores $1
+build/pim-cores $1 --channels $CHANNELS --workers $CHANNELS
 cd inputs
 
+if [ -f $ENERGY_CONFIG ]; then
+    bin/energy_model results/$1.stats ramulator-out/$1.cmd $ENERGY_CONFIG results/$1.energy
+else
+    echo "No energy config $ENERGY_CONFIG, the energy of $1 is not estimated"
+fi
+
 # ./decode_results results/$1.results
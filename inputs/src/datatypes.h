@@ -2,25 +2,47 @@
 #define SRC_DATATYPES_H_
 
 #include <stdint.h>
+#include <cstring>
 #include "../../src/defs.h"
 #include "half.hpp"
+#include "../../src/bfloat16.h"
+#include "../../src/fp8.h"
 using half_float::half;
 
-#if (DATA_TYPE > 3)
+#if (DATA_TYPE > 3 && DATA_TYPE < 8)
 #define INT_TYPE    1       // 1 if Integer data type, 0 otherwise
 #else
 #define INT_TYPE    0       // 1 if Integer data type, 0 otherwise
 #endif
 
-#if (DATA_TYPE == 0 || DATA_TYPE == 3) // TODO until bfloat is implemented
+#if (DATA_TYPE == 0)
 #define HALF_FLOAT  1       // 1 if Half Precision Floating Point data type, 0 otherwise
 #else
 #define HALF_FLOAT  0
 #endif
 
+#if (DATA_TYPE == 3)
+#define BFLOAT      1       // 1 if Brain Floating Point data type, 0 otherwise
+#else
+#define BFLOAT      0
+#endif
+
+#if (DATA_TYPE == 8 || DATA_TYPE == 9)
+#define FP8         1       // 1 if 8-bit Floating Point data type, 0 otherwise
+#else
+#define FP8         0
+#endif
+
+// Floating point types narrower than float are handled as float, rounded through cnm_narrow_t
+#define NARROW_FLOAT    (HALF_FLOAT || BFLOAT || FP8)
+
+#define CHAR_DATA       (DATA_TYPE == 4)    // int8 data, printed as int instead of as a character
+
 /*
 Data Formats for All Data Types:
 half16                 =>   half
+brain float 16         =>   bfloat16
+floating point 8       =>   fp8_e4m3, fp8_e5m2
 integer data types     =>   uintX_t
 floating point 32      =>   float
 floating point 64      =>   double
@@ -30,6 +52,7 @@ floating point 64      =>   double
     #define WORD_BITS   16
     typedef float       cnm_t;
     typedef uint16_t    rfBin_t;
+    typedef half        cnm_narrow_t;
 #elif (DATA_TYPE == 1)  // float
     #define WORD_BITS   32
     typedef float       cnm_t;
@@ -39,7 +62,10 @@ floating point 64      =>   double
     typedef double      cnm_t;
     typedef uint64_t    rfBin_t;
 #elif (DATA_TYPE == 3)  // bfloat
-
+    #define WORD_BITS   16
+    typedef float       cnm_t;
+    typedef uint16_t    rfBin_t;
+    typedef bfloat16    cnm_narrow_t;
 #elif (DATA_TYPE == 4)  // int8
     #define WORD_BITS   8
     typedef int8_t      cnm_t;
@@ -56,9 +82,19 @@ floating point 64      =>   double
     #define WORD_BITS   64
     typedef int64_t     cnm_t;
     typedef uint64_t    rfBin_t;
+#elif (DATA_TYPE == 8)  // fp8 E4M3
+    #define WORD_BITS   8
+    typedef float       cnm_t;
+    typedef uint8_t     rfBin_t;
+    typedef fp8_e4m3    cnm_narrow_t;
+#elif (DATA_TYPE == 9)  // fp8 E5M2
+    #define WORD_BITS   8
+    typedef float       cnm_t;
+    typedef uint8_t     rfBin_t;
+    typedef fp8_e5m2    cnm_narrow_t;
 #endif
 
-#if (!HALF_FLOAT)
+#if (!NARROW_FLOAT)
     typedef union
     {
         cnm_t       data;
@@ -66,6 +102,45 @@ floating point 64      =>   double
     } cnm_union;
 #endif
 
+// Wide accumulators of MACW, every one spans ACC_RATIO neighbouring lanes of a GRF_B entry
+#if WIDE_ACC
+    #if (WIDE_ACC == 1 && (HALF_FLOAT || FP8))
+        #define ACC_BITS    32
+        typedef float       cnm_acc_t;
+    #elif (WIDE_ACC == 2 && FP8)
+        #define ACC_BITS    16
+        typedef half        cnm_acc_t;
+    #elif (WIDE_ACC == 1 && DATA_TYPE == 4)
+        #define ACC_BITS    32
+        typedef int32_t     cnm_acc_t;
+    #else
+        #error "WIDE_ACC 1 needs half, int8 or FP8 lanes, WIDE_ACC 2 needs FP8 lanes"
+    #endif
+    #define ACC_RATIO   (ACC_BITS / WORD_BITS)      // Lanes of a wide accumulator
+    #define ACC_LANES   (SIMD_WIDTH / ACC_RATIO)    // Wide accumulators in a GRF_B entry
+
+    // Accumulator from the bits of its lanes, and back
+    inline cnm_acc_t acc_from_bits(uint32_t bits) {
+    #if ACC_BITS == 16
+        return half(half_float::detail::binary, bits);
+    #else
+        cnm_acc_t acc;
+        memcpy(&acc, &bits, sizeof(acc));
+        return acc;
+    #endif
+    }
+
+    inline uint32_t acc_to_bits(cnm_acc_t acc) {
+    #if ACC_BITS == 16
+        return acc.bin_word();
+    #else
+        uint32_t bits;
+        memcpy(&bits, &acc, sizeof(bits));
+        return bits;
+    #endif
+    }
+#endif
+
 #if DQ_BITS == 16
 typedef uint16_t dq_type;
 #elif DQ_BITS == 32
@@ -22,8 +22,8 @@ using namespace std;
 
 int main(int argc, const char *argv[])
 {
-    if (argc != 2) {
-        cout << "Usage: " << argv[0] << " <results-file>" << endl;
+    if (argc != 2 && argc != 3) {
+        cout << "Usage: " << argv[0] << " <results-file> [--wide]" << endl;
         return 0;
     }
 
@@ -32,13 +32,16 @@ int main(int argc, const char *argv[])
     string cycle, address;
     dq_type dataAux;
     half_float::half half_aux;
-    #if !(HALF_FLOAT)
+    #if !(NARROW_FLOAT)
     #if INT_TYPE
         cnm_t temp_aux;
     #else 
         cnm_union temp_aux;
     #endif
     #endif
+    #if WIDE_ACC
+        bool wide = argc == 3 && string(argv[2]) == "--wide";  // Decodes the wide accumulators of MACW
+    #endif
 
     // Open input file
     ifstream results;
@@ -50,12 +53,30 @@ int main(int argc, const char *argv[])
 
         riiss >> cycle >> address;
         cout << cycle << " " << address << "\t";
-        #if HALF_FLOAT
+        #if WIDE_ACC
+            if (wide) {
+                while (riiss >> showbase >> hex >> dataAux) {
+                    for (int i=0; i<(DQ_BITS/ACC_BITS); i++) {
+                        cout << acc_from_bits(dataAux & ((1ul << ACC_BITS) - 1)) << " ";
+                        dataAux = (uint64_t) dataAux >> ACC_BITS;
+                    }
+                    cout << "\t";
+                }
+
+                cout << endl;
+                continue;
+            }
+        #endif
+        #if NARROW_FLOAT
                 while (riiss >> showbase >> hex >> dataAux) {
-                    for (int i=0; DQ_BITS/WORD_BITS; i++) {
+                    for (int i=0; i<(DQ_BITS/WORD_BITS); i++) {
+                    #if HALF_FLOAT
                         half_aux = half_float::half(half_float::detail::binary, dataAux & HALF_MASK);
                         cout << half_aux << " ";
-                        dataAux = dataAux >> 16;
+                    #else
+                        cout << cnm_narrow_t::from_bits(dataAux & MASK) << " ";
+                    #endif
+                        dataAux = dataAux >> WORD_BITS;
                     }
                     cout << "\t";
                 }
@@ -0,0 +1,165 @@
+#include <cstdio>
+#include <cstdlib>
+#include <stdlib.h>
+#include <iostream>
+#include <sstream>
+#include <iomanip>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <map>
+
+#include "../../src/defs.h"
+
+using namespace std;
+
+// Format of the stats file:        CSV, header line followed by one line per core
+// Format of ramulator output:      Cmd     Cycle   Channel Rank    BG  Bank    Row Column
+// Format of the energy config:     <event> = <energy in pJ>, comments start with #
+// Format of the output file:       <event>,<count>,<energy in pJ>
+
+// Events with an associated energy, and the stats counters (or DRAM commands) they are charged to
+struct energyEvent {
+    string name;
+    vector<string> counters;
+};
+
+const vector<energyEvent> CORE_EVENTS = {
+    { "mul_lane_op",    { "mul_lane_ops" } },
+    { "add_lane_op",    { "add_lane_ops" } },
+    { "grf_rd",         { "grfa_rd", "grfb_rd" } },
+    { "grf_wr",         { "grfa_wr", "grfb_wr" } },
+    { "srf_rd",         { "srf_rd" } },
+    { "srf_wr",         { "srf_wr" } },
+    { "crf_rd",         { "pim_dq_cycles" } },  // One instruction fetch per issued command
+    { "crf_wr",         { "crf_wr" } },
+    { "bank_transfer",  { "bank_rd", "bank_wr" } },
+    { "dq_cycle",       { "rf_dq_cycles" } },
+    { "core_cycle",     { "cycles" } },
+};
+
+const vector<energyEvent> DRAM_EVENTS = {
+    { "act",    { "ACT" } },
+    { "pre",    { "PRE", "PREA", "RDA", "WRA" } },   // Auto-precharge also closes the row
+    { "rd",     { "RD", "RDA" } },
+    { "wr",     { "WR", "WRA" } },
+    { "ref",    { "REF", "REFSB" } },
+};
+
+int main(int argc, const char *argv[])
+{
+    if (argc != 5) {
+        cout << "Usage: " << argv[0] << " <stats-file> <ramulator-output> <energy-config> <output-file>" << endl;
+        return 0;
+    }
+
+    string si = argv[1];    // Input stats file name
+    string ro = argv[2];    // Input ramulator output file name
+    string ec = argv[3];    // Input energy configuration file name
+    string fo = argv[4];    // Output file name
+    string line;
+    string finalLine = "Simulation done.";  // Start of final line in ramulator output
+
+    map<string, double> energy;     // Energy per event, in pJ
+    map<string, uint64_t> counts;   // Occurrences of each counter or DRAM command
+    uint64_t cycles = 0;            // Execution time in cycles, the slowest core
+
+    // Read the energy per event
+    ifstream config;
+    config.open(ec);
+    if (!config.is_open()) {
+        cout << "Error when opening energy config file" << endl;
+        return 1;
+    }
+    while (getline(config, line)) {
+        line = line.substr(0, line.find('#'));
+        istringstream iss(line);
+        string key, eq;
+        double value;
+        if (!(iss >> key))
+            continue;   // Empty or comment line
+        if (!(iss >> eq >> value) || eq.compare("=")) {
+            cout << "Error when reading energy config: " << line << endl;
+            return 1;
+        }
+        energy[key] = value;
+    }
+    config.close();
+
+    // Accumulate the counters of all the cores
+    ifstream stats;
+    stats.open(si);
+    if (!stats.is_open()) {
+        cout << "Error when opening stats file" << endl;
+        return 1;
+    }
+    vector<string> columns;
+    if (getline(stats, line)) {
+        istringstream iss(line);
+        string column;
+        while (getline(iss, column, ','))
+            columns.push_back(column);
+    }
+    while (getline(stats, line)) {
+        istringstream iss(line);
+        string field;
+        for (uint i = 0; i < columns.size() && getline(iss, field, ','); i++) {
+            counts[columns[i]] += strtoull(field.c_str(), NULL, 10);
+            if (!columns[i].compare("cycles"))
+                cycles = max(cycles, (uint64_t) strtoull(field.c_str(), NULL, 10));
+        }
+    }
+    stats.close();
+
+    // Count the DRAM commands issued by ramulator
+    ifstream ramOut;
+    ramOut.open(ro);
+    if (!ramOut.is_open()) {
+        cout << "Error when opening ramulator output" << endl;
+        return 1;
+    }
+    while (getline(ramOut, line)) {
+        if (!line.compare(0, finalLine.size(), finalLine))
+            continue;
+        istringstream iss(line);
+        string ramCmd;
+        if (iss >> ramCmd)
+            counts[ramCmd]++;
+    }
+    ramOut.close();
+
+    // Multiply the activity by the energy per event
+    ofstream output;
+    output.open(fo);
+    output << "event,count,energy_pJ" << endl;
+
+    double coreEnergy = 0, dramEnergy = 0;
+    for (int pass = 0; pass < 2; pass++) {
+        const vector<energyEvent> &events = pass ? DRAM_EVENTS : CORE_EVENTS;
+        for (auto const &ev : events) {
+            uint64_t evCount = 0;
+            for (auto const &cnt : ev.counters)
+                evCount += counts[cnt];
+            if (evCount && !energy.count(ev.name))
+                cout << "Warning, no energy defined for " << ev.name << ", assuming 0" << endl;
+            double evEnergy = evCount * energy[ev.name];
+            (pass ? dramEnergy : coreEnergy) += evEnergy;
+            output << ev.name << "," << evCount << "," << evEnergy << endl;
+        }
+    }
+
+    double totalEnergy = coreEnergy + dramEnergy;
+    double delay = double(cycles) * CLK_PERIOD / 1000.0;   // In ns, CLK_PERIOD is given in ps
+    output << "core,," << coreEnergy << endl;
+    output << "dram,," << dramEnergy << endl;
+    output << "total,," << totalEnergy << endl;
+    output << "delay_ns,," << delay << endl;
+    output << "edp_pJns,," << totalEnergy * delay << endl;
+    output.close();
+
+    // Summary for the exploration scripts
+    cout << "Energy: " << totalEnergy << " pJ (core " << coreEnergy << " pJ, DRAM " << dramEnergy << " pJ)";
+    cout << " Delay: " << delay << " ns EDP: " << totalEnergy * delay << " pJ*ns" << endl;
+
+    return 0;
+}
@@ -7,12 +7,12 @@ void mapConvCWWRRLim (ofstream &assembly, ofstream &dataFile, ofstream &addrFile
     int i,j,l,m,n;
 
     int ext_loops = floor(pow(float(k),2)*float(ci)/float(GRF_ENTRIES)) - 1; 
-    int loops = ceil(float(wo)*float(ho)/float(SIMD_WIDTH*CORES_PER_PCH));
+    int loops = ceil(float(wo)*float(ho)/float(SIMD_WIDTH*LOCKSTEP_CORES));
     int ext_peeling = int(pow(k,2)*ci) % GRF_ENTRIES;
 
-    uint64_t weightBase = ceil(float(loops * k*k * ci / 2) / float(COLPERROW*CORES_PER_PCH)); // Div 2 because distributed in 2 banks
-    uint64_t biasBase = weightBase + ceil(float(ceil(float(co) * k*k * ci / float(SIMD_WIDTH*CORES_PER_PCH)) / 2) / float(COLPERROW));
-    uint64_t resBase = biasBase + ceil(float(ceil(float(co) / float(SIMD_WIDTH*CORES_PER_PCH)) / 2) / float(COLPERROW));
+    uint64_t weightBase = ceil(float(loops * k*k * ci / 2) / float(COLPERROW*LOCKSTEP_CORES)); // Div 2 because distributed in 2 banks
+    uint64_t biasBase = weightBase + ceil(float(ceil(float(co) * k*k * ci / float(SIMD_WIDTH*LOCKSTEP_CORES)) / 2) / float(COLPERROW));
+    uint64_t resBase = biasBase + ceil(float(ceil(float(co) / float(SIMD_WIDTH*LOCKSTEP_CORES)) / 2) / float(COLPERROW));
 
     uint64_t rowIdx[2] = {0, resBase};
     uint64_t colIdx[2] = {0,0};
@@ -48,9 +48,7 @@ void mapConvCWWRRLim (ofstream &assembly, ofstream &dataFile, ofstream &addrFile
                 assembly << "JUMP " << SRF_M_ENTRIES+1 << " " << loops-1 << endl;
             assembly << "EXIT" << endl;
             
-            for (j=0; j<SRF_M_ENTRIES; j++) { 
-                assembly << "WRF SRFM" << j << " DataFile" << endl; // Weights
-            }
+            writeSrfMLoad(assembly, SRF_M_ENTRIES);   // Weights
             assembly << "WRF SRFA0 DataFile" << endl;   // Bias
             
             assembly << "EXEC" << endl;
@@ -71,9 +69,7 @@ void mapConvCWWRRLim (ofstream &assembly, ofstream &dataFile, ofstream &addrFile
             assembly << "EXIT" << endl;
 
             for (j=0; j<ext_loops; j++) {
-                for (l=0; l<SRF_M_ENTRIES; l++) {   
-                    assembly << "WRF SRFM" << l << " DataFile" << endl; // Weights
-                }
+                writeSrfMLoad(assembly, SRF_M_ENTRIES);   // Weights
                 assembly << "EXEC" << endl;
             }
         }
@@ -87,9 +83,7 @@ void mapConvCWWRRLim (ofstream &assembly, ofstream &dataFile, ofstream &addrFile
                 assembly << "JUMP " << ext_peeling+2 << " " << loops-1 << endl;
             assembly << "EXIT" << endl;
 
-            for (j=0; j<ext_peeling; j++) {
-                assembly << "WRF SRFM" << j << " DataFile" << endl; // Weights
-            }
+            writeSrfMLoad(assembly, ext_peeling);   // Weights
             assembly << "EXEC" << endl;
         } else if (ext_peeling) {
             assembly << "; Peeled set of weights" << endl;
@@ -107,9 +101,7 @@ void mapConvCWWRRLim (ofstream &assembly, ofstream &dataFile, ofstream &addrFile
                 assembly << "JUMP " << ext_peeling+1 << " " << loops-1 << endl;
             assembly << "EXIT" << endl;
             
-            for (j=0; j<ext_peeling; j++) { 
-                assembly << "WRF SRFM" << j << " DataFile" << endl; // Weights
-            }
+            writeSrfMLoad(assembly, ext_peeling);   // Weights
             assembly << "WRF SRFA0 DataFile" << endl;   // Bias
             
             assembly << "EXEC" << endl;
@@ -135,15 +127,15 @@ void mapConvCWWRRLim (ofstream &assembly, ofstream &dataFile, ofstream &addrFile
             addrFile << "### First set of weights" << endl;
             for (l=0; l<loops; l++) {
                 for (m=0; m<SRF_M_ENTRIES/2; m++) {
-                    addrFile << showbase << hex << build_addr({0,0,0,0,rowIdx[0],colIdx[0]}) << endl;
-                    addrFile << showbase << hex << build_addr({0,0,0,1,rowIdx[0],colIdx[0]}) << endl;
+                    addrFile << showbase << hex << build_addr({mapChannel,mapRank,mapBankGroup,0,rowIdx[0],colIdx[0]}) << endl;
+                    addrFile << showbase << hex << build_addr({mapChannel,mapRank,mapBankGroup,1,rowIdx[0],colIdx[0]}) << endl;
                     if (++colIdx[0] == COLPERROW) {
                         colIdx[0] = 0;
                         rowIdx[0]++;
                     }
                 }
 
-                addrFile << showbase << hex << build_addr({0,0,0,1,rowIdx[1],colIdx[1]}) << endl;
+                addrFile << showbase << hex << build_addr({mapChannel,mapRank,mapBankGroup,1,rowIdx[1],colIdx[1]}) << endl;
                 if (++colIdx[1] == COLPERROW) {
                     colIdx[1] = 0;
                     rowIdx[1]++;
@@ -157,18 +149,18 @@ void mapConvCWWRRLim (ofstream &assembly, ofstream &dataFile, ofstream &addrFile
             for (j=0; j<ext_loops; j++) {
                 rowIdx[1] = resRowRet;  colIdx[1] = resColRet;
                 for (l=0; l<loops; l++) {
-                    addrFile << showbase << hex << build_addr({0,0,0,1,rowIdx[1],colIdx[1]}) << endl;
+                    addrFile << showbase << hex << build_addr({mapChannel,mapRank,mapBankGroup,1,rowIdx[1],colIdx[1]}) << endl;
 
                     for (m=0; m<SRF_M_ENTRIES/2; m++) {
-                        addrFile << showbase << hex << build_addr({0,0,0,0,rowIdx[0],colIdx[0]}) << endl;
-                        addrFile << showbase << hex << build_addr({0,0,0,1,rowIdx[0],colIdx[0]}) << endl;
+                        addrFile << showbase << hex << build_addr({mapChannel,mapRank,mapBankGroup,0,rowIdx[0],colIdx[0]}) << endl;
+                        addrFile << showbase << hex << build_addr({mapChannel,mapRank,mapBankGroup,1,rowIdx[0],colIdx[0]}) << endl;
                         if (++colIdx[0] == COLPERROW) {
                             colIdx[0] = 0;
                             rowIdx[0]++;
                         }
                     }
 
-                    addrFile << showbase << hex << build_addr({0,0,0,1,rowIdx[1],colIdx[1]}) << endl;
+                    addrFile << showbase << hex << build_addr({mapChannel,mapRank,mapBankGroup,1,rowIdx[1],colIdx[1]}) << endl;
                     if (++colIdx[1] == COLPERROW) {
                         colIdx[1] = 0;
                         rowIdx[1]++;
@@ -183,20 +175,20 @@ void mapConvCWWRRLim (ofstream &assembly, ofstream &dataFile, ofstream &addrFile
             rowIdx[1] = resRowRet;  colIdx[1] = resColRet;
             addrFile << "# Out of the main loop" << endl;
             for (j=0; j<loops; j++) {
-                addrFile << showbase << hex << build_addr({0,0,0,1,rowIdx[1],colIdx[1]}) << endl;
+                addrFile << showbase << hex << build_addr({mapChannel,mapRank,mapBankGroup,1,rowIdx[1],colIdx[1]}) << endl;
 
                 for (l=0; l<ext_peeling/2; l++) {
-                    addrFile << showbase << hex << build_addr({0,0,0,0,rowIdx[0],colIdx[0]}) << endl;
-                    addrFile << showbase << hex << build_addr({0,0,0,1,rowIdx[0],colIdx[0]}) << endl;
+                    addrFile << showbase << hex << build_addr({mapChannel,mapRank,mapBankGroup,0,rowIdx[0],colIdx[0]}) << endl;
+                    addrFile << showbase << hex << build_addr({mapChannel,mapRank,mapBankGroup,1,rowIdx[0],colIdx[0]}) << endl;
                     if (++colIdx[0] == COLPERROW) {
                         colIdx[0] = 0;
                         rowIdx[0]++;
                     }
                 }
                 if (ext_peeling - 2*l)  // If n it's odd, last one is only with EVEN_BANK
-                    addrFile << showbase << hex << build_addr({0,0,0,0,rowIdx[0],colIdx[0]}) << endl;
+                    addrFile << showbase << hex << build_addr({mapChannel,mapRank,mapBankGroup,0,rowIdx[0],colIdx[0]}) << endl;
 
-                addrFile << showbase << hex << build_addr({0,0,0,1,rowIdx[1],colIdx[1]}) << endl;
+                addrFile << showbase << hex << build_addr({mapChannel,mapRank,mapBankGroup,1,rowIdx[1],colIdx[1]}) << endl;
                 if (++colIdx[1] == COLPERROW) {
                     colIdx[1] = 0;
                     rowIdx[1]++;
@@ -225,14 +217,9 @@ void mapConvCWWRRLim (ofstream &assembly, ofstream &dataFile, ofstream &addrFile
         if (ext_loops > -1) {
             dataFile << "### First set of weights" << endl;
             // Weights
-            for (j=0; j<SRF_M_ENTRIES; j++) {
-                if(WORD_BITS != 8)
-                    dataFile << weight[weightIdx++] << endl;
-                else
-                    dataFile << int(weight[weightIdx++]) << endl; //need to cast the results for int8 only
-            }
+            writeSrfMData(dataFile, weight, &weightIdx, SRF_M_ENTRIES);
             // Bias
-            if(WORD_BITS != 8)
+            if (!CHAR_DATA)
                 dataFile << bias[i] << endl;
             else
                 dataFile << int(bias[i]) << endl; //need to cast the results for int8 only
@@ -247,9 +234,9 @@ void mapConvCWWRRLim (ofstream &assembly, ofstream &dataFile, ofstream &addrFile
                     wiStart = curKCol;  wiEnd = wi - k + curKCol + 1;
                     hiStart = curKRow;  hiEnd = hi - k + curKRow + 1;
 
-                    for (m=0; m<SIMD_WIDTH*CORES_PER_PCH; m++) {
+                    for (m=0; m<SIMD_WIDTH*LOCKSTEP_CORES; m++) {
                         // Output 0 if not relevant for the weight, otherwise data
-                        if(WORD_BITS != 8)
+                        if (!CHAR_DATA)
                             dataFile << (hiIdx[l] >= hiEnd ? 0 : act[ciIdx[l]*wi*hi + hiIdx[l]*wi + wiIdx[l]]) << " ";
                         else
                             dataFile << int(hiIdx[l] >= hiEnd ? 0 : act[ciIdx[l]*wi*hi + hiIdx[l]*wi + wiIdx[l]]) << " "; //need to cast the results for int8 only
@@ -282,17 +269,12 @@ void mapConvCWWRRLim (ofstream &assembly, ofstream &dataFile, ofstream &addrFile
             woIdx = hoIdx = 0;
 
             // Weights
-            for (l=0; l<SRF_M_ENTRIES; l++) {
-                if(WORD_BITS != 8)
-                    dataFile << weight[weightIdx++] << endl;
-                else
-                    dataFile << int(weight[weightIdx++]) << endl; //need to cast the results for int8 only
-            }
+            writeSrfMData(dataFile, weight, &weightIdx, SRF_M_ENTRIES);
 
             for (l=0; l<loops; l++) {
                 // Provide partial results or zeros
-                for (m=0; m<SIMD_WIDTH*CORES_PER_PCH; m++) {if (hoIdx < ho) {
-                        if(WORD_BITS != 8)
+                for (m=0; m<SIMD_WIDTH*LOCKSTEP_CORES; m++) {if (hoIdx < ho) {
+                        if (!CHAR_DATA)
                             dataFile << partPixConv(act, weight, bias, stride, k, ci, hi, wi, compKCh, compKRow, compKCol, i, hoIdx, woIdx) << " ";
                         else
                             dataFile << int(partPixConv(act, weight, bias, stride, k, ci, hi, wi, compKCh, compKRow, compKCol, i, hoIdx, woIdx)) << " "; //need to cast the results for int8 only
@@ -315,9 +297,9 @@ void mapConvCWWRRLim (ofstream &assembly, ofstream &dataFile, ofstream &addrFile
                     wiStart = curKCol;  wiEnd = wi - k + curKCol + 1;
                     hiStart = curKRow;  hiEnd = hi - k + curKRow + 1;
 
-                    for (n=0; n<SIMD_WIDTH*CORES_PER_PCH; n++) {
+                    for (n=0; n<SIMD_WIDTH*LOCKSTEP_CORES; n++) {
                         // Output 0 if not relevant for the weight, otherwise data
-                        if(WORD_BITS != 8)
+                        if (!CHAR_DATA)
                             dataFile << (hiIdx[m] >= hiEnd ? 0 : act[ciIdx[m]*wi*hi + hiIdx[m]*wi + wiIdx[m]]) << " ";
                         else
                             dataFile << int(hiIdx[m] >= hiEnd ? 0 : act[ciIdx[m]*wi*hi + hiIdx[m]*wi + wiIdx[m]]) << " "; //need to cast the results for int8 only
@@ -350,18 +332,13 @@ void mapConvCWWRRLim (ofstream &assembly, ofstream &dataFile, ofstream &addrFile
             woIdx = hoIdx = 0;
 
             // Weights
-            for (j=0; j<ext_peeling; j++) {
-                if(WORD_BITS != 8)
-                    dataFile << weight[weightIdx++] << endl;
-                else
-                    dataFile << int(weight[weightIdx++]) << endl; //need to cast the results for int8 only
-            }
+            writeSrfMData(dataFile, weight, &weightIdx, ext_peeling);
 
             for (j=0; j<loops; j++) {
                 // Provide partial results or zeros
-                for (l=0; l<SIMD_WIDTH*CORES_PER_PCH; l++) {
+                for (l=0; l<SIMD_WIDTH*LOCKSTEP_CORES; l++) {
                     if (hoIdx < ho) {
-                        if(WORD_BITS != 8)
+                        if (!CHAR_DATA)
                             dataFile << partPixConv(act, weight, bias, stride, k, ci, hi, wi, compKCh, compKRow, compKCol, i, hoIdx, woIdx) << " ";
                         else
                             dataFile << int(partPixConv(act, weight, bias, stride, k, ci, hi, wi, compKCh, compKRow, compKCol, i, hoIdx, woIdx)) << " "; //need to cast the results for int8 only
@@ -384,9 +361,9 @@ void mapConvCWWRRLim (ofstream &assembly, ofstream &dataFile, ofstream &addrFile
                     wiStart = curKCol;  wiEnd = wi - k + curKCol + 1;
                     hiStart = curKRow;  hiEnd = hi - k + curKRow + 1;
 
-                    for (m=0; m<SIMD_WIDTH*CORES_PER_PCH; m++) {
+                    for (m=0; m<SIMD_WIDTH*LOCKSTEP_CORES; m++) {
                         // Output 0 if not relevant for the weight, otherwise data
-                        if(WORD_BITS != 8)
+                        if (!CHAR_DATA)
                             dataFile << (hiIdx[l] >= hiEnd ? 0 : act[ciIdx[l]*wi*hi + hiIdx[l]*wi + wiIdx[l]]) << " ";
                         else
                             dataFile << int(hiIdx[l] >= hiEnd ? 0 : act[ciIdx[l]*wi*hi + hiIdx[l]*wi + wiIdx[l]]) << " "; //need to cast the results for int8 only
@@ -402,14 +379,9 @@ void mapConvCWWRRLim (ofstream &assembly, ofstream &dataFile, ofstream &addrFile
         } else if (ext_peeling) {
             dataFile << "### Peeled set of weights" << endl;
             // Weights
-            for (j=0; j<ext_peeling; j++) {
-                if(WORD_BITS != 8)
-                    dataFile << weight[weightIdx++] << endl;
-                else
-                    dataFile << int(weight[weightIdx++]) << endl; //need to cast the results for int8 only
-            }
+            writeSrfMData(dataFile, weight, &weightIdx, ext_peeling);
             // Bias
-            if(WORD_BITS != 8)
+            if (!CHAR_DATA)
                 dataFile << bias[i] << endl;
             else
                 dataFile << int(bias[i]) << endl; //need to cast the results for int8 only
@@ -424,9 +396,9 @@ void mapConvCWWRRLim (ofstream &assembly, ofstream &dataFile, ofstream &addrFile
                     wiStart = curKCol;  wiEnd = wi - k + curKCol + 1;
                     hiStart = curKRow;  hiEnd = hi - k + curKRow + 1;
 
-                    for (m=0; m<SIMD_WIDTH*CORES_PER_PCH; m++) {
+                    for (m=0; m<SIMD_WIDTH*LOCKSTEP_CORES; m++) {
                         // Output 0 if not relevant for the weight, otherwise data
-                        if(WORD_BITS != 8)
+                        if (!CHAR_DATA)
                             dataFile << (hiIdx[l] >= hiEnd ? 0 : act[ciIdx[l]*wi*hi + hiIdx[l]*wi + wiIdx[l]]) << " ";
                         else
                             dataFile << int(hiIdx[l] >= hiEnd ? 0 : act[ciIdx[l]*wi*hi + hiIdx[l]*wi + wiIdx[l]]) << " "; //need to cast the results for int8 only
@@ -452,12 +424,12 @@ void mapConvCWWRCLim (ofstream &assembly, ofstream &dataFile, ofstream &addrFile
     int crfSegment = CRF_ENTRIES - 4;
     crfSegment = min(crfSegment, SRF_M_ENTRIES);         // If segment is larger than SRF capacity, limit it to the latter
     int ext_loops = floor(pow(float(k),2)*float(ci)/float(crfSegment)) - 1; 
-    int loops = ceil(float(wo)*float(ho)/float(SIMD_WIDTH*CORES_PER_PCH));
+    int loops = ceil(float(wo)*float(ho)/float(SIMD_WIDTH*LOCKSTEP_CORES));
     int ext_peeling = int(pow(k,2)*ci) % crfSegment;
 
-    uint64_t weightBase = ceil(float(loops * k*k * ci / 2) / float(COLPERROW*CORES_PER_PCH)); // Div 2 because distributed in 2 banks
-    uint64_t biasBase = weightBase + ceil(float(ceil(float(co) * k*k * ci / float(SIMD_WIDTH*CORES_PER_PCH)) / 2) / float(COLPERROW));
-    uint64_t resBase = biasBase + ceil(float(ceil(float(co) / float(SIMD_WIDTH*CORES_PER_PCH)) / 2) / float(COLPERROW));
+    uint64_t weightBase = ceil(float(loops * k*k * ci / 2) / float(COLPERROW*LOCKSTEP_CORES)); // Div 2 because distributed in 2 banks
+    uint64_t biasBase = weightBase + ceil(float(ceil(float(co) * k*k * ci / float(SIMD_WIDTH*LOCKSTEP_CORES)) / 2) / float(COLPERROW));
+    uint64_t resBase = biasBase + ceil(float(ceil(float(co) / float(SIMD_WIDTH*LOCKSTEP_CORES)) / 2) / float(COLPERROW));
 
     uint64_t rowIdx[2] = {0, resBase};
     uint64_t colIdx[2] = {0,0};
@@ -496,9 +468,7 @@ void mapConvCWWRCLim (ofstream &assembly, ofstream &dataFile, ofstream &addrFile
                 assembly << "JUMP " << crfSegment+1 << " " << loops-1 << endl;
             assembly << "EXIT" << endl;
             
-            for (j=0; j<crfSegment; j++) { 
-                assembly << "WRF SRFM" << j << " DataFile" << endl; // Weights
-            }
+            writeSrfMLoad(assembly, crfSegment);   // Weights
             assembly << "WRF SRFA0 DataFile" << endl;   // Bias
             
             assembly << "EXEC" << endl;
@@ -522,9 +492,7 @@ void mapConvCWWRCLim (ofstream &assembly, ofstream &dataFile, ofstream &addrFile
             assembly << "EXIT" << endl;
 
             for (j=0; j<ext_loops; j++) {
-                for (l=0; l<crfSegment; l++) {   
-                    assembly << "WRF SRFM" << l << " DataFile" << endl; // Weights
-                }
+                writeSrfMLoad(assembly, crfSegment);   // Weights
                 assembly << "EXEC" << endl;
             }
         }
@@ -538,9 +506,7 @@ void mapConvCWWRCLim (ofstream &assembly, ofstream &dataFile, ofstream &addrFile
                 assembly << "JUMP " << ext_peeling+2 << " " << loops-1 << endl;
             assembly << "EXIT" << endl;
 
-            for (j=0; j<ext_peeling; j++) {
-                assembly << "WRF SRFM" << j << " DataFile" << endl; // Weights
-            }
+            writeSrfMLoad(assembly, ext_peeling);   // Weights
             assembly << "EXEC" << endl;
         } else if (ext_peeling) {
             assembly << "; Peeled set of weights" << endl;
@@ -558,9 +524,7 @@ void mapConvCWWRCLim (ofstream &assembly, ofstream &dataFile, ofstream &addrFile
                 assembly << "JUMP " << ext_peeling+1 << " " << loops-1 << endl;
             assembly << "EXIT" << endl;
             
-            for (j=0; j<ext_peeling; j++) { 
-                assembly << "WRF SRFM" << j << " DataFile" << endl; // Weights
-            }
+            writeSrfMLoad(assembly, ext_peeling);   // Weights
             assembly << "WRF SRFA0 DataFile" << endl;   // Bias
             
             assembly << "EXEC" << endl;
@@ -586,22 +550,22 @@ void mapConvCWWRCLim (ofstream &assembly, ofstream &dataFile, ofstream &addrFile
             addrFile << "### First set of weights" << endl;
             for (l=0; l<loops; l++) {
                 for (m=0; m<crfSegment/2; m++) {
-                    addrFile << showbase << hex << build_addr({0,0,0,0,rowIdx[0],colIdx[0]}) << endl;
-                    addrFile << showbase << hex << build_addr({0,0,0,1,rowIdx[0],colIdx[0]}) << endl;
+                    addrFile << showbase << hex << build_addr({mapChannel,mapRank,mapBankGroup,0,rowIdx[0],colIdx[0]}) << endl;
+                    addrFile << showbase << hex << build_addr({mapChannel,mapRank,mapBankGroup,1,rowIdx[0],colIdx[0]}) << endl;
                     if (++colIdx[0] == COLPERROW) {
                         colIdx[0] = 0;
                         rowIdx[0]++;
                     }
                 }
                 if (crfSegment % 2) {
-                    addrFile << showbase << hex << build_addr({0,0,0,0,rowIdx[0],colIdx[0]}) << endl;
+                    addrFile << showbase << hex << build_addr({mapChannel,mapRank,mapBankGroup,0,rowIdx[0],colIdx[0]}) << endl;
                     if (++colIdx[0] == COLPERROW) {
                         colIdx[0] = 0;
                         rowIdx[0]++;
                     }
                 }
 
-                addrFile << showbase << hex << build_addr({0,0,0,1,rowIdx[1],colIdx[1]}) << endl;
+                addrFile << showbase << hex << build_addr({mapChannel,mapRank,mapBankGroup,1,rowIdx[1],colIdx[1]}) << endl;
                 if (++colIdx[1] == COLPERROW) {
                     colIdx[1] = 0;
                     rowIdx[1]++;
@@ -615,25 +579,25 @@ void mapConvCWWRCLim (ofstream &assembly, ofstream &dataFile, ofstream &addrFile
             for (j=0; j<ext_loops; j++) {
                 rowIdx[1] = resRowRet;  colIdx[1] = resColRet;
                 for (l=0; l<loops; l++) {
-                    addrFile << showbase << hex << build_addr({0,0,0,1,rowIdx[1],colIdx[1]}) << endl;
+                    addrFile << showbase << hex << build_addr({mapChannel,mapRank,mapBankGroup,1,rowIdx[1],colIdx[1]}) << endl;
 
                     for (m=0; m<crfSegment/2; m++) {
-                        addrFile << showbase << hex << build_addr({0,0,0,0,rowIdx[0],colIdx[0]}) << endl;
-                        addrFile << showbase << hex << build_addr({0,0,0,1,rowIdx[0],colIdx[0]}) << endl;
+                        addrFile << showbase << hex << build_addr({mapChannel,mapRank,mapBankGroup,0,rowIdx[0],colIdx[0]}) << endl;
+                        addrFile << showbase << hex << build_addr({mapChannel,mapRank,mapBankGroup,1,rowIdx[0],colIdx[0]}) << endl;
                         if (++colIdx[0] == COLPERROW) {
                             colIdx[0] = 0;
                             rowIdx[0]++;
                         }
                     }
                     if (crfSegment % 2) {
-                        addrFile << showbase << hex << build_addr({0,0,0,0,rowIdx[0],colIdx[0]}) << endl;
+                        addrFile << showbase << hex << build_addr({mapChannel,mapRank,mapBankGroup,0,rowIdx[0],colIdx[0]}) << endl;
                         if (++colIdx[0] == COLPERROW) {
                             colIdx[0] = 0;
                             rowIdx[0]++;
                         }
                     }
 
-                    addrFile << showbase << hex << build_addr({0,0,0,1,rowIdx[1],colIdx[1]}) << endl;
+                    addrFile << showbase << hex << build_addr({mapChannel,mapRank,mapBankGroup,1,rowIdx[1],colIdx[1]}) << endl;
                     if (++colIdx[1] == COLPERROW) {
                         colIdx[1] = 0;
                         rowIdx[1]++;
@@ -648,20 +612,20 @@ void mapConvCWWRCLim (ofstream &assembly, ofstream &dataFile, ofstream &addrFile
             rowIdx[1] = resRowRet;  colIdx[1] = resColRet;
             addrFile << "# Out of the main loop" << endl;
             for (j=0; j<loops; j++) {
-                addrFile << showbase << hex << build_addr({0,0,0,1,rowIdx[1],colIdx[1]}) << endl;
+                addrFile << showbase << hex << build_addr({mapChannel,mapRank,mapBankGroup,1,rowIdx[1],colIdx[1]}) << endl;
 
                 for (l=0; l<ext_peeling/2; l++) {
-                    addrFile << showbase << hex << build_addr({0,0,0,0,rowIdx[0],colIdx[0]}) << endl;
-                    addrFile << showbase << hex << build_addr({0,0,0,1,rowIdx[0],colIdx[0]}) << endl;
+                    addrFile << showbase << hex << build_addr({mapChannel,mapRank,mapBankGroup,0,rowIdx[0],colIdx[0]}) << endl;
+                    addrFile << showbase << hex << build_addr({mapChannel,mapRank,mapBankGroup,1,rowIdx[0],colIdx[0]}) << endl;
                     if (++colIdx[0] == COLPERROW) {
                         colIdx[0] = 0;
                         rowIdx[0]++;
                     }
                 }
                 if (ext_peeling - 2*l)  // If n it's odd, last one is only with EVEN_BANK
-                    addrFile << showbase << hex << build_addr({0,0,0,0,rowIdx[0],colIdx[0]}) << endl;
+                    addrFile << showbase << hex << build_addr({mapChannel,mapRank,mapBankGroup,0,rowIdx[0],colIdx[0]}) << endl;
 
-                addrFile << showbase << hex << build_addr({0,0,0,1,rowIdx[1],colIdx[1]}) << endl;
+                addrFile << showbase << hex << build_addr({mapChannel,mapRank,mapBankGroup,1,rowIdx[1],colIdx[1]}) << endl;
                 if (++colIdx[1] == COLPERROW) {
                     colIdx[1] = 0;
                     rowIdx[1]++;
@@ -690,14 +654,9 @@ void mapConvCWWRCLim (ofstream &assembly, ofstream &dataFile, ofstream &addrFile
         if (ext_loops > -1) {
             dataFile << "### First set of weights" << endl;
             // Weights
-            for (j=0; j<crfSegment; j++) {
-                if(WORD_BITS != 8)
-                    dataFile << weight[weightIdx++] << endl;
-                else
-                    dataFile << int(weight[weightIdx++]) << endl; //need to cast the results for int8 only
-            }
+            writeSrfMData(dataFile, weight, &weightIdx, crfSegment);
             // Bias
-            if(WORD_BITS != 8)
+            if (!CHAR_DATA)
                 dataFile << bias[i] << endl;
             else
                 dataFile << int(bias[i]) << endl; //need to cast the results for int8 only
@@ -712,9 +671,9 @@ void mapConvCWWRCLim (ofstream &assembly, ofstream &dataFile, ofstream &addrFile
                     wiStart = curKCol;  wiEnd = wi - k + curKCol + 1;
                     hiStart = curKRow;  hiEnd = hi - k + curKRow + 1;
 
-                    for (m=0; m<SIMD_WIDTH*CORES_PER_PCH; m++) {
+                    for (m=0; m<SIMD_WIDTH*LOCKSTEP_CORES; m++) {
                         // Output 0 if not relevant for the weight, otherwise data
-                        if(WORD_BITS != 8)
+                        if (!CHAR_DATA)
                             dataFile << (hiIdx[l] >= hiEnd ? 0 : act[ciIdx[l]*wi*hi + hiIdx[l]*wi + wiIdx[l]]) << " ";
                         else
                             dataFile << int(hiIdx[l] >= hiEnd ? 0 : act[ciIdx[l]*wi*hi + hiIdx[l]*wi + wiIdx[l]]) << " "; //need to cast the results for int8 only
@@ -747,17 +706,12 @@ void mapConvCWWRCLim (ofstream &assembly, ofstream &dataFile, ofstream &addrFile
             woIdx = hoIdx = 0;
 
             // Weights
-            for (l=0; l<crfSegment; l++) {
-                if(WORD_BITS != 8)
-                    dataFile << weight[weightIdx++] << endl;
-                else
-                    dataFile << int(weight[weightIdx++]) << endl; //need to cast the results for int8 only
-            }
+            writeSrfMData(dataFile, weight, &weightIdx, crfSegment);
 
             for (l=0; l<loops; l++) {
                 // Provide partial results or zeros
-                for (m=0; m<SIMD_WIDTH*CORES_PER_PCH; m++) {if (hoIdx < ho) {
-                        if(WORD_BITS != 8)
+                for (m=0; m<SIMD_WIDTH*LOCKSTEP_CORES; m++) {if (hoIdx < ho) {
+                        if (!CHAR_DATA)
                             dataFile << partPixConv(act, weight, bias, stride, k, ci, hi, wi, compKCh, compKRow, compKCol, i, hoIdx, woIdx) << " ";
                         else
                             dataFile << int(partPixConv(act, weight, bias, stride, k, ci, hi, wi, compKCh, compKRow, compKCol, i, hoIdx, woIdx)) << " "; //need to cast the results for int8 only
@@ -780,9 +734,9 @@ void mapConvCWWRCLim (ofstream &assembly, ofstream &dataFile, ofstream &addrFile
                     wiStart = curKCol;  wiEnd = wi - k + curKCol + 1;
                     hiStart = curKRow;  hiEnd = hi - k + curKRow + 1;
 
-                    for (n=0; n<SIMD_WIDTH*CORES_PER_PCH; n++) {
+                    for (n=0; n<SIMD_WIDTH*LOCKSTEP_CORES; n++) {
                         // Output 0 if not relevant for the weight, otherwise data
-                        if(WORD_BITS != 8)
+                        if (!CHAR_DATA)
                             dataFile << (hiIdx[m] >= hiEnd ? 0 : act[ciIdx[m]*wi*hi + hiIdx[m]*wi + wiIdx[m]]) << " ";
                         else
                             dataFile << int(hiIdx[m] >= hiEnd ? 0 : act[ciIdx[m]*wi*hi + hiIdx[m]*wi + wiIdx[m]]) << " "; //need to cast the results for int8 only
@@ -815,18 +769,13 @@ void mapConvCWWRCLim (ofstream &assembly, ofstream &dataFile, ofstream &addrFile
             woIdx = hoIdx = 0;
 
             // Weights
-            for (j=0; j<ext_peeling; j++) {
-                if(WORD_BITS != 8)
-                    dataFile << weight[weightIdx++] << endl;
-                else
-                    dataFile << int(weight[weightIdx++]) << endl; //need to cast the results for int8 only
-            }
+            writeSrfMData(dataFile, weight, &weightIdx, ext_peeling);
 
             for (j=0; j<loops; j++) {
                 // Provide partial results or zeros
-                for (l=0; l<SIMD_WIDTH*CORES_PER_PCH; l++) {
+                for (l=0; l<SIMD_WIDTH*LOCKSTEP_CORES; l++) {
                     if (hoIdx < ho) {
-                        if(WORD_BITS != 8)
+                        if (!CHAR_DATA)
                             dataFile << partPixConv(act, weight, bias, stride, k, ci, hi, wi, compKCh, compKRow, compKCol, i, hoIdx, woIdx) << " ";
                         else
                             dataFile << int(partPixConv(act, weight, bias, stride, k, ci, hi, wi, compKCh, compKRow, compKCol, i, hoIdx, woIdx)) << " "; //need to cast the results for int8 only
@@ -849,9 +798,9 @@ void mapConvCWWRCLim (ofstream &assembly, ofstream &dataFile, ofstream &addrFile
                     wiStart = curKCol;  wiEnd = wi - k + curKCol + 1;
                     hiStart = curKRow;  hiEnd = hi - k + curKRow + 1;
 
-                    for (m=0; m<SIMD_WIDTH*CORES_PER_PCH; m++) {
+                    for (m=0; m<SIMD_WIDTH*LOCKSTEP_CORES; m++) {
                         // Output 0 if not relevant for the weight, otherwise data
-                        if(WORD_BITS != 8)
+                        if (!CHAR_DATA)
                             dataFile << (hiIdx[l] >= hiEnd ? 0 : act[ciIdx[l]*wi*hi + hiIdx[l]*wi + wiIdx[l]]) << " ";
                         else
                             dataFile << int(hiIdx[l] >= hiEnd ? 0 : act[ciIdx[l]*wi*hi + hiIdx[l]*wi + wiIdx[l]]) << " "; //need to cast the results for int8 only
@@ -867,14 +816,9 @@ void mapConvCWWRCLim (ofstream &assembly, ofstream &dataFile, ofstream &addrFile
         } else if (ext_peeling) {
             dataFile << "### Peeled set of weights" << endl;
             // Weights
-            for (j=0; j<ext_peeling; j++) {
-                if(WORD_BITS != 8)
-                    dataFile << weight[weightIdx++] << endl;
-                else
-                    dataFile << int(weight[weightIdx++]) << endl; //need to cast the results for int8 only
-            }
+            writeSrfMData(dataFile, weight, &weightIdx, ext_peeling);
             // Bias
-            if(WORD_BITS != 8)
+            if (!CHAR_DATA)
                 dataFile << bias[i] << endl;
             else
                 dataFile << int(bias[i]) << endl; //need to cast the results for int8 only
@@ -889,9 +833,9 @@ void mapConvCWWRCLim (ofstream &assembly, ofstream &dataFile, ofstream &addrFile
                     wiStart = curKCol;  wiEnd = wi - k + curKCol + 1;
                     hiStart = curKRow;  hiEnd = hi - k + curKRow + 1;
 
-                    for (m=0; m<SIMD_WIDTH*CORES_PER_PCH; m++) {
+                    for (m=0; m<SIMD_WIDTH*LOCKSTEP_CORES; m++) {
                         // Output 0 if not relevant for the weight, otherwise data
-                        if(WORD_BITS != 8)
+                        if (!CHAR_DATA)
                             dataFile << (hiIdx[l] >= hiEnd ? 0 : act[ciIdx[l]*wi*hi + hiIdx[l]*wi + wiIdx[l]]) << " ";
                         else
                             dataFile << int(hiIdx[l] >= hiEnd ? 0 : act[ciIdx[l]*wi*hi + hiIdx[l]*wi + wiIdx[l]]) << " "; //need to cast the results for int8 only
@@ -908,18 +852,176 @@ void mapConvCWWRCLim (ofstream &assembly, ofstream &dataFile, ofstream &addrFile
     }
 }
 
-#if (HALF_FLOAT)
+void mapConvCWSlidingWindow (ofstream &assembly, ofstream &dataFile, ofstream &addrFile,
+                                cnm_t *act, cnm_t *weight, cnm_t *bias,
+                                int ci, int wi, int hi, int k, int co, int wo, int ho)
+{
+    int i,j,l,m,n,x;
+
+    // The rows of the activations are laid one after another, so that the output (y,x) is at position y*wi + x.
+    // Every core computes a tile of wt consecutive positions, from the SIMD_WIDTH activations starting at the
+    // same position of the input rows below, and the cores in lockstep take consecutive tiles. The positions
+    // of the last k-1 columns of every row are not outputs
+    int wt = SIMD_WIDTH - k + 1;
+    int tiles = ceil(float((ho-1)*wi + wo)/float(wt));
+    int loops = ceil(float(tiles)/float(LOCKSTEP_CORES));
+    int rowsPerSet = SRF_M_ENTRIES / k;         // Filter rows whose weights fit in the SRF
+    int sets = ceil(float(ci*k)/float(rowsPerSet));
+
+    int rows;                                   // Filter rows of the current set
+    int first;                                  // First filter row of the current set
+    int progRows = -1;                          // Filter rows of the program in the CRF, -1 if none
+    bool progBias = false;                      // The program in the CRF adds the bias
+    uint64_t weightIdx;                         // Index to run through weights
+    uint64_t actIdx, resIdx;                    // Columns of the activations, in the even bank, and of the results, in the odd one
+    int t, pos;                                 // Tile and position of a lane
+
+    // Write assembly instructions. The first set of filter rows adds the bias, and the next ones accumulate
+    // onto the partial results stored by the previous one. The program is only written when it changes
+    assembly << "; Channel-wise mapping of convolution with a sliding window, ci = " << ci << ", co = ";
+    assembly << co << ", k = " << k << ", wo = " << wo << ", ho = " << ho << endl;
+
+    for (i=0; i<co; i++) {
+
+        assembly << "; Output channel " << i << endl;
+
+        for (j=0; j<sets; j++) {
+            first = j*rowsPerSet;
+            rows = min(rowsPerSet, ci*k - first);
+
+            if (rows != progRows || (j == 0) != progBias) {
+                assembly << "WRF CRF0" << endl;
+                if (j)
+                    assembly << "MOV GRFB0 ODD_BANK[AddrFile] DataFile" << endl;
+                for (l=0; l<rows; l++) {
+                    assembly << "MOV GRFA0 EVEN_BANK[AddrFile] DataFile" << endl;
+                    for (m=0; m<k; m++) {
+                        if (m)
+                            assembly << "PERM GRFA0 GRFA0 SHR 1" << endl;
+                        if (!j && !l && !m)
+                            assembly << "MAD GRFB0 GRFA0 SRFM0 SRFA0" << endl;
+                        else
+                            assembly << "MAC GRFB0 GRFA0 SRFM" << l*k + m << endl;
+                    }
+                }
+                assembly << "MOV ODD_BANK[AddrFile] GRFB0" << endl;
+                if (loops-1)
+                    assembly << "JUMP " << 2*k*rows + (j ? 2 : 1) << " " << loops-1 << endl;
+                assembly << "EXIT" << endl;
+                progRows = rows;
+                progBias = (j == 0);
+            }
+
+            writeSrfMLoad(assembly, rows*k);        // Weights
+            if (!j)
+                assembly << "WRF SRFA0 DataFile" << endl;   // Bias
+            assembly << "EXEC" << endl;
+        }
+    }
+
+
+    // Write address for loops and others. The activations of every tile and filter row are in a column of the
+    // even bank, and the results of every tile and output channel in a column of the odd one
+    addrFile << "# Channel-wise mapping of convolution with a sliding window, ci = " << ci << ", co = ";
+    addrFile << co << ", k = " << k << ", wo = " << wo << ", ho = " << ho << endl;
+
+    for (i=0; i<co; i++) {
+
+        addrFile << "## Output channel " << i << endl;
+
+        for (j=0; j<sets; j++) {
+            first = j*rowsPerSet;
+            rows = min(rowsPerSet, ci*k - first);
+
+            for (l=0; l<loops; l++) {
+                resIdx = uint64_t(i)*loops + l;
+                if (j)
+                    addrFile << showbase << hex << build_addr({mapChannel,mapRank,mapBankGroup,1,resIdx/COLPERROW,resIdx%COLPERROW}) << endl;
+                for (m=0; m<rows; m++) {
+                    actIdx = uint64_t(l)*ci*k + first + m;
+                    addrFile << showbase << hex << build_addr({mapChannel,mapRank,mapBankGroup,0,actIdx/COLPERROW,actIdx%COLPERROW}) << endl;
+                }
+                addrFile << showbase << hex << build_addr({mapChannel,mapRank,mapBankGroup,1,resIdx/COLPERROW,resIdx%COLPERROW}) << endl;
+            }
+        }
+    }
+
+
+    // Write data for loops and others
+    dataFile << "# Channel-wise mapping of convolution with a sliding window, ci = " << ci << ", co = ";
+    dataFile << co << ", k = " << k << ", wo = " << wo << ", ho = " << ho << endl;
+
+    for (i=0; i<co; i++) {
+
+        dataFile << "## Output channel " << i << endl;
+
+        for (j=0; j<sets; j++) {
+            first = j*rowsPerSet;
+            rows = min(rowsPerSet, ci*k - first);
+
+            // Weights, the filter rows of a set are consecutive
+            weightIdx = uint64_t(i)*ci*k*k + first*k;
+            writeSrfMData(dataFile, weight, &weightIdx, rows*k);
+            // Bias
+            if (!j) {
+                if (!CHAR_DATA)
+                    dataFile << bias[i] << endl;
+                else
+                    dataFile << int(bias[i]) << endl; //need to cast the results for int8 only
+            }
+
+            for (l=0; l<loops; l++) {
+                // Partial results of the previous sets, or zeros out of the output tiles
+                if (j) {
+                    for (n=0; n<LOCKSTEP_CORES; n++) {
+                        t = l*LOCKSTEP_CORES + n;
+                        for (x=0; x<SIMD_WIDTH; x++) {
+                            pos = t*wt + x;
+                            if (t < tiles && x < wt && pos % wi < wo && pos / wi < ho) {
+                                if (!CHAR_DATA)
+                                    dataFile << partPixConv(act, weight, bias, 1, k, ci, hi, wi, first/k, first%k, 0, i, pos/wi, pos%wi) << " ";
+                                else
+                                    dataFile << int(partPixConv(act, weight, bias, 1, k, ci, hi, wi, first/k, first%k, 0, i, pos/wi, pos%wi)) << " "; //need to cast the results for int8 only
+                            } else {
+                                dataFile << 0 << " ";
+                            }
+                        }
+                    }
+                    dataFile << endl;
+                }
+
+                // Activations of every filter row, from the position of each tile in the input row of the filter row
+                for (m=first; m<first+rows; m++) {
+                    for (n=0; n<LOCKSTEP_CORES; n++) {
+                        t = l*LOCKSTEP_CORES + n;
+                        for (x=0; x<SIMD_WIDTH; x++) {
+                            pos = t*wt + x + (m % k)*wi;
+                            bool in = t < tiles && pos < hi*wi;
+                            if (!CHAR_DATA)
+                                dataFile << (in ? act[(m/k)*hi*wi + pos] : 0) << " ";
+                            else
+                                dataFile << int(in ? act[(m/k)*hi*wi + pos] : 0) << " "; //need to cast the results for int8 only
+                        }
+                    }
+                    dataFile << endl;
+                }
+            }
+        }
+    }
+}
+
+#if (NARROW_FLOAT)
 
 float partPixConv(float *act, float *weight, float *bias, int stride, int k,
                     int ci, int hi, int wi, int ck, int hk, int wk, int co, int ho, int wo) {
-    half_float::half res = half_float::half_cast<half_float::half>(bias[co]);
+    cnm_narrow_t res = cnm_narrow_t(bias[co]);
 
     // Convolve through all input channels except current one
     for (int i=0; i<ck; i++) {
         for (int j=0; j<k; j++) {
             for (int l=0; l<k; l++) {
-                res += half_float::half_cast<half_float::half>(act[i*hi*wi + (ho*stride + j)*wi + (wo*stride + l)]) *
-                        half_float::half_cast<half_float::half>(weight[co*ci*k*k + i*k*k + j*k + l]);
+                res += cnm_narrow_t(act[i*hi*wi + (ho*stride + j)*wi + (wo*stride + l)]) *
+                        cnm_narrow_t(weight[co*ci*k*k + i*k*k + j*k + l]);
             }
         }
     }
@@ -927,13 +1029,13 @@ float partPixConv(float *act, float *weight, float *bias, int stride, int k,
     // Convolve partially through current input channel
     for (int j=0; j<hk; j++) {
         for (int l=0; l<k; l++) {
-            res += half_float::half_cast<half_float::half>(act[ck*hi*wi + (ho*stride + j)*wi + (wo*stride + l)]) *
-                    half_float::half_cast<half_float::half>(weight[co*ci*k*k + ck*k*k + j*k + l]);
+            res += cnm_narrow_t(act[ck*hi*wi + (ho*stride + j)*wi + (wo*stride + l)]) *
+                    cnm_narrow_t(weight[co*ci*k*k + ck*k*k + j*k + l]);
         }
     }
     for (int l=0; l<wk; l++) {
-        res += half_float::half_cast<half_float::half>(act[ck*hi*wi + (ho*stride + hk)*wi + (wo*stride + l)]) *
-                half_float::half_cast<half_float::half>(weight[co*ci*k*k + ck*k*k + hk*k + l]);
+        res += cnm_narrow_t(act[ck*hi*wi + (ho*stride + hk)*wi + (wo*stride + l)]) *
+                cnm_narrow_t(weight[co*ci*k*k + ck*k*k + hk*k + l]);
     }
 
     // cout << res << endl;
@@ -974,4 +1076,4 @@ cnm_t partPixConv(cnm_t *act, cnm_t *weight, cnm_t *bias, int stride, int k,
     return cnm_t(res);
 }
 
-#endif  // HALF_FLOAT
+#endif  // NARROW_FLOAT
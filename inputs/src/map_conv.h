@@ -19,7 +19,13 @@ void mapConvCWWRCLim (ofstream &assembly, ofstream &dataFile, ofstream &addrFile
                                 cnm_t *act, cnm_t *weight, cnm_t *bias,
                                 int ci, int wi, int hi, int k, int co, int wo, int ho, int stride); 
 
-#if (HALF_FLOAT)
+// Channel-wise mapping of convolution with a sliding window, every row of activations is loaded once
+// and shifted through the lanes for the columns of the filter (LANE_PERM), stride 1
+void mapConvCWSlidingWindow (ofstream &assembly, ofstream &dataFile, ofstream &addrFile,
+                                cnm_t *act, cnm_t *weight, cnm_t *bias,
+                                int ci, int wi, int hi, int k, int co, int wo, int ho);
+
+#if (NARROW_FLOAT)
 
 // Function for computing partial convolution resulting in a pixel
 float partPixConv(float *act, float *weight, float *bias, int stride, int k,
@@ -31,6 +37,6 @@ float partPixConv(float *act, float *weight, float *bias, int stride, int k,
 cnm_t partPixConv(cnm_t *act, cnm_t *weight, cnm_t *bias, int stride, int k,
                     int ci, int hi, int wi, int ck, int hk, int wk, int co, int ho, int wo);
 
-#endif  // HALF_FLOAT
+#endif  // NARROW_FLOAT
 
 #endif  // MAP_CONV_H
@@ -1,16 +1,53 @@
 #include "map_dp.h"
 
+// Waits for the last MAC, which loads an operand from the bank, to write the accumulator back, with a NOP per
+// cycle since it is read as the next instruction issues. With reduce, the lanes of the accumulator are then summed
+// into lane 0, waiting for the tree. With ring, lane 0 of the lockstep cores is then summed through the core ring:
+// every step passes on the partial sum received in the previous one, so that all the cores hold the total after
+// LOCKSTEP_CORES-1 steps, waiting for every addition. The assembler replaces the NOPs if it schedules.
+// Returns the instructions written
+static int reduceResult (ofstream &assembly, bool reduce, bool ring)
+{
+    int i, j;
+    int acc = GRF_ENTRIES-1;
+    int steps = ring ? min(LOCKSTEP_CORES-1, 2) : 0;    // Unrolled ring steps, the rest loop over the second one
+
+    for (i=0; i<MULT_STAGES+ADD_STAGES+1; i++) { assembly << "NOP 1" << endl; }
+    if (!reduce)
+        return reduceLength(false, false);
+    assembly << "RED GRFB" << acc << " GRFB" << acc << endl;
+    for (i=0; i<RED_STAGES; i++) { assembly << "NOP 1" << endl; }
+    for (i=0; i<steps; i++) {
+        assembly << "MOV GRFB0 RING" << (i ? 0 : acc) << endl;
+        assembly << "ADD GRFB" << acc << " GRFB" << acc << " GRFB0" << endl;
+        for (j=0; j<ADD_STAGES; j++) { assembly << "NOP 1" << endl; }
+    }
+    if (ring && LOCKSTEP_CORES > 3)
+        assembly << "JUMP " << 2+ADD_STAGES << " " << LOCKSTEP_CORES-3 << endl;
+    return reduceLength(true, ring);
+}
+
+int reduceLength (bool reduce, bool ring)
+{
+    int steps = ring ? min(LOCKSTEP_CORES-1, 2) : 0;
+
+    if (!reduce)
+        return MULT_STAGES + ADD_STAGES + 1;
+    return MULT_STAGES + ADD_STAGES + 1 + 1 + RED_STAGES + steps*(2 + ADD_STAGES) + (ring && LOCKSTEP_CORES > 3);
+}
+
 void mapDotProductRLim (ofstream &assembly, ofstream &dataFile, ofstream &addrFile,
-                                cnm_t **op1, cnm_t **op2, int V, int n)
+                                cnm_t **op1, cnm_t **op2, int V, int n, bool reduce, bool ring, bool wide)
 {
     int i,j,k,l;
-    int ext_loops = ceil(floor(V)/floor(SIMD_WIDTH*CORES_PER_PCH));
+    string mac = wide ? "MACW" : "MAC";     // MACW accumulates into the wide lanes of the accumulator
+    int ext_loops = ceil(floor(V)/floor(SIMD_WIDTH*LOCKSTEP_CORES));
+    int red = 0;
     int loops = floor(float(n)/(2.0*GRF_ENTRIES-1.0)) ;
     int peeling = n % (2*GRF_ENTRIES-1);
     int totalCol = n * ceil(float(V)/float(SIMD_WIDTH)) / 2;                // Div 2 because distributed in 2 banks
-    uint64_t op2Base = ceil(float(totalCol)/float(COLPERROW*CORES_PER_PCH));              // Op2 will start in this row
-    uint64_t resBase = op2Base + ceil(float(totalCol)/float(COLPERROW*CORES_PER_PCH));    // Result will start in this row
-    uint64_t zeroBase = resBase + (ceil(float(V)/float(SIMD_WIDTH*CORES_PER_PCH)/2));     // Column fill with zeros, after the result
+    uint64_t op2Base = ceil(float(totalCol)/float(COLPERROW*LOCKSTEP_CORES));              // Op2 will start in this row
+    uint64_t resBase = op2Base + ceil(float(totalCol)/float(COLPERROW*LOCKSTEP_CORES));    // Result will start in this row
     uint64_t rowIdx[3] = {0,op2Base,resBase};
     uint64_t colIdx[3] = {0,0,0};
     int nIdx[2] = {0,0};
@@ -19,7 +56,7 @@ void mapDotProductRLim (ofstream &assembly, ofstream &dataFile, ofstream &addrFi
     // Write assembly instructions
     assembly << "; Mapping of dot product, R-limited, V = " << V << ", n = " << n << endl;
     assembly << "WRF CRF0" << endl;
-    assembly << "MOV GRFB" << GRF_ENTRIES-1 << " ODD_BANK[AddrFile] DataFile" << endl;
+    assembly << "FILL GRFB" << GRF_ENTRIES-1 << " 0" << endl;
 
     if (loops) {
         for (i=0; i<GRF_ENTRIES; i++) {
@@ -28,9 +65,9 @@ void mapDotProductRLim (ofstream &assembly, ofstream &dataFile, ofstream &addrFi
                 assembly << "MOV GRFB" << i << " ODD_BANK[AddrFile] DataFile" << endl;
         }
         for (i=0; i<GRF_ENTRIES; i++) {
-            assembly << "MAC GRFB" << GRF_ENTRIES-1 << " GRFA" << i << " EVEN_BANK[AddrFile] DataFile" << endl;
+            assembly << mac << " GRFB" << GRF_ENTRIES-1 << " GRFA" << i << " EVEN_BANK[AddrFile] DataFile" << endl;
             if (i != GRF_ENTRIES-1)
-                assembly << "MAC GRFB" << GRF_ENTRIES-1 << " GRFB" << i << " ODD_BANK[AddrFile] DataFile" << endl;
+                assembly << mac << " GRFB" << GRF_ENTRIES-1 << " GRFB" << i << " ODD_BANK[AddrFile] DataFile" << endl;
         }
         if (loops-1)
             assembly << "JUMP " << 4*GRF_ENTRIES-2 << " " << loops-1 << endl;
@@ -45,27 +82,27 @@ void mapDotProductRLim (ofstream &assembly, ofstream &dataFile, ofstream &addrFi
         if (peeling - 2*i)  // If n it's odd, last one is only with GRFA
             assembly << "MOV GRFA" << i << " EVEN_BANK[AddrFile] DataFile" << endl;
         for (i=0; i<peeling/2; i++) {
-            assembly << "MAC GRFB" << GRF_ENTRIES-1 << " GRFA" << i << " EVEN_BANK[AddrFile] DataFile" << endl;
-            assembly << "MAC GRFB" << GRF_ENTRIES-1 << " GRFB" << i << " ODD_BANK[AddrFile] DataFile" << endl;
+            assembly << mac << " GRFB" << GRF_ENTRIES-1 << " GRFA" << i << " EVEN_BANK[AddrFile] DataFile" << endl;
+            assembly << mac << " GRFB" << GRF_ENTRIES-1 << " GRFB" << i << " ODD_BANK[AddrFile] DataFile" << endl;
         }
         if (peeling - 2*i)  // If n it's odd, last one is only with GRFA
-            assembly << "MAC GRFB" << GRF_ENTRIES-1 << " GRFA" << i << " EVEN_BANK[AddrFile] DataFile" << endl;
+            assembly << mac << " GRFB" << GRF_ENTRIES-1 << " GRFA" << i << " EVEN_BANK[AddrFile] DataFile" << endl;
     }
 
+    red = reduceResult(assembly, reduce, ring);
     assembly << "MOV ODD_BANK[AddrFile] GRFB" << GRF_ENTRIES-1 << endl;
-    assembly << "EXIT" << endl;
-    for (i=0; i<ext_loops; i++) { assembly << "EXEC" << endl; }
+    writeExecLoops(assembly, 1 + (loops ? 4*GRF_ENTRIES-2 + (loops > 1) : 0) + 2*peeling
+                                + red + 1, ext_loops);
 
     // Write address for loops and others
     addrFile << "# Mapping of dot product, R-limited, V = " << V << ", n = " << n << endl;
     for (i=0; i<ext_loops; i++) {
-        addrFile << showbase << hex << build_addr({0,0,0,1,zeroBase,0}) << endl;    // Initialize with zeros
         for (j=0; j<loops; j++) {
             for (k=0; k<GRF_ENTRIES; k++){
                 // MOVs to GRFs
-                addrFile << showbase << hex << build_addr({0,0,0,0,rowIdx[0],colIdx[0]}) << endl;
+                addrFile << showbase << hex << build_addr({mapChannel,mapRank,mapBankGroup,0,rowIdx[0],colIdx[0]}) << endl;
                 if (k != GRF_ENTRIES-1)
-                    addrFile << showbase << hex << build_addr({0,0,0,1,rowIdx[0],colIdx[0]}) << endl;
+                    addrFile << showbase << hex << build_addr({mapChannel,mapRank,mapBankGroup,1,rowIdx[0],colIdx[0]}) << endl;
                 if (++colIdx[0] == COLPERROW) {
                     colIdx[0] = 0;
                     rowIdx[0]++;
@@ -73,9 +110,9 @@ void mapDotProductRLim (ofstream &assembly, ofstream &dataFile, ofstream &addrFi
             }
             for (k=0; k<GRF_ENTRIES; k++){
                 // ALU ops
-                addrFile << showbase << hex << build_addr({0,0,0,0,rowIdx[1],colIdx[1]}) << endl;
+                addrFile << showbase << hex << build_addr({mapChannel,mapRank,mapBankGroup,0,rowIdx[1],colIdx[1]}) << endl;
                 if (k != GRF_ENTRIES-1)
-                    addrFile << showbase << hex << build_addr({0,0,0,1,rowIdx[1],colIdx[1]}) << endl;
+                    addrFile << showbase << hex << build_addr({mapChannel,mapRank,mapBankGroup,1,rowIdx[1],colIdx[1]}) << endl;
                 if (++colIdx[1] == COLPERROW) {
                     colIdx[1] = 0;
                     rowIdx[1]++;
@@ -87,29 +124,29 @@ void mapDotProductRLim (ofstream &assembly, ofstream &dataFile, ofstream &addrFi
             addrFile << "# Out of the main loop" << endl;
             for (j=0; j<peeling/2; j++) {
                 // MOVs to GRFs
-                addrFile << showbase << hex << build_addr({0,0,0,0,rowIdx[0],colIdx[0]}) << endl;
-                addrFile << showbase << hex << build_addr({0,0,0,1,rowIdx[0],colIdx[0]}) << endl;
+                addrFile << showbase << hex << build_addr({mapChannel,mapRank,mapBankGroup,0,rowIdx[0],colIdx[0]}) << endl;
+                addrFile << showbase << hex << build_addr({mapChannel,mapRank,mapBankGroup,1,rowIdx[0],colIdx[0]}) << endl;
                 if (++colIdx[0] == COLPERROW) {
                     colIdx[0] = 0;
                     rowIdx[0]++;
                 }
             }
             if (peeling - 2*j)  // If n it's odd, last one is only with GRFA
-                addrFile << showbase << hex << build_addr({0,0,0,0,rowIdx[0],colIdx[0]}) << endl;
+                addrFile << showbase << hex << build_addr({mapChannel,mapRank,mapBankGroup,0,rowIdx[0],colIdx[0]}) << endl;
             for (j=0; j<peeling/2; j++) {
                 // ALU ops
-                addrFile << showbase << hex << build_addr({0,0,0,0,rowIdx[1],colIdx[1]}) << endl;
-                addrFile << showbase << hex << build_addr({0,0,0,1,rowIdx[1],colIdx[1]}) << endl;
+                addrFile << showbase << hex << build_addr({mapChannel,mapRank,mapBankGroup,0,rowIdx[1],colIdx[1]}) << endl;
+                addrFile << showbase << hex << build_addr({mapChannel,mapRank,mapBankGroup,1,rowIdx[1],colIdx[1]}) << endl;
                 if (++colIdx[1] == COLPERROW) {
                     colIdx[1] = 0;
                     rowIdx[1]++;
                 }
             }
             if (peeling - 2*j)  // If n it's odd, last one is only with GRFA
-                addrFile << showbase << hex << build_addr({0,0,0,0,rowIdx[1],colIdx[1]}) << endl;
+                addrFile << showbase << hex << build_addr({mapChannel,mapRank,mapBankGroup,0,rowIdx[1],colIdx[1]}) << endl;
         }
         // MOV result to BANK
-        addrFile << showbase << hex << build_addr({0,0,0,1,rowIdx[2],colIdx[2]}) << endl;
+        addrFile << showbase << hex << build_addr({mapChannel,mapRank,mapBankGroup,1,rowIdx[2],colIdx[2]}) << endl;
         if (++colIdx[2] == COLPERROW) {
             colIdx[2] = 0;
             rowIdx[2]++;
@@ -119,23 +156,19 @@ void mapDotProductRLim (ofstream &assembly, ofstream &dataFile, ofstream &addrFi
     // Write data for loops and others
     dataFile << "# Mapping of dot product, R-limited, V = " << V << ", n = " << n << endl;
     for (i=0; i<ext_loops ; i++) {
-        for (l=0; l<SIMD_WIDTH*CORES_PER_PCH; l++) {  // Initialize to zero
-            dataFile << 0 << " "; 
-        }
-        dataFile << endl;
         for (j=0; j<loops; j++) {
             for (k=0; k<2*GRF_ENTRIES-1; k++){
                 // MOVs to GRFs
-                for (l=0; l<SIMD_WIDTH*CORES_PER_PCH; l++) {
-                    if(WORD_BITS != 8)
+                for (l=0; l<SIMD_WIDTH*LOCKSTEP_CORES; l++) {
+                    if (!CHAR_DATA)
                         dataFile << (VIdx[0] < V ? op1[VIdx[0]][nIdx[0]] : 0) << " ";
                     else
                         dataFile << int(VIdx[0] < V ? op1[VIdx[0]][nIdx[0]] : 0) << " "; //need to cast the results for int8 only
-                    if (!(++VIdx[0] % (SIMD_WIDTH*CORES_PER_PCH))){ // Ended dimension of S vectors
+                    if (!(++VIdx[0] % (SIMD_WIDTH*LOCKSTEP_CORES))){ // Ended dimension of S vectors
                         if (++nIdx[0] == n) {       // Finished all dimensions of S vectors
                             nIdx[0] = 0;
                         } else {
-                            VIdx[0] -= SIMD_WIDTH*CORES_PER_PCH;
+                            VIdx[0] -= SIMD_WIDTH*LOCKSTEP_CORES;
                         }
                     }
                 }
@@ -143,16 +176,16 @@ void mapDotProductRLim (ofstream &assembly, ofstream &dataFile, ofstream &addrFi
             }
             for (k=0; k<2*GRF_ENTRIES-1; k++){
                 // ALU ops
-                for (l=0; l<SIMD_WIDTH*CORES_PER_PCH; l++) {
-                    if(WORD_BITS != 8)
+                for (l=0; l<SIMD_WIDTH*LOCKSTEP_CORES; l++) {
+                    if (!CHAR_DATA)
                         dataFile << (VIdx[1] < V ? op2[VIdx[1]][nIdx[1]] : 0) << " ";
                     else
                         dataFile << int(VIdx[1] < V ? op2[VIdx[1]][nIdx[1]] : 0) << " "; //need to cast the results for int8 only
-                    if (!(++VIdx[1] % (SIMD_WIDTH*CORES_PER_PCH))){ // Ended dimension of S vectors
+                    if (!(++VIdx[1] % (SIMD_WIDTH*LOCKSTEP_CORES))){ // Ended dimension of S vectors
                         if (++nIdx[1] == n) {       // Finished all dimensions of S vectors
                             nIdx[1] = 0;
                         } else {
-                            VIdx[1] -= SIMD_WIDTH*CORES_PER_PCH;
+                            VIdx[1] -= SIMD_WIDTH*LOCKSTEP_CORES;
                         }
                     }
                 }
@@ -164,16 +197,16 @@ void mapDotProductRLim (ofstream &assembly, ofstream &dataFile, ofstream &addrFi
             dataFile << "# Out of the main loop" << endl;
             for (j=0; j<peeling; j++) {
                 // MOVs to GRFs
-                for (k=0; k<SIMD_WIDTH*CORES_PER_PCH; k++) {
-                    if(WORD_BITS != 8)
+                for (k=0; k<SIMD_WIDTH*LOCKSTEP_CORES; k++) {
+                    if (!CHAR_DATA)
                         dataFile << (VIdx[0] < V ? op1[VIdx[0]][nIdx[0]] : 0) << " ";
                     else
                         dataFile << int(VIdx[0] < V ? op1[VIdx[0]][nIdx[0]] : 0) << " "; //need to cast the results for int8 only
-                    if (!(++VIdx[0] % (SIMD_WIDTH*CORES_PER_PCH))){ // Ended dimension of S vectors
+                    if (!(++VIdx[0] % (SIMD_WIDTH*LOCKSTEP_CORES))){ // Ended dimension of S vectors
                         if (++nIdx[0] == n) {       // Finished all dimensions of S vectors
                             nIdx[0] = 0;
                         } else {
-                            VIdx[0] -= SIMD_WIDTH*CORES_PER_PCH;
+                            VIdx[0] -= SIMD_WIDTH*LOCKSTEP_CORES;
                         }
                     }
                 }
@@ -181,16 +214,16 @@ void mapDotProductRLim (ofstream &assembly, ofstream &dataFile, ofstream &addrFi
             }
             for (j=0; j<peeling; j++) {
                 // ALU ops
-                for (k=0; k<SIMD_WIDTH*CORES_PER_PCH; k++) {
-                    if(WORD_BITS != 8)
+                for (k=0; k<SIMD_WIDTH*LOCKSTEP_CORES; k++) {
+                    if (!CHAR_DATA)
                         dataFile << (VIdx[1] < V ? op2[VIdx[1]][nIdx[1]] : 0) << " ";
                     else
                         dataFile << int(VIdx[1] < V ? op2[VIdx[1]][nIdx[1]] : 0) << " "; //need to cast the results for int8 only
-                    if (!(++VIdx[1] % (SIMD_WIDTH*CORES_PER_PCH))){ // Ended dimension of S vectors
+                    if (!(++VIdx[1] % (SIMD_WIDTH*LOCKSTEP_CORES))){ // Ended dimension of S vectors
                         if (++nIdx[1] == n) {       // Finished all dimensions of S vectors
                             nIdx[1] = 0;
                         } else {
-                            VIdx[1] -= SIMD_WIDTH*CORES_PER_PCH;
+                            VIdx[1] -= SIMD_WIDTH*LOCKSTEP_CORES;
                         }
                     }
                 }
@@ -200,19 +233,173 @@ void mapDotProductRLim (ofstream &assembly, ofstream &dataFile, ofstream &addrFi
     }
 }
 
-void mapDotProductCLim (ofstream &assembly, ofstream &dataFile, ofstream &addrFile,
+#if DUAL_BANK
+void mapDotProductDualBank (ofstream &assembly, ofstream &dataFile, ofstream &addrFile,
+                                cnm_t **op1, cnm_t **op2, int V, int n, bool reduce, bool ring, bool wide)
+{
+    int i,j,k,l;
+    string mac = wide ? "MACW" : "MAC";     // MACW accumulates into the wide lanes of the accumulator
+    int ext_loops = ceil(floor(V)/floor(SIMD_WIDTH*LOCKSTEP_CORES));
+    int red = 0;
+    int unroll = (CRF_ENTRIES - 4 - reduceLength(reduce, ring))/2;   // MACs per iteration, the peeled ones also fit
+    int loops = n/unroll;
+    int peeling = n % unroll;
+    uint64_t resBase = ceil(float(n*ext_loops)/float(COLPERROW));   // Result will start in this row of the odd bank
+    uint64_t rowIdx[2] = {0,resBase};
+    uint64_t colIdx[2] = {0,0};
+
+    // Write assembly instructions, op1 in the even bank and op2 in the odd one are read by the same column command
+    assembly << "; Mapping of dot product from both banks, V = " << V << ", n = " << n << endl;
+    assembly << "WRF CRF0" << endl;
+    assembly << "FILL GRFB" << GRF_ENTRIES-1 << " 0" << endl;
+    if (loops) {
+        for (i=0; i<unroll; i++)
+            assembly << mac << " GRFB" << GRF_ENTRIES-1 << " EVEN_BANK[AddrFile] ODD_BANK DataFile" << endl;
+        if (loops-1)
+            assembly << "JUMP " << unroll << " " << loops-1 << endl;
+    }
+    if (peeling) {
+        assembly << "; Out of the main loop" << endl;
+        for (i=0; i<peeling; i++)
+            assembly << mac << " GRFB" << GRF_ENTRIES-1 << " EVEN_BANK[AddrFile] ODD_BANK DataFile" << endl;
+    }
+    red = reduceResult(assembly, reduce, ring);
+    assembly << "MOV ODD_BANK[AddrFile] GRFB" << GRF_ENTRIES-1 << endl;
+    writeExecLoops(assembly, 1 + (loops ? unroll + (loops > 1) : 0) + peeling + red + 1, ext_loops);
+
+    // Write address for loops and others, the even bank of every pair of operands and then the result
+    addrFile << "# Mapping of dot product from both banks, V = " << V << ", n = " << n << endl;
+    for (i=0; i<ext_loops; i++) {
+        for (j=0; j<n; j++) {
+            addrFile << showbase << hex << build_addr({mapChannel,mapRank,mapBankGroup,0,rowIdx[0],colIdx[0]}) << endl;
+            if (++colIdx[0] == COLPERROW) {
+                colIdx[0] = 0;
+                rowIdx[0]++;
+            }
+        }
+        addrFile << showbase << hex << build_addr({mapChannel,mapRank,mapBankGroup,1,rowIdx[1],colIdx[1]}) << endl;
+        if (++colIdx[1] == COLPERROW) {
+            colIdx[1] = 0;
+            rowIdx[1]++;
+        }
+    }
+
+    // Write data, a line per MAC with the even bank first
+    dataFile << "# Mapping of dot product from both banks, V = " << V << ", n = " << n << endl;
+    for (i=0; i<ext_loops; i++) {
+        for (j=0; j<n; j++) {
+            for (k=0; k<2; k++) {
+                cnm_t **op = k ? op2 : op1;
+                for (l=0; l<SIMD_WIDTH*LOCKSTEP_CORES; l++) {
+                    int v = i*SIMD_WIDTH*LOCKSTEP_CORES + l;
+                    if (!CHAR_DATA)
+                        dataFile << (v < V ? op[v][j] : 0) << " ";
+                    else
+                        dataFile << int(v < V ? op[v][j] : 0) << " "; //need to cast the results for int8 only
+                }
+            }
+            dataFile << endl;
+        }
+    }
+}
+#endif
+
+void mapDotProductRed (ofstream &assembly, ofstream &dataFile, ofstream &addrFile,
+                                cnm_t **op1, cnm_t **op2, int V, int n, bool rLim, bool ring)
+{
+    int i,j,l;
+    int width = ring ? SIMD_WIDTH*LOCKSTEP_CORES : SIMD_WIDTH;    // Lanes taken by every vector
+    int cols = ceil(float(n)/float(width));         // Elements of every vector in each lane
+    cnm_t **lane1 = new cnm_t *[V*width];
+    cnm_t **lane2 = new cnm_t *[V*width];
+
+    // Every vector takes all the lanes of a core, or of the lockstep cores with ring, lane l holds the elements
+    // l, l+width, ... so the dot product mapping accumulates partial sums per lane, reduced at the end
+    for (i=0; i<V; i++) {
+        for (l=0; l<width; l++) {
+            lane1[i*width+l] = new cnm_t[cols];
+            lane2[i*width+l] = new cnm_t[cols];
+            for (j=0; j<cols; j++) {
+                lane1[i*width+l][j] = (j*width+l < n) ? op1[i][j*width+l] : cnm_t(0);
+                lane2[i*width+l][j] = (j*width+l < n) ? op2[i][j*width+l] : cnm_t(0);
+            }
+        }
+    }
+
+    assembly << "; Mapping of dot product with lane reduction" << (ring ? " and core ring" : "")
+                << ", V = " << V << ", n = " << n << endl;
+#if DUAL_BANK
+    mapDotProductDualBank(assembly, dataFile, addrFile, lane1, lane2, V*width, cols, true, ring, false);
+#else
+    if (rLim)
+        mapDotProductRLim(assembly, dataFile, addrFile, lane1, lane2, V*width, cols, true, ring, false);
+    else
+        mapDotProductCLim(assembly, dataFile, addrFile, lane1, lane2, V*width, cols, true, ring, false);
+#endif
+
+    for (i=0; i<V*width; i++) {
+        delete[] lane1[i];
+        delete[] lane2[i];
+    }
+    delete[] lane1;
+    delete[] lane2;
+}
+
+#if WIDE_ACC
+void mapDotProductWide (ofstream &assembly, ofstream &dataFile, ofstream &addrFile,
                                 cnm_t **op1, cnm_t **op2, int V, int n)
+{
+    int i,j,r;
+    int cols = ceil(float(n)/float(ACC_RATIO));    // Elements of every vector in each lane
+    cnm_t **lane1 = new cnm_t *[V*ACC_RATIO];
+    cnm_t **lane2 = new cnm_t *[V*ACC_RATIO];
+
+    // Every vector takes the ACC_RATIO lanes of a wide accumulator, lane r holds the elements
+    // r, r+ACC_RATIO, ... so that every MACW adds ACC_RATIO products of the vector at once
+    for (i=0; i<V; i++) {
+        for (r=0; r<ACC_RATIO; r++) {
+            lane1[i*ACC_RATIO+r] = new cnm_t[cols];
+            lane2[i*ACC_RATIO+r] = new cnm_t[cols];
+            for (j=0; j<cols; j++) {
+                lane1[i*ACC_RATIO+r][j] = (j*ACC_RATIO+r < n) ? op1[i][j*ACC_RATIO+r] : cnm_t(0);
+                lane2[i*ACC_RATIO+r][j] = (j*ACC_RATIO+r < n) ? op2[i][j*ACC_RATIO+r] : cnm_t(0);
+            }
+        }
+    }
+
+    assembly << "; Mapping of dot product with wide accumulators, V = " << V << ", n = " << n << endl;
+#if DUAL_BANK
+    mapDotProductDualBank(assembly, dataFile, addrFile, lane1, lane2, V*ACC_RATIO, cols, false, false, true);
+#else
+    if (CRF_ENTRIES < (4*GRF_ENTRIES + 2*(cols % (2*GRF_ENTRIES-1)) + 2 + reduceLength(false, false)))
+        mapDotProductCLim(assembly, dataFile, addrFile, lane1, lane2, V*ACC_RATIO, cols, false, false, true);
+    else
+        mapDotProductRLim(assembly, dataFile, addrFile, lane1, lane2, V*ACC_RATIO, cols, false, false, true);
+#endif
+
+    for (i=0; i<V*ACC_RATIO; i++) {
+        delete[] lane1[i];
+        delete[] lane2[i];
+    }
+    delete[] lane1;
+    delete[] lane2;
+}
+#endif
+
+void mapDotProductCLim (ofstream &assembly, ofstream &dataFile, ofstream &addrFile,
+                                cnm_t **op1, cnm_t **op2, int V, int n, bool reduce, bool ring, bool wide)
 {
     int i,j,k,l;
-    int crfSegment = floor((float(CRF_ENTRIES)-4.0)/2.0);
+    string mac = wide ? "MACW" : "MAC";     // MACW accumulates into the wide lanes of the accumulator
+    int red = 0;
+    int crfSegment = floor((float(CRF_ENTRIES)-4.0-reduceLength(reduce, ring))/2.0);
     crfSegment = min(crfSegment, 2*GRF_ENTRIES);           // If segment is larger than GRF capacity, limit it to the latter
-    int ext_loops = ceil(float(V)/float(SIMD_WIDTH*CORES_PER_PCH));
+    int ext_loops = ceil(float(V)/float(SIMD_WIDTH*LOCKSTEP_CORES));
     int loops = floor(float(n)/crfSegment) ;
     int peeling = n % crfSegment;
     int totalCol = n * ceil(float(V)/float(SIMD_WIDTH)) / 2;                    // Div 2 because distributed in 2 banks
-    uint64_t op2Base = ceil(float(totalCol)/(float(COLPERROW*CORES_PER_PCH)+1.0));            // Op2 will start in this row
-    uint64_t resBase = op2Base + ceil(float(totalCol)/(float(COLPERROW*CORES_PER_PCH)+1.0));  // Result will start in this row
-    uint64_t zeroBase = resBase + (ceil(float(V)/float(SIMD_WIDTH*CORES_PER_PCH)/2));         // Column fill with zeros, after the result
+    uint64_t op2Base = ceil(float(totalCol)/(float(COLPERROW*LOCKSTEP_CORES)+1.0));            // Op2 will start in this row
+    uint64_t resBase = op2Base + ceil(float(totalCol)/(float(COLPERROW*LOCKSTEP_CORES)+1.0));  // Result will start in this row
     uint64_t rowIdx[3] = {0,op2Base,resBase};
     uint64_t colIdx[3] = {0,0,0};
     int nIdx[2] = {0,0};
@@ -223,7 +410,7 @@ void mapDotProductCLim (ofstream &assembly, ofstream &dataFile, ofstream &addrFi
 
     if (loops) {
         assembly << "WRF CRF0" << endl;
-        assembly << "MOV GRFB" << GRF_ENTRIES-1 << " ODD_BANK[AddrFile] DataFile" << endl;
+        assembly << "FILL GRFB" << GRF_ENTRIES-1 << " 0" << endl;
         for (i=0; i<crfSegment/2; i++) {
             assembly << "MOV GRFA" << i << " EVEN_BANK[AddrFile] DataFile" << endl;
             assembly << "MOV GRFB" << i << " ODD_BANK[AddrFile] DataFile" << endl;
@@ -232,23 +419,27 @@ void mapDotProductCLim (ofstream &assembly, ofstream &dataFile, ofstream &addrFi
             assembly << "MOV GRFA" << i << " EVEN_BANK[AddrFile] DataFile" << endl;
         }
         for (i=0; i<crfSegment/2; i++) {
-            assembly << "MAC GRFB" << GRF_ENTRIES-1 << " GRFA" << i << " EVEN_BANK[AddrFile] DataFile" << endl;
-            assembly << "MAC GRFB" << GRF_ENTRIES-1 << " GRFB" << i << " ODD_BANK[AddrFile] DataFile" << endl;
+            assembly << mac << " GRFB" << GRF_ENTRIES-1 << " GRFA" << i << " EVEN_BANK[AddrFile] DataFile" << endl;
+            assembly << mac << " GRFB" << GRF_ENTRIES-1 << " GRFB" << i << " ODD_BANK[AddrFile] DataFile" << endl;
         }
         if (crfSegment % 2) {
-            assembly << "MAC GRFB" << GRF_ENTRIES-1 << " GRFA" << i << " EVEN_BANK[AddrFile] DataFile" << endl;
+            assembly << mac << " GRFB" << GRF_ENTRIES-1 << " GRFA" << i << " EVEN_BANK[AddrFile] DataFile" << endl;
         }
         if (loops-1)
             assembly << "JUMP " << 2*crfSegment << " " << loops-1 << endl;
+        // The cores are only summed through the ring after the peeled columns
+        red = reduceResult(assembly, reduce, ring && !peeling);
         assembly << "MOV ODD_BANK[AddrFile] GRFB" << GRF_ENTRIES-1 << endl;
-        assembly << "EXIT" << endl;
-        for (i=0; i<ext_loops; i++) { assembly << "EXEC" << endl; }
+        writeExecLoops(assembly, 1 + 2*crfSegment + (loops > 1) + red + 1, ext_loops);
     }
 
     if (peeling) {
         assembly << "; Out of the main loop" << endl;
         assembly << "WRF CRF0" << endl;
-        assembly << "MOV GRFB" << GRF_ENTRIES-1 << " ODD_BANK[AddrFile] DataFile" << endl;
+        if (loops)  // Start from the partial result of the main loop
+            assembly << "MOV GRFB" << GRF_ENTRIES-1 << " ODD_BANK[AddrFile] DataFile" << endl;
+        else
+            assembly << "FILL GRFB" << GRF_ENTRIES-1 << " 0" << endl;
         for (i=0; i<peeling/2; i++) { 
             assembly << "MOV GRFA" << i << " EVEN_BANK[AddrFile] DataFile" << endl;
             assembly << "MOV GRFB" << i << " ODD_BANK[AddrFile] DataFile" << endl;
@@ -256,33 +447,31 @@ void mapDotProductCLim (ofstream &assembly, ofstream &dataFile, ofstream &addrFi
         if (peeling - 2*i)  // If n it's odd, last one is only with GRFA
             assembly << "MOV GRFA" << i << " EVEN_BANK[AddrFile] DataFile" << endl;
         for (i=0; i<peeling/2; i++) {
-            assembly << "MAC GRFB" << GRF_ENTRIES-1 << " GRFA" << i << " EVEN_BANK[AddrFile] DataFile" << endl;
-            assembly << "MAC GRFB" << GRF_ENTRIES-1 << " GRFB" << i << " ODD_BANK[AddrFile] DataFile" << endl;
+            assembly << mac << " GRFB" << GRF_ENTRIES-1 << " GRFA" << i << " EVEN_BANK[AddrFile] DataFile" << endl;
+            assembly << mac << " GRFB" << GRF_ENTRIES-1 << " GRFB" << i << " ODD_BANK[AddrFile] DataFile" << endl;
         }
         if (peeling - 2*i)  // If n it's odd, last one is only with GRFA
-            assembly << "MAC GRFB" << GRF_ENTRIES-1 << " GRFA" << i << " EVEN_BANK[AddrFile] DataFile" << endl;
+            assembly << mac << " GRFB" << GRF_ENTRIES-1 << " GRFA" << i << " EVEN_BANK[AddrFile] DataFile" << endl;
+        red = reduceResult(assembly, reduce, ring);
         assembly << "MOV ODD_BANK[AddrFile] GRFB" << GRF_ENTRIES-1 << endl;
-        assembly << "EXIT" << endl;
-        for (i=0; i<ext_loops; i++) { assembly << "EXEC" << endl; }    
+        writeExecLoops(assembly, 1 + 2*peeling + red + 1, ext_loops);
     }
 
     // Write address for loops and others  
     addrFile << "# Mapping of dot product, C-limited, V = " << V << ", n = " << n << endl;
     for (i=0; i<ext_loops; i++) {
-        if (loops)
-            addrFile << showbase << hex << build_addr({0,0,0,1,zeroBase,0}) << endl;    // Initialize with zeros
         for (j=0; j<loops; j++) {
             for (k=0; k<crfSegment/2; k++){
                 // MOVs to GRFs
-                addrFile << showbase << hex << build_addr({0,0,0,0,rowIdx[0],colIdx[0]}) << endl;
-                addrFile << showbase << hex << build_addr({0,0,0,1,rowIdx[0],colIdx[0]}) << endl;
+                addrFile << showbase << hex << build_addr({mapChannel,mapRank,mapBankGroup,0,rowIdx[0],colIdx[0]}) << endl;
+                addrFile << showbase << hex << build_addr({mapChannel,mapRank,mapBankGroup,1,rowIdx[0],colIdx[0]}) << endl;
                 if (++colIdx[0] == COLPERROW) {
                     colIdx[0] = 0;
                     rowIdx[0]++;
                 }
             }
             if (crfSegment % 2) {
-                addrFile << showbase << hex << build_addr({0,0,0,0,rowIdx[0],colIdx[0]}) << endl;
+                addrFile << showbase << hex << build_addr({mapChannel,mapRank,mapBankGroup,0,rowIdx[0],colIdx[0]}) << endl;
                 if (++colIdx[0] == COLPERROW) {
                     colIdx[0] = 0;
                     rowIdx[0]++;
@@ -290,15 +479,15 @@ void mapDotProductCLim (ofstream &assembly, ofstream &dataFile, ofstream &addrFi
             }
             for (k=0; k<crfSegment/2; k++){
                 // ALU ops
-                addrFile << showbase << hex << build_addr({0,0,0,0,rowIdx[1],colIdx[1]}) << endl;
-                addrFile << showbase << hex << build_addr({0,0,0,1,rowIdx[1],colIdx[1]}) << endl;
+                addrFile << showbase << hex << build_addr({mapChannel,mapRank,mapBankGroup,0,rowIdx[1],colIdx[1]}) << endl;
+                addrFile << showbase << hex << build_addr({mapChannel,mapRank,mapBankGroup,1,rowIdx[1],colIdx[1]}) << endl;
                 if (++colIdx[1] == COLPERROW) {
                     colIdx[1] = 0;
                     rowIdx[1]++;
                 }
             }
             if (crfSegment % 2) {
-                addrFile << showbase << hex << build_addr({0,0,0,0,rowIdx[1],colIdx[1]}) << endl;
+                addrFile << showbase << hex << build_addr({mapChannel,mapRank,mapBankGroup,0,rowIdx[1],colIdx[1]}) << endl;
                 if (++colIdx[1] == COLPERROW) {
                     colIdx[1] = 0;
                     rowIdx[1]++;
@@ -315,7 +504,7 @@ void mapDotProductCLim (ofstream &assembly, ofstream &dataFile, ofstream &addrFi
         }
         if (loops) {
             // MOV (partial) result to BANK
-            addrFile << showbase << hex << build_addr({0,0,0,1,rowIdx[2],colIdx[2]}) << endl;
+            addrFile << showbase << hex << build_addr({mapChannel,mapRank,mapBankGroup,1,rowIdx[2],colIdx[2]}) << endl;
             if (++colIdx[2] == COLPERROW) {
                 colIdx[2] = 0;
                 rowIdx[2]++;
@@ -337,21 +526,21 @@ void mapDotProductCLim (ofstream &assembly, ofstream &dataFile, ofstream &addrFi
                 colIdx[0] = (colIdx[0] + int(ceil((n - peeling) / 2.0))) % COLPERROW;
                 rowIdx[1] += (colIdx[1] + int(ceil((n - peeling) / 2.0))) / COLPERROW;
                 colIdx[1] = (colIdx[1] + int(ceil((n - peeling) / 2.0))) % COLPERROW;
-            }
 
-            // Retrieve partial result or zeros
-            addrFile << showbase << hex << (loops ? build_addr({0,0,0,1,rowIdx[2],colIdx[2]}) : build_addr({0,0,0,1,zeroBase,0})) << endl;
+                // Retrieve partial result
+                addrFile << showbase << hex << build_addr({mapChannel,mapRank,mapBankGroup,1,rowIdx[2],colIdx[2]}) << endl;
+            }
             for (j=0; j<peeling/2; j++) {
                 // MOVs to GRFs
-                addrFile << showbase << hex << build_addr({0,0,0,0,rowIdx[0],colIdx[0]}) << endl;
-                addrFile << showbase << hex << build_addr({0,0,0,1,rowIdx[0],colIdx[0]}) << endl;
+                addrFile << showbase << hex << build_addr({mapChannel,mapRank,mapBankGroup,0,rowIdx[0],colIdx[0]}) << endl;
+                addrFile << showbase << hex << build_addr({mapChannel,mapRank,mapBankGroup,1,rowIdx[0],colIdx[0]}) << endl;
                 if (++colIdx[0] == COLPERROW) {
                     colIdx[0] = 0;
                     rowIdx[0]++;
                 }
             }
             if (peeling - 2*j){  // If n it's odd, last one is only with GRFA
-                addrFile << showbase << hex << build_addr({0,0,0,0,rowIdx[0],colIdx[0]}) << endl;  
+                addrFile << showbase << hex << build_addr({mapChannel,mapRank,mapBankGroup,0,rowIdx[0],colIdx[0]}) << endl;  
                 cout << i << " 2st part last row " << rowIdx[0] << " col " << colIdx[0] << endl;              
                 if (++colIdx[0] == COLPERROW) {
                     colIdx[0] = 0;
@@ -361,15 +550,15 @@ void mapDotProductCLim (ofstream &assembly, ofstream &dataFile, ofstream &addrFi
 
             for (j=0; j<peeling/2; j++) {
                 // ALU ops
-                addrFile << showbase << hex << build_addr({0,0,0,0,rowIdx[1],colIdx[1]}) << endl;
-                addrFile << showbase << hex << build_addr({0,0,0,1,rowIdx[1],colIdx[1]}) << endl;
+                addrFile << showbase << hex << build_addr({mapChannel,mapRank,mapBankGroup,0,rowIdx[1],colIdx[1]}) << endl;
+                addrFile << showbase << hex << build_addr({mapChannel,mapRank,mapBankGroup,1,rowIdx[1],colIdx[1]}) << endl;
                 if (++colIdx[1] == COLPERROW) {
                     colIdx[1] = 0;
                     rowIdx[1]++;
                 }
             }
             if (peeling - 2*j){  // If n it's odd, last one is only with GRFA
-                addrFile << showbase << hex << build_addr({0,0,0,0,rowIdx[1],colIdx[1]}) << endl;                
+                addrFile << showbase << hex << build_addr({mapChannel,mapRank,mapBankGroup,0,rowIdx[1],colIdx[1]}) << endl;                
                 if (++colIdx[1] == COLPERROW) {
                     colIdx[1] = 0;
                     rowIdx[1]++;
@@ -377,7 +566,7 @@ void mapDotProductCLim (ofstream &assembly, ofstream &dataFile, ofstream &addrFi
             }
 
             // MOV result to BANK
-            addrFile << showbase << hex << build_addr({0,0,0,1,rowIdx[2],colIdx[2]}) << endl;
+            addrFile << showbase << hex << build_addr({mapChannel,mapRank,mapBankGroup,1,rowIdx[2],colIdx[2]}) << endl;
             if (++colIdx[2] == COLPERROW) {
                 colIdx[2] = 0;
                 rowIdx[2]++;
@@ -388,25 +577,19 @@ void mapDotProductCLim (ofstream &assembly, ofstream &dataFile, ofstream &addrFi
     // Write data for loops and others
     dataFile << "# Mapping of dot product, C-limited, V = " << V << ", n = " << n << endl;
     for (i=0; i<ext_loops ; i++) {
-        if (loops) {
-            for (l=0; l<SIMD_WIDTH*CORES_PER_PCH; l++) {  // Initialize to zero
-                dataFile << 0 << " "; 
-            }
-            dataFile << endl;
-        }
         for (j=0; j<loops; j++) {
             for (k=0; k<crfSegment; k++){
                 // MOVs to GRFs
-                for (l=0; l<SIMD_WIDTH*CORES_PER_PCH; l++) {
-                    if(WORD_BITS != 8)
+                for (l=0; l<SIMD_WIDTH*LOCKSTEP_CORES; l++) {
+                    if (!CHAR_DATA)
                         dataFile << (VIdx[0] < V ? op1[VIdx[0]][nIdx[0]] : 0) << " ";
                     else
                         dataFile << int(VIdx[0] < V ? op1[VIdx[0]][nIdx[0]] : 0) << " "; //need to cast the results for int8 only
-                    if (!(++VIdx[0] % (SIMD_WIDTH*CORES_PER_PCH))){ // Ended dimension of S vectors
+                    if (!(++VIdx[0] % (SIMD_WIDTH*LOCKSTEP_CORES))){ // Ended dimension of S vectors
                         if (++nIdx[0] == n) {       // Finished all dimensions of S vectors
                             nIdx[0] = 0;
                         } else {
-                            VIdx[0] -= SIMD_WIDTH*CORES_PER_PCH;
+                            VIdx[0] -= SIMD_WIDTH*LOCKSTEP_CORES;
                         }
                     }
                 }
@@ -414,16 +597,16 @@ void mapDotProductCLim (ofstream &assembly, ofstream &dataFile, ofstream &addrFi
             }
             for (k=0; k<crfSegment; k++){
                 // ALU ops
-                for (l=0; l<SIMD_WIDTH*CORES_PER_PCH; l++) {
-                    if(WORD_BITS != 8)
+                for (l=0; l<SIMD_WIDTH*LOCKSTEP_CORES; l++) {
+                    if (!CHAR_DATA)
                         dataFile << (VIdx[1] < V ? op2[VIdx[1]][nIdx[1]] : 0) << " ";
                     else
                         dataFile << int(VIdx[1] < V ? op2[VIdx[1]][nIdx[1]] : 0) << " "; //need to cast the results for int8 only
-                    if (!(++VIdx[1] % (SIMD_WIDTH*CORES_PER_PCH))){ // Ended dimension of S vectors
+                    if (!(++VIdx[1] % (SIMD_WIDTH*LOCKSTEP_CORES))){ // Ended dimension of S vectors
                         if (++nIdx[1] == n) {       // Finished all dimensions of S vectors
                             nIdx[1] = 0;
                         } else {
-                            VIdx[1] -= SIMD_WIDTH*CORES_PER_PCH;
+                            VIdx[1] -= SIMD_WIDTH*LOCKSTEP_CORES;
                         }
                     }
                 }
@@ -432,8 +615,8 @@ void mapDotProductCLim (ofstream &assembly, ofstream &dataFile, ofstream &addrFi
         }
         // Jump to next group of vectors, as dimensions left will be done in the peeled part
         if (loops && peeling) {
-            VIdx[0] += SIMD_WIDTH*CORES_PER_PCH;  nIdx[0] = 0;
-            VIdx[1] += SIMD_WIDTH*CORES_PER_PCH;  nIdx[1] = 0;
+            VIdx[0] += SIMD_WIDTH*LOCKSTEP_CORES;  nIdx[0] = 0;
+            VIdx[1] += SIMD_WIDTH*LOCKSTEP_CORES;  nIdx[1] = 0;
         }
     }
 
@@ -449,29 +632,43 @@ void mapDotProductCLim (ofstream &assembly, ofstream &dataFile, ofstream &addrFi
                 nIdx[0] = n - peeling;
                 nIdx[1] = n - peeling;
             }
-            // Provide partial result or zeros
-            for (j=0; j<SIMD_WIDTH*CORES_PER_PCH; j++) {
-                if (loops && (VIdx[0]+j < V))
-                    if(WORD_BITS != 8)
-                        dataFile << partDotProduct(op1[VIdx[0]+j], op2[VIdx[1]+j], nIdx[0]) << " ";
+            // Provide partial result, the accumulator is filled with zeros otherwise
+#if WIDE_ACC
+            if (loops && wide) {
+                dataFile << "W";
+                for (j=0; j<SIMD_WIDTH*LOCKSTEP_CORES; j+=ACC_RATIO) {
+                    if (VIdx[0]+j < V)
+                        dataFile << partDotProductWide(op1 + VIdx[0]+j, op2 + VIdx[1]+j, nIdx[0]) << " ";
                     else
-                        dataFile << int(partDotProduct(op1[VIdx[0]+j], op2[VIdx[1]+j], nIdx[0])) << " "; //need to cast the results for int8 only
-                else 
-                    dataFile << 0 << " "; 
+                        dataFile << 0 << " ";
+                }
+                dataFile << endl;
+            } else
+#endif
+            if (loops) {
+                for (j=0; j<SIMD_WIDTH*LOCKSTEP_CORES; j++) {
+                    if (VIdx[0]+j < V)
+                        if (!CHAR_DATA)
+                            dataFile << partDotProduct(op1[VIdx[0]+j], op2[VIdx[1]+j], nIdx[0]) << " ";
+                        else
+                            dataFile << int(partDotProduct(op1[VIdx[0]+j], op2[VIdx[1]+j], nIdx[0])) << " "; //need to cast the results for int8 only
+                    else
+                        dataFile << 0 << " ";
+                }
+                dataFile << endl;
             }
-            dataFile << endl;
             for (j=0; j<peeling; j++) {
                 // MOVs to GRFs
-                for (k=0; k<SIMD_WIDTH*CORES_PER_PCH; k++) {
-                    if(WORD_BITS != 8)
+                for (k=0; k<SIMD_WIDTH*LOCKSTEP_CORES; k++) {
+                    if (!CHAR_DATA)
                         dataFile << (VIdx[0] < V ? op1[VIdx[0]][nIdx[0]] : 0) << " ";
                     else
                         dataFile << int(VIdx[0] < V ? op1[VIdx[0]][nIdx[0]] : 0) << " "; //need to cast the results for int8 only
-                    if (!(++VIdx[0] % (SIMD_WIDTH*CORES_PER_PCH))){ // Ended dimension of S vectors
+                    if (!(++VIdx[0] % (SIMD_WIDTH*LOCKSTEP_CORES))){ // Ended dimension of S vectors
                         if (++nIdx[0] == n) {       // Finished all dimensions of S vectors
                             nIdx[0] = 0;
                         } else {
-                            VIdx[0] -= SIMD_WIDTH*CORES_PER_PCH;
+                            VIdx[0] -= SIMD_WIDTH*LOCKSTEP_CORES;
                         }
                     }
                 }
@@ -479,16 +676,16 @@ void mapDotProductCLim (ofstream &assembly, ofstream &dataFile, ofstream &addrFi
             }
             for (j=0; j<peeling; j++) {
                 // ALU ops
-                for (k=0; k<SIMD_WIDTH*CORES_PER_PCH; k++) {
-                    if(WORD_BITS != 8)
+                for (k=0; k<SIMD_WIDTH*LOCKSTEP_CORES; k++) {
+                    if (!CHAR_DATA)
                         dataFile << (VIdx[1] < V ? op2[VIdx[1]][nIdx[1]] : 0) << " ";
                     else
                         dataFile << int(VIdx[1] < V ? op2[VIdx[1]][nIdx[1]] : 0) << " "; //need to cast the results for int8 only
-                    if (!(++VIdx[1] % (SIMD_WIDTH*CORES_PER_PCH))){ // Ended dimension of S vectors
+                    if (!(++VIdx[1] % (SIMD_WIDTH*LOCKSTEP_CORES))){ // Ended dimension of S vectors
                         if (++nIdx[1] == n) {       // Finished all dimensions of S vectors
                             nIdx[1] = 0;
                         } else {
-                            VIdx[1] -= SIMD_WIDTH*CORES_PER_PCH;
+                            VIdx[1] -= SIMD_WIDTH*LOCKSTEP_CORES;
                         }
                     }
                 }
@@ -498,12 +695,30 @@ void mapDotProductCLim (ofstream &assembly, ofstream &dataFile, ofstream &addrFi
     }
 }
 
-#if (HALF_FLOAT)
+#if WIDE_ACC
+
+cnm_acc_t partDotProductWide(cnm_t **op1, cnm_t **op2, int n) {
+    cnm_acc_t res = cnm_acc_t(0);
+    for (int i=0; i<n; i++) {
+        for (int r=0; r<ACC_RATIO; r++) {
+#if (NARROW_FLOAT)
+            res += cnm_acc_t(float(cnm_narrow_t(op1[r][i]))) * cnm_acc_t(float(cnm_narrow_t(op2[r][i])));
+#else
+            res += cnm_acc_t(op1[r][i]) * cnm_acc_t(op2[r][i]);
+#endif
+        }
+    }
+    return res;
+}
+
+#endif  // WIDE_ACC
+
+#if (NARROW_FLOAT)
 
 float partDotProduct(float *op1, float *op2, int n) {  
-    half_float::half res = half_float::half_cast<half_float::half>(0);
+    cnm_narrow_t res = cnm_narrow_t(0);
     for (int i=0; i<n; i++) {
-        res += half_float::half_cast<half_float::half>(op1[i]) * half_float::half_cast<half_float::half>(op2[i]);
+        res += cnm_narrow_t(op1[i]) * cnm_narrow_t(op2[i]);
     }
     return float(res);
 }
@@ -518,4 +733,4 @@ cnm_t partDotProduct(cnm_t *op1, cnm_t *op2, int n) {
     return (cnm_t)(res);
 }
 
-#endif  // HALF_FLOAT
\ No newline at end of file
+#endif  // NARROW_FLOAT
\ No newline at end of file
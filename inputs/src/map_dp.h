@@ -9,15 +9,45 @@
 
 using namespace std;
 
-// Mapping of dot product, R-limited
+// CRF entries taken before the write-back of the DP mappings: the NOPs waiting for the accumulator and, with
+// reduce, the lane reduction and, with ring, the sum across the lockstep cores
+int reduceLength (bool reduce, bool ring);
+
+// Mapping of dot product, R-limited. With reduce, the lanes of every result are summed into lane 0,
+// and with ring, also across the lockstep cores. With wide, the results are accumulated into the wide lanes of MACW
 void mapDotProductRLim (ofstream &assembly, ofstream &dataFile, ofstream &addrFile,
-                                cnm_t **op1, cnm_t **op2, int V, int n);
+                                cnm_t **op1, cnm_t **op2, int V, int n, bool reduce, bool ring, bool wide);
+
+#if DUAL_BANK
+
+// Mapping of dot product with op1 in the even bank and op2 in the odd one, read by the same column command
+void mapDotProductDualBank (ofstream &assembly, ofstream &dataFile, ofstream &addrFile,
+                                cnm_t **op1, cnm_t **op2, int V, int n, bool reduce, bool ring, bool wide);
+
+#endif  // DUAL_BANK
+
+// Mapping of dot product of long vectors, spread over the lanes of a core and reduced across them.
+// With ring, every vector is spread over the lockstep cores, which add their sums through the core ring
+void mapDotProductRed (ofstream &assembly, ofstream &dataFile, ofstream &addrFile,
+                                cnm_t **op1, cnm_t **op2, int V, int n, bool rLim, bool ring);
 
-// Mapping of dot product, C-limited
+// Mapping of dot product, C-limited. With reduce, the lanes of every result are summed into lane 0,
+// and with ring, also across the lockstep cores. With wide, the results are accumulated into the wide lanes of MACW
 void mapDotProductCLim (ofstream &assembly, ofstream &dataFile, ofstream &addrFile,
-                                   cnm_t **op1, cnm_t **op2, int V, int n);
+                                   cnm_t **op1, cnm_t **op2, int V, int n, bool reduce, bool ring, bool wide);
+
+#if WIDE_ACC
+
+// Mapping of dot product into wide accumulators, every vector spread over the lanes of one of them
+void mapDotProductWide (ofstream &assembly, ofstream &dataFile, ofstream &addrFile,
+                                cnm_t **op1, cnm_t **op2, int V, int n);
+
+// Partial dot product of the ACC_RATIO lanes of a wide accumulator, computed in the wide type
+cnm_acc_t partDotProductWide(cnm_t **op1, cnm_t **op2, int n);
+
+#endif  // WIDE_ACC
 
-#if (HALF_FLOAT)
+#if (NARROW_FLOAT)
 
 // Function for computing partial dot products
 float partDotProduct(float *op1, float *op2, int n);
@@ -27,6 +57,6 @@ float partDotProduct(float *op1, float *op2, int n);
 // Function for computing partial dot products
 cnm_t partDotProduct(cnm_t *op1, cnm_t *op2, int n);
 
-#endif  // HALF_FLOAT
+#endif  // NARROW_FLOAT
 
 #endif  // MAP_DP_H
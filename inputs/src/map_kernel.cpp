@@ -1,35 +1,51 @@
 #include "map_kernel.h"
 
-int main(int argc, const char *argv[])
+int main(int argc_all, const char *argv_all[])
 {
+    // Extract the partitioning options, the rest of the arguments select the kernel
+    int channels = 1, ranks = 1, bankgroups = 1;
+    vector<const char *> args;
+    for (int a = 0; a < argc_all; a++) {
+        if (!string(argv_all[a]).compare("--channels") && a + 1 < argc_all)
+            channels = max(atoi(argv_all[++a]), 1);
+        else if (!string(argv_all[a]).compare("--ranks") && a + 1 < argc_all)
+            ranks = max(atoi(argv_all[++a]), 1);
+        else if (!string(argv_all[a]).compare("--bankgroups") && a + 1 < argc_all)
+            bankgroups = max(atoi(argv_all[++a]), 1);
+        else
+            args.push_back(argv_all[a]);
+    }
+    int argc = args.size();
+    const char **argv = args.data();
+
     if (argc != 5 && argc != 6 && argc != 11) {
         cout << "Usage: " << argv[0] << " <output_name> <kernel> <V> <n>" << endl;
         cout << "OR" << endl;
         cout << "Usage: " << argv[0] << " <output_name> <kernel> <m> <n> <q>" << endl;
         cout << "OR" << endl;
         cout << "Usage: " << argv[0] << " <output_name> <kernel> <ci> <wi> <hi> <k> <stride> <co> <wo> <ho>" << endl;
+        cout << "Optionally followed by: [--channels <c>] [--ranks <r>] [--bankgroups <g>]" << endl;
         cout << argc;
         return 0;
     }
 
-    string ao = "assembly-input/" + string(argv[1]) + ".asm";   // Output assembly file name
-    string df = "data-input/" + string(argv[1]) + ".data";      // Output data file name
-    string af = "address-input/" + string(argv[1]) + ".addr";   // Output address file name
-
-    // Open output files
-    ofstream assembly;
-    ofstream dataFile;
-    ofstream addrFile;
-    assembly.open(ao);
-    dataFile.open(df);
-    addrFile.open(af);
+    if (channels > (1 << CHANNEL_BITS) || ranks > (1 << RANK_BITS) || bankgroups > (1 << BG_BITS)) {
+        cout << "Error, more channels, ranks or bank groups than the address mapping allows" << endl;
+        return 1;
+    }
+    if (bankgroups > 1 && !BG_CORES) {
+        cout << "Error, partitioning across bank groups needs a core per bank group (BG_CORES)" << endl;
+        return 1;
+    }
 
     std::mt19937 gen(1111);    // Standard mersenne_twister_engine seeded
-#if HALF_FLOAT
+#if NARROW_FLOAT
     std::normal_distribution<float> dis(0, 65504/32768); 
 #else
 #if INT_TYPE
-#if DATA_TYPE == 4
+#if DATA_TYPE == 4 && WIDE_ACC
+    std::uniform_int_distribution<cnm_t> dis(-128, 127);    // The wide accumulators do not overflow
+#elif DATA_TYPE == 4
     std::uniform_int_distribution<cnm_t> dis(-1, 1);
 #else
     std::uniform_int_distribution<cnm_t> dis(-32768, 32767); //for int8 use (-1,1) to not overflow
@@ -37,7 +53,7 @@ int main(int argc, const char *argv[])
 #else
     std::normal_distribution<cnm_t> dis(0, 65504/32768); 
 #endif  // INT_TYPE
-#endif  // HALF_FLOAT
+#endif  // NARROW_FLOAT
 
     // Trial mapping of simple kernels
     int V,n;
@@ -116,120 +132,235 @@ int main(int argc, const char *argv[])
     }
 
     uint8_t kernel_choice = KERNEL.at(argv[2]);
+    cnm_t scale = kernel_choice == EWASRW ? cnm_t(dis(gen)) : cnm_t(0);   // Shared by all the partitions
 
-    // Generate correct mapping
+    // Partitioning: the independent outputs of the kernel (vectors for EW and DP, rows of
+    // the first matrix for MMS, MMB and MMC and output channels for CCWWR and CCWSW) are split evenly across the
+    // channels, ranks and bank groups, and every partition gets its own program, data and addresses
+    int parts = channels * ranks * bankgroups;
+    int total, chunk;
     switch(kernel_choice) {
-        case EWARW:
-            if (CRF_ENTRIES < (6*GRF_ENTRIES + 3*(int(ceil(float(n*V)/float(SIMD_WIDTH*CORES_PER_PCH))) % (2*GRF_ENTRIES)) + 2))
-                mapEWAdditionRowWiseCLim(assembly, dataFile, addrFile, op1, op2, V, n);
-            else
-                mapEWAdditionRowWiseRLim(assembly, dataFile, addrFile, op1, op2, V, n);
-            // cout << "--------- RESULTS ----------" << endl;
-            // for (int i =0; i < V; i++){
-            //     for(int j =0; j < n; j++){
-            //         cout << op1[i][j] + op2[i][j] << "\t";
-            //         if (!((i+1)%SIMD_WIDTH))    cout << endl;
-            //     }
-            //     cout << endl;
-            // }
-        break;
-        case EWACW:
-            if (CRF_ENTRIES < (6*GRF_ENTRIES + 3*(int(float(n)*ceil(float(V)/float(SIMD_WIDTH*CORES_PER_PCH))) % (2*GRF_ENTRIES)) + 2))
-                mapEWAdditionColWiseCLim(assembly, dataFile, addrFile, op1, op2, V, n);
-            else
-                mapEWAdditionColWiseRLim(assembly, dataFile, addrFile, op1, op2, V, n);
-        break;
-        case EWMRW: break;
-        case EWMCW: break;
-        case DP:
-            if (CRF_ENTRIES < (4*GRF_ENTRIES + 2*(n % (2*GRF_ENTRIES-1)) + 2))
-                mapDotProductCLim(assembly, dataFile, addrFile, op1, op2, V, n);
-            else
-                mapDotProductRLim(assembly, dataFile, addrFile, op1, op2, V, n);
-            // // Print results for checking
-            // cout << "--------- RESULTS ----------" << endl;
-            // for (int i=0; i<V; i++) {
-            //     if(WORD_BITS != 8)
-            //         cout << partDotProduct(op1[i], op2[i], n) << " ";
-            //     else
-            //         cout << int(partDotProduct(op1[i], op2[i], n)) << " "; //need to cast the results for int8 only
-            //     if (!((i+1)%SIMD_WIDTH))    cout << endl;
-            // }
-            // cout << endl;
-        break;
         case MMS:
-            if (CRF_ENTRIES < (SRF_M_ENTRIES + 4))
-                mapMatrixMultSrfCLim(assembly, dataFile, addrFile, opM1, opM2, m, n, q);
-            else
-                mapMatrixMultSrfRLim(assembly, dataFile, addrFile, opM1, opM2, m, n, q);
-            // // Print matrices
-            // cout << "--------- MATRIX 1 ----------" << endl;
-            // for (int i=0; i<m; i++) {
-            //     for (int j=0; j<n; j++) {
-            //         cout << opM1[i*n+j] << " ";
-            //     }
-            //     cout << endl;
-            // }
-            // cout << "--------- MATRIX 2 ----------" << endl;
-            // for (int i=0; i<n; i++) {
-            //     for (int j=0; j<q; j++) {
-            //         cout << opM2[i*q+j] << " ";
-            //     }
-            //     cout << endl;
-            // }
-        
-            // // Print results for checking
-            // cout << "--------- RESULTS ----------" << endl;
-            // for (int i=0; i<m; i++) {
-            //     for (int j=0; j<q; j++) {
-            //         cout << partMatMultDP(opM1, opM2, m, n, q, i, j, n) << " ";
-            //         if (!((j+1)%(SIMD_WIDTH*CORES_PER_PCH)))    cout << endl;
-            //     }
-            //     cout << endl;
-            // }
-        break;
+        case MMB:
+        case MMC:   total = m;  chunk = ceil(float(m)/float(parts));    break;
         case CCWWR:
-            if (CRF_ENTRIES < (SRF_M_ENTRIES + 4))
-                mapConvCWWRCLim(assembly, dataFile, addrFile, act, weight, bias, ci, wi, hi, k, co, wo, ho, stride);
-            else
-                mapConvCWWRRLim(assembly, dataFile, addrFile, act, weight, bias, ci, wi, hi, k, co, wo, ho, stride);
-            // Print activations of first channel
-            // cout << "--------- ACTIVATIONS ----------" << endl;
-            // for (int j=0; j<hi; j++) {
-            //     for (int l=0; l<wi; l++) {
-            //         cout << act[(ci-1)*hi*wi + j*wi + l] << " ";
-            //     }
-            //     cout << endl;
-            // } 
-            // cout << endl;
-
-            // // Print weights
-            // cout << "--------- WEIGHTS ----------" << endl;
-            // for (int j=0; j<k; j++) {
-            //     for (int l=0; l<k; l++) {
-            //         cout << weight[(ci-1)*k*k + j*k + l] << " ";
-            //     }
-            //     cout << endl;
-            // } 
-            // cout << endl;
-
-            // // Print bias of first channel
-            // cout << "--------- BIAS ----------" << endl;
-            // cout << bias[0] << endl;
-            
-            // // Print results for checking
-            // cout << "--------- RESULTS ----------" << endl;
-            // for (int i=0; i<co; i++) {
-            //     for (int j=0; j<ho; j++) {
-            //         for (int l=0; l<wo; l++) {
-            //             cout << partPixConv(act, weight, bias, stride, k, ci, hi, wi, ci, 0, 0, i, j, l) << " ";
-            //             if (!((j*wo+l+1)%(SIMD_WIDTH*CORES_PER_PCH)))    cout << endl;
-            //         }
-            //     }
-            //     cout << endl;
-            // }
+        case CCWSW: total = co; chunk = ceil(float(co)/float(parts));   break;
+        case DPR:   total = V;  chunk = ceil(float(V)/float(parts));    break;  // A vector per core
+        case DPRC:  total = V;  chunk = ceil(float(V)/float(parts));    break;  // A vector per ring
+        default:    // Keep full SIMD vectors in every partition
+            total = V;
+            chunk = ceil(ceil(float(V)/float(parts))/float(SIMD_WIDTH*LOCKSTEP_CORES)) * SIMD_WIDTH*LOCKSTEP_CORES;
         break;
-        default:    break;
+    }
+
+    if (kernel_choice == EWAAM && !AAM_REGS) {
+        cout << "Error, EWAAM needs the AAM registers (AAM_REGS)" << endl;
+        return 1;
+    }
+
+    ofstream partsFile;
+    if (parts > 1) {
+        partsFile.open("assembly-input/" + string(argv[1]) + ".parts");
+    }
+
+    for (int p = 0; p < parts && p*chunk < total; p++) {
+        int start = p*chunk;
+        int len = min(chunk, total - start);
+        string name = string(argv[1]);
+        if (parts > 1) {
+            name += "_p" + to_string(p);
+        }
+        mapChannel = p / (ranks * bankgroups);
+        mapRank = (p / bankgroups) % ranks;
+        mapBankGroup = p % bankgroups;
+        if (parts > 1) {
+            partsFile << p << " " << mapChannel << " " << mapRank << " " << mapBankGroup << endl;
+        }
+
+        string ao = "assembly-input/" + name + ".asm";   // Output assembly file name
+        string df = "data-input/" + name + ".data";      // Output data file name
+        string af = "address-input/" + name + ".addr";   // Output address file name
+
+        // Open output files
+        ofstream assembly;
+        ofstream dataFile;
+        ofstream addrFile;
+        assembly.open(ao);
+        dataFile.open(df);
+        addrFile.open(af);
+
+        // Generate correct mapping
+        switch(kernel_choice) {
+            case EWARW:
+#if DUAL_BANK
+                mapEWAdditionDualBank(assembly, dataFile, addrFile, op1 + start, op2 + start, len, n);
+#else
+                if (CRF_ENTRIES < (6*GRF_ENTRIES + 3*(int(ceil(float(n*len)/float(SIMD_WIDTH*LOCKSTEP_CORES))) % (2*GRF_ENTRIES)) + 2))
+                    mapEWAdditionRowWiseCLim(assembly, dataFile, addrFile, op1 + start, op2 + start, len, n);
+                else
+                    mapEWAdditionRowWiseRLim(assembly, dataFile, addrFile, op1 + start, op2 + start, len, n);
+#endif
+                // cout << "--------- RESULTS ----------" << endl;
+                // for (int i =0; i < V; i++){
+                //     for(int j =0; j < n; j++){
+                //         cout << op1[i][j] + op2[i][j] << "\t";
+                //         if (!((i+1)%SIMD_WIDTH))    cout << endl;
+                //     }
+                //     cout << endl;
+                // }
+            break;
+            case EWACW:
+                if (CRF_ENTRIES < (6*GRF_ENTRIES + 3*(int(float(n)*ceil(float(len)/float(SIMD_WIDTH*LOCKSTEP_CORES))) % (2*GRF_ENTRIES)) + 2))
+                    mapEWAdditionColWiseCLim(assembly, dataFile, addrFile, op1 + start, op2 + start, len, n);
+                else
+                    mapEWAdditionColWiseRLim(assembly, dataFile, addrFile, op1 + start, op2 + start, len, n);
+            break;
+            case EWMRW: break;
+            case EWMCW: break;
+            case EWASRW:
+                mapEWAddScaleRowWise(assembly, dataFile, addrFile, op1 + start, op2 + start, scale, len, n);
+            break;
+            case EWAAM:
+                mapEWAdditionAam(assembly, dataFile, addrFile, op1 + start, op2 + start, len, n);
+            break;
+            case DP:
+#if WIDE_ACC
+                mapDotProductWide(assembly, dataFile, addrFile, op1 + start, op2 + start, len, n);
+#elif DUAL_BANK
+                mapDotProductDualBank(assembly, dataFile, addrFile, op1 + start, op2 + start, len, n, false, false, false);
+#else
+                if (CRF_ENTRIES < (4*GRF_ENTRIES + 2*(n % (2*GRF_ENTRIES-1)) + 2 + reduceLength(false, false)))
+                    mapDotProductCLim(assembly, dataFile, addrFile, op1 + start, op2 + start, len, n, false, false, false);
+                else
+                    mapDotProductRLim(assembly, dataFile, addrFile, op1 + start, op2 + start, len, n, false, false, false);
+#endif
+                // // Print results for checking
+                // cout << "--------- RESULTS ----------" << endl;
+                // for (int i=0; i<V; i++) {
+                //     if (!CHAR_DATA)
+                //         cout << partDotProduct(op1[i], op2[i], n) << " ";
+                //     else
+                //         cout << int(partDotProduct(op1[i], op2[i], n)) << " "; //need to cast the results for int8 only
+                //     if (!((i+1)%SIMD_WIDTH))    cout << endl;
+                // }
+                // cout << endl;
+            break;
+            case DPR:
+                mapDotProductRed(assembly, dataFile, addrFile, op1 + start, op2 + start, len, n,
+                    CRF_ENTRIES >= (4*GRF_ENTRIES + 2*(int(ceil(float(n)/float(SIMD_WIDTH))) % (2*GRF_ENTRIES-1)) + 3 + reduceLength(true, false)), false);
+            break;
+            case DPRC:
+                if (!CORE_RING) {
+                    cout << "Error, DPRC needs the core ring (CORE_RING)" << endl;
+                    return 1;
+                }
+                mapDotProductRed(assembly, dataFile, addrFile, op1 + start, op2 + start, len, n,
+                    CRF_ENTRIES >= (4*GRF_ENTRIES + 2*(int(ceil(float(n)/float(SIMD_WIDTH*LOCKSTEP_CORES))) % (2*GRF_ENTRIES-1)) + 3 + reduceLength(true, true)), true);
+            break;
+            case MMS:
+                if (CRF_ENTRIES < (SRF_M_ENTRIES + 4))
+                    mapMatrixMultSrfCLim(assembly, dataFile, addrFile, opM1 + start*n, opM2, len, n, q);
+                else
+                    mapMatrixMultSrfRLim(assembly, dataFile, addrFile, opM1 + start*n, opM2, len, n, q);
+                // // Print matrices
+                // cout << "--------- MATRIX 1 ----------" << endl;
+                // for (int i=0; i<m; i++) {
+                //     for (int j=0; j<n; j++) {
+                //         cout << opM1[i*n+j] << " ";
+                //     }
+                //     cout << endl;
+                // }
+                // cout << "--------- MATRIX 2 ----------" << endl;
+                // for (int i=0; i<n; i++) {
+                //     for (int j=0; j<q; j++) {
+                //         cout << opM2[i*q+j] << " ";
+                //     }
+                //     cout << endl;
+                // }
+        
+                // // Print results for checking
+                // cout << "--------- RESULTS ----------" << endl;
+                // for (int i=0; i<m; i++) {
+                //     for (int j=0; j<q; j++) {
+                //         cout << partMatMultDP(opM1, opM2, m, n, q, i, j, n) << " ";
+                //         if (!((j+1)%(SIMD_WIDTH*LOCKSTEP_CORES)))    cout << endl;
+                //     }
+                //     cout << endl;
+                // }
+            break;
+            case MMB:
+                if (CRF_ENTRIES < (int(ceil(float(SRF_M_ENTRIES)/float(SRF_M_PACK))) + SRF_M_ENTRIES + 4)) {
+                    cout << "Error, the CRF cannot hold the weight loads and the MACs of MMB" << endl;
+                    return 1;
+                }
+                mapMatrixMultBankRLim(assembly, dataFile, addrFile, opM1 + start*n, opM2, len, n, q);
+            break;
+            case MMC:
+                if (!UNICAST_RF) {
+                    cout << "Error, MMC needs RF writes to a single core (UNICAST_RF)" << endl;
+                    return 1;
+                }
+                if (CRF_ENTRIES < (SRF_M_ENTRIES + 4)) {
+                    cout << "Error, the CRF cannot hold the MACs of MMC" << endl;
+                    return 1;
+                }
+                mapMatrixMultCoreRows(assembly, dataFile, addrFile, opM1 + start*n, opM2, len, n, q);
+            break;
+            case CCWWR:
+                if (CRF_ENTRIES < (SRF_M_ENTRIES + 4))
+                    mapConvCWWRCLim(assembly, dataFile, addrFile, act, weight + start*ci*k*k, bias + start, ci, wi, hi, k, len, wo, ho, stride);
+                else
+                    mapConvCWWRRLim(assembly, dataFile, addrFile, act, weight + start*ci*k*k, bias + start, ci, wi, hi, k, len, wo, ho, stride);
+                // Print activations of first channel
+                // cout << "--------- ACTIVATIONS ----------" << endl;
+                // for (int j=0; j<hi; j++) {
+                //     for (int l=0; l<wi; l++) {
+                //         cout << act[(ci-1)*hi*wi + j*wi + l] << " ";
+                //     }
+                //     cout << endl;
+                // } 
+                // cout << endl;
+
+                // // Print weights
+                // cout << "--------- WEIGHTS ----------" << endl;
+                // for (int j=0; j<k; j++) {
+                //     for (int l=0; l<k; l++) {
+                //         cout << weight[(ci-1)*k*k + j*k + l] << " ";
+                //     }
+                //     cout << endl;
+                // } 
+                // cout << endl;
+
+                // // Print bias of first channel
+                // cout << "--------- BIAS ----------" << endl;
+                // cout << bias[0] << endl;
+            
+                // // Print results for checking
+                // cout << "--------- RESULTS ----------" << endl;
+                // for (int i=0; i<co; i++) {
+                //     for (int j=0; j<ho; j++) {
+                //         for (int l=0; l<wo; l++) {
+                //             cout << partPixConv(act, weight, bias, stride, k, ci, hi, wi, ci, 0, 0, i, j, l) << " ";
+                //             if (!((j*wo+l+1)%(SIMD_WIDTH*LOCKSTEP_CORES)))    cout << endl;
+                //         }
+                //     }
+                //     cout << endl;
+                // }
+            break;
+            case CCWSW:
+                if (!LANE_PERM || stride != 1 || k > SRF_M_ENTRIES || k > SIMD_WIDTH) {
+                    cout << "Error, CCWSW needs the lane permutation unit (LANE_PERM), stride 1 and a filter row in the SRF" << endl;
+                    return 1;
+                }
+                if (CRF_ENTRIES < (2*k*(SRF_M_ENTRIES/k) + 4)) {
+                    cout << "Error, the CRF cannot hold the filter rows of CCWSW" << endl;
+                    return 1;
+                }
+                mapConvCWSlidingWindow(assembly, dataFile, addrFile, act, weight + start*ci*k*k, bias + start, ci, wi, hi, k, len, wo, ho);
+            break;
+            default:    break;
+        }
+
     }
 
     return 0;
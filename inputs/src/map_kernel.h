@@ -14,9 +14,16 @@ enum KERNEL_VALUES {
     EWACW,  // Element-Wise Addition Column-Wise
     EWMRW,  // Element-Wise Multiplication Row-Wise
     EWMCW,  // Element-Wise Multiplication Column-Wise
+    EWASRW, // Element-Wise Addition and Scaling Row-Wise
+    EWAAM,  // Element-Wise Addition Row-Wise, with loops over the AAM registers
     DP,     // Dot Product
+    DPR,    // Dot Product of long vectors, reduced across the lanes
+    DPRC,   // Dot Product of long vectors, reduced across the lanes and through the ring of lockstep cores
     MMS,    // Matrix Multiplication using SRF
+    MMB,    // Matrix Multiplication using SRF, with the weights loaded from the banks
+    MMC,    // Matrix Multiplication using SRF, with a row of the first matrix written to every lockstep core
     CCWWR,  // Convolution Channel-Wise wieht Weight Reuse
+    CCWSW,  // Convolution Channel-Wise with a Sliding Window through the lanes
 };
 
 const std::map<std::string, uint8_t> KERNEL = {
@@ -24,7 +31,14 @@ const std::map<std::string, uint8_t> KERNEL = {
     { "EWACW", EWACW },
     { "EWMRW", EWMRW },
     { "EWMCW", EWMCW },
+    { "EWASRW", EWASRW },
+    { "EWAAM", EWAAM },
     { "DP", DP },
+    { "DPR", DPR },
+    { "DPRC", DPRC },
     { "MMS", MMS },
+    { "MMB", MMB },
+    { "MMC", MMC },
     { "CCWWR", CCWWR },
+    { "CCWSW", CCWSW },
 };
\ No newline at end of file
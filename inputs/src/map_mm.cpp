@@ -1,15 +1,37 @@
 #include "map_mm.h"
 
+// Writes the program of a peeled set of matrices, MACs with the first ext_peeling entries of the SRF_M, to crf
+// The accumulator starts from zero if fill is set, or from the partial result in the bank otherwise
+static void writePeeledProgram (ofstream &assembly, string crf, int ext_peeling, int loops, bool fill)
+{
+    int i;
+    assembly << "WRF " << crf << endl;
+    if (fill)
+        assembly << "FILL GRFB0 0" << endl;
+    else
+        assembly << "MOV GRFB0 ODD_BANK[AddrFile] DataFile" << endl;
+    for (i=0; i<ext_peeling/2; i++) {
+        assembly << "MAC GRFB0 EVEN_BANK[AddrFile] SRFM" << 2*i << " DataFile" << endl;
+        assembly << "MAC GRFB0 ODD_BANK[AddrFile] SRFM" << 2*i+1 << " DataFile" << endl;
+    }
+    if (ext_peeling - 2*i)
+        assembly << "MAC GRFB0 EVEN_BANK[AddrFile] SRFM" << 2*i << " DataFile" << endl;
+    assembly << "MOV ODD_BANK[AddrFile] GRFB0" << endl;
+    if (loops-1)
+        assembly << "JUMP " << ext_peeling+2 << " " << loops-1 << endl;
+    assembly << "EXIT" << endl;
+}
+
 void mapMatrixMultSrfRLim (ofstream &assembly, ofstream &dataFile, ofstream &addrFile,
                                 cnm_t *op1, cnm_t *op2, int m, int n, int q)
 {
     int i,j,k,l,p;
     int ext_loops = floor(float(n)/float(SRF_M_ENTRIES));
-    int loops = ceil(float(q)/float(SIMD_WIDTH*CORES_PER_PCH)) ;
+    int loops = ceil(float(q)/float(SIMD_WIDTH*LOCKSTEP_CORES)) ;
     int ext_peeling = n % SRF_M_ENTRIES;
-    uint64_t op2Base = ceil(float(m)*float(n)/float(SIMD_WIDTH)/float(COLPERROW*CORES_PER_PCH) / 2);          // Op2 will start in this row
-    uint64_t resBase = op2Base + ceil((n * ceil(float(q)/float(SIMD_WIDTH))) / float(COLPERROW*CORES_PER_PCH) / 2); // Result will start in this row
-    uint64_t zeroBase = resBase + ceil((m * ceil(float(q)/float(SIMD_WIDTH))) / float(COLPERROW*CORES_PER_PCH));    // Column fill with zeros, after the result
+    uint64_t op2Base = ceil(float(m)*float(n)/float(SIMD_WIDTH)/float(COLPERROW*LOCKSTEP_CORES) / 2);          // Op2 will start in this row
+    uint64_t resBase = op2Base + ceil((n * ceil(float(q)/float(SIMD_WIDTH))) / float(COLPERROW*LOCKSTEP_CORES) / 2); // Result will start in this row
+    uint64_t zeroBase = resBase + ceil((m * ceil(float(q)/float(SIMD_WIDTH))) / float(COLPERROW*LOCKSTEP_CORES));    // Column fill with zeros, after the result
     uint64_t rowIdx[2] = {op2Base,resBase};
     uint64_t colIdx[2] = {0,0};
     uint64_t op1Idx = 0;    // Index to run through matrix 1
@@ -33,46 +55,39 @@ void mapMatrixMultSrfRLim (ofstream &assembly, ofstream &dataFile, ofstream &add
         assembly << "EXIT" << endl;
 
         for (i=0; i<m*ext_loops; i++) {
-            for (j=0; j<SRF_M_ENTRIES; j++) {   
-                assembly << "WRF SRFM" << j << " DataFile" << endl; // Weights
-            }
+            writeSrfMLoad(assembly, SRF_M_ENTRIES);   // Weights
             assembly << "EXEC" << endl;
+#if CRF_DBUF
+            // The peeled program goes to the other CRF bank after the first EXEC, the assembler
+            // issues it with the next weights so that it is written while this bank executes
+            if (!i && ext_peeling)
+                writePeeledProgram(assembly, "CRFS0", ext_peeling, loops, false);
+#endif
         }
     }
 
     if (ext_peeling && ext_loops) {
         assembly << "; Peeled set of matrices" << endl;
+#if CRF_DBUF
+        assembly << "SWAP" << endl;     // Written to the other CRF bank along with the first weights
+#else
         assembly << "WRF CRF" << ext_peeling+1 << endl; // Move forward the MOV to BANK, JUMP and EXIT
         assembly << "MOV ODD_BANK[AddrFile] GRFB0" << endl;
         if (loops-1)
             assembly << "JUMP " << ext_peeling+2 << " " << loops-1 << endl;
         assembly << "EXIT" << endl;
+#endif
 
         for (i=0; i<m; i++) {
-            for (j=0; j<ext_peeling; j++) {   
-                assembly << "WRF SRFM" << j << " DataFile" << endl; // Weights
-            }
+            writeSrfMLoad(assembly, ext_peeling);   // Weights
             assembly << "EXEC" << endl;
         }
 
     } else if (ext_peeling) {
-        assembly << "WRF CRF0" << endl;
-        assembly << "MOV GRFB0 ODD_BANK[AddrFile] DataFile" << endl;
-        for (i=0; i<ext_peeling/2; i++) {
-            assembly << "MAC GRFB0 EVEN_BANK[AddrFile] SRFM" << 2*i << " DataFile" << endl;
-            assembly << "MAC GRFB0 ODD_BANK[AddrFile] SRFM" << 2*i+1 << " DataFile" << endl;
-        }
-        if (ext_peeling - 2*i)
-            assembly << "MAC GRFB0 EVEN_BANK[AddrFile] SRFM" << 2*i << " DataFile" << endl;
-        assembly << "MOV ODD_BANK[AddrFile] GRFB0" << endl;
-        if (loops-1)
-            assembly << "JUMP " << ext_peeling+2 << " " << loops-1 << endl;
-        assembly << "EXIT" << endl;
+        writePeeledProgram(assembly, "CRF0", ext_peeling, loops, true);
 
         for (i=0; i<m; i++) {
-            for (j=0; j<ext_peeling; j++) {   
-                assembly << "WRF SRFM" << j << " DataFile" << endl; // Weights
-            }
+            writeSrfMLoad(assembly, ext_peeling);   // Weights
             assembly << "EXEC" << endl;
         }
     }
@@ -87,23 +102,23 @@ void mapMatrixMultSrfRLim (ofstream &assembly, ofstream &dataFile, ofstream &add
             rowIdx[1] = curResRow;  colIdx[1] = curResCol;
             for (k=0; k<loops; k++) {
                 // (j * SRF_M_ENTRIES * ceil(float(q)/float(SIMD_WIDTH)) + k) is # DRAM columns from op2 start to current
-                rowIdx[0] = op2Base + (j * SRF_M_ENTRIES * int(ceil(float(q/2)/float(SIMD_WIDTH*CORES_PER_PCH))) + k) / COLPERROW;
-                colIdx[0] = (j * SRF_M_ENTRIES * int(ceil(float(q/2)/float(SIMD_WIDTH*CORES_PER_PCH))) + k) % COLPERROW;
+                rowIdx[0] = op2Base + (j * SRF_M_ENTRIES * int(ceil(float(q/2)/float(SIMD_WIDTH*LOCKSTEP_CORES))) + k) / COLPERROW;
+                colIdx[0] = (j * SRF_M_ENTRIES * int(ceil(float(q/2)/float(SIMD_WIDTH*LOCKSTEP_CORES))) + k) % COLPERROW;
                 if (colIdx[0] >= COLPERROW) cout << "j " << j << " k " << k << " col0 " << colIdx[0] << endl;
                 // MOV to GRF_B
-                addrFile << showbase << hex << (j ? build_addr({0,0,0,1,rowIdx[1],colIdx[1]}) : build_addr({0,0,0,1,zeroBase,0})) << endl;
+                addrFile << showbase << hex << (j ? build_addr({mapChannel,mapRank,mapBankGroup,1,rowIdx[1],colIdx[1]}) : build_addr({mapChannel,mapRank,mapBankGroup,1,zeroBase,0})) << endl;
                 // MACs
                 for (l=0; l<SRF_M_ENTRIES/2; l++) {
-                    addrFile << showbase << hex << build_addr({0,0,0,0,rowIdx[0],colIdx[0]}) << endl;
-                    addrFile << showbase << hex << build_addr({0,0,0,1,rowIdx[0],colIdx[0]}) << endl;
+                    addrFile << showbase << hex << build_addr({mapChannel,mapRank,mapBankGroup,0,rowIdx[0],colIdx[0]}) << endl;
+                    addrFile << showbase << hex << build_addr({mapChannel,mapRank,mapBankGroup,1,rowIdx[0],colIdx[0]}) << endl;
                     //  ceil(float(q/2)/float(SIMD_WIDTH)) is the ammount of DRAM columns a op2 row takes
                     // / 2 because we use divide it in 2 banks
-                    rowIdx[0] += (colIdx[0] + int(ceil(float(q/2)/float(SIMD_WIDTH*CORES_PER_PCH)))) / COLPERROW;
-                    colIdx[0] = (colIdx[0] + int(ceil(float(q/2)/float(SIMD_WIDTH*CORES_PER_PCH)))) % COLPERROW;
+                    rowIdx[0] += (colIdx[0] + int(ceil(float(q/2)/float(SIMD_WIDTH*LOCKSTEP_CORES)))) / COLPERROW;
+                    colIdx[0] = (colIdx[0] + int(ceil(float(q/2)/float(SIMD_WIDTH*LOCKSTEP_CORES)))) % COLPERROW;
                     if (colIdx[0] >= COLPERROW) cout << "j " << j << " k " << k << " l " << " col0 " << colIdx[0] << endl;
                 }
                 // MOV to BANK
-                addrFile << showbase << hex << build_addr({0,0,0,1,rowIdx[1],colIdx[1]}) << endl;
+                addrFile << showbase << hex << build_addr({mapChannel,mapRank,mapBankGroup,1,rowIdx[1],colIdx[1]}) << endl;
                 if (++colIdx[1] == COLPERROW) {
                     colIdx[1] = 0;
                     rowIdx[1]++;
@@ -121,22 +136,23 @@ void mapMatrixMultSrfRLim (ofstream &assembly, ofstream &dataFile, ofstream &add
             for (k=0; k<loops; k++) {
                 // (j * SRF_M_ENTRIES * ceil(float(q)/float(SIMD_WIDTH)) + k) is # DRAM columns from op2 start to current
                 rowIdx[0] = resBase + k / COLPERROW;
-                colIdx[0] = (j * SRF_M_ENTRIES * int(ceil(float(q/2)/float(SIMD_WIDTH*CORES_PER_PCH))) + k) % COLPERROW;
-                // MOV to GRF_B
-                addrFile << showbase << hex << (ext_loops ? build_addr({0,0,0,1,rowIdx[1],colIdx[1]}) : build_addr({0,0,0,1,zeroBase,0})) << endl;
+                colIdx[0] = (j * SRF_M_ENTRIES * int(ceil(float(q/2)/float(SIMD_WIDTH*LOCKSTEP_CORES))) + k) % COLPERROW;
+                // MOV partial result to GRF_B, filled with zeros otherwise
+                if (ext_loops)
+                    addrFile << showbase << hex << build_addr({mapChannel,mapRank,mapBankGroup,1,rowIdx[1],colIdx[1]}) << endl;
                 // MACs
                 for (l=0; l<ext_peeling/2; l++) {
-                    addrFile << showbase << hex << build_addr({0,0,0,0,rowIdx[0],colIdx[0]}) << endl;
-                    addrFile << showbase << hex << build_addr({0,0,0,1,rowIdx[0],colIdx[0]}) << endl;
+                    addrFile << showbase << hex << build_addr({mapChannel,mapRank,mapBankGroup,0,rowIdx[0],colIdx[0]}) << endl;
+                    addrFile << showbase << hex << build_addr({mapChannel,mapRank,mapBankGroup,1,rowIdx[0],colIdx[0]}) << endl;
                     //  ceil(float(q/2)/float(SIMD_WIDTH)) is the ammount of DRAM columns a op2 row takes
                     // / 2 because we use divide it in 2 banks
-                    rowIdx[0] += (colIdx[0] + int(ceil(float(q/2)/float(SIMD_WIDTH*CORES_PER_PCH)))) / COLPERROW;
-                    colIdx[0] = (colIdx[0] + int(ceil(float(q/2)/float(SIMD_WIDTH*CORES_PER_PCH)))) % COLPERROW;
+                    rowIdx[0] += (colIdx[0] + int(ceil(float(q/2)/float(SIMD_WIDTH*LOCKSTEP_CORES)))) / COLPERROW;
+                    colIdx[0] = (colIdx[0] + int(ceil(float(q/2)/float(SIMD_WIDTH*LOCKSTEP_CORES)))) % COLPERROW;
                 }
                 if (ext_peeling - 2*l)  // If n it's odd, last one is only with EVEN_BANK
-                    addrFile << showbase << hex << build_addr({0,0,0,0,rowIdx[0],colIdx[0]}) << endl;
+                    addrFile << showbase << hex << build_addr({mapChannel,mapRank,mapBankGroup,0,rowIdx[0],colIdx[0]}) << endl;
                 // MOV to BANK
-                addrFile << showbase << hex << build_addr({0,0,0,1,rowIdx[1],colIdx[1]}) << endl;
+                addrFile << showbase << hex << build_addr({mapChannel,mapRank,mapBankGroup,1,rowIdx[1],colIdx[1]}) << endl;
                 if (++colIdx[1] == COLPERROW) {
                     colIdx[1] = 0;
                     rowIdx[1]++;
@@ -152,16 +168,11 @@ void mapMatrixMultSrfRLim (ofstream &assembly, ofstream &dataFile, ofstream &add
         op1Idx = i*n;   // Set the op1 index to the start of the row (to jump over the peeled part)
         for (j=0; j<ext_loops; j++) {
             // Move the op1 to the SRF
-            for (k=0; k<SRF_M_ENTRIES; k++) {
-                if(WORD_BITS != 8)
-                    dataFile << op1[op1Idx++] << endl;
-                else
-                    dataFile << int(op1[op1Idx++]) << endl;
-            }
+            writeSrfMData(dataFile, op1, &op1Idx, SRF_M_ENTRIES);
             for (k=0; k<loops; k++) {
                 // Move 0 or partial result to GRFB (0 if starting to accumulate a result or if out of bounds)
-                for (l=0; l<SIMD_WIDTH*CORES_PER_PCH; l++) {
-                    if(WORD_BITS != 8)
+                for (l=0; l<SIMD_WIDTH*LOCKSTEP_CORES; l++) {
+                    if (!CHAR_DATA)
                         dataFile << (j && (k*SIMD_WIDTH+l<q) ? partMatMultDP(op1, op2, m, n, q, i, k*SIMD_WIDTH+l, j*SRF_M_ENTRIES) : 0) << " ";
                     else
                         dataFile << int(j && (k*SIMD_WIDTH+l<q) ? partMatMultDP(op1, op2, m, n, q, i, k*SIMD_WIDTH+l, j*SRF_M_ENTRIES) : 0) << " "; //need to cast the results for int8 only
@@ -169,9 +180,9 @@ void mapMatrixMultSrfRLim (ofstream &assembly, ofstream &dataFile, ofstream &add
                 dataFile << endl;
                 // Run through op2 for MAC
                 for (l=0; l<SRF_M_ENTRIES; l++) {
-                    op2Idx = (j * SRF_M_ENTRIES + l) * q + k*SIMD_WIDTH*CORES_PER_PCH; // Set the op2 index to the first lane of the SIMD
-                    for (p=0; p<SIMD_WIDTH*CORES_PER_PCH; p++) {
-                        if(WORD_BITS != 8)
+                    op2Idx = (j * SRF_M_ENTRIES + l) * q + k*SIMD_WIDTH*LOCKSTEP_CORES; // Set the op2 index to the first lane of the SIMD
+                    for (p=0; p<SIMD_WIDTH*LOCKSTEP_CORES; p++) {
+                        if (!CHAR_DATA)
                             dataFile << (op2Idx < (j*SRF_M_ENTRIES+l+1)*q ? op2[op2Idx++] : 0) << " ";
                         else
                             dataFile << int(op2Idx < (j*SRF_M_ENTRIES+l+1)*q ? op2[op2Idx++] : 0) << " "; //need to cast the results for int8 only
@@ -187,26 +198,23 @@ void mapMatrixMultSrfRLim (ofstream &assembly, ofstream &dataFile, ofstream &add
         for (i=0; i<m; i++) {
             op1Idx = i*n+ext_loops*SRF_M_ENTRIES;   // Set the op1 index to the start of the row (to jump over the peeled part)
             // Move the op1 to the SRF
-            for (j=0; j<ext_peeling; j++) {
-                if(WORD_BITS != 8)
-                    dataFile << op1[op1Idx++] << endl;
-                else
-                    dataFile << int(op1[op1Idx++]) << endl; //need to cast the results for int8 only
-            }
+            writeSrfMData(dataFile, op1, &op1Idx, ext_peeling);
             for (j=0; j<loops; j++) {
-                // Move 0 or partial result to GRFB (0 if starting to accumulate a result or if out of bounds)
-                for (k=0; k<SIMD_WIDTH*CORES_PER_PCH; k++) {
-                    if(WORD_BITS != 8)
-                        dataFile << (ext_loops && (j*SIMD_WIDTH+k<q) ? partMatMultDP(op1, op2, m, n, q, i, j*SIMD_WIDTH+k, ext_loops*SRF_M_ENTRIES) : 0) << " ";
-                    else
-                        dataFile << int(ext_loops && (j*SIMD_WIDTH+k<q) ? partMatMultDP(op1, op2, m, n, q, i, j*SIMD_WIDTH+k, ext_loops*SRF_M_ENTRIES) : 0) << " "; //need to cast the results for int8 only
+                // Move partial result to GRFB (0 if out of bounds), filled with zeros if starting to accumulate
+                if (ext_loops) {
+                    for (k=0; k<SIMD_WIDTH*LOCKSTEP_CORES; k++) {
+                        if (!CHAR_DATA)
+                            dataFile << ((j*SIMD_WIDTH+k<q) ? partMatMultDP(op1, op2, m, n, q, i, j*SIMD_WIDTH+k, ext_loops*SRF_M_ENTRIES) : 0) << " ";
+                        else
+                            dataFile << int((j*SIMD_WIDTH+k<q) ? partMatMultDP(op1, op2, m, n, q, i, j*SIMD_WIDTH+k, ext_loops*SRF_M_ENTRIES) : 0) << " "; //need to cast the results for int8 only
+                    }
+                    dataFile << endl;
                 }
-                dataFile << endl;
                 // Run through op2 for MAC
                 for (k=0; k<ext_peeling; k++) {
-                    op2Idx = (ext_loops * SRF_M_ENTRIES + k) * q + j*SIMD_WIDTH*CORES_PER_PCH; // Set the op2 index to the first lane of the SIMD
-                    for (p=0; p<SIMD_WIDTH*CORES_PER_PCH; p++) {
-                        if(WORD_BITS != 8)
+                    op2Idx = (ext_loops * SRF_M_ENTRIES + k) * q + j*SIMD_WIDTH*LOCKSTEP_CORES; // Set the op2 index to the first lane of the SIMD
+                    for (p=0; p<SIMD_WIDTH*LOCKSTEP_CORES; p++) {
+                        if (!CHAR_DATA)
                             dataFile << (op2Idx < (ext_loops*SRF_M_ENTRIES+k+1)*q ? op2[op2Idx++] : 0) << " ";
                         else 
                             dataFile << int(op2Idx < (ext_loops*SRF_M_ENTRIES+k+1)*q ? op2[op2Idx++] : 0) << " "; //need to cast the results for int8 only
@@ -225,11 +233,11 @@ void mapMatrixMultSrfCLim (ofstream &assembly, ofstream &dataFile, ofstream &add
     int crfSegment = CRF_ENTRIES - 4;
     crfSegment = min(crfSegment, SRF_M_ENTRIES);         // If segment is larger than SRF capacity, limit it to the latter
     int ext_loops = floor(float(n)/float(crfSegment));
-    int loops = ceil(float(q)/float(SIMD_WIDTH*CORES_PER_PCH)) ;
+    int loops = ceil(float(q)/float(SIMD_WIDTH*LOCKSTEP_CORES)) ;
     int ext_peeling = n % crfSegment;
-    uint64_t op2Base = ceil(float(m)*float(n)/float(SIMD_WIDTH*CORES_PER_PCH)/float(COLPERROW) / 2);          // Op2 will start in this row
-    uint64_t resBase = op2Base + ceil((n * ceil(float(q)/float(SIMD_WIDTH*CORES_PER_PCH))) / float(COLPERROW) / 2); // Result will start in this row
-    uint64_t zeroBase = resBase + ceil((m * ceil(float(q)/float(SIMD_WIDTH*CORES_PER_PCH))) / float(COLPERROW));    // Column fill with zeros, after the result
+    uint64_t op2Base = ceil(float(m)*float(n)/float(SIMD_WIDTH*LOCKSTEP_CORES)/float(COLPERROW) / 2);          // Op2 will start in this row
+    uint64_t resBase = op2Base + ceil((n * ceil(float(q)/float(SIMD_WIDTH*LOCKSTEP_CORES))) / float(COLPERROW) / 2); // Result will start in this row
+    uint64_t zeroBase = resBase + ceil((m * ceil(float(q)/float(SIMD_WIDTH*LOCKSTEP_CORES))) / float(COLPERROW));    // Column fill with zeros, after the result
     uint64_t rowIdx[2] = {op2Base,resBase};
     uint64_t colIdx[2] = {0,0};
     uint64_t op1Idx = 0;    // Index to run through matrix 1
@@ -256,46 +264,39 @@ void mapMatrixMultSrfCLim (ofstream &assembly, ofstream &dataFile, ofstream &add
         assembly << "EXIT" << endl;
 
         for (i=0; i<m*ext_loops; i++) {
-            for (j=0; j<crfSegment; j++) {   
-                assembly << "WRF SRFM" << j << " DataFile" << endl; // Weights
-            }
+            writeSrfMLoad(assembly, crfSegment);   // Weights
             assembly << "EXEC" << endl;
+#if CRF_DBUF
+            // The peeled program goes to the other CRF bank after the first EXEC, the assembler
+            // issues it with the next weights so that it is written while this bank executes
+            if (!i && ext_peeling)
+                writePeeledProgram(assembly, "CRFS0", ext_peeling, loops, false);
+#endif
         }
     }
 
     if (ext_peeling && ext_loops) {
         assembly << "; Peeled set of matrices" << endl;
+#if CRF_DBUF
+        assembly << "SWAP" << endl;     // Written to the other CRF bank along with the first weights
+#else
         assembly << "WRF CRF" << ext_peeling+1 << endl; // Move forward the MOV to BANK, JUMP and EXIT
         assembly << "MOV ODD_BANK[AddrFile] GRFB0" << endl;
         if (loops-1)
             assembly << "JUMP " << ext_peeling+2 << " " << loops-1 << endl;
         assembly << "EXIT" << endl;
+#endif
 
         for (i=0; i<m; i++) {
-            for (j=0; j<ext_peeling; j++) {   
-                assembly << "WRF SRFM" << j << " DataFile" << endl; // Weights
-            }
+            writeSrfMLoad(assembly, ext_peeling);   // Weights
             assembly << "EXEC" << endl;
         }
 
     } else if (ext_peeling) {
-        assembly << "WRF CRF0" << endl;
-        assembly << "MOV GRFB0 ODD_BANK[AddrFile] DataFile" << endl;
-        for (i=0; i<ext_peeling/2; i++) {
-            assembly << "MAC GRFB0 EVEN_BANK[AddrFile] SRFM" << 2*i << " DataFile" << endl;
-            assembly << "MAC GRFB0 ODD_BANK[AddrFile] SRFM" << 2*i+1 << " DataFile" << endl;
-        }
-        if (ext_peeling - 2*i)
-            assembly << "MAC GRFB0 EVEN_BANK[AddrFile] SRFM" << 2*i << " DataFile" << endl;
-        assembly << "MOV ODD_BANK[AddrFile] GRFB0" << endl;
-        if (loops-1)
-            assembly << "JUMP " << ext_peeling+2 << " " << loops-1 << endl;
-        assembly << "EXIT" << endl;
+        writePeeledProgram(assembly, "CRF0", ext_peeling, loops, true);
 
         for (i=0; i<m; i++) {
-            for (j=0; j<ext_peeling; j++) {   
-                assembly << "WRF SRFM" << j << " DataFile" << endl; // Weights
-            }
+            writeSrfMLoad(assembly, ext_peeling);   // Weights
             assembly << "EXEC" << endl;
         }
     }
@@ -310,28 +311,28 @@ void mapMatrixMultSrfCLim (ofstream &assembly, ofstream &dataFile, ofstream &add
             rowIdx[1] = curResRow;  colIdx[1] = curResCol;
             for (k=0; k<loops; k++) {
                 // (j * crfSegment * ceil(float(q)/float(SIMD_WIDTH)) + k) is # DRAM columns from op2 start to current
-                rowIdx[0] = op2Base + (j * crfSegment * int(ceil(float(q/2)/float(SIMD_WIDTH*CORES_PER_PCH))) + k) / COLPERROW;
-                colIdx[0] = (j * crfSegment * int(ceil(float(q/2)/float(SIMD_WIDTH*CORES_PER_PCH))) + k) % COLPERROW;
+                rowIdx[0] = op2Base + (j * crfSegment * int(ceil(float(q/2)/float(SIMD_WIDTH*LOCKSTEP_CORES))) + k) / COLPERROW;
+                colIdx[0] = (j * crfSegment * int(ceil(float(q/2)/float(SIMD_WIDTH*LOCKSTEP_CORES))) + k) % COLPERROW;
                 // MOV to GRF_B
-                addrFile << showbase << hex << (j ? build_addr({0,0,0,1,rowIdx[1],colIdx[1]}) : build_addr({0,0,0,1,zeroBase,0})) << endl;
+                addrFile << showbase << hex << (j ? build_addr({mapChannel,mapRank,mapBankGroup,1,rowIdx[1],colIdx[1]}) : build_addr({mapChannel,mapRank,mapBankGroup,1,zeroBase,0})) << endl;
                 // MACs
                 for (l=0; l<crfSegment/2; l++) {
-                    addrFile << showbase << hex << build_addr({0,0,0,0,rowIdx[0],colIdx[0]}) << endl;
-                    addrFile << showbase << hex << build_addr({0,0,0,1,rowIdx[0],colIdx[0]}) << endl;
+                    addrFile << showbase << hex << build_addr({mapChannel,mapRank,mapBankGroup,0,rowIdx[0],colIdx[0]}) << endl;
+                    addrFile << showbase << hex << build_addr({mapChannel,mapRank,mapBankGroup,1,rowIdx[0],colIdx[0]}) << endl;
                     //  ceil(float(q/2)/float(SIMD_WIDTH)) is the ammount of DRAM columns a op2 row takes
                     // / 2 because we use divide it in 2 banks
-                    rowIdx[0] += (colIdx[0] + int(ceil(float(q/2)/float(SIMD_WIDTH*CORES_PER_PCH)))) / COLPERROW;
-                    colIdx[0] = (colIdx[0] + int(ceil(float(q/2)/float(SIMD_WIDTH*CORES_PER_PCH)))) % COLPERROW;
+                    rowIdx[0] += (colIdx[0] + int(ceil(float(q/2)/float(SIMD_WIDTH*LOCKSTEP_CORES)))) / COLPERROW;
+                    colIdx[0] = (colIdx[0] + int(ceil(float(q/2)/float(SIMD_WIDTH*LOCKSTEP_CORES)))) % COLPERROW;
                 }
                 if (crfSegment % 2) {
-                    addrFile << showbase << hex << build_addr({0,0,0,0,rowIdx[0],colIdx[0]}) << endl;
+                    addrFile << showbase << hex << build_addr({mapChannel,mapRank,mapBankGroup,0,rowIdx[0],colIdx[0]}) << endl;
                     //  ceil(float(q/2)/float(SIMD_WIDTH)) is the ammount of DRAM columns a op2 row takes
                     // / 2 because we use divide it in 2 banks
-                    rowIdx[0] += (colIdx[0] + int(ceil(float(q/2)/float(SIMD_WIDTH*CORES_PER_PCH)))) / COLPERROW;
-                    colIdx[0] = (colIdx[0] + int(ceil(float(q/2)/float(SIMD_WIDTH*CORES_PER_PCH)))) % COLPERROW;
+                    rowIdx[0] += (colIdx[0] + int(ceil(float(q/2)/float(SIMD_WIDTH*LOCKSTEP_CORES)))) / COLPERROW;
+                    colIdx[0] = (colIdx[0] + int(ceil(float(q/2)/float(SIMD_WIDTH*LOCKSTEP_CORES)))) % COLPERROW;
                 }
                 // MOV to BANK
-                addrFile << showbase << hex << build_addr({0,0,0,1,rowIdx[1],colIdx[1]}) << endl;
+                addrFile << showbase << hex << build_addr({mapChannel,mapRank,mapBankGroup,1,rowIdx[1],colIdx[1]}) << endl;
                 if (++colIdx[1] == COLPERROW) {
                     colIdx[1] = 0;
                     rowIdx[1]++;
@@ -349,22 +350,23 @@ void mapMatrixMultSrfCLim (ofstream &assembly, ofstream &dataFile, ofstream &add
             for (k=0; k<loops; k++) {
                 // (j * crfSegment * ceil(float(q)/float(SIMD_WIDTH)) + k) is # DRAM columns from op2 start to current
                 rowIdx[0] = resBase + k / COLPERROW;
-                colIdx[0] = (j * crfSegment * int(ceil(float(q/2)/float(SIMD_WIDTH*CORES_PER_PCH))) + k) % COLPERROW;
-                // MOV to GRF_B
-                addrFile << showbase << hex << (ext_loops ? build_addr({0,0,0,1,rowIdx[1],colIdx[1]}) : build_addr({0,0,0,1,zeroBase,0})) << endl;
+                colIdx[0] = (j * crfSegment * int(ceil(float(q/2)/float(SIMD_WIDTH*LOCKSTEP_CORES))) + k) % COLPERROW;
+                // MOV partial result to GRF_B, filled with zeros otherwise
+                if (ext_loops)
+                    addrFile << showbase << hex << build_addr({mapChannel,mapRank,mapBankGroup,1,rowIdx[1],colIdx[1]}) << endl;
                 // MACs
                 for (l=0; l<ext_peeling/2; l++) {
-                    addrFile << showbase << hex << build_addr({0,0,0,0,rowIdx[0],colIdx[0]}) << endl;
-                    addrFile << showbase << hex << build_addr({0,0,0,1,rowIdx[0],colIdx[0]}) << endl;
+                    addrFile << showbase << hex << build_addr({mapChannel,mapRank,mapBankGroup,0,rowIdx[0],colIdx[0]}) << endl;
+                    addrFile << showbase << hex << build_addr({mapChannel,mapRank,mapBankGroup,1,rowIdx[0],colIdx[0]}) << endl;
                     //  ceil(float(q/2)/float(SIMD_WIDTH)) is the ammount of DRAM columns a op2 row takes
                     // / 2 because we use divide it in 2 banks
-                    rowIdx[0] += (colIdx[0] + int(ceil(float(q/2)/float(SIMD_WIDTH*CORES_PER_PCH)))) / COLPERROW;
-                    colIdx[0] = (colIdx[0] + int(ceil(float(q/2)/float(SIMD_WIDTH*CORES_PER_PCH)))) % COLPERROW;
+                    rowIdx[0] += (colIdx[0] + int(ceil(float(q/2)/float(SIMD_WIDTH*LOCKSTEP_CORES)))) / COLPERROW;
+                    colIdx[0] = (colIdx[0] + int(ceil(float(q/2)/float(SIMD_WIDTH*LOCKSTEP_CORES)))) % COLPERROW;
                 }
                 if (ext_peeling - 2*l)  // If n it's odd, last one is only with EVEN_BANK
-                    addrFile << showbase << hex << build_addr({0,0,0,0,rowIdx[0],colIdx[0]}) << endl;
+                    addrFile << showbase << hex << build_addr({mapChannel,mapRank,mapBankGroup,0,rowIdx[0],colIdx[0]}) << endl;
                 // MOV to BANK
-                addrFile << showbase << hex << build_addr({0,0,0,1,rowIdx[1],colIdx[1]}) << endl;
+                addrFile << showbase << hex << build_addr({mapChannel,mapRank,mapBankGroup,1,rowIdx[1],colIdx[1]}) << endl;
                 if (++colIdx[1] == COLPERROW) {
                     colIdx[1] = 0;
                     rowIdx[1]++;
@@ -380,16 +382,11 @@ void mapMatrixMultSrfCLim (ofstream &assembly, ofstream &dataFile, ofstream &add
         op1Idx = i*n;   // Set the op1 index to the start of the row (to jump over the peeled part)
         for (j=0; j<ext_loops; j++) {
             // Move the op1 to the SRF
-            for (k=0; k<crfSegment; k++) {
-                if(WORD_BITS != 8)
-                    dataFile << op1[op1Idx++] << endl;
-                else
-                    dataFile << int(op1[op1Idx++]) << endl; //need to cast the results for int8 only
-            }
+            writeSrfMData(dataFile, op1, &op1Idx, crfSegment);
             for (k=0; k<loops; k++) {
                 // Move 0 or partial result to GRFB (0 if starting to accumulate a result or if out of bounds)
-                for (l=0; l<SIMD_WIDTH*CORES_PER_PCH; l++) {
-                    if(WORD_BITS != 8)
+                for (l=0; l<SIMD_WIDTH*LOCKSTEP_CORES; l++) {
+                    if (!CHAR_DATA)
                         dataFile << (j && (k*SIMD_WIDTH+l<q) ? partMatMultDP(op1, op2, m, n, q, i, k*SIMD_WIDTH+l, j*crfSegment) : 0) << " ";
                     else
                         dataFile << int(j && (k*SIMD_WIDTH+l<q) ? partMatMultDP(op1, op2, m, n, q, i, k*SIMD_WIDTH+l, j*crfSegment) : 0) << " "; //need to cast the results for int8 only
@@ -397,9 +394,9 @@ void mapMatrixMultSrfCLim (ofstream &assembly, ofstream &dataFile, ofstream &add
                 dataFile << endl;
                 // Run through op2 for MAC
                 for (l=0; l<crfSegment; l++) {
-                    op2Idx = (j * crfSegment + l) * q + k*SIMD_WIDTH*CORES_PER_PCH; // Set the op2 index to the first lane of the SIMD
-                    for (p=0; p<SIMD_WIDTH*CORES_PER_PCH; p++) {
-                        if(WORD_BITS != 8)
+                    op2Idx = (j * crfSegment + l) * q + k*SIMD_WIDTH*LOCKSTEP_CORES; // Set the op2 index to the first lane of the SIMD
+                    for (p=0; p<SIMD_WIDTH*LOCKSTEP_CORES; p++) {
+                        if (!CHAR_DATA)
                             dataFile << (op2Idx < (j*crfSegment+l+1)*q ? op2[op2Idx++] : 0) << " ";
                         else
                             dataFile << int(op2Idx < (j*crfSegment+l+1)*q ? op2[op2Idx++] : 0) << " "; //need to cast the results for int8 only
@@ -415,29 +412,327 @@ void mapMatrixMultSrfCLim (ofstream &assembly, ofstream &dataFile, ofstream &add
         for (i=0; i<m; i++) {
             op1Idx = i*n+ext_loops*crfSegment;   // Set the op1 index to the start of the row (to jump over the peeled part)
             // Move the op1 to the SRF
-            for (j=0; j<ext_peeling; j++) {
-                if(WORD_BITS != 8)
-                    dataFile << op1[op1Idx++] << endl;
-                else 
-                    dataFile << int(op1[op1Idx++]) << endl; //need to cast the results for int8 only
-            }
+            writeSrfMData(dataFile, op1, &op1Idx, ext_peeling);
             for (j=0; j<loops; j++) {
+                // Move partial result to GRFB (0 if out of bounds), filled with zeros if starting to accumulate
+                if (ext_loops) {
+                    for (k=0; k<SIMD_WIDTH*LOCKSTEP_CORES; k++) {
+                        if (!CHAR_DATA)
+                            dataFile << ((j*SIMD_WIDTH+k<q) ? partMatMultDP(op1, op2, m, n, q, i, j*SIMD_WIDTH+k, ext_loops*crfSegment) : 0) << " ";
+                        else
+                            dataFile << int((j*SIMD_WIDTH+k<q) ? partMatMultDP(op1, op2, m, n, q, i, j*SIMD_WIDTH+k, ext_loops*crfSegment) : 0) << " "; //need to cast the results for int8 only
+                    }
+                    dataFile << endl;
+                }
+                // Run through op2 for MAC
+                for (k=0; k<ext_peeling; k++) {
+                    op2Idx = (ext_loops * crfSegment + k) * q + j*SIMD_WIDTH*LOCKSTEP_CORES; // Set the op2 index to the first lane of the SIMD
+                    for (p=0; p<SIMD_WIDTH*LOCKSTEP_CORES; p++) {
+                        if (!CHAR_DATA)
+                            dataFile << (op2Idx < (ext_loops*crfSegment+k+1)*q ? op2[op2Idx++] : 0) << " ";
+                        else
+                            dataFile << int(op2Idx < (ext_loops*crfSegment+k+1)*q ? op2[op2Idx++] : 0) << " "; //need to cast the results for int8 only
+                    }
+                    dataFile << endl;
+                }
+            }
+        }
+    }
+}
+
+void mapMatrixMultBankRLim (ofstream &assembly, ofstream &dataFile, ofstream &addrFile,
+                                cnm_t *op1, cnm_t *op2, int m, int n, int q)
+{
+    int i,j,k,l,p,e;
+    int ext_loops = floor(float(n)/float(SRF_M_ENTRIES));
+    int loops = ceil(float(q)/float(SIMD_WIDTH*LOCKSTEP_CORES)) ;
+    int ext_peeling = n % SRF_M_ENTRIES;
+    int sets = ext_loops + (ext_peeling ? 1 : 0);                           // Sets of SRF_M weights per row of op1
+    int loads = ceil(float(SRF_M_ENTRIES)/float(SRF_M_PACK));               // Even bank columns loaded per set of weights
+    uint64_t op2Base = ceil(float(m*sets*loads)/float(COLPERROW));          // Op2 will start in this row, op1 takes lanes 0 to SRF_M_PACK-1 of every column before
+    uint64_t resBase = op2Base + ceil((n * ceil(float(q)/float(SIMD_WIDTH))) / float(COLPERROW*LOCKSTEP_CORES) / 2); // Result will start in this row
+    uint64_t zeroBase = resBase + ceil((m * ceil(float(q)/float(SIMD_WIDTH))) / float(COLPERROW*LOCKSTEP_CORES));    // Column fill with zeros, after the result
+    uint64_t rowIdx[2] = {op2Base,resBase};
+    uint64_t colIdx[2] = {0,0};
+    uint64_t op1Col;        // Even bank column of the current set of weights
+    uint64_t op1Idx = 0;    // Index to run through matrix 1
+    uint64_t op2Idx = 0;    // Index to run through matrix 2
+    uint64_t curResRow, curResCol;  // Hold the indeces of the results being written in every external iteration
+
+    // Write assembly instructions, the weights are loaded from the even bank at the start of every EXEC
+    assembly << "; Mapping of matrix multiplication with the weights in the banks, R-limited, mxn * nxq, m = ";
+    assembly << m << ", n = " << n << ", q = " << q << endl;
+
+    if (ext_loops) {
+        assembly << "WRF CRF0" << endl;
+        for (e=0; e<loads; e++)
+            assembly << "MOV SRFMP" << e*SRF_M_PACK << " EVEN_BANK[AddrFile] DataFile" << endl;
+        assembly << "MOV GRFB0 ODD_BANK[AddrFile] DataFile" << endl;
+        for (i=0; i<SRF_M_ENTRIES/2; i++) {
+            assembly << "MAC GRFB0 EVEN_BANK[AddrFile] SRFM" << 2*i << " DataFile" << endl;
+            assembly << "MAC GRFB0 ODD_BANK[AddrFile] SRFM" << 2*i+1 << " DataFile" << endl;
+        }
+        assembly << "MOV ODD_BANK[AddrFile] GRFB0" << endl;
+        if (loops-1)
+            assembly << "JUMP " << SRF_M_ENTRIES+2 << " " << loops-1 << endl;
+        assembly << "EXIT" << endl;
+
+        for (i=0; i<m*ext_loops; i++)
+            assembly << "EXEC" << endl;
+    }
+
+    if (ext_peeling && ext_loops) {
+        assembly << "; Peeled set of matrices" << endl;
+        assembly << "WRF CRF" << loads+ext_peeling+1 << endl; // Move forward the MOV to BANK, JUMP and EXIT
+        assembly << "MOV ODD_BANK[AddrFile] GRFB0" << endl;
+        if (loops-1)
+            assembly << "JUMP " << ext_peeling+2 << " " << loops-1 << endl;
+        assembly << "EXIT" << endl;
+
+        for (i=0; i<m; i++)
+            assembly << "EXEC" << endl;
+
+    } else if (ext_peeling) {
+        assembly << "WRF CRF0" << endl;
+        for (e=0; e<loads; e++)
+            assembly << "MOV SRFMP" << e*SRF_M_PACK << " EVEN_BANK[AddrFile] DataFile" << endl;
+        assembly << "FILL GRFB0 0" << endl;
+        for (i=0; i<ext_peeling/2; i++) {
+            assembly << "MAC GRFB0 EVEN_BANK[AddrFile] SRFM" << 2*i << " DataFile" << endl;
+            assembly << "MAC GRFB0 ODD_BANK[AddrFile] SRFM" << 2*i+1 << " DataFile" << endl;
+        }
+        if (ext_peeling - 2*i)
+            assembly << "MAC GRFB0 EVEN_BANK[AddrFile] SRFM" << 2*i << " DataFile" << endl;
+        assembly << "MOV ODD_BANK[AddrFile] GRFB0" << endl;
+        if (loops-1)
+            assembly << "JUMP " << ext_peeling+2 << " " << loops-1 << endl;
+        assembly << "EXIT" << endl;
+
+        for (i=0; i<m; i++)
+            assembly << "EXEC" << endl;
+    }
+
+    // Write address for loops and others
+    addrFile << "# Mapping of matrix multiplication with the weights in the banks, R-limited, mxn * nxq, m = ";
+    addrFile << m << ", n = " << n << ", q = " << q << endl;
+    for (i=0; i<m; i++) {
+        curResRow = rowIdx[1];  curResCol = colIdx[1];  // Store indeces for accumulating at every ext iteration
+        for (j=0; j<ext_loops; j++) {
+            rowIdx[1] = curResRow;  colIdx[1] = curResCol;
+            // Weights to the SRF
+            for (e=0; e<loads; e++) {
+                op1Col = (i*sets + j)*loads + e;
+                addrFile << showbase << hex << build_addr({mapChannel,mapRank,mapBankGroup,0,op1Col/COLPERROW,op1Col%COLPERROW}) << endl;
+            }
+            for (k=0; k<loops; k++) {
+                rowIdx[0] = op2Base + (j * SRF_M_ENTRIES * int(ceil(float(q/2)/float(SIMD_WIDTH*LOCKSTEP_CORES))) + k) / COLPERROW;
+                colIdx[0] = (j * SRF_M_ENTRIES * int(ceil(float(q/2)/float(SIMD_WIDTH*LOCKSTEP_CORES))) + k) % COLPERROW;
+                // MOV to GRF_B
+                addrFile << showbase << hex << (j ? build_addr({mapChannel,mapRank,mapBankGroup,1,rowIdx[1],colIdx[1]}) : build_addr({mapChannel,mapRank,mapBankGroup,1,zeroBase,0})) << endl;
+                // MACs
+                for (l=0; l<SRF_M_ENTRIES/2; l++) {
+                    addrFile << showbase << hex << build_addr({mapChannel,mapRank,mapBankGroup,0,rowIdx[0],colIdx[0]}) << endl;
+                    addrFile << showbase << hex << build_addr({mapChannel,mapRank,mapBankGroup,1,rowIdx[0],colIdx[0]}) << endl;
+                    rowIdx[0] += (colIdx[0] + int(ceil(float(q/2)/float(SIMD_WIDTH*LOCKSTEP_CORES)))) / COLPERROW;
+                    colIdx[0] = (colIdx[0] + int(ceil(float(q/2)/float(SIMD_WIDTH*LOCKSTEP_CORES)))) % COLPERROW;
+                }
+                // MOV to BANK
+                addrFile << showbase << hex << build_addr({mapChannel,mapRank,mapBankGroup,1,rowIdx[1],colIdx[1]}) << endl;
+                if (++colIdx[1] == COLPERROW) {
+                    colIdx[1] = 0;
+                    rowIdx[1]++;
+                }
+            }
+        }
+    }
+
+    if (ext_peeling) {
+        addrFile << "# Peeled set of the matrices" << endl;
+        // Go back to first results to continue accumulating
+        rowIdx[1] = resBase;        colIdx[1] = 0;
+
+        for (i=0; i<m; i++) {
+            // Weights to the SRF
+            for (e=0; e<loads; e++) {
+                op1Col = (i*sets + ext_loops)*loads + e;
+                addrFile << showbase << hex << build_addr({mapChannel,mapRank,mapBankGroup,0,op1Col/COLPERROW,op1Col%COLPERROW}) << endl;
+            }
+            for (k=0; k<loops; k++) {
+                rowIdx[0] = op2Base + (ext_loops * SRF_M_ENTRIES * int(ceil(float(q/2)/float(SIMD_WIDTH*LOCKSTEP_CORES))) + k) / COLPERROW;
+                colIdx[0] = (ext_loops * SRF_M_ENTRIES * int(ceil(float(q/2)/float(SIMD_WIDTH*LOCKSTEP_CORES))) + k) % COLPERROW;
+                // MOV partial result to GRF_B, filled with zeros otherwise
+                if (ext_loops)
+                    addrFile << showbase << hex << build_addr({mapChannel,mapRank,mapBankGroup,1,rowIdx[1],colIdx[1]}) << endl;
+                // MACs
+                for (l=0; l<ext_peeling/2; l++) {
+                    addrFile << showbase << hex << build_addr({mapChannel,mapRank,mapBankGroup,0,rowIdx[0],colIdx[0]}) << endl;
+                    addrFile << showbase << hex << build_addr({mapChannel,mapRank,mapBankGroup,1,rowIdx[0],colIdx[0]}) << endl;
+                    rowIdx[0] += (colIdx[0] + int(ceil(float(q/2)/float(SIMD_WIDTH*LOCKSTEP_CORES)))) / COLPERROW;
+                    colIdx[0] = (colIdx[0] + int(ceil(float(q/2)/float(SIMD_WIDTH*LOCKSTEP_CORES)))) % COLPERROW;
+                }
+                if (ext_peeling - 2*l)  // If n it's odd, last one is only with EVEN_BANK
+                    addrFile << showbase << hex << build_addr({mapChannel,mapRank,mapBankGroup,0,rowIdx[0],colIdx[0]}) << endl;
+                // MOV to BANK
+                addrFile << showbase << hex << build_addr({mapChannel,mapRank,mapBankGroup,1,rowIdx[1],colIdx[1]}) << endl;
+                if (++colIdx[1] == COLPERROW) {
+                    colIdx[1] = 0;
+                    rowIdx[1]++;
+                }
+            }
+        }
+    }
+
+    // Write data for loops and others
+    dataFile << "# Mapping of matrix multiplication with the weights in the banks, R-limited, mxn * nxq, m = ";
+    dataFile << m << ", n = " << n << ", q = " << q << endl;
+    for (i=0; i<m; i++) {
+        for (j=0; j<ext_loops; j++) {
+            op1Idx = i*n + j*SRF_M_ENTRIES;
+            writeSrfMBankData(dataFile, op1, &op1Idx, SRF_M_ENTRIES);
+            for (k=0; k<loops; k++) {
                 // Move 0 or partial result to GRFB (0 if starting to accumulate a result or if out of bounds)
-                for (k=0; k<SIMD_WIDTH*CORES_PER_PCH; k++) {
-                    if(WORD_BITS != 8)
-                        dataFile << (ext_loops && (j*SIMD_WIDTH+k<q) ? partMatMultDP(op1, op2, m, n, q, i, j*SIMD_WIDTH+k, ext_loops*crfSegment) : 0) << " ";
+                for (l=0; l<SIMD_WIDTH*LOCKSTEP_CORES; l++) {
+                    if (!CHAR_DATA)
+                        dataFile << (j && (k*SIMD_WIDTH+l<q) ? partMatMultDP(op1, op2, m, n, q, i, k*SIMD_WIDTH+l, j*SRF_M_ENTRIES) : 0) << " ";
                     else
-                        dataFile << int(ext_loops && (j*SIMD_WIDTH+k<q) ? partMatMultDP(op1, op2, m, n, q, i, j*SIMD_WIDTH+k, ext_loops*crfSegment) : 0) << " "; //need to cast the results for int8 only
+                        dataFile << int(j && (k*SIMD_WIDTH+l<q) ? partMatMultDP(op1, op2, m, n, q, i, k*SIMD_WIDTH+l, j*SRF_M_ENTRIES) : 0) << " "; //need to cast the results for int8 only
                 }
                 dataFile << endl;
                 // Run through op2 for MAC
+                for (l=0; l<SRF_M_ENTRIES; l++) {
+                    op2Idx = (j * SRF_M_ENTRIES + l) * q + k*SIMD_WIDTH*LOCKSTEP_CORES; // Set the op2 index to the first lane of the SIMD
+                    for (p=0; p<SIMD_WIDTH*LOCKSTEP_CORES; p++) {
+                        if (!CHAR_DATA)
+                            dataFile << (op2Idx < (j*SRF_M_ENTRIES+l+1)*q ? op2[op2Idx++] : 0) << " ";
+                        else
+                            dataFile << int(op2Idx < (j*SRF_M_ENTRIES+l+1)*q ? op2[op2Idx++] : 0) << " "; //need to cast the results for int8 only
+                    }
+                    dataFile << endl;
+                }
+            }
+        }
+    }
+
+    if (ext_peeling) {
+        dataFile << "# Peeled set of the matrices" << endl;
+        for (i=0; i<m; i++) {
+            op1Idx = i*n+ext_loops*SRF_M_ENTRIES;   // Set the op1 index to the start of the peeled part of the row
+            writeSrfMBankData(dataFile, op1, &op1Idx, ext_peeling);
+            for (j=0; j<loops; j++) {
+                // Move partial result to GRFB (0 if out of bounds), filled with zeros if starting to accumulate
+                if (ext_loops) {
+                    for (k=0; k<SIMD_WIDTH*LOCKSTEP_CORES; k++) {
+                        if (!CHAR_DATA)
+                            dataFile << ((j*SIMD_WIDTH+k<q) ? partMatMultDP(op1, op2, m, n, q, i, j*SIMD_WIDTH+k, ext_loops*SRF_M_ENTRIES) : 0) << " ";
+                        else
+                            dataFile << int((j*SIMD_WIDTH+k<q) ? partMatMultDP(op1, op2, m, n, q, i, j*SIMD_WIDTH+k, ext_loops*SRF_M_ENTRIES) : 0) << " "; //need to cast the results for int8 only
+                    }
+                    dataFile << endl;
+                }
+                // Run through op2 for MAC
                 for (k=0; k<ext_peeling; k++) {
-                    op2Idx = (ext_loops * crfSegment + k) * q + j*SIMD_WIDTH*CORES_PER_PCH; // Set the op2 index to the first lane of the SIMD
-                    for (p=0; p<SIMD_WIDTH*CORES_PER_PCH; p++) {
-                        if(WORD_BITS != 8)
-                            dataFile << (op2Idx < (ext_loops*crfSegment+k+1)*q ? op2[op2Idx++] : 0) << " ";
+                    op2Idx = (ext_loops * SRF_M_ENTRIES + k) * q + j*SIMD_WIDTH*LOCKSTEP_CORES; // Set the op2 index to the first lane of the SIMD
+                    for (p=0; p<SIMD_WIDTH*LOCKSTEP_CORES; p++) {
+                        if (!CHAR_DATA)
+                            dataFile << (op2Idx < (ext_loops*SRF_M_ENTRIES+k+1)*q ? op2[op2Idx++] : 0) << " ";
                         else
-                            dataFile << int(op2Idx < (ext_loops*crfSegment+k+1)*q ? op2[op2Idx++] : 0) << " "; //need to cast the results for int8 only
+                            dataFile << int(op2Idx < (ext_loops*SRF_M_ENTRIES+k+1)*q ? op2[op2Idx++] : 0) << " "; //need to cast the results for int8 only
+                    }
+                    dataFile << endl;
+                }
+            }
+        }
+    }
+}
+
+// Address of the linear column idx of a region of bank (0 even, 1 odd) starting at row base
+static uint64_t regionAddr(uint64_t bank, uint64_t base, uint64_t idx)
+{
+    return build_addr({mapChannel,mapRank,mapBankGroup,bank,base + idx/COLPERROW,idx%COLPERROW});
+}
+
+void mapMatrixMultCoreRows (ofstream &assembly, ofstream &dataFile, ofstream &addrFile,
+                                cnm_t *op1, cnm_t *op2, int m, int n, int q)
+{
+    int i,j,k,l,c,t,r;
+    int segs = ceil(float(n)/float(SRF_M_ENTRIES));             // Segments of the op1 rows held by the SRF
+    int groups = ceil(float(m)/float(LOCKSTEP_CORES));          // Rows of op1 computed at once, one per core
+    int loops = ceil(float(q)/float(SIMD_WIDTH));               // Columns of every core to run through
+    int len;
+    uint64_t resBase = ceil(ceil(float(n)/2) * loops / float(COLPERROW));  // Op2 rows alternate between the banks
+    uint64_t op1Idx;
+    vector<cnm_t> zeros(SRF_M_ENTRIES, cnm_t(0));              // SRF_M of the cores past the last row
+
+    // Write assembly instructions
+    assembly << "; Mapping of matrix multiplication with a row of op1 per core, mxn * nxq, m = ";
+    assembly << m << ", n = " << n << ", q = " << q << endl;
+    for (j=0; j<segs; j++) {
+        len = min(SRF_M_ENTRIES, n - j*SRF_M_ENTRIES);
+        // The first segment starts from zero, the rest accumulate into the result, the last one may be shorter
+        if (j < 2 || len < SRF_M_ENTRIES)
+            writePeeledProgram(assembly, "CRF0", len, loops, !j);
+        for (i=0; i<groups; i++) {
+            // Every core gets the segment of its own row, written only to it
+            for (c=0; c<LOCKSTEP_CORES; c++)
+                writeSrfMLoad(assembly, len, mapBankGroup*LOCKSTEP_CORES + c);
+            assembly << "EXEC" << endl;
+        }
+    }
+
+    // Write address for loops and others
+    addrFile << "# Mapping of matrix multiplication with a row of op1 per core, mxn * nxq, m = ";
+    addrFile << m << ", n = " << n << ", q = " << q << endl;
+    for (j=0; j<segs; j++) {
+        len = min(SRF_M_ENTRIES, n - j*SRF_M_ENTRIES);
+        for (i=0; i<groups; i++) {
+            for (t=0; t<loops; t++) {
+                // MOV to GRF_B
+                if (j)
+                    addrFile << showbase << hex << regionAddr(1, resBase, i*loops + t) << endl;
+                // MACs, the even rows of op2 in the even bank and the odd ones in the odd bank
+                for (k=j*SRF_M_ENTRIES; k<j*SRF_M_ENTRIES+len; k++)
+                    addrFile << showbase << hex << regionAddr(k%2, 0, (k/2)*loops + t) << endl;
+                // MOV to BANK
+                addrFile << showbase << hex << regionAddr(1, resBase, i*loops + t) << endl;
+            }
+        }
+    }
+
+    // Write data for loops and others, the lanes of every core follow those of the previous one
+    dataFile << "# Mapping of matrix multiplication with a row of op1 per core, mxn * nxq, m = ";
+    dataFile << m << ", n = " << n << ", q = " << q << endl;
+    for (j=0; j<segs; j++) {
+        len = min(SRF_M_ENTRIES, n - j*SRF_M_ENTRIES);
+        for (i=0; i<groups; i++) {
+            // Move the op1 segments to the SRF of every core
+            for (c=0; c<LOCKSTEP_CORES; c++) {
+                r = i*LOCKSTEP_CORES + c;
+                op1Idx = r < m ? r*n + j*SRF_M_ENTRIES : 0;
+                writeSrfMData(dataFile, r < m ? op1 : zeros.data(), &op1Idx, len);
+            }
+            for (t=0; t<loops; t++) {
+                // Move the partial result of every core to GRFB (0 if out of bounds)
+                if (j) {
+                    for (c=0; c<LOCKSTEP_CORES; c++) {
+                        r = i*LOCKSTEP_CORES + c;
+                        for (l=t*SIMD_WIDTH; l<(t+1)*SIMD_WIDTH; l++) {
+                            if (!CHAR_DATA)
+                                dataFile << (r<m && l<q ? partMatMultDP(op1, op2, m, n, q, r, l, j*SRF_M_ENTRIES) : 0) << " ";
+                            else
+                                dataFile << int(r<m && l<q ? partMatMultDP(op1, op2, m, n, q, r, l, j*SRF_M_ENTRIES) : 0) << " "; //need to cast the results for int8 only
+                        }
+                    }
+                    dataFile << endl;
+                }
+                // Run through op2 for MAC, the same columns in every core
+                for (k=j*SRF_M_ENTRIES; k<j*SRF_M_ENTRIES+len; k++) {
+                    for (c=0; c<LOCKSTEP_CORES; c++) {
+                        for (l=t*SIMD_WIDTH; l<(t+1)*SIMD_WIDTH; l++) {
+                            if (!CHAR_DATA)
+                                dataFile << (l<q ? op2[k*q+l] : 0) << " ";
+                            else
+                                dataFile << int(l<q ? op2[k*q+l] : 0) << " "; //need to cast the results for int8 only
+                        }
                     }
                     dataFile << endl;
                 }
@@ -446,12 +741,12 @@ void mapMatrixMultSrfCLim (ofstream &assembly, ofstream &dataFile, ofstream &add
     }
 }
 
-#if (HALF_FLOAT)
+#if (NARROW_FLOAT)
 
 float partMatMultDP(float *op1, float *op2, int m, int n, int q, int rowOp1, int colOp2, int len) {
-    half_float::half res = half_float::half_cast<half_float::half>(0);
+    cnm_narrow_t res = cnm_narrow_t(0);
     for (int i=0; i<len; i++) {
-        res += half_float::half_cast<half_float::half>(op1[rowOp1*n+i]) * half_float::half_cast<half_float::half>(op2[i*q+colOp2]);
+        res += cnm_narrow_t(op1[rowOp1*n+i]) * cnm_narrow_t(op2[i*q+colOp2]);
     }
     return float(res);
 }
@@ -17,7 +17,16 @@ void mapMatrixMultSrfRLim (ofstream &assembly, ofstream &dataFile, ofstream &add
 void mapMatrixMultSrfCLim (ofstream &assembly, ofstream &dataFile, ofstream &addrFile,
                                 cnm_t *op1, cnm_t *op2, int m, int n, int q);
 
-#if (HALF_FLOAT)
+// Mapping of matrix multriplication keeping the weights in the banks and loading them to the SRF, R-limited
+void mapMatrixMultBankRLim (ofstream &assembly, ofstream &dataFile, ofstream &addrFile,
+                                cnm_t *op1, cnm_t *op2, int m, int n, int q);
+
+// Mapping of matrix multiplication with every lockstep core computing a different row of the first matrix,
+// which is written to the SRF of each core alone (needs UNICAST_RF)
+void mapMatrixMultCoreRows (ofstream &assembly, ofstream &dataFile, ofstream &addrFile,
+                                cnm_t *op1, cnm_t *op2, int m, int n, int q);
+
+#if (NARROW_FLOAT)
 
 // Function for computing a partial dot product within a matrix multiplication
 float partMatMultDP(float *op1, float *op2, int m, int n, int q, int rowOp1, int colOp2, int len);
@@ -27,6 +36,6 @@ float partMatMultDP(float *op1, float *op2, int m, int n, int q, int rowOp1, int
 // Function for computing a partial dot product within a matrix multiplication
 cnm_t partMatMultDP(cnm_t *op1, cnm_t *op2, int m, int n, int q, int rowOp1, int colOp2, int len);
 
-#endif  // HALF_FLOAT
+#endif  // NARROW_FLOAT
 
 #endif  // MAP_MM_H
@@ -1,14 +1,45 @@
 #include "map_va.h"
 
+// Loads, adds, scales and stores cols columns of both operands. The MUL of every column can be
+// issued along with the ADD of the next one, into the other GRF, with DUAL_ISSUE
+static void writeAddScaleBody (ofstream &assembly, int cols)
+{
+    int i;
+
+    for (i=0; i<cols; i++) {
+        assembly << "MOV GRFA" << i << " EVEN_BANK[AddrFile] DataFile" << endl;
+        assembly << "MOV GRFB" << i << " ODD_BANK[AddrFile] DataFile" << endl;
+    }
+    for (i=0; i<cols; i++)
+        assembly << "ADD GRFA" << i << " GRFA" << i << " GRFB" << i << endl;
+    for (i=0; i<cols; i++)
+        assembly << "MUL GRFB" << i << " GRFA" << i << " SRFM0" << endl;
+    for (i=0; i<cols; i++)
+        assembly << "MOV ODD_BANK[AddrFile] GRFB" << i << endl;
+}
+
+// Data of the column col of an operand mapped row-wise, zero past its last element
+static void writeRowWiseColumn (ofstream &dataFile, cnm_t **op, int col, int V, int n)
+{
+    for (int k=0; k<SIMD_WIDTH*LOCKSTEP_CORES; k++) {
+        int e = col*SIMD_WIDTH*LOCKSTEP_CORES + k;
+        cnm_t val = e < n*V ? op[e/n][e%n] : cnm_t(0);
+        if (!CHAR_DATA)
+            dataFile << val << " ";
+        else
+            dataFile << int(val) << " "; //need to cast the results for int8 only
+    }
+}
+
 void mapEWAdditionRowWiseRLim (ofstream &assembly, ofstream &dataFile, ofstream &addrFile,
                                 cnm_t **op1, cnm_t **op2, int V, int n)
 {
     int i,j,k;
-    int loops = floor(ceil(float(n*V)/float(SIMD_WIDTH*CORES_PER_PCH))/(2*GRF_ENTRIES));
-    int peeling = int(ceil(float(n*V)/float(SIMD_WIDTH*CORES_PER_PCH))) % (2*GRF_ENTRIES);
+    int loops = floor(ceil(float(n*V)/float(SIMD_WIDTH*LOCKSTEP_CORES))/(2*GRF_ENTRIES));
+    int peeling = int(ceil(float(n*V)/float(SIMD_WIDTH*LOCKSTEP_CORES))) % (2*GRF_ENTRIES);
     int totalCol = ceil((float(n*V)/2.0)/float(SIMD_WIDTH));                    // Div 2 because distributed in 2 banks
-    uint64_t op2Base = ceil(float(totalCol)/float(COLPERROW*CORES_PER_PCH));    // Op2 will start in this row. Take into account parallel bank access within pCH.
-    uint64_t resBase = op2Base + ceil(float(totalCol)/float(COLPERROW*CORES_PER_PCH));  // Result will start in this row
+    uint64_t op2Base = ceil(float(totalCol)/float(COLPERROW*LOCKSTEP_CORES));    // Op2 will start in this row. Take into account parallel bank access within pCH.
+    uint64_t resBase = op2Base + ceil(float(totalCol)/float(COLPERROW*LOCKSTEP_CORES));  // Result will start in this row
     uint64_t rowIdx[3] = {0,op2Base,resBase};
     uint64_t colIdx[3] = {0,0,0};
     int nIdx[2] = {0,0};
@@ -63,8 +94,8 @@ void mapEWAdditionRowWiseRLim (ofstream &assembly, ofstream &dataFile, ofstream
     for (i=0; i<loops; i++) {
         for (j=0; j<GRF_ENTRIES; j++){
             // MOVs to GRFs
-            addrFile << showbase << hex << build_addr({0,0,0,0,rowIdx[0],colIdx[0]}) << endl;
-            addrFile << showbase << hex << build_addr({0,0,0,1,rowIdx[0],colIdx[0]}) << endl;
+            addrFile << showbase << hex << build_addr({mapChannel,mapRank,mapBankGroup,0,rowIdx[0],colIdx[0]}) << endl;
+            addrFile << showbase << hex << build_addr({mapChannel,mapRank,mapBankGroup,1,rowIdx[0],colIdx[0]}) << endl;
             if (++colIdx[0] == COLPERROW) {
                 colIdx[0] = 0;
                 rowIdx[0]++;
@@ -72,8 +103,8 @@ void mapEWAdditionRowWiseRLim (ofstream &assembly, ofstream &dataFile, ofstream
         }
         for (j=0; j<GRF_ENTRIES; j++){
             // ALU ops
-            addrFile << showbase << hex << build_addr({0,0,0,0,rowIdx[1],colIdx[1]}) << endl;
-            addrFile << showbase << hex << build_addr({0,0,0,1,rowIdx[1],colIdx[1]}) << endl;
+            addrFile << showbase << hex << build_addr({mapChannel,mapRank,mapBankGroup,0,rowIdx[1],colIdx[1]}) << endl;
+            addrFile << showbase << hex << build_addr({mapChannel,mapRank,mapBankGroup,1,rowIdx[1],colIdx[1]}) << endl;
             if (++colIdx[1] == COLPERROW) {
                 colIdx[1] = 0;
                 rowIdx[1]++;
@@ -81,8 +112,8 @@ void mapEWAdditionRowWiseRLim (ofstream &assembly, ofstream &dataFile, ofstream
         }
         for (j=0; j<GRF_ENTRIES; j++){
             // MOVs to BANKs
-            addrFile << showbase << hex << build_addr({0,0,0,0,rowIdx[2],colIdx[2]}) << endl;
-            addrFile << showbase << hex << build_addr({0,0,0,1,rowIdx[2],colIdx[2]}) << endl;
+            addrFile << showbase << hex << build_addr({mapChannel,mapRank,mapBankGroup,0,rowIdx[2],colIdx[2]}) << endl;
+            addrFile << showbase << hex << build_addr({mapChannel,mapRank,mapBankGroup,1,rowIdx[2],colIdx[2]}) << endl;
             if (++colIdx[2] == COLPERROW) {
                 colIdx[2] = 0;
                 rowIdx[2]++;
@@ -94,37 +125,37 @@ void mapEWAdditionRowWiseRLim (ofstream &assembly, ofstream &dataFile, ofstream
         addrFile << "# Out of the main loop" << endl;
         for (i=0; i<peeling/2; i++) {
             // MOVs to GRFs
-            addrFile << showbase << hex << build_addr({0,0,0,0,rowIdx[0],colIdx[0]}) << endl;
-            addrFile << showbase << hex << build_addr({0,0,0,1,rowIdx[0],colIdx[0]}) << endl;
+            addrFile << showbase << hex << build_addr({mapChannel,mapRank,mapBankGroup,0,rowIdx[0],colIdx[0]}) << endl;
+            addrFile << showbase << hex << build_addr({mapChannel,mapRank,mapBankGroup,1,rowIdx[0],colIdx[0]}) << endl;
             if (++colIdx[0] == COLPERROW) {
                 colIdx[0] = 0;
                 rowIdx[0]++;
             }
         }
         if (peeling - 2*i)  // If n*V it's odd, last one is only with GRF
-            addrFile << showbase << hex << build_addr({0,0,0,0,rowIdx[0],colIdx[0]}) << endl;
+            addrFile << showbase << hex << build_addr({mapChannel,mapRank,mapBankGroup,0,rowIdx[0],colIdx[0]}) << endl;
         for (i=0; i<peeling/2; i++) {
             // ALU ops
-            addrFile << showbase << hex << build_addr({0,0,0,0,rowIdx[1],colIdx[1]}) << endl;
-            addrFile << showbase << hex << build_addr({0,0,0,1,rowIdx[1],colIdx[1]}) << endl;
+            addrFile << showbase << hex << build_addr({mapChannel,mapRank,mapBankGroup,0,rowIdx[1],colIdx[1]}) << endl;
+            addrFile << showbase << hex << build_addr({mapChannel,mapRank,mapBankGroup,1,rowIdx[1],colIdx[1]}) << endl;
             if (++colIdx[1] == COLPERROW) {
                 colIdx[1] = 0;
                 rowIdx[1]++;
             }
         }
         if (peeling - 2*i)  // If n*V it's odd, last one is only with GRF
-            addrFile << showbase << hex << build_addr({0,0,0,0,rowIdx[1],colIdx[1]}) << endl;
+            addrFile << showbase << hex << build_addr({mapChannel,mapRank,mapBankGroup,0,rowIdx[1],colIdx[1]}) << endl;
         for (i=0; i<peeling/2; i++) {
             // MOVs to BANKs
-            addrFile << showbase << hex << build_addr({0,0,0,0,rowIdx[2],colIdx[2]}) << endl;
-            addrFile << showbase << hex << build_addr({0,0,0,1,rowIdx[2],colIdx[2]}) << endl;
+            addrFile << showbase << hex << build_addr({mapChannel,mapRank,mapBankGroup,0,rowIdx[2],colIdx[2]}) << endl;
+            addrFile << showbase << hex << build_addr({mapChannel,mapRank,mapBankGroup,1,rowIdx[2],colIdx[2]}) << endl;
             if (++colIdx[2] == COLPERROW) {
                 colIdx[2] = 0;
                 rowIdx[2]++;
             }
         }
         if (peeling - 2*i)  // If n*V it's odd, last one is only with GRF
-            addrFile << showbase << hex << build_addr({0,0,0,0,rowIdx[2],colIdx[2]}) << endl;
+            addrFile << showbase << hex << build_addr({mapChannel,mapRank,mapBankGroup,0,rowIdx[2],colIdx[2]}) << endl;
     }
 
     // Write data for loops and others
@@ -132,10 +163,10 @@ void mapEWAdditionRowWiseRLim (ofstream &assembly, ofstream &dataFile, ofstream
     for (i=0; i<loops; i++) {
         for (j=0; j<GRF_ENTRIES; j++){
             // MOVs to GRFs
-            for (k=0; k<2*SIMD_WIDTH*CORES_PER_PCH; k++) {
-                if (k == SIMD_WIDTH*CORES_PER_PCH)
+            for (k=0; k<2*SIMD_WIDTH*LOCKSTEP_CORES; k++) {
+                if (k == SIMD_WIDTH*LOCKSTEP_CORES)
                     dataFile << endl;
-                if(WORD_BITS != 8)
+                if (!CHAR_DATA)
                     dataFile << op1[VIdx[0]][nIdx[0]] << " ";
                 else     
                     dataFile << int(op1[VIdx[0]][nIdx[0]]) << " "; //need to cast the results for int8 only
@@ -149,10 +180,10 @@ void mapEWAdditionRowWiseRLim (ofstream &assembly, ofstream &dataFile, ofstream
         }
         for (j=0; j<GRF_ENTRIES; j++){
             // ALU ops
-            for (k=0; k<2*SIMD_WIDTH*CORES_PER_PCH; k++) {
-                if (k == SIMD_WIDTH*CORES_PER_PCH)
+            for (k=0; k<2*SIMD_WIDTH*LOCKSTEP_CORES; k++) {
+                if (k == SIMD_WIDTH*LOCKSTEP_CORES)
                     dataFile << endl;
-                if(WORD_BITS != 8)
+                if (!CHAR_DATA)
                     dataFile << op2[VIdx[1]][nIdx[1]] << " ";
                 else
                     dataFile << int(op2[VIdx[1]][nIdx[1]]) << " "; //need to cast the results for int8 only
@@ -170,10 +201,10 @@ void mapEWAdditionRowWiseRLim (ofstream &assembly, ofstream &dataFile, ofstream
         dataFile << "# Out of the main loop" << endl;
         for (i=0; i<peeling/2; i++) {
             // MOVs to GRFs
-            for (k=0; k<2*SIMD_WIDTH*CORES_PER_PCH; k++) {
-                if (k == SIMD_WIDTH*CORES_PER_PCH)
+            for (k=0; k<2*SIMD_WIDTH*LOCKSTEP_CORES; k++) {
+                if (k == SIMD_WIDTH*LOCKSTEP_CORES)
                     dataFile << endl;
-                if(WORD_BITS != 8)
+                if (!CHAR_DATA)
                     dataFile << op1[VIdx[0]][nIdx[0]] << " ";
                 else
                     dataFile << int(op1[VIdx[0]][nIdx[0]]) << " "; //need to cast the results for int8 only
@@ -186,8 +217,8 @@ void mapEWAdditionRowWiseRLim (ofstream &assembly, ofstream &dataFile, ofstream
             dataFile << endl;
         }
         if (peeling - 2*i) {    // If n*V it's odd, last one is only with GRF
-            for (k=0; k<SIMD_WIDTH*CORES_PER_PCH; k++) {
-                if(WORD_BITS != 8)
+            for (k=0; k<SIMD_WIDTH*LOCKSTEP_CORES; k++) {
+                if (!CHAR_DATA)
                     dataFile << op1[VIdx[0]][nIdx[0]] << " ";
                 else 
                     dataFile << int(op1[VIdx[0]][nIdx[0]]) << " "; //need to cast the results for int8 only
@@ -201,10 +232,10 @@ void mapEWAdditionRowWiseRLim (ofstream &assembly, ofstream &dataFile, ofstream
         }
         for (i=0; i<peeling/2; i++) {
             // ALU ops
-            for (k=0; k<2*SIMD_WIDTH*CORES_PER_PCH; k++) {
-                if (k == SIMD_WIDTH*CORES_PER_PCH)
+            for (k=0; k<2*SIMD_WIDTH*LOCKSTEP_CORES; k++) {
+                if (k == SIMD_WIDTH*LOCKSTEP_CORES)
                     dataFile << endl;
-                if(WORD_BITS != 8)
+                if (!CHAR_DATA)
                     dataFile << op2[VIdx[1]][nIdx[1]] << " ";
                 else 
                     dataFile << int(op2[VIdx[1]][nIdx[1]]) << " "; //need to cast the results for int8 only
@@ -217,8 +248,8 @@ void mapEWAdditionRowWiseRLim (ofstream &assembly, ofstream &dataFile, ofstream
             dataFile << endl;
         }
         if (peeling - 2*i) {    // If n*V it's odd, last one is only with GRF
-            for (k=0; k<SIMD_WIDTH*CORES_PER_PCH; k++) {
-                if(WORD_BITS != 8)
+            for (k=0; k<SIMD_WIDTH*LOCKSTEP_CORES; k++) {
+                if (!CHAR_DATA)
                     dataFile << op2[VIdx[1]][nIdx[1]] << " ";
                 else 
                     dataFile << int(op2[VIdx[1]][nIdx[1]]) << " "; //need to cast the results for int8 only
@@ -240,11 +271,11 @@ void mapEWAdditionRowWiseCLim (ofstream &assembly, ofstream &dataFile, ofstream
     int i,j,k;
     int crfSegment = floor((float(CRF_ENTRIES)-2.0)/3.0);
     crfSegment = min(crfSegment, 2*GRF_ENTRIES);           // If segment is larger than GRF capacity, limit it to the latter
-    int loops = floor(ceil(float(n*V)/float(SIMD_WIDTH*CORES_PER_PCH))/crfSegment);
-    int peeling = int(ceil(float(n*V)/float(SIMD_WIDTH*CORES_PER_PCH))) % crfSegment;
+    int loops = floor(ceil(float(n*V)/float(SIMD_WIDTH*LOCKSTEP_CORES))/crfSegment);
+    int peeling = int(ceil(float(n*V)/float(SIMD_WIDTH*LOCKSTEP_CORES))) % crfSegment;
     int totalCol = ceil((float(n*V)/2.0)/float(SIMD_WIDTH));                    // Div 2 because distributed in 2 banks
-    uint64_t op2Base = ceil(float(totalCol)/(float(COLPERROW*CORES_PER_PCH)+1.0));              // Op2 will start in this row (+ 1 in case crfSegment is odd)
-    uint64_t resBase = op2Base + ceil(float(totalCol)/(float(COLPERROW*CORES_PER_PCH)+1.0));    // Result will start in this row
+    uint64_t op2Base = ceil(float(totalCol)/(float(COLPERROW*LOCKSTEP_CORES)+1.0));              // Op2 will start in this row (+ 1 in case crfSegment is odd)
+    uint64_t resBase = op2Base + ceil(float(totalCol)/(float(COLPERROW*LOCKSTEP_CORES)+1.0));    // Result will start in this row
     uint64_t rowIdx[3] = {0,op2Base,resBase};
     uint64_t colIdx[3] = {0,0,0};
     int nIdx[2] = {0,0};
@@ -310,15 +341,15 @@ void mapEWAdditionRowWiseCLim (ofstream &assembly, ofstream &dataFile, ofstream
     for (i=0; i<loops; i++) {
         for (j=0; j<crfSegment/2; j++){
             // MOVs to GRFs
-            addrFile << showbase << hex << build_addr({0,0,0,0,rowIdx[0],colIdx[0]}) << endl;
-            addrFile << showbase << hex << build_addr({0,0,0,1,rowIdx[0],colIdx[0]}) << endl;
+            addrFile << showbase << hex << build_addr({mapChannel,mapRank,mapBankGroup,0,rowIdx[0],colIdx[0]}) << endl;
+            addrFile << showbase << hex << build_addr({mapChannel,mapRank,mapBankGroup,1,rowIdx[0],colIdx[0]}) << endl;
             if (++colIdx[0] == COLPERROW) {
                 colIdx[0] = 0;
                 rowIdx[0]++;
             }
         }
         if (crfSegment % 2) {
-            addrFile << showbase << hex << build_addr({0,0,0,0,rowIdx[0],colIdx[0]}) << endl;
+            addrFile << showbase << hex << build_addr({mapChannel,mapRank,mapBankGroup,0,rowIdx[0],colIdx[0]}) << endl;
             if (++colIdx[0] == COLPERROW) {
                 colIdx[0] = 0;
                 rowIdx[0]++;
@@ -326,15 +357,15 @@ void mapEWAdditionRowWiseCLim (ofstream &assembly, ofstream &dataFile, ofstream
         }
         for (j=0; j<crfSegment/2; j++){
             // ALU ops
-            addrFile << showbase << hex << build_addr({0,0,0,0,rowIdx[1],colIdx[1]}) << endl;
-            addrFile << showbase << hex << build_addr({0,0,0,1,rowIdx[1],colIdx[1]}) << endl;
+            addrFile << showbase << hex << build_addr({mapChannel,mapRank,mapBankGroup,0,rowIdx[1],colIdx[1]}) << endl;
+            addrFile << showbase << hex << build_addr({mapChannel,mapRank,mapBankGroup,1,rowIdx[1],colIdx[1]}) << endl;
             if (++colIdx[1] == COLPERROW) {
                 colIdx[1] = 0;
                 rowIdx[1]++;
             }
         }
         if (crfSegment % 2) {
-            addrFile << showbase << hex << build_addr({0,0,0,0,rowIdx[1],colIdx[1]}) << endl;
+            addrFile << showbase << hex << build_addr({mapChannel,mapRank,mapBankGroup,0,rowIdx[1],colIdx[1]}) << endl;
             if (++colIdx[1] == COLPERROW) {
                 colIdx[1] = 0;
                 rowIdx[1]++;
@@ -342,15 +373,15 @@ void mapEWAdditionRowWiseCLim (ofstream &assembly, ofstream &dataFile, ofstream
         }
         for (j=0; j<crfSegment/2; j++){
             // MOVs to BANKs
-            addrFile << showbase << hex << build_addr({0,0,0,0,rowIdx[2],colIdx[2]}) << endl;
-            addrFile << showbase << hex << build_addr({0,0,0,1,rowIdx[2],colIdx[2]}) << endl;
+            addrFile << showbase << hex << build_addr({mapChannel,mapRank,mapBankGroup,0,rowIdx[2],colIdx[2]}) << endl;
+            addrFile << showbase << hex << build_addr({mapChannel,mapRank,mapBankGroup,1,rowIdx[2],colIdx[2]}) << endl;
             if (++colIdx[2] == COLPERROW) {
                 colIdx[2] = 0;
                 rowIdx[2]++;
             }
         }
         if (crfSegment % 2) {
-            addrFile << showbase << hex << build_addr({0,0,0,0,rowIdx[2],colIdx[2]}) << endl;
+            addrFile << showbase << hex << build_addr({mapChannel,mapRank,mapBankGroup,0,rowIdx[2],colIdx[2]}) << endl;
             if (++colIdx[2] == COLPERROW) {
                 colIdx[2] = 0;
                 rowIdx[2]++;
@@ -362,37 +393,37 @@ void mapEWAdditionRowWiseCLim (ofstream &assembly, ofstream &dataFile, ofstream
         addrFile << "# Out of the main loop" << endl;
         for (i=0; i<peeling/2; i++) {
             // MOVs to GRFs
-            addrFile << showbase << hex << build_addr({0,0,0,0,rowIdx[0],colIdx[0]}) << endl;
-            addrFile << showbase << hex << build_addr({0,0,0,1,rowIdx[0],colIdx[0]}) << endl;
+            addrFile << showbase << hex << build_addr({mapChannel,mapRank,mapBankGroup,0,rowIdx[0],colIdx[0]}) << endl;
+            addrFile << showbase << hex << build_addr({mapChannel,mapRank,mapBankGroup,1,rowIdx[0],colIdx[0]}) << endl;
             if (++colIdx[0] == COLPERROW) {
                 colIdx[0] = 0;
                 rowIdx[0]++;
             }
         }
         if (peeling - 2*i)  // If n*V it's odd, last one is only with GRF
-            addrFile << showbase << hex << build_addr({0,0,0,0,rowIdx[0],colIdx[0]}) << endl;
+            addrFile << showbase << hex << build_addr({mapChannel,mapRank,mapBankGroup,0,rowIdx[0],colIdx[0]}) << endl;
         for (i=0; i<peeling/2; i++) {
             // ALU ops
-            addrFile << showbase << hex << build_addr({0,0,0,0,rowIdx[1],colIdx[1]}) << endl;
-            addrFile << showbase << hex << build_addr({0,0,0,1,rowIdx[1],colIdx[1]}) << endl;
+            addrFile << showbase << hex << build_addr({mapChannel,mapRank,mapBankGroup,0,rowIdx[1],colIdx[1]}) << endl;
+            addrFile << showbase << hex << build_addr({mapChannel,mapRank,mapBankGroup,1,rowIdx[1],colIdx[1]}) << endl;
             if (++colIdx[1] == COLPERROW) {
                 colIdx[1] = 0;
                 rowIdx[1]++;
             }
         }
         if (peeling - 2*i)  // If n*V it's odd, last one is only with GRF
-            addrFile << showbase << hex << build_addr({0,0,0,0,rowIdx[1],colIdx[1]}) << endl;
+            addrFile << showbase << hex << build_addr({mapChannel,mapRank,mapBankGroup,0,rowIdx[1],colIdx[1]}) << endl;
         for (i=0; i<peeling/2; i++) {
             // MOVs to BANKs
-            addrFile << showbase << hex << build_addr({0,0,0,0,rowIdx[2],colIdx[2]}) << endl;
-            addrFile << showbase << hex << build_addr({0,0,0,1,rowIdx[2],colIdx[2]}) << endl;
+            addrFile << showbase << hex << build_addr({mapChannel,mapRank,mapBankGroup,0,rowIdx[2],colIdx[2]}) << endl;
+            addrFile << showbase << hex << build_addr({mapChannel,mapRank,mapBankGroup,1,rowIdx[2],colIdx[2]}) << endl;
             if (++colIdx[2] == COLPERROW) {
                 colIdx[2] = 0;
                 rowIdx[2]++;
             }
         }
         if (peeling - 2*i)  // If n*V it's odd, last one is only with GRF
-            addrFile << showbase << hex << build_addr({0,0,0,0,rowIdx[2],colIdx[2]}) << endl;
+            addrFile << showbase << hex << build_addr({mapChannel,mapRank,mapBankGroup,0,rowIdx[2],colIdx[2]}) << endl;
     }
 
     // Write data for loops and others
@@ -400,10 +431,10 @@ void mapEWAdditionRowWiseCLim (ofstream &assembly, ofstream &dataFile, ofstream
     for (i=0; i<loops; i++) {
         for (j=0; j<crfSegment/2; j++){
             // MOVs to GRFs
-            for (k=0; k<2*SIMD_WIDTH*CORES_PER_PCH; k++) {
-                if (k == SIMD_WIDTH*CORES_PER_PCH)
+            for (k=0; k<2*SIMD_WIDTH*LOCKSTEP_CORES; k++) {
+                if (k == SIMD_WIDTH*LOCKSTEP_CORES)
                     dataFile << endl;
-                if (WORD_BITS != 8)
+                if (!CHAR_DATA)
                     dataFile << op1[VIdx[0]][nIdx[0]] << " ";
                 else 
                     dataFile << int(op1[VIdx[0]][nIdx[0]]) << " ";
@@ -416,8 +447,8 @@ void mapEWAdditionRowWiseCLim (ofstream &assembly, ofstream &dataFile, ofstream
             dataFile << endl;
         }
         if (crfSegment%2) {
-            for (k=0; k<SIMD_WIDTH*CORES_PER_PCH; k++) {
-                if (WORD_BITS != 8)
+            for (k=0; k<SIMD_WIDTH*LOCKSTEP_CORES; k++) {
+                if (!CHAR_DATA)
                     dataFile << op1[VIdx[0]][nIdx[0]] << " ";
                 else 
                     dataFile << int(op1[VIdx[0]][nIdx[0]]) << " ";
@@ -431,10 +462,10 @@ void mapEWAdditionRowWiseCLim (ofstream &assembly, ofstream &dataFile, ofstream
         }
         for (j=0; j<crfSegment/2; j++){
             // ALU ops
-            for (k=0; k<2*SIMD_WIDTH*CORES_PER_PCH; k++) {
-                if (k == SIMD_WIDTH*CORES_PER_PCH)
+            for (k=0; k<2*SIMD_WIDTH*LOCKSTEP_CORES; k++) {
+                if (k == SIMD_WIDTH*LOCKSTEP_CORES)
                     dataFile << endl;
-                if (WORD_BITS != 8)
+                if (!CHAR_DATA)
                     dataFile << op2[VIdx[1]][nIdx[1]] << " ";
                 else 
                     dataFile << int(op2[VIdx[1]][nIdx[1]]) << " ";
@@ -447,8 +478,8 @@ void mapEWAdditionRowWiseCLim (ofstream &assembly, ofstream &dataFile, ofstream
             dataFile << endl;
         }
         if (crfSegment%2) {
-            for (k=0; k<SIMD_WIDTH*CORES_PER_PCH; k++) {
-                if (WORD_BITS != 8)
+            for (k=0; k<SIMD_WIDTH*LOCKSTEP_CORES; k++) {
+                if (!CHAR_DATA)
                     dataFile << op2[VIdx[1]][nIdx[1]] << " ";
                 else 
                     dataFile << int(op2[VIdx[1]][nIdx[1]]) << " ";
@@ -466,10 +497,10 @@ void mapEWAdditionRowWiseCLim (ofstream &assembly, ofstream &dataFile, ofstream
         dataFile << "# Out of the main loop" << endl;
         for (i=0; i<peeling/2; i++) {
             // MOVs to GRFs
-            for (k=0; k<2*SIMD_WIDTH*CORES_PER_PCH; k++) {
-                if (k == SIMD_WIDTH*CORES_PER_PCH)
+            for (k=0; k<2*SIMD_WIDTH*LOCKSTEP_CORES; k++) {
+                if (k == SIMD_WIDTH*LOCKSTEP_CORES)
                     dataFile << endl;
-                if (WORD_BITS != 8)
+                if (!CHAR_DATA)
                     dataFile << op1[VIdx[0]][nIdx[0]] << " ";
                 else 
                     dataFile << int(op1[VIdx[0]][nIdx[0]]) << " ";
@@ -482,8 +513,8 @@ void mapEWAdditionRowWiseCLim (ofstream &assembly, ofstream &dataFile, ofstream
             dataFile << endl;
         }
         if (peeling - 2*i) {    // If n*V it's odd, last one is only with GRF
-            for (k=0; k<SIMD_WIDTH*CORES_PER_PCH; k++) {
-                if (WORD_BITS != 8)
+            for (k=0; k<SIMD_WIDTH*LOCKSTEP_CORES; k++) {
+                if (!CHAR_DATA)
                     dataFile << op1[VIdx[0]][nIdx[0]] << " ";
                 else 
                     dataFile << int(op1[VIdx[0]][nIdx[0]]) << " ";
@@ -497,10 +528,10 @@ void mapEWAdditionRowWiseCLim (ofstream &assembly, ofstream &dataFile, ofstream
         }
         for (i=0; i<peeling/2; i++) {
             // ALU ops
-            for (k=0; k<2*SIMD_WIDTH*CORES_PER_PCH; k++) {
-                if (k == SIMD_WIDTH*CORES_PER_PCH)
+            for (k=0; k<2*SIMD_WIDTH*LOCKSTEP_CORES; k++) {
+                if (k == SIMD_WIDTH*LOCKSTEP_CORES)
                     dataFile << endl;
-                if (WORD_BITS != 8)
+                if (!CHAR_DATA)
                     dataFile << op2[VIdx[1]][nIdx[1]] << " ";
                 else
                     dataFile << int(op2[VIdx[1]][nIdx[1]]) << " ";
@@ -513,8 +544,8 @@ void mapEWAdditionRowWiseCLim (ofstream &assembly, ofstream &dataFile, ofstream
             dataFile << endl;
         }
         if (peeling - 2*i) {    // If n*V it's odd, last one is only with GRF
-            for (k=0; k<SIMD_WIDTH*CORES_PER_PCH; k++) {
-                if (WORD_BITS != 8)
+            for (k=0; k<SIMD_WIDTH*LOCKSTEP_CORES; k++) {
+                if (!CHAR_DATA)
                     dataFile << op2[VIdx[1]][nIdx[1]] << " ";
                 else 
                     dataFile << int(op2[VIdx[1]][nIdx[1]]) << " ";
@@ -534,11 +565,11 @@ void mapEWAdditionColWiseRLim (ofstream &assembly, ofstream &dataFile, ofstream
                                 cnm_t **op1, cnm_t **op2, int V, int n)
 {
     int i,j,k;
-    int loops = floor(float(n)*ceil(float(V)/float(SIMD_WIDTH*CORES_PER_PCH))/(2.0*GRF_ENTRIES));
-    int peeling = int(float(n)*ceil(float(V)/float(SIMD_WIDTH*CORES_PER_PCH))) % (2*GRF_ENTRIES);
+    int loops = floor(float(n)*ceil(float(V)/float(SIMD_WIDTH*LOCKSTEP_CORES))/(2.0*GRF_ENTRIES));
+    int peeling = int(float(n)*ceil(float(V)/float(SIMD_WIDTH*LOCKSTEP_CORES))) % (2*GRF_ENTRIES);
     int totalCol = n * ceil(float(V)/float(SIMD_WIDTH)) / 2;                // Div 2 because distributed in 2 banks
-    uint64_t op2Base = ceil(float(totalCol)/float(COLPERROW*CORES_PER_PCH));              // Op2 will start in this row
-    uint64_t resBase = op2Base + ceil(float(totalCol)/float(COLPERROW*CORES_PER_PCH));    // Result will start in this row
+    uint64_t op2Base = ceil(float(totalCol)/float(COLPERROW*LOCKSTEP_CORES));              // Op2 will start in this row
+    uint64_t resBase = op2Base + ceil(float(totalCol)/float(COLPERROW*LOCKSTEP_CORES));    // Result will start in this row
     uint64_t rowIdx[3] = {0,op2Base,resBase};
     uint64_t colIdx[3] = {0,0,0};
     int nIdx[2] = {0,0};
@@ -593,8 +624,8 @@ void mapEWAdditionColWiseRLim (ofstream &assembly, ofstream &dataFile, ofstream
     for (i=0; i<loops; i++) {
         for (j=0; j<GRF_ENTRIES; j++){
             // MOVs to GRFs
-            addrFile << showbase << hex << build_addr({0,0,0,0,rowIdx[0],colIdx[0]}) << endl;
-            addrFile << showbase << hex << build_addr({0,0,0,1,rowIdx[0],colIdx[0]}) << endl;
+            addrFile << showbase << hex << build_addr({mapChannel,mapRank,mapBankGroup,0,rowIdx[0],colIdx[0]}) << endl;
+            addrFile << showbase << hex << build_addr({mapChannel,mapRank,mapBankGroup,1,rowIdx[0],colIdx[0]}) << endl;
             if (++colIdx[0] == COLPERROW) {
                 colIdx[0] = 0;
                 rowIdx[0]++;
@@ -602,8 +633,8 @@ void mapEWAdditionColWiseRLim (ofstream &assembly, ofstream &dataFile, ofstream
         }
         for (j=0; j<GRF_ENTRIES; j++){
             // ALU ops
-            addrFile << showbase << hex << build_addr({0,0,0,0,rowIdx[1],colIdx[1]}) << endl;
-            addrFile << showbase << hex << build_addr({0,0,0,1,rowIdx[1],colIdx[1]}) << endl;
+            addrFile << showbase << hex << build_addr({mapChannel,mapRank,mapBankGroup,0,rowIdx[1],colIdx[1]}) << endl;
+            addrFile << showbase << hex << build_addr({mapChannel,mapRank,mapBankGroup,1,rowIdx[1],colIdx[1]}) << endl;
             if (++colIdx[1] == COLPERROW) {
                 colIdx[1] = 0;
                 rowIdx[1]++;
@@ -611,8 +642,8 @@ void mapEWAdditionColWiseRLim (ofstream &assembly, ofstream &dataFile, ofstream
         }
         for (j=0; j<GRF_ENTRIES; j++){
             // MOVs to BANKs
-            addrFile << showbase << hex << build_addr({0,0,0,0,rowIdx[2],colIdx[2]}) << endl;
-            addrFile << showbase << hex << build_addr({0,0,0,1,rowIdx[2],colIdx[2]}) << endl;
+            addrFile << showbase << hex << build_addr({mapChannel,mapRank,mapBankGroup,0,rowIdx[2],colIdx[2]}) << endl;
+            addrFile << showbase << hex << build_addr({mapChannel,mapRank,mapBankGroup,1,rowIdx[2],colIdx[2]}) << endl;
             if (++colIdx[2] == COLPERROW) {
                 colIdx[2] = 0;
                 rowIdx[2]++;
@@ -624,37 +655,37 @@ void mapEWAdditionColWiseRLim (ofstream &assembly, ofstream &dataFile, ofstream
         addrFile << "# Out of the main loop" << endl;
         for (i=0; i<peeling/2; i++) {
             // MOVs to GRFs
-            addrFile << showbase << hex << build_addr({0,0,0,0,rowIdx[0],colIdx[0]}) << endl;
-            addrFile << showbase << hex << build_addr({0,0,0,1,rowIdx[0],colIdx[0]}) << endl;
+            addrFile << showbase << hex << build_addr({mapChannel,mapRank,mapBankGroup,0,rowIdx[0],colIdx[0]}) << endl;
+            addrFile << showbase << hex << build_addr({mapChannel,mapRank,mapBankGroup,1,rowIdx[0],colIdx[0]}) << endl;
             if (++colIdx[0] == COLPERROW) {
                 colIdx[0] = 0;
                 rowIdx[0]++;
             }
         }
         if (peeling - 2*i)  // If n it's odd, last one is only with GRF
-            addrFile << showbase << hex << build_addr({0,0,0,0,rowIdx[0],colIdx[0]}) << endl;
+            addrFile << showbase << hex << build_addr({mapChannel,mapRank,mapBankGroup,0,rowIdx[0],colIdx[0]}) << endl;
         for (i=0; i<peeling/2; i++) {
             // ALU ops
-            addrFile << showbase << hex << build_addr({0,0,0,0,rowIdx[1],colIdx[1]}) << endl;
-            addrFile << showbase << hex << build_addr({0,0,0,1,rowIdx[1],colIdx[1]}) << endl;
+            addrFile << showbase << hex << build_addr({mapChannel,mapRank,mapBankGroup,0,rowIdx[1],colIdx[1]}) << endl;
+            addrFile << showbase << hex << build_addr({mapChannel,mapRank,mapBankGroup,1,rowIdx[1],colIdx[1]}) << endl;
             if (++colIdx[1] == COLPERROW) {
                 colIdx[1] = 0;
                 rowIdx[1]++;
             }
         }
         if (peeling - 2*i)  // If n it's odd, last one is only with GRF
-            addrFile << showbase << hex << build_addr({0,0,0,0,rowIdx[1],colIdx[1]}) << endl;
+            addrFile << showbase << hex << build_addr({mapChannel,mapRank,mapBankGroup,0,rowIdx[1],colIdx[1]}) << endl;
         for (i=0; i<peeling/2; i++) {
             // MOVs to BANKs
-            addrFile << showbase << hex << build_addr({0,0,0,0,rowIdx[2],colIdx[2]}) << endl;
-            addrFile << showbase << hex << build_addr({0,0,0,1,rowIdx[2],colIdx[2]}) << endl;
+            addrFile << showbase << hex << build_addr({mapChannel,mapRank,mapBankGroup,0,rowIdx[2],colIdx[2]}) << endl;
+            addrFile << showbase << hex << build_addr({mapChannel,mapRank,mapBankGroup,1,rowIdx[2],colIdx[2]}) << endl;
             if (++colIdx[2] == COLPERROW) {
                 colIdx[2] = 0;
                 rowIdx[2]++;
             }
         }
         if (peeling - 2*i)  // If n it's odd, last one is only with GRF
-            addrFile << showbase << hex << build_addr({0,0,0,0,rowIdx[2],colIdx[2]}) << endl;
+            addrFile << showbase << hex << build_addr({mapChannel,mapRank,mapBankGroup,0,rowIdx[2],colIdx[2]}) << endl;
     }
 
     // Write data for loops and others
@@ -662,18 +693,18 @@ void mapEWAdditionColWiseRLim (ofstream &assembly, ofstream &dataFile, ofstream
     for (i=0; i<loops; i++) {
         for (j=0; j<GRF_ENTRIES; j++){
             // MOVs to GRFs
-            for (k=0; k<2*SIMD_WIDTH*CORES_PER_PCH; k++) {
-                if (k == SIMD_WIDTH*CORES_PER_PCH)
+            for (k=0; k<2*SIMD_WIDTH*LOCKSTEP_CORES; k++) {
+                if (k == SIMD_WIDTH*LOCKSTEP_CORES)
                     dataFile << endl;
                 if(WORD_BITS !=8)
                     dataFile << (VIdx[0] < V ? op1[VIdx[0]][nIdx[0]] : 0) << " ";
                 else 
                     dataFile << int((VIdx[0] < V ? op1[VIdx[0]][nIdx[0]] : 0)) << " ";
-                if (!(++VIdx[0] % (SIMD_WIDTH*CORES_PER_PCH))){ // Ended dimension of S vectors
+                if (!(++VIdx[0] % (SIMD_WIDTH*LOCKSTEP_CORES))){ // Ended dimension of S vectors
                     if (++nIdx[0] == n) {       // Finished all dimensions of S vectors
                         nIdx[0] = 0;
                     } else {
-                        VIdx[0] -= SIMD_WIDTH*CORES_PER_PCH;
+                        VIdx[0] -= SIMD_WIDTH*LOCKSTEP_CORES;
                     }
                 }
             }
@@ -681,18 +712,18 @@ void mapEWAdditionColWiseRLim (ofstream &assembly, ofstream &dataFile, ofstream
         }
         for (j=0; j<GRF_ENTRIES; j++){
             // ALU ops
-            for (k=0; k<2*SIMD_WIDTH*CORES_PER_PCH; k++) {
-                if (k == SIMD_WIDTH*CORES_PER_PCH)
+            for (k=0; k<2*SIMD_WIDTH*LOCKSTEP_CORES; k++) {
+                if (k == SIMD_WIDTH*LOCKSTEP_CORES)
                     dataFile << endl;
                 if(WORD_BITS !=8)
                     dataFile << (VIdx[1] < V ? op2[VIdx[1]][nIdx[1]] : 0) << " ";
                 else
                     dataFile << int(VIdx[1] < V ? op2[VIdx[1]][nIdx[1]] : 0) << " ";
-                if (!(++VIdx[1] % (SIMD_WIDTH*CORES_PER_PCH))){ // Ended dimension of S vectors
+                if (!(++VIdx[1] % (SIMD_WIDTH*LOCKSTEP_CORES))){ // Ended dimension of S vectors
                     if (++nIdx[1] == n) {       // Finished all dimensions of S vectors
                         nIdx[1] = 0;
                     } else {
-                        VIdx[1] -= SIMD_WIDTH*CORES_PER_PCH;
+                        VIdx[1] -= SIMD_WIDTH*LOCKSTEP_CORES;
                     }
                 }
             }
@@ -704,34 +735,34 @@ void mapEWAdditionColWiseRLim (ofstream &assembly, ofstream &dataFile, ofstream
         dataFile << "# Out of the main loop" << endl;
         for (i=0; i<peeling/2; i++) {
             // MOVs to GRFs
-            for (k=0; k<2*SIMD_WIDTH*CORES_PER_PCH; k++) {
-                if (k == SIMD_WIDTH*CORES_PER_PCH)
+            for (k=0; k<2*SIMD_WIDTH*LOCKSTEP_CORES; k++) {
+                if (k == SIMD_WIDTH*LOCKSTEP_CORES)
                     dataFile << endl;
                 if(WORD_BITS !=8)
                     dataFile << (VIdx[0] < V ? op1[VIdx[0]][nIdx[0]] : 0) << " ";
                 else 
                     dataFile << int(VIdx[0] < V ? op1[VIdx[0]][nIdx[0]] : 0) << " ";
-                if (!(++VIdx[0] % (SIMD_WIDTH*CORES_PER_PCH))){ // Ended dimension of S vectors
+                if (!(++VIdx[0] % (SIMD_WIDTH*LOCKSTEP_CORES))){ // Ended dimension of S vectors
                     if (++nIdx[0] == n) {       // Finished all dimensions of S vectors
                         nIdx[0] = 0;
                     } else {
-                        VIdx[0] -= SIMD_WIDTH*CORES_PER_PCH;
+                        VIdx[0] -= SIMD_WIDTH*LOCKSTEP_CORES;
                     }
                 }
             }
             dataFile << endl;
         }
         if (peeling - 2*i) {    // If n it's odd, last one is only with GRF
-            for (k=0; k<SIMD_WIDTH*CORES_PER_PCH; k++) {
+            for (k=0; k<SIMD_WIDTH*LOCKSTEP_CORES; k++) {
                 if(WORD_BITS !=8)
                     dataFile << (VIdx[0] < V ? op1[VIdx[0]][nIdx[0]] : 0) << " ";
                 else 
                     dataFile << int(VIdx[0] < V ? op1[VIdx[0]][nIdx[0]] : 0) << " ";
-                if (!(++VIdx[0] % (SIMD_WIDTH*CORES_PER_PCH))){ // Ended dimension of S vectors
+                if (!(++VIdx[0] % (SIMD_WIDTH*LOCKSTEP_CORES))){ // Ended dimension of S vectors
                     if (++nIdx[0] == n) {       // Finished all dimensions of S vectors
                         nIdx[0] = 0;
                     } else {
-                        VIdx[0] -= SIMD_WIDTH*CORES_PER_PCH;
+                        VIdx[0] -= SIMD_WIDTH*LOCKSTEP_CORES;
                     }
                 }
             }
@@ -739,34 +770,34 @@ void mapEWAdditionColWiseRLim (ofstream &assembly, ofstream &dataFile, ofstream
         }
         for (i=0; i<peeling/2; i++) {
             // ALU ops
-            for (k=0; k<2*SIMD_WIDTH*CORES_PER_PCH; k++) {
-                if (k == SIMD_WIDTH*CORES_PER_PCH)
+            for (k=0; k<2*SIMD_WIDTH*LOCKSTEP_CORES; k++) {
+                if (k == SIMD_WIDTH*LOCKSTEP_CORES)
                     dataFile << endl;
                 if(WORD_BITS !=8)
                     dataFile << (VIdx[1] < V ? op2[VIdx[1]][nIdx[1]] : 0) << " ";
                 else 
                     dataFile << int(VIdx[1] < V ? op2[VIdx[1]][nIdx[1]] : 0) << " ";
-                if (!(++VIdx[1] % (SIMD_WIDTH*CORES_PER_PCH))){ // Ended dimension of S vectors
+                if (!(++VIdx[1] % (SIMD_WIDTH*LOCKSTEP_CORES))){ // Ended dimension of S vectors
                     if (++nIdx[1] == n) {       // Finished all dimensions of S vectors
                         nIdx[1] = 0;
                     } else {
-                        VIdx[1] -= SIMD_WIDTH*CORES_PER_PCH;
+                        VIdx[1] -= SIMD_WIDTH*LOCKSTEP_CORES;
                     }
                 }
             }
             dataFile << endl;
         }
         if (peeling - 2*i) {    // If n it's odd, last one is only with GRF
-            for (k=0; k<SIMD_WIDTH*CORES_PER_PCH; k++) {
+            for (k=0; k<SIMD_WIDTH*LOCKSTEP_CORES; k++) {
                 if(WORD_BITS !=8)
                     dataFile << (VIdx[1] < V ? op2[VIdx[1]][nIdx[1]] : 0) << " ";
                 else 
                     dataFile << int(VIdx[1] < V ? op2[VIdx[1]][nIdx[1]] : 0) << " ";
-                if (!(++VIdx[1] % (SIMD_WIDTH*CORES_PER_PCH))){ // Ended dimension of S vectors
+                if (!(++VIdx[1] % (SIMD_WIDTH*LOCKSTEP_CORES))){ // Ended dimension of S vectors
                     if (++nIdx[1] == n) {       // Finished all dimensions of S vectors
                         nIdx[1] = 0;
                     } else {
-                        VIdx[1] -= SIMD_WIDTH*CORES_PER_PCH;
+                        VIdx[1] -= SIMD_WIDTH*LOCKSTEP_CORES;
                     }
                 }
             }
@@ -782,11 +813,11 @@ void mapEWAdditionColWiseCLim (ofstream &assembly, ofstream &dataFile, ofstream
     int i,j,k;
     int crfSegment = floor((float(CRF_ENTRIES)-2.0)/3.0);
     crfSegment = min(crfSegment, 2*GRF_ENTRIES);           // If segment is larger than GRF capacity, limit it to the latter
-    int loops = floor(float(n)*ceil(float(V)/float(SIMD_WIDTH*CORES_PER_PCH))/crfSegment);
-    int peeling = int(float(n)*ceil(float(V)/float(SIMD_WIDTH*CORES_PER_PCH))) % crfSegment;
+    int loops = floor(float(n)*ceil(float(V)/float(SIMD_WIDTH*LOCKSTEP_CORES))/crfSegment);
+    int peeling = int(float(n)*ceil(float(V)/float(SIMD_WIDTH*LOCKSTEP_CORES))) % crfSegment;
     int totalCol = n * ceil(float(V)/float(SIMD_WIDTH)) / 2;                    // Div 2 because distributed in 2 banks
-    uint64_t op2Base = ceil(float(totalCol)/(float(COLPERROW*CORES_PER_PCH)+1.0));            // Op2 will start in this row (+ 1 in case crfSegment is odd)
-    uint64_t resBase = op2Base + ceil(float(totalCol)/(float(COLPERROW*CORES_PER_PCH)+1.0));  // Result will start in this row
+    uint64_t op2Base = ceil(float(totalCol)/(float(COLPERROW*LOCKSTEP_CORES)+1.0));            // Op2 will start in this row (+ 1 in case crfSegment is odd)
+    uint64_t resBase = op2Base + ceil(float(totalCol)/(float(COLPERROW*LOCKSTEP_CORES)+1.0));  // Result will start in this row
     uint64_t rowIdx[3] = {0,op2Base,resBase};
     uint64_t colIdx[3] = {0,0,0};
     int nIdx[2] = {0,0};
@@ -852,15 +883,15 @@ void mapEWAdditionColWiseCLim (ofstream &assembly, ofstream &dataFile, ofstream
     for (i=0; i<loops; i++) {
         for (j=0; j<crfSegment/2; j++){
             // MOVs to GRFs
-            addrFile << showbase << hex << build_addr({0,0,0,0,rowIdx[0],colIdx[0]}) << endl;
-            addrFile << showbase << hex << build_addr({0,0,0,1,rowIdx[0],colIdx[0]}) << endl;
+            addrFile << showbase << hex << build_addr({mapChannel,mapRank,mapBankGroup,0,rowIdx[0],colIdx[0]}) << endl;
+            addrFile << showbase << hex << build_addr({mapChannel,mapRank,mapBankGroup,1,rowIdx[0],colIdx[0]}) << endl;
             if (++colIdx[0] == COLPERROW) {
                 colIdx[0] = 0;
                 rowIdx[0]++;
             }
         }
         if (crfSegment % 2) {
-            addrFile << showbase << hex << build_addr({0,0,0,0,rowIdx[0],colIdx[0]}) << endl;
+            addrFile << showbase << hex << build_addr({mapChannel,mapRank,mapBankGroup,0,rowIdx[0],colIdx[0]}) << endl;
             if (++colIdx[0] == COLPERROW) {
                 colIdx[0] = 0;
                 rowIdx[0]++;
@@ -868,15 +899,15 @@ void mapEWAdditionColWiseCLim (ofstream &assembly, ofstream &dataFile, ofstream
         }
         for (j=0; j<crfSegment/2; j++){
             // ALU ops
-            addrFile << showbase << hex << build_addr({0,0,0,0,rowIdx[1],colIdx[1]}) << endl;
-            addrFile << showbase << hex << build_addr({0,0,0,1,rowIdx[1],colIdx[1]}) << endl;
+            addrFile << showbase << hex << build_addr({mapChannel,mapRank,mapBankGroup,0,rowIdx[1],colIdx[1]}) << endl;
+            addrFile << showbase << hex << build_addr({mapChannel,mapRank,mapBankGroup,1,rowIdx[1],colIdx[1]}) << endl;
             if (++colIdx[1] == COLPERROW) {
                 colIdx[1] = 0;
                 rowIdx[1]++;
             }
         }
         if (crfSegment % 2) {
-            addrFile << showbase << hex << build_addr({0,0,0,0,rowIdx[1],colIdx[1]}) << endl;
+            addrFile << showbase << hex << build_addr({mapChannel,mapRank,mapBankGroup,0,rowIdx[1],colIdx[1]}) << endl;
             if (++colIdx[1] == COLPERROW) {
                 colIdx[1] = 0;
                 rowIdx[1]++;
@@ -884,15 +915,15 @@ void mapEWAdditionColWiseCLim (ofstream &assembly, ofstream &dataFile, ofstream
         }
         for (j=0; j<crfSegment/2; j++){
             // MOVs to BANKs
-            addrFile << showbase << hex << build_addr({0,0,0,0,rowIdx[2],colIdx[2]}) << endl;
-            addrFile << showbase << hex << build_addr({0,0,0,1,rowIdx[2],colIdx[2]}) << endl;
+            addrFile << showbase << hex << build_addr({mapChannel,mapRank,mapBankGroup,0,rowIdx[2],colIdx[2]}) << endl;
+            addrFile << showbase << hex << build_addr({mapChannel,mapRank,mapBankGroup,1,rowIdx[2],colIdx[2]}) << endl;
             if (++colIdx[2] == COLPERROW) {
                 colIdx[2] = 0;
                 rowIdx[2]++;
             }
         }
         if (crfSegment % 2) {
-            addrFile << showbase << hex << build_addr({0,0,0,0,rowIdx[2],colIdx[2]}) << endl;
+            addrFile << showbase << hex << build_addr({mapChannel,mapRank,mapBankGroup,0,rowIdx[2],colIdx[2]}) << endl;
             if (++colIdx[2] == COLPERROW) {
                 colIdx[2] = 0;
                 rowIdx[2]++;
@@ -904,37 +935,37 @@ void mapEWAdditionColWiseCLim (ofstream &assembly, ofstream &dataFile, ofstream
         addrFile << "# Out of the main loop" << endl;
         for (i=0; i<peeling/2; i++) {
             // MOVs to GRFs
-            addrFile << showbase << hex << build_addr({0,0,0,0,rowIdx[0],colIdx[0]}) << endl;
-            addrFile << showbase << hex << build_addr({0,0,0,1,rowIdx[0],colIdx[0]}) << endl;
+            addrFile << showbase << hex << build_addr({mapChannel,mapRank,mapBankGroup,0,rowIdx[0],colIdx[0]}) << endl;
+            addrFile << showbase << hex << build_addr({mapChannel,mapRank,mapBankGroup,1,rowIdx[0],colIdx[0]}) << endl;
             if (++colIdx[0] == COLPERROW) {
                 colIdx[0] = 0;
                 rowIdx[0]++;
             }
         }
         if (peeling - 2*i)  // If n it's odd, last one is only with GRF
-            addrFile << showbase << hex << build_addr({0,0,0,0,rowIdx[0],colIdx[0]}) << endl;
+            addrFile << showbase << hex << build_addr({mapChannel,mapRank,mapBankGroup,0,rowIdx[0],colIdx[0]}) << endl;
         for (i=0; i<peeling/2; i++) {
             // ALU ops
-            addrFile << showbase << hex << build_addr({0,0,0,0,rowIdx[1],colIdx[1]}) << endl;
-            addrFile << showbase << hex << build_addr({0,0,0,1,rowIdx[1],colIdx[1]}) << endl;
+            addrFile << showbase << hex << build_addr({mapChannel,mapRank,mapBankGroup,0,rowIdx[1],colIdx[1]}) << endl;
+            addrFile << showbase << hex << build_addr({mapChannel,mapRank,mapBankGroup,1,rowIdx[1],colIdx[1]}) << endl;
             if (++colIdx[1] == COLPERROW) {
                 colIdx[1] = 0;
                 rowIdx[1]++;
             }
         }
         if (peeling - 2*i)  // If n it's odd, last one is only with GRF
-            addrFile << showbase << hex << build_addr({0,0,0,0,rowIdx[1],colIdx[1]}) << endl;
+            addrFile << showbase << hex << build_addr({mapChannel,mapRank,mapBankGroup,0,rowIdx[1],colIdx[1]}) << endl;
         for (i=0; i<peeling/2; i++) {
             // MOVs to BANKs
-            addrFile << showbase << hex << build_addr({0,0,0,0,rowIdx[2],colIdx[2]}) << endl;
-            addrFile << showbase << hex << build_addr({0,0,0,1,rowIdx[2],colIdx[2]}) << endl;
+            addrFile << showbase << hex << build_addr({mapChannel,mapRank,mapBankGroup,0,rowIdx[2],colIdx[2]}) << endl;
+            addrFile << showbase << hex << build_addr({mapChannel,mapRank,mapBankGroup,1,rowIdx[2],colIdx[2]}) << endl;
             if (++colIdx[2] == COLPERROW) {
                 colIdx[2] = 0;
                 rowIdx[2]++;
             }
         }
         if (peeling - 2*i)  // If n it's odd, last one is only with GRF
-            addrFile << showbase << hex << build_addr({0,0,0,0,rowIdx[2],colIdx[2]}) << endl;
+            addrFile << showbase << hex << build_addr({mapChannel,mapRank,mapBankGroup,0,rowIdx[2],colIdx[2]}) << endl;
     }
 
     // Write data for loops and others
@@ -942,34 +973,34 @@ void mapEWAdditionColWiseCLim (ofstream &assembly, ofstream &dataFile, ofstream
     for (i=0; i<loops; i++) {
         for (j=0; j<crfSegment/2; j++){
             // MOVs to GRFs
-            for (k=0; k<2*SIMD_WIDTH*CORES_PER_PCH; k++) {
-                if (k == SIMD_WIDTH*CORES_PER_PCH)
+            for (k=0; k<2*SIMD_WIDTH*LOCKSTEP_CORES; k++) {
+                if (k == SIMD_WIDTH*LOCKSTEP_CORES)
                     dataFile << endl;
-                if(WORD_BITS != 8)
+                if (!CHAR_DATA)
                     dataFile << (VIdx[0] < V ? op1[VIdx[0]][nIdx[0]] : 0) << " "; 
                 else
                     dataFile << int(VIdx[0] < V ? op1[VIdx[0]][nIdx[0]] : 0) << " "; //need to cast the results for int8 only
-                if (!(++VIdx[0] % (SIMD_WIDTH*CORES_PER_PCH))){ // Ended dimension of S vectors
+                if (!(++VIdx[0] % (SIMD_WIDTH*LOCKSTEP_CORES))){ // Ended dimension of S vectors
                     if (++nIdx[0] == n) {       // Finished all dimensions of S vectors
                         nIdx[0] = 0;
                     } else {
-                        VIdx[0] -= SIMD_WIDTH*CORES_PER_PCH;
+                        VIdx[0] -= SIMD_WIDTH*LOCKSTEP_CORES;
                     }
                 }
             }
             dataFile << endl;
         }
         if (crfSegment%2) {
-            for (k=0; k<SIMD_WIDTH*CORES_PER_PCH; k++) {
-                if(WORD_BITS != 8)
+            for (k=0; k<SIMD_WIDTH*LOCKSTEP_CORES; k++) {
+                if (!CHAR_DATA)
                     dataFile << (VIdx[0] < V ? op1[VIdx[0]][nIdx[0]] : 0) << " ";
                 else 
                     dataFile << int(VIdx[0] < V ? op1[VIdx[0]][nIdx[0]] : 0) << " "; //need to cast the results for int8 only
-                if (!(++VIdx[0] % (SIMD_WIDTH*CORES_PER_PCH))){ // Ended dimension of S vectors
+                if (!(++VIdx[0] % (SIMD_WIDTH*LOCKSTEP_CORES))){ // Ended dimension of S vectors
                     if (++nIdx[0] == n) {       // Finished all dimensions of S vectors
                         nIdx[0] = 0;
                     } else {
-                        VIdx[0] -= SIMD_WIDTH*CORES_PER_PCH;
+                        VIdx[0] -= SIMD_WIDTH*LOCKSTEP_CORES;
                     }
                 }
             }
@@ -977,36 +1008,36 @@ void mapEWAdditionColWiseCLim (ofstream &assembly, ofstream &dataFile, ofstream
         }
         for (j=0; j<crfSegment/2; j++){
             // ALU ops
-            for (k=0; k<2*SIMD_WIDTH*CORES_PER_PCH; k++) {
-                if (k == SIMD_WIDTH*CORES_PER_PCH)
+            for (k=0; k<2*SIMD_WIDTH*LOCKSTEP_CORES; k++) {
+                if (k == SIMD_WIDTH*LOCKSTEP_CORES)
                     dataFile << endl;
-                if(WORD_BITS != 8)
+                if (!CHAR_DATA)
                     dataFile << (VIdx[1] < V ? op2[VIdx[1]][nIdx[1]] : 0) << " ";
                 else
                     dataFile << int(VIdx[1] < V ? op2[VIdx[1]][nIdx[1]] : 0) << " "; //need to cast the results for int8 only
-                if (!(++VIdx[1] % (SIMD_WIDTH*CORES_PER_PCH))){ // Ended dimension of S vectors
+                if (!(++VIdx[1] % (SIMD_WIDTH*LOCKSTEP_CORES))){ // Ended dimension of S vectors
                     if (++nIdx[1] == n) {       // Finished all dimensions of S vectors
                         nIdx[1] = 0;
                     } else {
-                        VIdx[1] -= SIMD_WIDTH*CORES_PER_PCH;
+                        VIdx[1] -= SIMD_WIDTH*LOCKSTEP_CORES;
                     }
                 }
             }
             dataFile << endl;
         }
         if (crfSegment%2) {
-            for (k=0; k<SIMD_WIDTH*CORES_PER_PCH; k++) {
-                if(WORD_BITS != 8){
+            for (k=0; k<SIMD_WIDTH*LOCKSTEP_CORES; k++) {
+                if (!CHAR_DATA){
                     dataFile << op2[VIdx[1]][nIdx[1]] << " ";
                     dataFile << (VIdx[1] < V ? op2[VIdx[1]][nIdx[1]] : 0) << " ";}
                 else{
                     dataFile << int(op2[VIdx[1]][nIdx[1]]) << " ";
                     dataFile << int(VIdx[1] < V ? op2[VIdx[1]][nIdx[1]] : 0) << " ";} //need to cast the results for int8 only
-                if (!(++VIdx[1] % (SIMD_WIDTH*CORES_PER_PCH))){ // Ended dimension of S vectors
+                if (!(++VIdx[1] % (SIMD_WIDTH*LOCKSTEP_CORES))){ // Ended dimension of S vectors
                     if (++nIdx[1] == n) {       // Finished all dimensions of S vectors
                         nIdx[1] = 0;
                     } else {
-                        VIdx[1] -= SIMD_WIDTH*CORES_PER_PCH;
+                        VIdx[1] -= SIMD_WIDTH*LOCKSTEP_CORES;
                     }
                 }
             }
@@ -1018,34 +1049,34 @@ void mapEWAdditionColWiseCLim (ofstream &assembly, ofstream &dataFile, ofstream
         dataFile << "# Out of the main loop" << endl;
         for (i=0; i<peeling/2; i++) {
             // MOVs to GRFs
-            for (k=0; k<2*SIMD_WIDTH*CORES_PER_PCH; k++) {
-                if (k == SIMD_WIDTH*CORES_PER_PCH)
+            for (k=0; k<2*SIMD_WIDTH*LOCKSTEP_CORES; k++) {
+                if (k == SIMD_WIDTH*LOCKSTEP_CORES)
                     dataFile << endl;
-                if(WORD_BITS != 8)
+                if (!CHAR_DATA)
                     dataFile << (VIdx[0] < V ? op1[VIdx[0]][nIdx[0]] : 0) << " ";
                 else
                     dataFile << int(VIdx[0] < V ? op1[VIdx[0]][nIdx[0]] : 0) << " "; //need to cast the results for int8 only
-                if (!(++VIdx[0] % (SIMD_WIDTH*CORES_PER_PCH))){ // Ended dimension of S vectors
+                if (!(++VIdx[0] % (SIMD_WIDTH*LOCKSTEP_CORES))){ // Ended dimension of S vectors
                     if (++nIdx[0] == n) {       // Finished all dimensions of S vectors
                         nIdx[0] = 0;
                     } else {
-                        VIdx[0] -= SIMD_WIDTH*CORES_PER_PCH;
+                        VIdx[0] -= SIMD_WIDTH*LOCKSTEP_CORES;
                     }
                 }
             }
             dataFile << endl;
         }
         if (peeling - 2*i) {    // If n it's odd, last one is only with GRF
-            for (k=0; k<SIMD_WIDTH*CORES_PER_PCH; k++) {
-                if(WORD_BITS != 8)
+            for (k=0; k<SIMD_WIDTH*LOCKSTEP_CORES; k++) {
+                if (!CHAR_DATA)
                     dataFile << (VIdx[0] < V ? op1[VIdx[0]][nIdx[0]] : 0) << " ";
                 else 
                     dataFile << int(VIdx[0] < V ? op1[VIdx[0]][nIdx[0]] : 0) << " "; //need to cast the results for int8 only
-                if (!(++VIdx[0] % (SIMD_WIDTH*CORES_PER_PCH))){ // Ended dimension of S vectors
+                if (!(++VIdx[0] % (SIMD_WIDTH*LOCKSTEP_CORES))){ // Ended dimension of S vectors
                     if (++nIdx[0] == n) {       // Finished all dimensions of S vectors
                         nIdx[0] = 0;
                     } else {
-                        VIdx[0] -= SIMD_WIDTH*CORES_PER_PCH;
+                        VIdx[0] -= SIMD_WIDTH*LOCKSTEP_CORES;
                     }
                 }
             }
@@ -1053,34 +1084,34 @@ void mapEWAdditionColWiseCLim (ofstream &assembly, ofstream &dataFile, ofstream
         }
         for (i=0; i<peeling/2; i++) {
             // ALU ops
-            for (k=0; k<2*SIMD_WIDTH*CORES_PER_PCH; k++) {
-                if (k == SIMD_WIDTH*CORES_PER_PCH)
+            for (k=0; k<2*SIMD_WIDTH*LOCKSTEP_CORES; k++) {
+                if (k == SIMD_WIDTH*LOCKSTEP_CORES)
                     dataFile << endl;
-                if(WORD_BITS != 8)
+                if (!CHAR_DATA)
                     dataFile << (VIdx[1] < V ? op2[VIdx[1]][nIdx[1]] : 0) << " ";
                 else
                     dataFile << int(VIdx[1] < V ? op2[VIdx[1]][nIdx[1]] : 0) << " "; //need to cast the results for int8 only
-                if (!(++VIdx[1] % (SIMD_WIDTH*CORES_PER_PCH))){ // Ended dimension of S vectors
+                if (!(++VIdx[1] % (SIMD_WIDTH*LOCKSTEP_CORES))){ // Ended dimension of S vectors
                     if (++nIdx[1] == n) {       // Finished all dimensions of S vectors
                         nIdx[1] = 0;
                     } else {
-                        VIdx[1] -= SIMD_WIDTH*CORES_PER_PCH;
+                        VIdx[1] -= SIMD_WIDTH*LOCKSTEP_CORES;
                     }
                 }
             }
             dataFile << endl;
         }
         if (peeling - 2*i) {    // If n it's odd, last one is only with GRF
-            for (k=0; k<SIMD_WIDTH*CORES_PER_PCH; k++) {
-                if(WORD_BITS != 8)
+            for (k=0; k<SIMD_WIDTH*LOCKSTEP_CORES; k++) {
+                if (!CHAR_DATA)
                     dataFile << (VIdx[1] < V ? op2[VIdx[1]][nIdx[1]] : 0) << " ";
                 else
                     dataFile << int(VIdx[1] < V ? op2[VIdx[1]][nIdx[1]] : 0) << " "; //need to cast the results for int8 only
-                if (!(++VIdx[1] % (SIMD_WIDTH*CORES_PER_PCH))){ // Ended dimension of S vectors
+                if (!(++VIdx[1] % (SIMD_WIDTH*LOCKSTEP_CORES))){ // Ended dimension of S vectors
                     if (++nIdx[1] == n) {       // Finished all dimensions of S vectors
                         nIdx[1] = 0;
                     } else {
-                        VIdx[1] -= SIMD_WIDTH*CORES_PER_PCH;
+                        VIdx[1] -= SIMD_WIDTH*LOCKSTEP_CORES;
                     }
                 }
             }
@@ -1089,3 +1120,202 @@ void mapEWAdditionColWiseCLim (ofstream &assembly, ofstream &dataFile, ofstream
     }
 
 }
+
+void mapEWAddScaleRowWise (ofstream &assembly, ofstream &dataFile, ofstream &addrFile,
+                            cnm_t **op1, cnm_t **op2, cnm_t scale, int V, int n)
+{
+    int i,j;
+    int loads = ceil(float(n*V)/float(SIMD_WIDTH*LOCKSTEP_CORES));     // Columns of op1 in the even bank, op2 in the odd one
+    int tiles = min(GRF_ENTRIES, (CRF_ENTRIES-2)/10);                   // Columns per iteration, the peeled ones also fit
+    int loops = loads/tiles;
+    int peeling = loads % tiles;
+    uint64_t resBase = ceil(float(loads)/float(COLPERROW));             // Result will start in this row of the odd bank
+    uint64_t rowIdx[2] = {0,resBase};
+    uint64_t colIdx[2] = {0,0};
+    uint64_t scaleIdx = 0;
+    int col = 0;
+
+    // Write assembly instructions
+    assembly << "; Row-wise mapping of element-wise addition and scaling, V = " << V << ", n = " << n << endl;
+    assembly << "WRF CRF0" << endl;
+    if (loops) {
+        writeAddScaleBody(assembly, tiles);
+        if (loops-1)
+            assembly << "JUMP " << 5*tiles << " " << loops-1 << endl;
+    }
+    if (peeling) {
+        assembly << "; Out of the main loop" << endl;
+        writeAddScaleBody(assembly, peeling);
+    }
+    assembly << "EXIT" << endl;
+    writeSrfMLoad(assembly, 1);     // Scale
+    assembly << "EXEC" << endl;
+
+    // Write address for loops and others, the columns of every iteration and then the peeled ones
+    addrFile << "# Row-wise mapping of element-wise addition and scaling, V = " << V << ", n = " << n << endl;
+    for (i=0; i<loops+(peeling>0); i++) {
+        int cols = i < loops ? tiles : peeling;
+        for (j=0; j<cols; j++) {
+            // MOVs to GRFs
+            addrFile << showbase << hex << build_addr({mapChannel,mapRank,mapBankGroup,0,rowIdx[0],colIdx[0]}) << endl;
+            addrFile << showbase << hex << build_addr({mapChannel,mapRank,mapBankGroup,1,rowIdx[0],colIdx[0]}) << endl;
+            if (++colIdx[0] == COLPERROW) {
+                colIdx[0] = 0;
+                rowIdx[0]++;
+            }
+        }
+        for (j=0; j<cols; j++) {
+            // MOVs to BANKs
+            addrFile << showbase << hex << build_addr({mapChannel,mapRank,mapBankGroup,1,rowIdx[1],colIdx[1]}) << endl;
+            if (++colIdx[1] == COLPERROW) {
+                colIdx[1] = 0;
+                rowIdx[1]++;
+            }
+        }
+    }
+
+    // Write data, the scale and then the columns loaded by every iteration
+    dataFile << "# Row-wise mapping of element-wise addition and scaling, V = " << V << ", n = " << n << endl;
+    writeSrfMData(dataFile, &scale, &scaleIdx, 1);
+    for (i=0; i<loops+(peeling>0); i++) {
+        int cols = i < loops ? tiles : peeling;
+        for (j=0; j<cols; j++, col++) {
+            writeRowWiseColumn(dataFile, op1, col, V, n);
+            dataFile << endl;
+            writeRowWiseColumn(dataFile, op2, col, V, n);
+            dataFile << endl;
+        }
+    }
+}
+
+void mapEWAdditionDualBank (ofstream &assembly, ofstream &dataFile, ofstream &addrFile,
+                                cnm_t **op1, cnm_t **op2, int V, int n)
+{
+    int i,j;
+    int loads = ceil(float(n*V)/float(SIMD_WIDTH*LOCKSTEP_CORES));     // Columns of op1 in the even bank, op2 in the odd one
+    int tiles = min(GRF_ENTRIES, (CRF_ENTRIES-2)/4);                    // Columns per iteration, the peeled ones also fit
+    int loops = loads/tiles;
+    int peeling = loads % tiles;
+    uint64_t resBase = ceil(float(loads)/float(COLPERROW));             // Result will start in this row of the even bank
+    uint64_t rowIdx[2] = {0,resBase};
+    uint64_t colIdx[2] = {0,0};
+    int col = 0;
+
+    // Write assembly instructions, both operands are read by the same column command
+    assembly << "; Row-wise mapping of element-wise addition from both banks, V = " << V << ", n = " << n << endl;
+    assembly << "WRF CRF0" << endl;
+    for (i=0; i<2; i++) {
+        int cols = i ? peeling : (loops ? tiles : 0);
+        if (i && cols)
+            assembly << "; Out of the main loop" << endl;
+        for (j=0; j<cols; j++)
+            assembly << "ADD GRFA" << j << " EVEN_BANK[AddrFile] ODD_BANK DataFile" << endl;
+        for (j=0; j<cols; j++)
+            assembly << "MOV EVEN_BANK[AddrFile] GRFA" << j << endl;
+        if (!i && loops > 1)
+            assembly << "JUMP " << 2*tiles << " " << loops-1 << endl;
+    }
+    assembly << "EXIT" << endl << "EXEC" << endl;
+
+    // Write address for loops and others, the columns of every iteration and then the peeled ones
+    addrFile << "# Row-wise mapping of element-wise addition from both banks, V = " << V << ", n = " << n << endl;
+    for (i=0; i<loops+(peeling>0); i++) {
+        int cols = i < loops ? tiles : peeling;
+        for (j=0; j<cols; j++) {
+            // ALU ops, the address of the even bank
+            addrFile << showbase << hex << build_addr({mapChannel,mapRank,mapBankGroup,0,rowIdx[0],colIdx[0]}) << endl;
+            if (++colIdx[0] == COLPERROW) {
+                colIdx[0] = 0;
+                rowIdx[0]++;
+            }
+        }
+        for (j=0; j<cols; j++) {
+            // MOVs to BANKs
+            addrFile << showbase << hex << build_addr({mapChannel,mapRank,mapBankGroup,0,rowIdx[1],colIdx[1]}) << endl;
+            if (++colIdx[1] == COLPERROW) {
+                colIdx[1] = 0;
+                rowIdx[1]++;
+            }
+        }
+    }
+
+    // Write data, a line per column with the even bank first
+    dataFile << "# Row-wise mapping of element-wise addition from both banks, V = " << V << ", n = " << n << endl;
+    for (col=0; col<loads; col++) {
+        writeRowWiseColumn(dataFile, op1, col, V, n);
+        writeRowWiseColumn(dataFile, op2, col, V, n);
+        dataFile << endl;
+    }
+}
+
+void mapEWAdditionAam (ofstream &assembly, ofstream &dataFile, ofstream &addrFile,
+                                cnm_t **op1, cnm_t **op2, int V, int n)
+{
+    int i,j,k;
+    int loads = ceil(float(n*V)/float(SIMD_WIDTH*LOCKSTEP_CORES));     // Columns of every operand
+    int pairs = (loads + 1)/2;                                          // Columns of each bank, the last odd one padded
+    int loops = pairs/GRF_ENTRIES;
+    int peeling = pairs % GRF_ENTRIES;
+    uint64_t rows = ceil(float(pairs)/float(COLPERROW));
+    uint64_t rowBase[3] = {0,rows,2*rows};                              // Op1, op2 and result
+    string grf[2] = {"GRFA", "GRFB"};
+    string bank[2] = {"EVEN_BANK", "ODD_BANK"};
+
+    // Write assembly instructions, a program for the main loop and another one for the peeled columns. Every GRF
+    // is loaded, added and stored by an instruction repeated over as many entries as the modulo of the AAM indices,
+    // so that both offsets are back to zero for the next one. Their bank columns follow the first one of every EXEC
+    assembly << "; Row-wise mapping of element-wise addition with AAM loops, V = " << V << ", n = " << n << endl;
+    for (i=0; i<2; i++) {
+        int cols = i ? peeling : (loops ? GRF_ENTRIES : 0);
+        if (!cols)
+            continue;
+        if (i)
+            assembly << "; Out of the main loop" << endl;
+        assembly << "WRF AAM 0 1 " << cols << " 0 1 " << cols << endl;
+        assembly << "WRF CRF0" << endl;
+        for (j=0; j<2; j++) {
+            assembly << "MOVa " << grf[j] << " " << bank[j] << "[AddrFile] DataFile" << endl;
+            if (cols > 1)
+                assembly << "JUMP 1 " << cols-1 << endl;
+            assembly << "ADDa " << grf[j] << " " << grf[j] << " " << bank[j] << "[AddrFile] DataFile" << endl;
+            if (cols > 1)
+                assembly << "JUMP 1 " << cols-1 << endl;
+            assembly << "MOVa " << bank[j] << "[AddrFile] " << grf[j] << endl;
+            if (cols > 1)
+                assembly << "JUMP 1 " << cols-1 << endl;
+        }
+        if (!i && loops > 1)
+            assembly << "JUMP " << (cols > 1 ? 12 : 6) << " " << loops-1 << endl;
+        assembly << "EXIT" << endl << "EXEC" << endl;
+    }
+
+    // Write the first address of every instruction of each EXEC
+    addrFile << "# Row-wise mapping of element-wise addition with AAM loops, V = " << V << ", n = " << n << endl;
+    for (i=0; i<2; i++) {
+        uint64_t col = i ? loops*GRF_ENTRIES : 0;
+        if (!(i ? peeling : loops))
+            continue;
+        for (j=0; j<2; j++) {
+            for (k=0; k<3; k++)
+                addrFile << showbase << hex << build_addr({mapChannel,mapRank,mapBankGroup,uint64_t(j),
+                        rowBase[k] + col/COLPERROW,col % COLPERROW}) << endl;
+        }
+    }
+
+    // Write data, the columns of op1 and op2 of the even bank for every iteration, and then those of the odd one
+    dataFile << "# Row-wise mapping of element-wise addition with AAM loops, V = " << V << ", n = " << n << endl;
+    for (i=0; i<loops+(peeling>0); i++) {
+        int cols = i < loops ? GRF_ENTRIES : peeling;
+        for (j=0; j<2; j++) {
+            for (k=0; k<cols; k++) {
+                writeRowWiseColumn(dataFile, op1, 2*(i*GRF_ENTRIES + k) + j, V, n);
+                dataFile << endl;
+            }
+            for (k=0; k<cols; k++) {
+                writeRowWiseColumn(dataFile, op2, 2*(i*GRF_ENTRIES + k) + j, V, n);
+                dataFile << endl;
+            }
+        }
+    }
+}
+
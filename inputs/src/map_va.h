@@ -23,4 +23,18 @@ void mapEWAdditionColWiseRLim (ofstream &assembly, ofstream &dataFile, ofstream
 void mapEWAdditionColWiseCLim (ofstream &assembly, ofstream &dataFile, ofstream &addrFile,
                                 cnm_t **op1, cnm_t **op2, int V, int n);
 
+// Row-wise mapping of element-wise addition scaled by a scalar, (op1 + op2) * scale
+void mapEWAddScaleRowWise (ofstream &assembly, ofstream &dataFile, ofstream &addrFile,
+                            cnm_t **op1, cnm_t **op2, cnm_t scale, int V, int n);
+
+// Row-wise mapping of element-wise vector addition, with op1 in the even bank and op2 in the odd one read
+// by the same column command (DUAL_BANK)
+void mapEWAdditionDualBank (ofstream &assembly, ofstream &dataFile, ofstream &addrFile,
+                                cnm_t **op1, cnm_t **op2, int V, int n);
+
+// Row-wise mapping of element-wise vector addition, with every load, addition and store written once and
+// repeated over the GRF by a loop, taking the GRF indices and bank columns from the AAM registers (AAM_REGS)
+void mapEWAdditionAam (ofstream &assembly, ofstream &dataFile, ofstream &addrFile,
+                                cnm_t **op1, cnm_t **op2, int V, int n);
+
 #endif  // MAP_VA_H
\ No newline at end of file
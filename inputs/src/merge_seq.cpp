@@ -0,0 +1,57 @@
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+// Format of raw traces: Address    R/W     Data
+// Merges the raw sequences of the partitions of a kernel, taking one command of each
+// partition in turn so that the memory controller sees all the channels and ranks busy
+
+int main(int argc, const char *argv[])
+{
+    if (argc < 3) {
+        cout << "Usage: " << argv[0] << " <output-file> <input-file>..." << endl;
+        return 0;
+    }
+
+    int numInputs = argc - 2;
+    vector<ifstream> input(numInputs);
+    ofstream output;
+    string line;
+
+    // Open input and output files
+    for (int i = 0; i < numInputs; i++) {
+        input[i].open(argv[i+2]);
+        if (!input[i].is_open()) {
+            cout << "Error, could not open " << argv[i+2] << endl;
+            return 1;
+        }
+    }
+    output.open(argv[1]);
+
+    // Round robin over the inputs until all of them are consumed
+    int active = numInputs;
+    while (active) {
+        active = 0;
+        for (int i = 0; i < numInputs; i++) {
+            if (getline(input[i], line)) {
+                if (!line.empty())
+                    output << line << endl;
+                active++;
+            }
+        }
+    }
+
+    for (int i = 0; i < numInputs; i++) {
+        input[i].close();
+    }
+    output.close();
+
+    cout << "Raw sequences merged" << endl;
+
+    return 0;
+}
@@ -7,8 +7,8 @@ enum class DefaultCmd : int {defaultRD, defaultWR, defaultInherit};
 
 int main(int argc, const char *argv[])
 { 
-    if (argc < 3 || argc > 5) {
-        cout << "Usage: " << argv[0] << " <assembly-input> <raw-output> [<data-input> <address-input]" << endl;
+    if (argc < 3 || argc > 8 || argc == 4 || argc == 6) {
+        cout << "Usage: " << argv[0] << " <assembly-input> <raw-output> [<data-input> <address-input> [<channel> <rank> [<bank-group>]]]" << endl;
         return 0;
     }
 
@@ -25,13 +25,22 @@ int main(int argc, const char *argv[])
     rawSeq.open(ro);
 
     // Prepare data input if needed
-    if (argc == 5) {
+    if (argc >= 5) {
         string di = argv[3];    // Input data file name
         string ad = argv[4];    // Input address file name
         dataFile.open(di);
         addrFile.open(ad);
     }
 
+    // Channel, rank and bank group of the partition, for the addresses that are not read from file
+    if (argc >= 7) {
+        asm_channel = atoi(argv[5]);
+        asm_rank = atoi(argv[6]);
+    }
+    if (argc == 8) {
+        asm_bg = atoi(argv[7]);
+    }
+
     bool error = false;
     DefaultCmd defaultCmd = DefaultCmd::defaultRD;  // Change here for the defaulr cmd policy
 
@@ -39,10 +48,12 @@ int main(int argc, const char *argv[])
     uint8_t instrType, storeType;
     string instrTypeString, storeTypeString;
     uint64_t idx;
+    int core;
+    bool unicast, laneSel;
     string dataString, diline;
     float dataFloat;
-#if HALF_FLOAT
-    half_float::half dataHalf;
+#if NARROW_FLOAT
+    cnm_narrow_t dataHalf;
 #else
     cnm_union dataVal;
 #endif
@@ -52,10 +63,18 @@ int main(int argc, const char *argv[])
     deque<dq_type> rfData;
 
     // Variables for writing to CRF
-    std::array<nmcInst, CRF_ENTRIES> crfInstr;
+    std::array<nmcInst, CRF_ENTRIES> crfBank[2];   // Both banks of a double-buffered CRF
+    std::array<nmcInst, CRF_ENTRIES> *crfWr = &crfBank[0];
     uint8_t crfIdx;
+    uint8_t execBank = 0;
     bool crfWrMode = false;
+    bool crfShadow = false;     // Writing the bank that is not executing
+    deque<string> crfPending;   // Writes to that bank, issued along with the next RF writes or at the SWAP
+    vector<nmcInst> crfProg;    // Instructions of the block being written, from index crfBase
+    uint8_t crfBase = 0;
+    vector<nmcInst> crfSrc[2];  // Program of each bank as written in the assembly, before scheduling
     string dstAux, src0Aux, src1Aux, src2Aux;
+    string addDstAux, addSrc0Aux, addSrc1Aux;   // ADD of a MULADD
 
     // Variables for writing EXEC triggers
     uint8_t execIdx = 0;
@@ -63,8 +82,8 @@ int main(int argc, const char *argv[])
     string memCmd;
     uint16_t lastRow, lastCol;
     string lastMemCmd;
-    bool jmpAct;
-    uint16_t jmpNum;
+    vector<pair<int, uint16_t> > jmpStack;  // CRF index and remaining iterations of every active loop, innermost last
+    map<uint8_t, uint64_t> aamAddr;         // Last address of the bank operand of every AAM instruction, with AAM_REGS
 
     // Variables to write the raw sequence
     uint64_t addr;
@@ -98,12 +117,20 @@ int main(int argc, const char *argv[])
                 // If Write to RF (WRF), check target RF
                 case (INSTR::WRF):
 
+                    // Any WRF ends the CRF block being written
+                    if (!crfProg.empty()) {
+                        error = writeCrf(crfProg, crfBase, crfShadow, crfSrc[execBank ^ crfShadow], crfWr, rawSeq, crfPending);
+                        crfProg.clear();
+                        if (error)  break;
+                    }
+
                     // Split storage ID and index
                     if (!(aistream >> storeTypeString)) {
                         cout << "Error when reading which Register File to write to" << endl;
                         error = true;
                         break;
                     }
+                    unicast = splitStoreSuffix(&storeTypeString, CORESEL, &core);
                     splitStoreIndex(&storeTypeString, &idx);
 
                     try{ storeType = STRING2STORE.at(storeTypeString); }
@@ -113,11 +140,26 @@ int main(int argc, const char *argv[])
                         break;
                     }
 
+                    // Only the SRF and GRF can be written in a single core, the one selected by
+                    // the bank and bank group bits when the LSB of the bank is set
+                    if (unicast && (storeType == STORE::CRF || storeType == STORE::CRFS || core < 0 || core >= CORES_PER_PCH)) {
+                        cout << "Error, invalid core for writing to " << storeTypeString << endl;
+                        error = true;
+                        break;
+                    }
+
                     // If WRF to CRF, start CRF writing mode starting at index n, checking if it's valid
-                    if (storeType == STORE::CRF) {
+                    if (storeType == STORE::CRF || storeType == STORE::CRFS) {
+                        if (storeType == STORE::CRFS && !CRF_DBUF) {
+                            cout << "Error, writing to the second CRF bank needs a double-buffered CRF (CRF_DBUF)" << endl;
+                            error = true;
+                            break;
+                        }
                         if (idx < CRF_ENTRIES) {
                             crfWrMode = true;
-                            crfIdx = idx;
+                            crfIdx = crfBase = idx;
+                            crfShadow = (storeType == STORE::CRFS);
+                            crfWr = &crfBank[execBank ^ crfShadow];
                         } else {
                             cout << "Error, starting to write out of CRF range" << endl;
                             error = true;
@@ -126,9 +168,19 @@ int main(int argc, const char *argv[])
 
                     // Else, write to output the correct {A,R/W,D}
                     } else {
-                        
-                        // Obtain the data to write to the RF
-                        if (aistream >> dataString) {
+
+                        // The RF row is already being written, so the pending writes to the other CRF bank go first
+                        while (!crfPending.empty()) {
+                            rawSeq << crfPending.front() << endl;
+                            crfPending.pop_front();
+                        }
+
+                        // Obtain the data to write to the RF, or the fields of the AAM configuration
+                        if (storeType == STORE::AAM) {
+                            error = getAamConfig(aistream, &dataAux);
+                            if (error)  break;
+                            rfData.push_back(dataAux);
+                        } else if (aistream >> dataString) {
                             // Read from data file
                             if (!dataString.compare(DATAFILE)){
                                 do {
@@ -139,7 +191,7 @@ int main(int argc, const char *argv[])
                                     }
                                 } while (diline.length() == 0  || diline.at(0) == '#');
                                 istringstream distream(diline);
-#if (HALF_FLOAT)
+#if (NARROW_FLOAT)
                                 while (distream >> dataFloat) {  
                                     dataHalf = dataFloat;
                                     dataBin = dataHalf.bin_word();
@@ -157,10 +209,10 @@ int main(int argc, const char *argv[])
                                     rfBin.push_back(dataVal.bin);
                                 }
 #endif  // DATA_TYPE == 4
-#endif  // HALF_FLOAT
+#endif  // NARROW_FLOAT
                             // Read from assembly file
                             } else {
-#if (HALF_FLOAT)
+#if (NARROW_FLOAT)
                                 dataFloat = stof(dataString);
                                 dataHalf = dataFloat;
                                 dataBin = dataHalf.bin_word();
@@ -238,6 +290,28 @@ int main(int argc, const char *argv[])
                                 rfBin.pop_front();
                                 rfData.push_back(dataAux);
                             break;
+                            case (STORE::SRFMP):
+                            case (STORE::SRFAP):
+                                if (rfBin.empty() || rfBin.size() > (storeType == STORE::SRFMP ? SRF_M_PACK : SRF_A_PACK)
+                                        || idx + rfBin.size() > (storeType == STORE::SRFMP ? SRF_M_ENTRIES : SRF_A_ENTRIES)) {
+                                    cout << "Error trying to write to " << storeTypeString << endl;
+                                    error = true;
+                                    break;
+                                }
+
+                                // The burst is as wide as a GRF entry, the lanes after the given data are zeroed
+                                rfBin.resize(SIMD_WIDTH, 0);
+                                for (int i = 0; i < (SIMD_WIDTH)/(WORDS_PER_BURST); i++) {
+                                    dataAux = 0;
+                                    for (int j = 0; j < WORDS_PER_BURST; j++) {
+                                        dataAux |= (MASK & (dq_type) rfBin.front()) << j*WORD_BITS;
+                                        rfBin.pop_front();
+                                    }
+                                    rfData.push_back(dataAux);
+                                }
+                            break;
+                            case (STORE::AAM):
+                            break;
                             default:
                                 cout << "Error, trying to write to BANK" << endl;
                                 error = true;
@@ -245,7 +319,12 @@ int main(int argc, const char *argv[])
                         }
 
                         // Parse index to address
-                        addr = build_addr({0, 0, 0, 0, storeType, idx}, true);
+                        if (unicast) {
+                            addr = build_addr({asm_channel, asm_rank, uint64_t(core >> (BANK_BITS - 1)),
+                                    uint64_t(((core << 1) | 1) & ((1 << BANK_BITS) - 1)), storeType, idx}, true);
+                        } else {
+                            addr = build_addr({asm_channel, asm_rank, asm_bg, 0, storeType, idx}, true);
+                        }
 
                         // Write command
                         rawSeq << showbase << hex << addr << "\tWR";
@@ -258,14 +337,42 @@ int main(int argc, const char *argv[])
 
                 break;
                 
+                // If SWAP, finish writing the other CRF bank and make it the executing one
+                case (INSTR::SWAP):
+                    if (!CRF_DBUF) {
+                        cout << "Error, SWAP needs a double-buffered CRF (CRF_DBUF)" << endl;
+                        error = true;
+                        break;
+                    }
+                    if (!crfProg.empty()) {
+                        error = writeCrf(crfProg, crfBase, crfShadow, crfSrc[execBank ^ crfShadow], crfWr, rawSeq, crfPending);
+                        crfProg.clear();
+                        if (error)  break;
+                    }
+                    while (!crfPending.empty()) {
+                        rawSeq << crfPending.front() << endl;
+                        crfPending.pop_front();
+                    }
+                    addr = build_addr({asm_channel, asm_rank, asm_bg, 0, STORE::CRFSWAP, 0}, true);
+                    rawSeq << showbase << hex << addr << "\tWR\t" << 0 << endl;
+                    execBank ^= 1;
+                    crfWrMode = false;
+                break;
+
                 // If EXEC, stop CRF writing mode and write to output the {A,R/W,D} sequence
                 // that will trigger execution starting from index 0, taking into account 
                 // the loops (and maybe later the NOPs)
                 case (INSTR::EXEC):
 
+                    if (!crfProg.empty()) {
+                        error = writeCrf(crfProg, crfBase, crfShadow, crfSrc[execBank ^ crfShadow], crfWr, rawSeq, crfPending);
+                        crfProg.clear();
+                        if (error)  break;
+                    }
+
                     execStop = false;
-                    jmpAct = false;
-                    jmpNum = 0;
+                    jmpStack.clear();
+                    aamAddr.clear();
                     lastRow = lastCol = 0;
                     lastMemCmd = "RD";
                     execIdx = 0;
@@ -275,41 +382,41 @@ int main(int argc, const char *argv[])
                         
                         memCmd = "DC";
 
-                        nmcInst execInstr = crfInstr.at(execIdx);
+                        nmcInst execInstr = crfBank[execBank].at(execIdx);
 
                         // Check if we need a specific address 
                         // and decide if we need a WR or RD command
                         if (execInstr.dst == OPC_EVEN_BANK || execInstr.dst == OPC_ODD_BANK) {
                             if (execInstr.dstAddrFile) {
-                                error = getAddrFromFile(addrFile, &addr);
+                                error = getExecAddr(addrFile, execInstr, execIdx, aamAddr, &addr);
                             } else {
                                 addr = execInstr.idxDst;
                             }
                             memCmd = "WR";
                         } else if (execInstr.src0 == OPC_EVEN_BANK || execInstr.src0 == OPC_ODD_BANK) {
                             if (execInstr.src0AddrFile) {
-                                error = getAddrFromFile(addrFile, &addr);
+                                error = getExecAddr(addrFile, execInstr, execIdx, aamAddr, &addr);
                             } else {
                                 addr = execInstr.idxSrc0;
                             }
                             memCmd = "RD";
                         } else if (execInstr.src1 == OPC_EVEN_BANK || execInstr.src1 == OPC_ODD_BANK) {
                             if (execInstr.src1AddrFile) {
-                                error = getAddrFromFile(addrFile, &addr);
+                                error = getExecAddr(addrFile, execInstr, execIdx, aamAddr, &addr);
                             } else {
                                 addr = execInstr.idxSrc1;
                             }
                             memCmd = "RD";
                         } else if (execInstr.src2 == OPC_EVEN_BANK || execInstr.src2 == OPC_ODD_BANK) {
                             if (execInstr.src2AddrFile) {
-                                error = getAddrFromFile(addrFile, &addr);
+                                error = getExecAddr(addrFile, execInstr, execIdx, aamAddr, &addr);
                             } else {
                                 addr = execInstr.idxSrc2;
                             }
                             memCmd = "RD";
                         } else {
                             // If not, generate one.
-                            addr = build_addr({0, 0, 0, 0, lastRow, lastCol}, false);
+                            addr = build_addr({asm_channel, asm_rank, asm_bg, 0, lastRow, lastCol}, false);
                             switch (defaultCmd){
                                 case DefaultCmd::defaultWR:
                                     memCmd = "WR";
@@ -358,20 +465,24 @@ int main(int argc, const char *argv[])
                             execStop = true;
                         // Check if its a jump, and if so proceed accordingly
                         } else if (execInstr.opCode == OP_JUMP) {
-                            // If first time seen it, set target and number of loops
-                            if (!jmpAct) {
-                                jmpAct = true;
-                                jmpNum = execInstr.imm1-1;
-                                execIdx -= execInstr.imm0;
-                            // Else, check the loop counter
+                            // If first time seen it, push a nested loop with its target and number of loops
+                            if (jmpStack.empty() || jmpStack.back().first != execIdx) {
+                                if (jmpStack.size() < LOOP_DEPTH) {
+                                    jmpStack.push_back(make_pair(execIdx, uint16_t(execInstr.imm1-1)));
+                                    execIdx -= execInstr.imm0;
+                                } else {    // Deeper nesting than the hardware stack is ignored
+                                    cout << "Warning, JUMP at CRF" << execIdx << " nested deeper than " << LOOP_DEPTH << " loops" << endl;
+                                    execIdx++;
+                                }
+                            // Else, check the loop counter of the innermost loop
                             } else {
-                                // If final one, clean loop variables and increase execIdx normally
-                                if (jmpNum == 0) {
-                                    jmpAct = false;
+                                // If final one, return to the enclosing loop and increase execIdx normally
+                                if (jmpStack.back().second == 0) {
+                                    jmpStack.pop_back();
                                     execIdx++;
                                 // Else, update execIdx and decrease loop counter
                                 } else {
-                                    jmpNum--;
+                                    jmpStack.back().second--;
                                     execIdx -= execInstr.imm0;
                                 }
                             }
@@ -381,9 +492,8 @@ int main(int argc, const char *argv[])
                     }
                 break;
 
-                // Else, decode the instruction, write it into the instruction array mimicking the CRF,
-                // generate the traces for writing to the CRF, advance index
-                // and check it's not higher than the CRF size
+                // Else, decode the instruction, add it to the block written to the CRF at the next
+                // WRF, SWAP or EXEC, advance index and check it's not higher than the CRF size
                 default:
                     if (!crfWrMode || crfIdx >= CRF_ENTRIES) {
                         cout << "Error when trying to write NMC instructions" << endl;
@@ -400,7 +510,7 @@ int main(int argc, const char *argv[])
                                 error = true;
                                 break;
                             }
-                            crfInstr.at(crfIdx) = *currInstr;
+                            crfWr->at(crfIdx) = *currInstr;
                         break;
 
                         case INSTR::JUMP:
@@ -410,36 +520,86 @@ int main(int argc, const char *argv[])
                                 error = true;
                                 break;
                             }
-                            crfInstr.at(crfIdx) = *currInstr;
+                            crfWr->at(crfIdx) = *currInstr;
                         break;
 
                         case INSTR::EXIT:
                             currInstr->opCode = INSTR2OPCODE.at(instrType);
-                            crfInstr.at(crfIdx) = *currInstr;
+                            crfWr->at(crfIdx) = *currInstr;
                         break;
 
                         case INSTR::MOV:
+                        case INSTR::MOVa:
                             currInstr->opCode = INSTR2OPCODE.at(instrType);
                             if (!(aistream >> dstAux >> src0Aux)) {
                                 cout << "Error when reading MOV parameters" << endl;
                                 error = true;
                                 break;
                             }
+                            laneSel = splitStoreSuffix(&src0Aux, LANESEL, &(currInstr->lane));
                             currInstr->dstAddrFile = splitStoreIndex(&dstAux, &(currInstr->idxDst));
                             currInstr->src0AddrFile = splitStoreIndex(&src0Aux, &(currInstr->idxSrc0));
                             try {
-                                currInstr->dst = STRING2OPCSTORAGE.at(dstAux);
-                                currInstr->src0 = STRING2OPCSTORAGE.at(src0Aux);
+                                // Block loads from a bank to the SRF are signaled with the ReLU bit
+                                if (STRING2OPCBLOCK.count(dstAux)) {
+                                    currInstr->dst = STRING2OPCBLOCK.at(dstAux);
+                                    currInstr->relu = true;
+                                } else {
+                                    currInstr->dst = STRING2OPCSTORAGE.at(dstAux);
+                                }
+                                // RING<i> is the GRF_B entry i of the previous core in the ring
+                                currInstr->src0 = (src0Aux == "RING") ? uint8_t(OPC_RING) : STRING2OPCSTORAGE.at(src0Aux);
                             } catch (const std::out_of_range& oor) {
                                 cout << "Error when reading MOV parameters" << endl;
                                 error = true;
                                 break;
                             }
 
+                            if (currInstr->src0 == OPC_RING) {
+                                if (!CORE_RING) {
+                                    cout << "Error, MOV from RING needs the core ring (CORE_RING)" << endl;
+                                    error = true;
+                                    break;
+                                }
+                                if (currInstr->dst > OPC_GRF_B || instrType == INSTR::MOVa) {
+                                    cout << "Error, MOV from RING can only write a GRF" << endl;
+                                    error = true;
+                                    break;
+                                }
+                            }
+
+                            // Lanes are only selected when loading from a bank to the SRF
+                            if ((laneSel || currInstr->relu) && ((currInstr->dst != OPC_SRF_M && currInstr->dst != OPC_SRF_A)
+                                    || (currInstr->src0 != OPC_EVEN_BANK && currInstr->src0 != OPC_ODD_BANK))) {
+                                cout << "Error, lanes can only be loaded from a bank to the SRF" << endl;
+                                error = true;
+                                break;
+                            }
+                            if (currInstr->lane < 0 || currInstr->lane >= SIMD_WIDTH) {
+                                cout << "Error, lane out of the SIMD range" << endl;
+                                error = true;
+                                break;
+                            }
+
+                            // A MOVa takes the indices of its GRF operands from the AAM registers
+                            if (instrType == INSTR::MOVa) {
+                                if (!AAM_REGS) {
+                                    cout << "Error, MOVa needs the AAM registers (AAM_REGS)" << endl;
+                                    error = true;
+                                    break;
+                                }
+                                if (currInstr->dst > OPC_GRF_B && currInstr->src0 > OPC_GRF_B) {
+                                    cout << "Error, MOVa needs a GRF operand" << endl;
+                                    error = true;
+                                    break;
+                                }
+                                currInstr->aam = true;
+                            }
+
                             if (!error)
                                 error = getInstData(aistream, rfBin, currInstr);
 
-                            crfInstr.at(crfIdx) = *currInstr;
+                            crfWr->at(crfIdx) = *currInstr;
                         break;
                         
                         case INSTR::RELU:
@@ -464,12 +624,120 @@ int main(int argc, const char *argv[])
                                 error = getInstData(aistream, rfBin, currInstr);
 
                             currInstr->relu = true;
-                            crfInstr.at(crfIdx) = *currInstr;
+                            crfWr->at(crfIdx) = *currInstr;
                         break;
 
                         case INSTR::FILL:
-                            cout << "Error, FILL is not yet implemented" << endl;
-                            error = true;
+                            currInstr->opCode = INSTR2OPCODE.at(instrType);
+                            if (!(aistream >> dstAux >> src0Aux)) {
+                                cout << "Error when reading FILL parameters" << endl;
+                                error = true;
+                                break;
+                            }
+                            currInstr->dstAddrFile = splitStoreIndex(&dstAux, &(currInstr->idxDst));
+                            try {
+                                currInstr->dst = STRING2OPCSTORAGE.at(dstAux);
+                                // The source is either an SRF entry or an integer immediate
+                                if (STRING2OPCSTORAGE.count(src0Aux.substr(0, src0Aux.find_first_of("0123456789[")))) {
+                                    currInstr->src0AddrFile = splitStoreIndex(&src0Aux, &(currInstr->idxSrc0));
+                                    currInstr->src0 = STRING2OPCSTORAGE.at(src0Aux);
+                                } else {
+                                    currInstr->imm = stoi(src0Aux);
+                                    currInstr->fillImm = true;
+                                }
+                            } catch (const std::exception& e) {
+                                cout << "Error when reading FILL parameters" << endl;
+                                error = true;
+                                break;
+                            }
+
+                            // Bank columns are written with a MOV from a GRF
+                            if (currInstr->dst == OPC_EVEN_BANK || currInstr->dst == OPC_ODD_BANK
+                                    || (!currInstr->fillImm && currInstr->src0 != OPC_SRF_M && currInstr->src0 != OPC_SRF_A)) {
+                                cout << "Error, FILL only writes an SRF entry or an immediate into a GRF or the SRF" << endl;
+                                error = true;
+                                break;
+                            }
+                            if (currInstr->imm < -(1 << (FILL_IMM_STA-FILL_IMM_END)) || currInstr->imm >= (1 << (FILL_IMM_STA-FILL_IMM_END))) {
+                                cout << "Error, FILL immediate out of range" << endl;
+                                error = true;
+                                break;
+                            }
+
+                            crfWr->at(crfIdx) = *currInstr;
+                        break;
+
+                        case INSTR::PERM:
+                            currInstr->opCode = INSTR2OPCODE.at(instrType);
+                            if (!(aistream >> dstAux >> src0Aux >> src1Aux >> currInstr->imm)) {
+                                cout << "Error when reading PERM parameters" << endl;
+                                error = true;
+                                break;
+                            }
+                            currInstr->dstAddrFile = splitStoreIndex(&dstAux, &(currInstr->idxDst));
+                            currInstr->src0AddrFile = splitStoreIndex(&src0Aux, &(currInstr->idxSrc0));
+                            try {
+                                currInstr->dst = STRING2OPCSTORAGE.at(dstAux);
+                                currInstr->src0 = STRING2OPCSTORAGE.at(src0Aux);
+                            } catch (const std::out_of_range& oor) {
+                                cout << "Error when reading PERM parameters" << endl;
+                                error = true;
+                                break;
+                            }
+                            for (auto const &p : PERM_SEL_STRING) {
+                                if (p.first != PERM_NONE && p.second == src1Aux)
+                                    currInstr->perm = p.first;
+                            }
+
+                            // The lanes of a GRF entry are permuted as they are written to a GRF
+                            if (!LANE_PERM) {
+                                cout << "Error, PERM needs the lane permutation unit (LANE_PERM)" << endl;
+                                error = true;
+                                break;
+                            }
+                            if (currInstr->dst > OPC_GRF_B || currInstr->src0 > OPC_GRF_B || currInstr->perm == PERM_NONE) {
+                                cout << "Error, PERM shifts (SHL, SHR), rotates (ROT) or broadcasts (BCAST) the lanes of a GRF into a GRF" << endl;
+                                error = true;
+                                break;
+                            }
+                            if (currInstr->imm < 0 || currInstr->imm >= SIMD_WIDTH) {
+                                cout << "Error, PERM lanes out of the SIMD range" << endl;
+                                error = true;
+                                break;
+                            }
+
+                            crfWr->at(crfIdx) = *currInstr;
+                        break;
+
+                        case INSTR::RED:
+                        case INSTR::REDMAX:
+                            currInstr->opCode = INSTR2OPCODE.at(instrType);
+                            if (!(aistream >> dstAux >> src0Aux)) {
+                                cout << "Error when reading " << instrTypeString << " parameters" << endl;
+                                error = true;
+                                break;
+                            }
+                            currInstr->dstAddrFile = splitStoreIndex(&dstAux, &(currInstr->idxDst));
+                            currInstr->src0AddrFile = splitStoreIndex(&src0Aux, &(currInstr->idxSrc0));
+                            try {
+                                currInstr->dst = STRING2OPCSTORAGE.at(dstAux);
+                                currInstr->src0 = STRING2OPCSTORAGE.at(src0Aux);
+                            } catch (const std::out_of_range& oor) {
+                                cout << "Error when reading " << instrTypeString << " parameters" << endl;
+                                error = true;
+                                break;
+                            }
+
+                            // The lanes of a GRF entry are reduced into lane 0 of a GRF entry or into an SRF entry
+                            if ((currInstr->src0 != OPC_GRF_A && currInstr->src0 != OPC_GRF_B)
+                                    || currInstr->dst == OPC_EVEN_BANK || currInstr->dst == OPC_ODD_BANK) {
+                                cout << "Error, only GRFs can be reduced into a GRF or the SRF" << endl;
+                                error = true;
+                                break;
+                            }
+
+                            currInstr->redMax = (instrType == INSTR::REDMAX);
+                            crfWr->at(crfIdx) = *currInstr;
                         break;
 
                         case INSTR::ADD:
@@ -495,7 +763,7 @@ int main(int argc, const char *argv[])
                             if (!error)
                                 error = getInstData(aistream, rfBin, currInstr);
 
-                            crfInstr.at(crfIdx) = *currInstr;
+                            crfWr->at(crfIdx) = *currInstr;
                         break;
 
                         case INSTR::ADDa:
@@ -522,7 +790,7 @@ int main(int argc, const char *argv[])
                                 error = getInstData(aistream, rfBin, currInstr);
 
                             currInstr->aam = true;
-                            crfInstr.at(crfIdx) = *currInstr;
+                            crfWr->at(crfIdx) = *currInstr;
                         break;
 
                         case INSTR::MUL:
@@ -548,7 +816,7 @@ int main(int argc, const char *argv[])
                             if (!error)
                                 error = getInstData(aistream, rfBin, currInstr);
 
-                            crfInstr.at(crfIdx) = *currInstr;
+                            crfWr->at(crfIdx) = *currInstr;
                         break;
 
                         case INSTR::MULa:
@@ -575,7 +843,7 @@ int main(int argc, const char *argv[])
                                 error = getInstData(aistream, rfBin, currInstr);
 
                             currInstr->aam = true;
-                            crfInstr.at(crfIdx) = *currInstr;  
+                            crfWr->at(crfIdx) = *currInstr;  
                         break;
 
                         case INSTR::MAD:
@@ -603,7 +871,7 @@ int main(int argc, const char *argv[])
                             if (!error)
                                 error = getInstData(aistream, rfBin, currInstr);
 
-                            crfInstr.at(crfIdx) = *currInstr;
+                            crfWr->at(crfIdx) = *currInstr;
                         break;
 
                         case INSTR::MADa:
@@ -632,13 +900,20 @@ int main(int argc, const char *argv[])
                                 error = getInstData(aistream, rfBin, currInstr);
 
                             currInstr->aam = true;
-                            crfInstr.at(crfIdx) = *currInstr;
+                            crfWr->at(crfIdx) = *currInstr;
                         break;
 
+                        case INSTR::MACW:
+#if !WIDE_ACC
+                            cout << "Error, MACW needs WIDE_ACC" << endl;
+                            error = true;
+                            break;
+#endif
+                        // fall through
                         case INSTR::MAC:
                             currInstr->opCode = INSTR2OPCODE.at(instrType);
                             if (!(aistream >> dstAux >> src0Aux >> src1Aux)) {
-                                cout << "Error when reading MAC parameters" << endl;
+                                cout << "Error when reading " << INSTR2STRING.at(instrType) << " parameters" << endl;
                                 error = true;
                                 break;
                             }
@@ -650,7 +925,7 @@ int main(int argc, const char *argv[])
                                 currInstr->src0 = STRING2OPCSTORAGE.at(src0Aux);
                                 currInstr->src1 = STRING2OPCSTORAGE.at(src1Aux);
                             } catch (const std::out_of_range& oor) {
-                                cout << "Error when reading MAC parameters" << endl;
+                                cout << "Error when reading " << INSTR2STRING.at(instrType) << " parameters" << endl;
                                 error = true;
                                 break;
                             }
@@ -658,7 +933,7 @@ int main(int argc, const char *argv[])
                             if (!error)
                                 error = getInstData(aistream, rfBin, currInstr);
 
-                            crfInstr.at(crfIdx) = *currInstr;  
+                            crfWr->at(crfIdx) = *currInstr;  
                         break;
 
                         case INSTR::MACa:
@@ -685,7 +960,53 @@ int main(int argc, const char *argv[])
                                 error = getInstData(aistream, rfBin, currInstr);
 
                             currInstr->aam = true;
-                            crfInstr.at(crfIdx) = *currInstr;  
+                            crfWr->at(crfIdx) = *currInstr;  
+                        break;
+
+                        // MUL and ADD issued in the same cycle, from the RFs only
+                        case INSTR::MULADD:
+#if DUAL_ISSUE
+                        {
+                            nmcInst mulInstr, addInstr;
+                            if (!(aistream >> dstAux >> src0Aux >> src1Aux >> addDstAux >> addSrc0Aux >> addSrc1Aux)) {
+                                cout << "Error when reading MULADD parameters" << endl;
+                                error = true;
+                                break;
+                            }
+                            mulInstr.opCode = OP_MUL;
+                            addInstr.opCode = OP_ADD;
+                            splitStoreIndex(&dstAux, &(mulInstr.idxDst));
+                            splitStoreIndex(&src0Aux, &(mulInstr.idxSrc0));
+                            splitStoreIndex(&src1Aux, &(mulInstr.idxSrc1));
+                            splitStoreIndex(&addDstAux, &(addInstr.idxDst));
+                            splitStoreIndex(&addSrc0Aux, &(addInstr.idxSrc0));
+                            splitStoreIndex(&addSrc1Aux, &(addInstr.idxSrc1));
+                            try {
+                                mulInstr.dst = STRING2OPCSTORAGE.at(dstAux);
+                                mulInstr.src0 = STRING2OPCSTORAGE.at(src0Aux);
+                                mulInstr.src1 = STRING2OPCSTORAGE.at(src1Aux);
+                                addInstr.dst = STRING2OPCSTORAGE.at(addDstAux);
+                                addInstr.src0 = STRING2OPCSTORAGE.at(addSrc0Aux);
+                                addInstr.src1 = STRING2OPCSTORAGE.at(addSrc1Aux);
+                            } catch (const std::out_of_range& oor) {
+                                cout << "Error when reading MULADD parameters" << endl;
+                                error = true;
+                                break;
+                            }
+
+                            if (!dualPair(mulInstr, addInstr)) {
+                                cout << "Error, the MUL and the ADD of a MULADD cannot be issued together" << endl;
+                                error = true;
+                                break;
+                            }
+
+                            *currInstr = fuseMulAdd(mulInstr, addInstr);
+                            crfWr->at(crfIdx) = *currInstr;
+                        }
+#else
+                            cout << "Error, MULADD needs DUAL_ISSUE" << endl;
+                            error = true;
+#endif
                         break;
 
                         default:
@@ -694,26 +1015,21 @@ int main(int argc, const char *argv[])
                         break;
                     }
 
-                    // Parse index to address
-#if CRF_BANK_ADDR
-                    // If not enough column bits to address CRF, using also bank bits
-                    uint bank_aux = (crfIdx >> addr_bits[int(Level::Column)]) & ((1 << addr_bits[int(Level::Bank)]) - 1);
-                    uint col_aux = crfIdx & ((1 << addr_bits[int(Level::Column)]) - 1);
-                    addr = build_addr({0, 0, 0, bank_aux, STORE::CRF, col_aux}, true);
-#else
-                    addr = build_addr({0, 0, 0, 0, STORE::CRF, crfIdx}, true);
-#endif
+                    // Several bank operands are read by a single column command, from both banks of the pair
+                    if (!error) {
+                        int evenRd = (currInstr->src0 == OPC_EVEN_BANK) + (currInstr->src1 == OPC_EVEN_BANK) + (currInstr->src2 == OPC_EVEN_BANK);
+                        int oddRd = (currInstr->src0 == OPC_ODD_BANK) + (currInstr->src1 == OPC_ODD_BANK) + (currInstr->src2 == OPC_ODD_BANK);
+                        if (evenRd + oddRd > 1 && !DUAL_BANK) {
+                            cout << "Error, reading two bank operands needs DUAL_BANK" << endl;
+                            error = true;
+                        } else if (evenRd > 1 || oddRd > 1) {
+                            cout << "Error, the bank operands of an instruction must be the even and the odd bank of a pair" << endl;
+                            error = true;
+                        }
+                    }
 
-                    // Write command
-                    rawSeq << showbase << hex << addr << "\tWR\t";
-                    uint64_t instTemp = build_instr(*currInstr);
-#if DQ_BITS == 16
-                    uint16_t instLowerPart = instTemp & 0xFFFF;
-                    uint16_t instUpperPart = (instTemp >> 16) & 0xFFFF;
-                    rawSeq << hex << instLowerPart << "\t" << instUpperPart << endl;
-#else
-                    rawSeq << hex << instTemp << endl;
-#endif
+                    // The block is scheduled and written to the CRF once it is complete
+                    crfProg.push_back(*currInstr);
 
                     // Advance CRF index
                     crfIdx++;
@@ -722,13 +1038,24 @@ int main(int argc, const char *argv[])
         }
     }
 
+    // A CRF block at the end of the assembly, and the writes to the other CRF bank that were never
+    // followed by RF writes or a SWAP
+    if (!crfProg.empty() && !error)
+        error = writeCrf(crfProg, crfBase, crfShadow, crfSrc[execBank ^ crfShadow], crfWr, rawSeq, crfPending);
+    while (!crfPending.empty()) {
+        rawSeq << crfPending.front() << endl;
+        crfPending.pop_front();
+    }
+
     assembly.close();
     rawSeq.close();
-    if (argc == 5) {
+    if (argc >= 5) {
         dataFile.close();
         addrFile.close();
     }
 
+    if (error)
+        return 1;
     cout << "Raw sequence generated" << endl;
 
     return 0;
@@ -787,6 +1114,21 @@ bool splitStoreIndex(string* storeTypeString, uint64_t *idx)
     return addressFromFile;
 }
 
+bool splitStoreSuffix(string* storeTypeString, const string &suffix, int *value)
+{
+    size_t pos = storeTypeString->find(suffix);
+
+    if (pos == string::npos) {
+        return false;
+    }
+
+    try { *value = stoi(storeTypeString->substr(pos + suffix.length())); }
+    catch (const std::exception& e) { *value = -1; }
+    *storeTypeString = storeTypeString->substr(0, pos);
+
+    return true;
+}
+
 uint8_t get_bank(uint64_t addr) {
     uint64_t bank, bankMask;
     uint offset = global_offset; // Initial offset
@@ -844,6 +1186,30 @@ uint16_t get_col(uint64_t addr) {
     return col;
 }
 
+uint64_t next_col(uint64_t addr) {
+    uint offset = global_offset; // Initial offset
+    uint colOffset = 0, rowOffset = 0;
+    uint64_t col = get_col(addr) + 1;
+    uint64_t row = get_row(addr);
+
+    // Position of the column and the row in the address
+    for (int lvl = 0; lvl < int(Level::MAX); lvl++) {
+        if (addr_map[lvl] == Level::Column)
+            colOffset = offset;
+        else if (addr_map[lvl] == Level::Row)
+            rowOffset = offset;
+        offset += addr_bits[int(addr_map[lvl])];
+    }
+    if (col >> addr_bits[int(Level::Column)]) {
+        col = 0;
+        row++;
+    }
+    addr &= ~(((uint64_t(1) << addr_bits[int(Level::Column)]) - 1) << colOffset);
+    addr &= ~(((uint64_t(1) << addr_bits[int(Level::Row)]) - 1) << rowOffset);
+
+    return addr | (col << colOffset) | (row << rowOffset);
+}
+
 uint64_t build_instr(nmcInst instrData) {
     uint32_t instrWord = 0;
 
@@ -860,6 +1226,7 @@ uint64_t build_instr(nmcInst instrData) {
         case OP_MUL:
         case OP_MAD:
         case OP_MAC:
+        case OP_MACW:
             instrWord |= (instrData.opCode & ((1 << (OPCODE_STA-OPCODE_END+1)) - 1)) << OPCODE_END;
             instrWord |= (instrData.dst & ((1 << (DST_STA-DST_END+1)) - 1)) << DST_END;
             instrWord |= (instrData.src0 & ((1 << (SRC0_STA-SRC0_END+1)) - 1)) << SRC0_END;
@@ -872,26 +1239,612 @@ uint64_t build_instr(nmcInst instrData) {
         break;
 
         case OP_MOV:
-        case OP_FILL:
             instrWord |= (instrData.opCode & ((1 << (OPCODE_STA-OPCODE_END+1)) - 1)) << OPCODE_END;
             instrWord |= (instrData.dst & ((1 << (DST_STA-DST_END+1)) - 1)) << DST_END;
             instrWord |= (instrData.src0 & ((1 << (SRC0_STA-SRC0_END+1)) - 1)) << SRC0_END;
             instrWord |= (instrData.relu & 1) << RELU_BIT;
+            instrWord |= (instrData.aam & 1) << MOV_AAM_BIT;
             instrWord |= (instrData.idxDst & ((1 << (DST_N_STA-DST_N_END+1)) - 1)) << DST_N_END;
-            instrWord |= (instrData.idxSrc0 & ((1 << (SRC0_N_STA-SRC0_N_END+1)) - 1)) << SRC0_N_END;
+            if (instrData.src0 == OPC_EVEN_BANK || instrData.src0 == OPC_ODD_BANK)   // The index of a bank is its lane
+                instrWord |= (instrData.lane & ((1 << (SRC0_N_STA-SRC0_N_END+1)) - 1)) << SRC0_N_END;
+            else
+                instrWord |= (instrData.idxSrc0 & ((1 << (SRC0_N_STA-SRC0_N_END+1)) - 1)) << SRC0_N_END;
             instrWord |= (instrData.idxSrc1 & ((1 << (SRC1_N_STA-SRC1_N_END+1)) - 1)) << SRC1_N_END;
         break;
+
+        case OP_FILL:
+            instrWord |= (instrData.opCode & ((1 << (OPCODE_STA-OPCODE_END+1)) - 1)) << OPCODE_END;
+            instrWord |= (instrData.dst & ((1 << (DST_STA-DST_END+1)) - 1)) << DST_END;
+            instrWord |= (instrData.src0 & ((1 << (SRC0_STA-SRC0_END+1)) - 1)) << SRC0_END;
+            instrWord |= (instrData.fillImm & 1) << IMM_BIT;
+            instrWord |= (instrData.idxDst & ((1 << (DST_N_STA-DST_N_END+1)) - 1)) << DST_N_END;
+            if (instrData.fillImm)
+                instrWord |= (instrData.imm & ((1 << (FILL_IMM_STA-FILL_IMM_END+1)) - 1)) << FILL_IMM_END;
+            else
+                instrWord |= (instrData.idxSrc0 & ((1 << (SRC0_N_STA-SRC0_N_END+1)) - 1)) << SRC0_N_END;
+        break;
+
+        case OP_PERM:
+            instrWord |= (instrData.opCode & ((1 << (OPCODE_STA-OPCODE_END+1)) - 1)) << OPCODE_END;
+            instrWord |= (instrData.dst & ((1 << (DST_STA-DST_END+1)) - 1)) << DST_END;
+            instrWord |= (instrData.src0 & ((1 << (SRC0_STA-SRC0_END+1)) - 1)) << SRC0_END;
+            instrWord |= (instrData.perm & ((1 << (PERM_SEL_STA-PERM_SEL_END+1)) - 1)) << PERM_SEL_END;
+            instrWord |= (instrData.idxDst & ((1 << (DST_N_STA-DST_N_END+1)) - 1)) << DST_N_END;
+            instrWord |= (instrData.idxSrc0 & ((1 << (SRC0_N_STA-SRC0_N_END+1)) - 1)) << SRC0_N_END;
+            instrWord |= (instrData.imm & ((1 << (PERM_K_STA-PERM_K_END+1)) - 1)) << PERM_K_END;
+        break;
+
+        case OP_RED:
+            instrWord |= (instrData.opCode & ((1 << (OPCODE_STA-OPCODE_END+1)) - 1)) << OPCODE_END;
+            instrWord |= (instrData.dst & ((1 << (DST_STA-DST_END+1)) - 1)) << DST_END;
+            instrWord |= (instrData.src0 & ((1 << (SRC0_STA-SRC0_END+1)) - 1)) << SRC0_END;
+            instrWord |= (instrData.redMax & 1) << MAX_BIT;
+            instrWord |= (instrData.idxDst & ((1 << (DST_N_STA-DST_N_END+1)) - 1)) << DST_N_END;
+            instrWord |= (instrData.idxSrc0 & ((1 << (SRC0_N_STA-SRC0_N_END+1)) - 1)) << SRC0_N_END;
+        break;
+
+        case OP_MULADD:
+            instrWord |= (instrData.opCode & ((1 << (OPCODE_STA-OPCODE_END+1)) - 1)) << OPCODE_END;
+            instrWord |= (instrData.dst & 1) << DI_MDST_BIT;
+            instrWord |= (instrData.idxDst & ((1 << (DI_MDST_N_STA-DI_MDST_N_END+1)) - 1)) << DI_MDST_N_END;
+            instrWord |= (instrData.src0 & ((1 << (DI_MSRC0_STA-DI_MSRC0_END+1)) - 1)) << DI_MSRC0_END;
+            instrWord |= (instrData.idxSrc0 & ((1 << (DI_MSRC0_N_STA-DI_MSRC0_N_END+1)) - 1)) << DI_MSRC0_N_END;
+            instrWord |= (instrData.src1 & ((1 << (DI_MSRC1_STA-DI_MSRC1_END+1)) - 1)) << DI_MSRC1_END;
+            instrWord |= (instrData.idxSrc1 & ((1 << (DI_MSRC1_N_STA-DI_MSRC1_N_END+1)) - 1)) << DI_MSRC1_N_END;
+            instrWord |= (instrData.idxAddDst & ((1 << (DI_ADST_N_STA-DI_ADST_N_END+1)) - 1)) << DI_ADST_N_END;
+            instrWord |= (instrData.addSrc0 & ((1 << (DI_ASRC0_STA-DI_ASRC0_END+1)) - 1)) << DI_ASRC0_END;
+            instrWord |= (instrData.idxAddSrc0 & ((1 << (DI_ASRC0_N_STA-DI_ASRC0_N_END+1)) - 1)) << DI_ASRC0_N_END;
+            instrWord |= (instrData.addSrc1 & ((1 << (DI_ASRC1_STA-DI_ASRC1_END+1)) - 1)) << DI_ASRC1_END;
+            instrWord |= (instrData.idxAddSrc1 & ((1 << (DI_ASRC1_N_STA-DI_ASRC1_N_END+1)) - 1)) << DI_ASRC1_N_END;
+        break;
     }
 
     return instrWord;
 
 }
 
+string crfWriteCmd(const nmcInst &instr, uint8_t idx, bool shadow) {
+    uint64_t addr;
+    ostringstream crfCmd;
+
+    // Parse index to address
+#if CRF_BANK_ADDR
+    // If not enough column bits to address CRF, using also bank bits
+    uint bank_aux = (idx >> addr_bits[int(Level::Column)]) & ((1 << addr_bits[int(Level::Bank)]) - 1);
+    uint col_aux = idx & ((1 << addr_bits[int(Level::Column)]) - 1);
+    addr = build_addr({asm_channel, asm_rank, asm_bg, bank_aux, shadow ? STORE::CRFS : STORE::CRF, col_aux}, true);
+#else
+    addr = build_addr({asm_channel, asm_rank, asm_bg, 0, shadow ? STORE::CRFS : STORE::CRF, idx}, true);
+#endif
+
+    crfCmd << showbase << hex << addr << "\tWR\t";
+    uint64_t instTemp = build_instr(instr);
+#if DQ_BITS == 16
+    uint16_t instLowerPart = instTemp & 0xFFFF;
+    uint16_t instUpperPart = (instTemp >> 16) & 0xFFFF;
+    crfCmd << hex << instLowerPart << "\t" << instUpperPart;
+#else
+    crfCmd << hex << instTemp;
+#endif
+
+    return crfCmd.str();
+}
+
+bool writeCrf(const vector<nmcInst> &block, uint8_t base, bool shadow, vector<nmcInst> &src,
+                std::array<nmcInst, CRF_ENTRIES> *crf, ofstream &rawSeq, deque<string> &crfPending) {
+    vector<nmcInst> prog;
+    vector<bool> wr;
+    uint i;
+
+    // The block patches the program of the bank as written in the assembly
+    if (src.size() < base + block.size())
+        src.resize(base + block.size());
+    copy(block.begin(), block.end(), src.begin() + base);
+
+#if ASM_SCHED
+    // The whole program is scheduled again, so the entries of the block and those that
+    // were moved by it are written
+    vector<pair<int, int> > span;
+    scheduleCrf(src, prog, span);
+    if (prog.size() > CRF_ENTRIES) {     // No room for the NOPs, the program is written as in the assembly
+        cout << "Warning, the scheduled program needs " << prog.size() << " CRF entries, it is not scheduled" << endl;
+        prog = src;
+        span.clear();
+        for (i = 0; i < prog.size(); i++) {
+            span.push_back(make_pair(i, i));
+        }
+    }
+    wr.resize(prog.size(), false);
+    for (i = base; i < base + block.size(); i++) {
+        for (int k = span[i].first; k >= 0 && k <= span[i].second; k++) {
+            wr[k] = true;
+        }
+    }
+    for (i = 0; i < prog.size(); i++) {
+        wr[i] = wr[i] || build_instr(prog[i]) != build_instr(crf->at(i));
+    }
+#else
+    prog = src;
+    wr.resize(prog.size(), false);
+    fill(wr.begin() + base, wr.begin() + base + block.size(), true);
+#endif
+
+    // Write commands, held back if they target the bank that is not executing
+    for (i = 0; i < prog.size(); i++) {
+        crf->at(i) = prog[i];
+        if (!wr[i])
+            continue;
+        if (shadow)
+            crfPending.push_back(crfWriteCmd(prog[i], i, shadow));
+        else
+            rawSeq << crfWriteCmd(prog[i], i, shadow) << endl;
+    }
+
+    return false;
+}
+
+bool dualPair(const nmcInst &mul, const nmcInst &add) {
+    const uint64_t entries = 1 << (DI_MDST_N_STA-DI_MDST_N_END+1);     // Reached by the indices of a MULADD
+    uint8_t rf[4] = {mul.src0, mul.src1, add.src0, add.src1};
+    uint64_t idx[4] = {mul.idxSrc0, mul.idxSrc1, add.idxSrc0, add.idxSrc1};
+    int srfReads = 0;
+    int i, j, ports;
+
+    if (mul.opCode != OP_MUL || add.opCode != OP_ADD || mul.aam || add.aam)
+        return false;
+    if ((mul.dst != OPC_GRF_A && mul.dst != OPC_GRF_B) || add.dst != (mul.dst ^ 1)
+            || mul.idxDst >= entries || add.idxDst >= entries)
+        return false;
+
+    // The first input of the multipliers is a GRF, the second one a GRF or the SRF_M, the adders take a GRF or the SRF_A
+    if ((rf[0] != OPC_GRF_A && rf[0] != OPC_GRF_B) || rf[1] == OPC_SRF_A || rf[1] > OPC_SRF_A
+            || rf[2] == OPC_SRF_M || rf[2] > OPC_SRF_A || rf[3] == OPC_SRF_M || rf[3] > OPC_SRF_A)
+        return false;
+    for (i = 0; i < 4; i++) {
+        if (idx[i] >= entries)
+            return false;
+        srfReads += (rf[i] == OPC_SRF_M || rf[i] == OPC_SRF_A);
+    }
+    if (srfReads > 1)
+        return false;
+
+    // Two read ports per GRF, shared by the operands that read the same entry
+    for (i = 0; i < 4; i++) {
+        if (rf[i] != OPC_GRF_A && rf[i] != OPC_GRF_B)
+            continue;
+        ports = 0;
+        for (j = 0; j < 4; j++) {
+            bool first = true;
+            for (int k = 0; k < j; k++) {
+                first = first && !(rf[k] == rf[j] && idx[k] == idx[j]);
+            }
+            ports += (rf[j] == rf[i] && first);
+        }
+        if (ports > 2)
+            return false;
+    }
+
+    return true;
+}
+
+nmcInst fuseMulAdd(const nmcInst &mul, const nmcInst &add) {
+    nmcInst instr = mul;
+
+    instr.opCode = OP_MULADD;
+    instr.addDst = add.dst;
+    instr.addSrc0 = add.src0;
+    instr.addSrc1 = add.src1;
+    instr.idxAddDst = add.idxDst;
+    instr.idxAddSrc0 = add.idxSrc0;
+    instr.idxAddSrc1 = add.idxSrc1;
+
+    return instr;
+}
+
+instTiming getTiming(const nmcInst &instr) {
+    instTiming t;
+    bool bank0 = instr.src0 == OPC_EVEN_BANK || instr.src0 == OPC_ODD_BANK;
+    bool bank1 = instr.src1 == OPC_EVEN_BANK || instr.src1 == OPC_ODD_BANK;
+    bool bankDst = instr.dst == OPC_EVEN_BANK || instr.dst == OPC_ODD_BANK;
+    int ld = (bank0 || bank1) ? 1 : 0;      // Operands loaded from a bank reach the FPU a cycle later
+    uint64_t pack = (instr.dst == OPC_SRF_A) ? SRF_A_PACK : SRF_M_PACK;
+    // The AAM indices come from the column address, or from the AAM registers, so any entry of the RF can be accessed
+    uint64_t dstHi = instr.aam ? UINT64_MAX : instr.idxDst;
+    uint64_t src0Hi = instr.aam ? UINT64_MAX : instr.idxSrc0;
+    uint64_t src1Hi = instr.aam ? UINT64_MAX : instr.idxSrc1;
+    uint64_t dstLo = instr.aam ? 0 : instr.idxDst;
+    uint64_t src0Lo = instr.aam ? 0 : instr.idxSrc0;
+    uint64_t src1Lo = instr.aam ? 0 : instr.idxSrc1;
+
+    switch (instr.opCode) {
+        case OP_MOV:
+            if (bank0) {        // Loads, written from the bank in the next cycle, several SRF entries if packed
+                t.wr.push_back({instr.dst, dstLo, dstHi + (instr.relu ? pack - 1 : 0), 1, false});
+            } else {
+                // The ring reads the same GRF_B entry in every core
+                t.rd.push_back({instr.src0 == OPC_RING ? uint8_t(OPC_GRF_B) : instr.src0, src0Lo, src0Hi, 0, false});
+                if (!bankDst)
+                    t.wr.push_back({instr.dst, dstLo, dstHi, 0, false});
+            }
+        break;
+        case OP_PERM:
+            t.rd.push_back({instr.src0, instr.idxSrc0, instr.idxSrc0, 0, false});
+            t.wr.push_back({instr.dst, instr.idxDst, instr.idxDst, 0, false});
+        break;
+        case OP_FILL:
+            if (!instr.fillImm)
+                t.rd.push_back({instr.src0, instr.idxSrc0, instr.idxSrc0, 0, false});
+            t.wr.push_back({instr.dst, instr.idxDst, instr.idxDst, 0, false});
+        break;
+        case OP_RED:
+            t.rd.push_back({instr.src0, instr.idxSrc0, instr.idxSrc0, 0, true});
+            t.wr.push_back({instr.dst, instr.idxDst, instr.idxDst, RED_STAGES, true});
+            t.add = 0;
+        break;
+        case OP_ADD:
+        case OP_MUL:
+        case OP_MAD:
+        case OP_MAC:
+        case OP_MACW:
+            if (!bank0)
+                t.rd.push_back({instr.src0, src0Lo, src0Hi, ld, true});
+            if (!bank1)
+                t.rd.push_back({instr.src1, src1Lo, src1Hi, ld, true});
+            if (instr.opCode == OP_ADD) {
+                t.add = ld;
+                t.wr.push_back({instr.dst, dstLo, dstHi, ADD_STAGES + ld, true});
+            } else if (instr.opCode == OP_MUL) {
+                t.mult = ld;
+                t.wr.push_back({instr.dst, dstLo, dstHi, MULT_STAGES + ld, true});
+            } else {
+                // Accumulated operand, read by the adders after the multiplication. The one of a MAD has the index of SRC1
+                t.mult = ld;
+                t.add = MULT_STAGES + ld;
+                if (instr.opCode == OP_MAD)
+                    t.rd.push_back({instr.src2, instr.aam ? 0 : instr.idxSrc1, instr.aam ? UINT64_MAX : instr.idxSrc1, t.add, true});
+                else
+                    t.rd.push_back({instr.dst, dstLo, dstHi, t.add, true});
+                t.wr.push_back({instr.dst, dstLo, dstHi, MULT_STAGES + ADD_STAGES + ld, true});
+            }
+        break;
+        case OP_MULADD:     // The product is written back from the multiplier output, which is not forwarded
+            t.rd.push_back({instr.src0, instr.idxSrc0, instr.idxSrc0, 0, true});
+            t.rd.push_back({instr.src1, instr.idxSrc1, instr.idxSrc1, 0, true});
+            t.rd.push_back({instr.addSrc0, instr.idxAddSrc0, instr.idxAddSrc0, 0, true});
+            t.rd.push_back({instr.addSrc1, instr.idxAddSrc1, instr.idxAddSrc1, 0, true});
+            t.wr.push_back({instr.dst, instr.idxDst, instr.idxDst, MULT_STAGES, false});
+            t.wr.push_back({instr.addDst, instr.idxAddDst, instr.idxAddDst, ADD_STAGES, true});
+            t.mult = 0;
+            t.add = 0;
+        break;
+        default:        // NOP, JUMP and EXIT only take their command slot
+        break;
+    }
+
+    t.bank = bank0 || bank1 || bankDst;
+    t.bankWr = bankDst;
+    t.aam = AAM_REGS && instr.aam;
+    t.file = instr.dataFile || (bankDst && instr.dstAddrFile) || (bank0 && instr.src0AddrFile)
+                || (bank1 && instr.src1AddrFile);
+
+    return t;
+}
+
+int hazardSlots(const instTiming &p, const instTiming &c, bool *dep) {
+    int cycles = 0;
+
+    // AAM instructions advance the same offsets, so they also keep their order
+    *dep = (p.bankWr && c.bank) || (p.bank && c.bankWr) || (p.file && c.file) || (p.aam && c.aam);
+
+    // Read after write, the FPU output can be forwarded in the cycle it is written back
+    for (const rfAccess &w : p.wr) {
+        for (const rfAccess &r : c.rd) {
+            if (w.rf == r.rf && w.lo <= r.hi && r.lo <= w.hi) {
+                *dep = true;
+                cycles = max(cycles, w.cycle - r.cycle + ((HAZARD_FWD && w.fpu && r.fpu) ? 0 : 1));
+            }
+        }
+    }
+
+    // Write after read, the entry can be overwritten in the cycle it is read
+    for (const rfAccess &r : p.rd) {
+        for (const rfAccess &w : c.wr) {
+            if (w.rf == r.rf && w.lo <= r.hi && r.lo <= w.hi) {
+                *dep = true;
+                cycles = max(cycles, r.cycle - w.cycle);
+            }
+        }
+    }
+
+    // Writes to the same RF, or from the FPU, are written back in order so that they never share
+    // the write port or the FPU output. The SRF has a single write port for both halves
+    for (const rfAccess &w0 : p.wr) {
+        for (const rfAccess &w1 : c.wr) {
+            bool srf0 = w0.rf == OPC_SRF_M || w0.rf == OPC_SRF_A;
+            bool srf1 = w1.rf == OPC_SRF_M || w1.rf == OPC_SRF_A;
+            if (w0.rf == w1.rf && w0.lo <= w1.hi && w1.lo <= w0.hi)
+                *dep = true;
+            if (w0.rf == w1.rf || (srf0 && srf1) || (w0.fpu && w1.fpu))
+                cycles = max(cycles, w0.cycle - w1.cycle + 1);
+        }
+    }
+
+    // The multipliers and adders take the operands of one instruction per cycle
+    if (p.mult >= 0 && c.mult >= 0)
+        cycles = max(cycles, p.mult - c.mult + 1);
+    if (p.add >= 0 && c.add >= 0)
+        cycles = max(cycles, p.add - c.add + 1);
+
+    return (cycles + CMD_CYCLES - 1) / CMD_CYCLES;
+}
+
+void scheduleCrf(const vector<nmcInst> &src, vector<nmcInst> &prog, vector<pair<int, int> > &span) {
+    int i, j, k, s;
+    int n = src.size();
+    // Command slots after which an instruction no longer delays any other one
+    const int horizon = (MULT_STAGES + ADD_STAGES + RED_STAGES + 2) / CMD_CYCLES + 2;
+    nmcInst pad;
+
+    pad.opCode = OP_NOP;
+    pad.imm0 = 1;
+
+    prog = src;
+    span.clear();
+    for (i = 0; i < n; i++) {
+        span.push_back(make_pair(i, i));
+    }
+
+    // Jump targets, which must be in the program, and instructions reached from the start
+    vector<int> target(n, -1);
+    vector<bool> reached(n, false);
+    vector<int> stack(1, 0);
+    while (!stack.empty()) {
+        i = stack.back();
+        stack.pop_back();
+        if (i >= n || reached[i])
+            continue;
+        reached[i] = true;
+        if (src[i].opCode == OP_JUMP) {
+            target[i] = i - src[i].imm0;
+            if (target[i] < 0) {
+                cout << "Warning, JUMP at CRF" << i << " out of the program, the program is not scheduled" << endl;
+                return;
+            }
+            stack.push_back(target[i]);
+        }
+        if (src[i].opCode != OP_EXIT)
+            stack.push_back(i + 1);
+    }
+
+    // The NOPs written in the assembly and the instructions never reached are dropped,
+    // the jumps to a NOP go to the next instruction
+    vector<nmcInst> code;
+    vector<int> codeSrc;
+    vector<int> newIdx(n + 1);
+    vector<int> codeTarget;
+    for (i = 0; i < n; i++) {
+        newIdx[i] = code.size();
+        if (reached[i] && src[i].opCode != OP_NOP) {
+            code.push_back(src[i]);
+            codeSrc.push_back(i);
+        }
+        span[i] = make_pair(-1, -1);
+    }
+    newIdx[n] = code.size();
+    for (i = 0; i < n; i++) {
+        if (reached[i] && src[i].opCode == OP_JUMP)
+            codeTarget.push_back(newIdx[target[i]]);
+    }
+    n = code.size();
+
+    // Basic blocks start at the beginning, at every jump target and after every JUMP or EXIT
+    vector<bool> leader(n + 1, false);
+    leader[0] = leader[n] = true;
+    for (i = 0, k = 0; i < n; i++) {
+        if (code[i].opCode == OP_JUMP)
+            leader[codeTarget[k++]] = true;
+        if (code[i].opCode == OP_JUMP || code[i].opCode == OP_EXIT)
+            leader[i + 1] = true;
+    }
+
+    // A MUL and an ADD of the same block that can be issued together are merged into a MULADD, in place
+    // of the first one if the second one can be moved up to it, or else in place of the second one
+    vector<int> codeFused(n, -1);
+#if DUAL_ISSUE
+    vector<instTiming> fuseTiming(n);
+    vector<bool> merged(n, false);
+    for (i = 0; i < n; i++) {
+        fuseTiming[i] = getTiming(code[i]);
+    }
+    for (i = 0; i < n; i++) {
+        if (code[i].opCode != OP_MUL && code[i].opCode != OP_ADD)
+            continue;
+        bool mulFirst = code[i].opCode == OP_MUL;
+        for (j = i + 1; !leader[j] && !merged[i]; j++) {
+            bool dep, up = true, down = true;
+            if (merged[j] || !(mulFirst ? dualPair(code[i], code[j]) : dualPair(code[j], code[i])))
+                continue;
+            hazardSlots(fuseTiming[i], fuseTiming[j], &dep);
+            for (k = i + 1; k < j && !dep; k++) {
+                bool depUp, depDown;
+                if (merged[k])
+                    continue;
+                hazardSlots(fuseTiming[k], fuseTiming[j], &depUp);
+                hazardSlots(fuseTiming[i], fuseTiming[k], &depDown);
+                up = up && !depUp;
+                down = down && !depDown;
+            }
+            if (dep || (!up && !down))
+                continue;
+            int keep = up ? i : j, drop = up ? j : i;
+            code[keep] = mulFirst ? fuseMulAdd(code[i], code[j]) : fuseMulAdd(code[j], code[i]);
+            codeFused[keep] = codeSrc[drop];
+            fuseTiming[keep] = getTiming(code[keep]);
+            merged[drop] = true;
+        }
+    }
+
+    // The merged instructions are removed, blocks and jumps start at the next instruction left
+    vector<int> kept(n + 1);
+    for (i = 0, k = 0; i < n; i++) {
+        kept[i] = k;
+        if (!merged[i]) {
+            code[k] = code[i];
+            codeSrc[k] = codeSrc[i];
+            codeFused[k] = codeFused[i];
+            k++;
+        }
+    }
+    kept[n] = k;
+    vector<bool> keptLeader(k + 1, false);
+    for (i = 0; i <= n; i++) {
+        if (leader[i])
+            keptLeader[kept[i]] = true;
+    }
+    for (int &t : codeTarget) {
+        t = kept[t];
+    }
+    n = k;
+    code.resize(n);
+    codeSrc.resize(n);
+    codeFused.resize(n);
+    leader = keptLeader;
+#endif
+
+    // List scheduling inside every basic block: the instruction that can go first without waiting
+    // is taken, the earliest one in the assembly if several can. JUMP and EXIT stay at the end
+    vector<instTiming> timing(n);
+    for (i = 0; i < n; i++) {
+        timing[i] = getTiming(code[i]);
+    }
+    vector<int> order(n);
+    for (int start = 0, end; start < n; start = end) {
+        for (end = start + 1; !leader[end]; end++);
+        int last = end;
+        if (code[end-1].opCode == OP_JUMP || code[end-1].opCode == OP_EXIT)
+            order[--last] = end - 1;
+
+        vector<bool> placed(n, false);
+        vector<int> slot(n, 0);
+        int next = 0;
+        for (k = start; k < last; k++) {
+            int best = -1, bestSlot = 0;
+            for (i = start; i < last; i++) {
+                if (placed[i])
+                    continue;
+                bool ready = true;
+                int earliest = next;
+                for (j = start; j < last && ready; j++) {
+                    bool dep;
+                    if (j == i)
+                        continue;
+                    if (placed[j]) {
+                        s = hazardSlots(timing[j], timing[i], &dep);
+                        earliest = max(earliest, slot[j] + s);
+                    } else if (j < i) {
+                        hazardSlots(timing[j], timing[i], &dep);
+                        ready = !dep;
+                    }
+                }
+                if (ready && (best < 0 || earliest < bestSlot)) {
+                    best = i;
+                    bestSlot = earliest;
+                }
+            }
+            placed[best] = true;
+            slot[best] = bestSlot;
+            next = bestSlot + 1;
+            order[k] = best;
+        }
+    }
+
+    vector<nmcInst> sched(n);
+    vector<instTiming> schedTiming(n);
+    vector<int> schedSrc(n);
+    vector<int> schedFused(n);
+    for (i = 0; i < n; i++) {
+        sched[i] = code[order[i]];
+        schedTiming[i] = timing[order[i]];
+        schedSrc[i] = codeSrc[order[i]];
+        schedFused[i] = codeFused[order[i]];
+    }
+
+    // Successors of every instruction. After an EXIT the program can be executed again right away
+    vector<vector<int> > succ(n);
+    for (i = 0, k = 0; i < n; i++) {
+        if (sched[i].opCode == OP_EXIT) {
+            succ[i].push_back(0);
+            continue;
+        }
+        if (sched[i].opCode == OP_JUMP)
+            succ[i].push_back(codeTarget[k++]);     // Block starts keep their index
+        if (i + 1 < n)
+            succ[i].push_back(i + 1);
+    }
+
+    // NOPs before every instruction, until the instructions still in flight along every path that
+    // reaches it, as (instruction, slots since its decode), are far enough from it
+    vector<int> pads(n, 0);
+    bool padded = true;
+    while (padded) {
+        vector<map<int, int> > inFlight(n);
+        bool changed = true;
+        while (changed) {
+            changed = false;
+            for (i = 0; i < n; i++) {
+                map<int, int> out;
+                for (auto &f : inFlight[i]) {
+                    if (f.second + pads[i] + 1 < horizon)
+                        out[f.first] = f.second + pads[i] + 1;
+                }
+                out[i] = 1;
+                for (int next : succ[i]) {
+                    for (auto &f : out) {
+                        auto it = inFlight[next].find(f.first);
+                        if (it == inFlight[next].end() || it->second > f.second) {
+                            inFlight[next][f.first] = f.second;
+                            changed = true;
+                        }
+                    }
+                }
+            }
+        }
+
+        padded = false;
+        for (i = 0; i < n; i++) {
+            for (auto &f : inFlight[i]) {
+                bool dep;
+                s = hazardSlots(schedTiming[f.first], schedTiming[i], &dep) - f.second;
+                if (s > pads[i]) {
+                    pads[i] = s;
+                    padded = true;
+                }
+            }
+        }
+    }
+
+    // Program with the NOPs, and the JUMP offsets to the NOPs before their targets
+    vector<int> start(n);
+    prog.clear();
+    for (i = 0; i < n; i++) {
+        start[i] = prog.size();
+        prog.insert(prog.end(), pads[i], pad);
+        prog.push_back(sched[i]);
+        span[schedSrc[i]] = make_pair(start[i], start[i] + pads[i]);
+        if (schedFused[i] >= 0)
+            span[schedFused[i]] = span[schedSrc[i]];
+    }
+    for (i = 0, k = 0; i < n; i++) {
+        if (sched[i].opCode == OP_JUMP)
+            prog[start[i] + pads[i]].imm0 = start[i] + pads[i] - start[codeTarget[k++]];
+    }
+}
+
 bool getInstData(istringstream &aistream, deque<rfBin_t> &rfBin, nmcInst *currInstr) {
     string dataString;
     float dataFloat;
-#if HALF_FLOAT
-    half_float::half dataHalf;
+#if NARROW_FLOAT
+    cnm_narrow_t dataHalf;
 #else
     cnm_union dataVal;
 #endif
@@ -905,7 +1858,7 @@ bool getInstData(istringstream &aistream, deque<rfBin_t> &rfBin, nmcInst *currIn
             currInstr->dataFile = true;
         // Read from assembly file
         } else {
-#if (HALF_FLOAT)
+#if (NARROW_FLOAT)
             dataFloat = stof(dataString); //string to int
             dataHalf = dataFloat;
             dataBin = dataHalf.bin_word();
@@ -948,8 +1901,8 @@ bool getInstData(istringstream &aistream, deque<rfBin_t> &rfBin, nmcInst *currIn
 bool getDataFromFile (ifstream &dataFile, deque<rfBin_t> &rfBin, nmcInst *currInstr) {
     string diline;
     float dataFloat;
-#if (HALF_FLOAT)
-    half_float::half dataHalf;
+#if (NARROW_FLOAT)
+    cnm_narrow_t dataHalf;
 #else
     cnm_union dataVal;
 #endif
@@ -964,9 +1917,24 @@ bool getDataFromFile (ifstream &dataFile, deque<rfBin_t> &rfBin, nmcInst *currIn
         }
     } while (diline.length() == 0 || diline.at(0) == '#');
 
+#if WIDE_ACC
+    // Lines starting with W hold wide accumulators, every one split into ACC_RATIO lanes, lowest first
+    bool wide = diline.at(0) == 'W';
+    if (wide)
+        diline.erase(0, 1);
+#endif
+
     istringstream distream(diline);
 
-#if (HALF_FLOAT)
+#if WIDE_ACC
+    cnm_acc_t wideVal;
+    while (wide && distream >> wideVal) {
+        for (int k = 0; k < ACC_RATIO; k++)
+            rfBin.push_back((acc_to_bits(wideVal) >> (k*WORD_BITS)) & MASK);
+    }
+#endif
+
+#if (NARROW_FLOAT)
     while (distream >> dataFloat) {
         dataHalf = dataFloat;
         dataBin = dataHalf.bin_word();
@@ -984,7 +1952,7 @@ bool getDataFromFile (ifstream &dataFile, deque<rfBin_t> &rfBin, nmcInst *currIn
         rfBin.push_back(dataVal.bin);
     }
 #endif  // DATA_TYPE == 4
-#endif  // HALF_FLOAT
+#endif  // NARROW_FLOAT
 
     while (!rfBin.empty()) {
         //Check if number of data is acceptable
@@ -1020,4 +1988,43 @@ bool getAddrFromFile (ifstream &addrFile, uint64_t *addr) {
     aistream >> hex >> *addr;
 
     return false;
-}
\ No newline at end of file
+}
+
+bool getExecAddr (ifstream &addrFile, const nmcInst &instr, uint8_t idx, map<uint8_t, uint64_t> &aamAddr, uint64_t *addr) {
+    bool error = false;
+
+    if (AAM_REGS && instr.aam && aamAddr.count(idx)) {
+        *addr = aamAddr[idx] = next_col(aamAddr[idx]);
+    } else {
+        error = getAddrFromFile(addrFile, addr);
+        if (AAM_REGS && instr.aam)
+            aamAddr[idx] = *addr;
+    }
+
+    return error;
+}
+
+bool getAamConfig (istringstream &aistream, dq_type *cfg) {
+    int srcBase, srcStride, srcMod, dstBase, dstStride, dstMod;
+
+    if (!AAM_REGS) {
+        cout << "Error, writing to the AAM registers needs AAM_REGS" << endl;
+        return true;
+    }
+    if (!(aistream >> srcBase >> srcStride >> srcMod >> dstBase >> dstStride >> dstMod)) {
+        cout << "Error when reading the AAM base, stride and modulo" << endl;
+        return true;
+    }
+    // Every field takes an index of the GRF, the modulo is encoded minus one
+    if (srcBase < 0 || srcBase >= GRF_ENTRIES || srcMod < 1 || srcMod > GRF_ENTRIES || srcStride < 0 || srcStride >= srcMod
+            || dstBase < 0 || dstBase >= GRF_ENTRIES || dstMod < 1 || dstMod > GRF_ENTRIES || dstStride < 0 || dstStride >= dstMod) {
+        cout << "Error, AAM bases out of the GRF, or strides not smaller than their modulos" << endl;
+        return true;
+    }
+
+    *cfg = (dq_type(srcBase) << AAM_SRC_BASE_END) | (dq_type(srcStride) << AAM_SRC_STRIDE_END)
+            | (dq_type(srcMod - 1) << AAM_SRC_MOD_END) | (dq_type(dstBase) << AAM_DST_BASE_END)
+            | (dq_type(dstStride) << AAM_DST_STRIDE_END) | (dq_type(dstMod - 1) << AAM_DST_MOD_END);
+
+    return false;
+}
@@ -26,6 +26,11 @@
 
 #define DATAFILE    "DataFile"
 #define ADDRFILE    "AddrFile"
+#define CORESEL     "@core"     // Suffix of the RF writes to a single core, e.g. GRFA3@core5
+#define LANESEL     "@lane"     // Suffix of the bank lane loaded to the SRF, e.g. MOV SRFM2 EVEN_BANK[AddrFile]@lane5
+
+#define ASM_SCHED   1           // 1 to reorder the CRF programs and pad them with NOPs for the pipeline depths of defs.h
+#define CMD_CYCLES  2           // Core cycles between two column commands of an EXEC, tCCDL of the all-bank mode
 
 using namespace std;
 
@@ -36,27 +41,42 @@ enum INSTR {
     WRF,
     NOP, JUMP, EXIT,
     MOV, RELU, FILL,
+    RED, REDMAX,
     ADD, MUL, MAD, MAC,
     ADDa, MULa, MADa, MACa,
-    EXEC
+    EXEC, SWAP,
+    MACW,
+    MULADD,
+    MOVa,
+    PERM
 };
 
 const std::map<uint8_t, std::string> INSTR2STRING = {
     { WRF, "WRF" },
     { NOP, "NOP" }, { JUMP, "JUMP" }, { EXIT, "EXIT" },
     { MOV, "MOV" }, { RELU, "RELU" }, { FILL, "FILL" },
+    { RED, "RED" }, { REDMAX, "REDMAX" },
     { ADD, "ADD" }, { MUL, "MUL" }, { MAD, "MAD" }, { MAC, "MAC" },
     { ADDa, "ADDa" }, { MULa, "MULa" }, { MADa, "MADa" }, { MACa, "MACa" },
-    { EXEC, "EXEC" },
+    { EXEC, "EXEC" }, { SWAP, "SWAP" },
+    { MACW, "MACW" },
+    { MULADD, "MULADD" },
+    { MOVa, "MOVa" },
+    { PERM, "PERM" },
 };
 
 const std::map<std::string, uint8_t> STRING2INSTR = {
     { "WRF", WRF },
     { "NOP", NOP }, { "JUMP", JUMP }, { "EXIT", EXIT },
     { "MOV", MOV }, { "RELU", RELU }, { "FILL", FILL },
+    { "RED", RED }, { "REDMAX", REDMAX },
     { "ADD", ADD }, { "MUL", MUL }, { "MAD", MAD }, { "MAC", MAC },
     { "ADDa", ADDa }, { "MULa", MULa }, { "MADa", MADa }, { "MACa", MACa },
-    { "EXEC", EXEC },
+    { "EXEC", EXEC }, { "SWAP", SWAP },
+    { "MACW", MACW },
+    { "MULADD", MULADD },
+    { "MOVa", MOVa },
+    { "PERM", PERM },
 };
 
 // // OPCODES operation identifiers
@@ -66,6 +86,7 @@ const std::map<std::string, uint8_t> STRING2INSTR = {
 //     OP_EXIT = 2,
 //     OP_MOV = 4,
 //     OP_FILL = 5,
+//     OP_RED = 6,
 //     OP_ADD = 8,
 //     OP_MUL = 9,
 //     OP_MAD = 10,
@@ -84,29 +105,43 @@ const std::map<uint8_t, uint8_t> INSTR2OPCODE = {
     { MULa, OP_MUL },
     { MADa, OP_MAD },
     { MACa, OP_MAC },
+    { MACW, OP_MACW },
+    { MULADD, OP_MULADD },
     { MOV, OP_MOV },
+    { MOVa, OP_MOV },
     { RELU, OP_MOV },
     { FILL, OP_FILL },
+    { RED, OP_RED },
+    { REDMAX, OP_RED },
+    { PERM, OP_PERM },
 };
 
 enum STORE {
     CRF = 0,
     SRFM = 1, SRFA = 2,
     GRFA = 3, GRFB = 4,
-    EVEN = 5, ODD = 6
+    SRFMP = 5, SRFAP = 6,   // Packed writes, filling several SRF entries from index n with a burst
+    CRFS = 7,               // CRF bank that is not executing, with a double-buffered CRF
+    CRFSWAP = 8,            // Swaps the executing CRF bank
+    AAM = 9,                // AAM base, stride and modulo registers, with AAM_REGS
+    EVEN = 10, ODD = 11
 };
 
 const std::map<uint8_t, std::string> STORE2STRING = {
-    { CRF, "CRF" },
+    { CRF, "CRF" }, { CRFS, "CRFS" },
     { GRFA, "GRFA" }, { GRFB, "GRFB" },
     { SRFM, "SRFM" }, { SRFA, "SRFA" },
+    { SRFMP, "SRFMP" }, { SRFAP, "SRFAP" },
+    { AAM, "AAM" },
     { EVEN, "EVEN_BANK" }, { ODD, "ODD_BANK" }
 };
 
 const std::map<std::string, uint8_t> STRING2STORE = {
-    { "CRF", CRF },
+    { "CRF", CRF }, { "CRFS", CRFS },
     { "GRFA", GRFA }, { "GRFB", GRFB },
     { "SRFM", SRFM }, { "SRFA", SRFA },
+    { "SRFMP", SRFMP }, { "SRFAP", SRFAP },
+    { "AAM", AAM },
     { "EVEN_BANK", EVEN }, { "ODD_BANK", ODD  }
 };
 
@@ -129,6 +164,12 @@ const std::map<string, uint8_t> STRING2OPCSTORAGE = {
     { "ODD_BANK", OPC_ODD_BANK }
 };
 
+// Destinations of the MOVs that load a block of lanes of a bank column to consecutive SRF entries
+const std::map<string, uint8_t> STRING2OPCBLOCK = {
+    { "SRFMP", OPC_SRF_M },
+    { "SRFAP", OPC_SRF_A }
+};
+
 enum CMD {
     RD, WR,
     DC
@@ -158,15 +199,48 @@ class nmcInst {
     bool src2AddrFile;
     bool relu;
     bool aam;
+    bool redMax;
     bool dataFile;
+    int lane;
+    bool fillImm;   // FILL broadcasts imm instead of an SRF entry
+    int imm;
+    uint8_t perm;   // Lane permutation of a PERM, by imm lanes
+    uint8_t addDst;     // ADD of a MULADD, the MUL takes the fields above
+    uint8_t addSrc0;
+    uint8_t addSrc1;
+    uint64_t idxAddDst;
+    uint64_t idxAddSrc0;
+    uint64_t idxAddSrc1;
     deque<dq_type> data;
     nmcInst()
         : opCode(-1), imm0(0), imm1(0), dst(0), src0(0), src1(0), src2(0),
           idxDst(0), idxSrc0(0), idxSrc1(0), dstAddrFile(false), src0AddrFile(false),
-          src1AddrFile(false), relu(false), aam(false), dataFile(false)
+          src1AddrFile(false), relu(false), aam(false), redMax(false), dataFile(false), lane(0),
+          fillImm(false), imm(0), perm(PERM_NONE), addDst(0), addSrc0(0), addSrc1(0), idxAddDst(0), idxAddSrc0(0),
+          idxAddSrc1(0)
     {}
 };
 
+// Register file entries read or written by an instruction, in a cycle after its decode
+struct rfAccess {
+    uint8_t rf;         // OPC storage
+    uint64_t lo, hi;    // First and last entries
+    int cycle;          // Read in this cycle, or written back at its end
+    bool fpu;           // Read by an FPU input or written from the FPU output
+};
+
+// Pipeline usage of an instruction, as seen by the scheduler
+struct instTiming {
+    vector<rfAccess> rd;
+    vector<rfAccess> wr;
+    int mult, add;      // Cycles in which the multipliers and adders take its operands, -1 if unused
+    bool bank;          // Reads or writes a bank
+    bool bankWr;
+    bool file;          // Reads the address or data file when it is executed
+    bool aam;           // Advances the AAM offsets, with AAM_REGS
+    instTiming() : mult(-1), add(-1), bank(false), bankWr(false), file(false), aam(false) {}
+};
+
 // Definition of the address mapping
 enum class Level : int {Channel, Rank, BankGroup, Bank, Row, Column, MAX};
 string level_str[int(Level::MAX)] = {"Ch", "Ra", "Bg", "Ba", "Ro", "Co"};
@@ -175,12 +249,18 @@ Level addr_map[int(Level::MAX)] = {Level::Channel, Level::Column, Level::Rank,
                         Level::BankGroup, Level::Bank, Level::Row};
 int global_offset = GLOBAL_OFFSET;
 
+// Channel, rank and bank group targeted by the generated commands
+uint64_t asm_channel = 0, asm_rank = 0, asm_bg = 0;
+
 // Function for building the address using the indices of the different levels
 uint64_t build_addr(vector<uint64_t> addr_vec, bool rf_write);
 
 // Function for spliting the store type and the index
 bool splitStoreIndex(string* storeTypeString, uint64_t *idx);
 
+// Function for removing a suffix and its value (target core or lane) from the store, returns true if there was one
+bool splitStoreSuffix(string* storeTypeString, const string &suffix, int *value);
+
 // Function for getting the bank index from an address
 uint8_t get_bank(uint64_t addr);
 
@@ -190,9 +270,41 @@ uint16_t get_row(uint64_t addr);
 // Function for getting the column index from an address
 uint16_t get_col(uint64_t addr);
 
+// Function for getting the address of the next column of the same bank, the first one of the next row after the last
+uint64_t next_col(uint64_t addr);
+
 // Function for building the binary instruction word
 uint64_t build_instr(nmcInst instrData);
 
+// Function for building the CRF write command of an instruction
+string crfWriteCmd(const nmcInst &instr, uint8_t idx, bool shadow);
+
+// Function for writing a block of CRF instructions from index base into the program src of a bank,
+// scheduled if ASM_SCHED, held back in crfPending if they go to the bank that is not executing
+bool writeCrf(const vector<nmcInst> &block, uint8_t base, bool shadow, vector<nmcInst> &src,
+                std::array<nmcInst, CRF_ENTRIES> *crf, ofstream &rawSeq, deque<string> &crfPending);
+
+// Function for checking whether a MUL and an ADD can be issued together as a MULADD: RF operands
+// within the MULADD indices, the ADD writing the other GRF, and enough GRF and SRF read ports
+bool dualPair(const nmcInst &mul, const nmcInst &add);
+
+// Function for building the MULADD of a MUL and an ADD
+nmcInst fuseMulAdd(const nmcInst &mul, const nmcInst &add);
+
+// Function for obtaining the RF entries, functional units and files used by an instruction
+instTiming getTiming(const nmcInst &instr);
+
+// Function for obtaining the command slots instruction c must be decoded after p, and whether
+// their order matters (dependency through an RF entry, a bank or a file)
+int hazardSlots(const instTiming &p, const instTiming &c, bool *dep);
+
+// Function for scheduling a CRF program: the independent instructions of every basic block are
+// reordered, paired into MULADDs with DUAL_ISSUE, and NOPs are inserted where the pipelines need them,
+// including across the loops.
+// span holds the entries of prog taken by every instruction of src and its NOPs, -1 if dropped, those of the
+// MULADD for a MUL or an ADD merged into one
+void scheduleCrf(const vector<nmcInst> &src, vector<nmcInst> &prog, vector<pair<int, int> > &span);
+
 // Function from getting the data for the NMC instruction, either from
 // the assembly file, or signal to be read when the loop is executed
 bool getInstData(istringstream &aistream, deque<rfBin_t> &rfBin, nmcInst *currInstr);
@@ -201,4 +313,12 @@ bool getInstData(istringstream &aistream, deque<rfBin_t> &rfBin, nmcInst *currIn
 bool getDataFromFile (ifstream &dataFile, deque<rfBin_t> &rfBin, nmcInst *currInstr);
 
 // Function to get address from file at execution time, when the loop is executed
-bool getAddrFromFile (ifstream &addrFile, uint64_t *addr);
\ No newline at end of file
+bool getAddrFromFile (ifstream &addrFile, uint64_t *addr);
+
+// Function to get the address of the bank operand of the instruction at CRF index idx from file. With AAM_REGS,
+// an AAM instruction only reads it the first time it is executed in an EXEC, and then accesses the next column
+// every time, starting from its last address in aamAddr
+bool getExecAddr (ifstream &addrFile, const nmcInst &instr, uint8_t idx, map<uint8_t, uint64_t> &aamAddr, uint64_t *addr);
+
+// Function to get the AAM configuration word from the source and destination base, stride and modulo
+bool getAamConfig (istringstream &aistream, dq_type *cfg);
\ No newline at end of file
@@ -1,5 +1,9 @@
 #include "utils.h"
 
+uint64_t mapChannel = 0;
+uint64_t mapRank = 0;
+uint64_t mapBankGroup = 0;
+
 uint64_t build_addr(vector<uint64_t> addr_vec)
 {
     // Definition of the address mapping
@@ -106,3 +110,63 @@ uint16_t get_col(uint64_t addr) {
 
     return col;
 }
+
+void writeSrfMLoad(ofstream &assembly, int n, int core) {
+    string sel = core < 0 ? "" : "@core" + to_string(core);   // Core selection suffix of the assembler
+#if SRF_PACKED_WR
+    // Every burst fills up to SRF_M_PACK consecutive entries
+    for (int i = 0; i < n; i += SRF_M_PACK)
+        assembly << "WRF SRFMP" << i << sel << " DataFile" << endl;
+#else
+    for (int i = 0; i < n; i++)
+        assembly << "WRF SRFM" << i << sel << " DataFile" << endl;
+#endif
+}
+
+void writeExecLoops(ofstream &assembly, int body, int ext_loops) {
+    int i;
+#if NESTED_LOOPS
+    // The JUMP goes back to CRF0 and the inner loops are pushed again on every iteration
+    if (ext_loops > 1 && body + 2 <= CRF_ENTRIES && LOOP_DEPTH > 1) {
+        assembly << "JUMP " << body << " " << ext_loops-1 << endl;
+        assembly << "EXIT" << endl;
+        assembly << "EXEC" << endl;
+        return;
+    }
+#endif
+    assembly << "EXIT" << endl;
+    for (i=0; i<ext_loops; i++) { assembly << "EXEC" << endl; }
+}
+
+void writeSrfMData(ofstream &dataFile, cnm_t *src, uint64_t *idx, int n) {
+    for (int i = 0; i < n; i++) {
+        if (!CHAR_DATA)
+            dataFile << src[(*idx)++];
+        else
+            dataFile << int(src[(*idx)++]); //need to cast the results for int8 only
+#if SRF_PACKED_WR
+        // One line per burst
+        dataFile << ((i + 1) % SRF_M_PACK && i + 1 < n ? " " : "\n");
+#else
+        dataFile << endl;
+#endif
+    }
+}
+
+void writeSrfMBankData(ofstream &dataFile, cnm_t *src, uint64_t *idx, int n) {
+    int loads = ceil(float(SRF_M_ENTRIES)/float(SRF_M_PACK));
+
+    for (int e = 0; e < loads; e++) {
+        for (int c = 0; c < LOCKSTEP_CORES; c++) {
+            for (int l = 0; l < SIMD_WIDTH; l++) {
+                int w = e*SRF_M_PACK + l;
+                if (!CHAR_DATA)
+                    dataFile << (l < SRF_M_PACK && w < n ? src[*idx + w] : 0) << " ";
+                else
+                    dataFile << int(l < SRF_M_PACK && w < n ? src[*idx + w] : 0) << " "; //need to cast the results for int8 only
+            }
+        }
+        dataFile << endl;
+    }
+    *idx += n;
+}
@@ -31,6 +31,22 @@ const int global_offset = GLOBAL_OFFSET;
 
 #define COLPERROW   (1 << addr_bits[int(Level::Column)])
 
+// Cores that execute a mapping in lockstep, only the ones of a bank group if every bank group runs its own stream
+#if BG_CORES
+#define LOCKSTEP_CORES  CORES_PER_BG
+#else
+#define LOCKSTEP_CORES  CORES_PER_PCH
+#endif
+
+// Channel, rank and bank group where the mappers place the kernel, set by the partitioning in map_kernel
+extern uint64_t mapChannel, mapRank, mapBankGroup;
+
+// Write the weights of the SRF_M with packed writes, SRF_M_PACK entries per burst, instead of one write per entry
+#define SRF_PACKED_WR   1
+
+// Repeat a program with an outer JUMP around the inner loops instead of one EXEC per repetition
+#define NESTED_LOOPS    1
+
 // Function for building addresses
 uint64_t build_addr(vector<uint64_t> addr_vec);
 
@@ -43,4 +59,19 @@ uint16_t get_row(uint64_t addr);
 // Function for getting the column index from an address
 uint16_t get_col(uint64_t addr);
 
+// Function for writing the WRFs that load the first n entries of the SRF_M from the data file, to every core
+// or only to the given one (needs UNICAST_RF)
+void writeSrfMLoad(ofstream &assembly, int n, int core = -1);
+
+// Function for writing the EXIT and EXECs of a program with body instructions that runs ext_loops times,
+// nested in an outer JUMP if the CRF has room for it
+void writeExecLoops(ofstream &assembly, int body, int ext_loops);
+
+// Function for writing the data of writeSrfMLoad, n values of src starting at *idx
+void writeSrfMData(ofstream &dataFile, cnm_t *src, uint64_t *idx, int n);
+
+// Function for writing the bank columns that fill the SRF_M with block MOVs, n values of src starting at *idx
+// in the first SRF_M_PACK lanes of every column and core
+void writeSrfMBankData(ofstream &dataFile, cnm_t *src, uint64_t *idx, int n);
+
 #endif  // UTILS_H
\ No newline at end of file
@@ -0,0 +1,36 @@
+#!/bin/bash
+
+# Maps and assembles the DP kernel with the wide accumulators of MACW, half into float lanes (WIDE_ACC 1) and
+# fp8 into half lanes (WIDE_ACC 2), for sizes that fill the CRF. Fails if any program cannot be assembled,
+# does not fit the CRF once scheduled or gives an empty sequence. Run from the scripts folder
+
+echo "REMEMEBER ALL HEADER FILES SHOULD START WITH WIDE_ACC 0 and DATA_TYPE 0"
+
+FAILED=0
+
+for CONFIG in "1 0" "2 8"; do
+    W=${CONFIG% *}
+    T=${CONFIG#* }
+    sed -i "s/#define WIDE_ACC    0/#define WIDE_ACC    $W/g" ../src/defs.h
+    sed -i "s/#define DATA_TYPE   0/#define DATA_TYPE   $T/g" ../src/defs.h
+    cd ../inputs
+    ./compile_all.sh
+    for SIZE in "16 4" "64 14" "64 16" "64 20" "64 27" "64 28" "64 30" "128 20" "128 128"; do
+        NAME=dpwide${W}V${SIZE% *}n${SIZE#* }
+        bin/map_kernel $NAME DP $SIZE > /dev/null
+        OUT=$(bin/nmc_assembler assembly-input/$NAME.asm raw/$NAME.seq data-input/$NAME.data address-input/$NAME.addr)
+        if [ $? -ne 0 ] || [ ! -s raw/$NAME.seq ] || echo "$OUT" | grep -q "not scheduled"; then
+            echo "WIDE_ACC $W, DP V n = $SIZE failed"
+            FAILED=1
+        fi
+    done
+    cd ../scripts
+    sed -i "s/#define WIDE_ACC    $W/#define WIDE_ACC    0/g" ../src/defs.h
+    sed -i "s/#define DATA_TYPE   $T/#define DATA_TYPE   0/g" ../src/defs.h
+done
+
+cd ../inputs
+./compile_all.sh
+cd ../scripts
+
+exit $FAILED
@@ -0,0 +1,88 @@
+/*
+ * Copyright EPFL 2024
+ *
+ * Brain floating point datatype for simulation: 1 sign, 8 exponent and 7
+ * mantissa bits, the upper half of a float. Conversions from float round to
+ * nearest even, and the arithmetic is done in float and rounded once, which is
+ * exact for bfloat16 since a float holds more than twice its mantissa bits.
+ * The conversions are branch-free bit operations that compilers inline and
+ * vectorize, so the per-lane adders and multipliers stay cheap to simulate.
+ * It does not depend on SystemC, so the mapping tools share it.
+ *
+ */
+
+#ifndef SRC_BFLOAT16_H_
+#define SRC_BFLOAT16_H_
+
+#include <cstdint>
+#include <cstring>
+#include <ostream>
+#include <istream>
+#include <string>
+
+class bfloat16 {
+public:
+    bfloat16() : data_(0) {}
+    bfloat16(float f) : data_(round_bits(f)) {}
+
+    // Builds the value from its binary representation
+    static bfloat16 from_bits(uint16_t bits) {
+        bfloat16 b;
+        b.data_ = bits;
+        return b;
+    }
+
+    // Binary representation, as bin_word() of half
+    uint16_t bin_word() const { return data_; }
+
+    explicit operator float() const {
+        uint32_t u = uint32_t(data_) << 16;
+        float f;
+        memcpy(&f, &u, sizeof(f));
+        return f;
+    }
+
+    friend bfloat16 operator+(bfloat16 a, bfloat16 b) { return bfloat16(float(a) + float(b)); }
+    friend bfloat16 operator-(bfloat16 a, bfloat16 b) { return bfloat16(float(a) - float(b)); }
+    friend bfloat16 operator*(bfloat16 a, bfloat16 b) { return bfloat16(float(a) * float(b)); }
+    friend bfloat16 operator/(bfloat16 a, bfloat16 b) { return bfloat16(float(a) / float(b)); }
+    friend bfloat16 operator-(bfloat16 a) { return from_bits(a.data_ ^ 0x8000); }
+    bfloat16& operator+=(bfloat16 rhs) { return *this = *this + rhs; }
+    bfloat16& operator-=(bfloat16 rhs) { return *this = *this - rhs; }
+    bfloat16& operator*=(bfloat16 rhs) { return *this = *this * rhs; }
+    bfloat16& operator/=(bfloat16 rhs) { return *this = *this / rhs; }
+
+    friend bool operator==(bfloat16 a, bfloat16 b) { return float(a) == float(b); }
+    friend bool operator!=(bfloat16 a, bfloat16 b) { return float(a) != float(b); }
+    friend bool operator<(bfloat16 a, bfloat16 b) { return float(a) < float(b); }
+    friend bool operator>(bfloat16 a, bfloat16 b) { return float(a) > float(b); }
+    friend bool operator<=(bfloat16 a, bfloat16 b) { return float(a) <= float(b); }
+    friend bool operator>=(bfloat16 a, bfloat16 b) { return float(a) >= float(b); }
+
+    friend std::ostream& operator<<(std::ostream &out, bfloat16 b) { return out << float(b); }
+    friend std::istream& operator>>(std::istream &in, bfloat16 &b) {
+        float f;
+        if (in >> f)
+            b = bfloat16(f);
+        return in;
+    }
+
+    // Integration into SystemC, only instantiated when a bfloat16 signal is traced
+    template <typename trace_file>
+    friend void sc_trace(trace_file *tf, const bfloat16 &b, const std::string &name) {
+        sc_trace(tf, b.data_, name);
+    }
+
+private:
+    // Rounds a float to nearest even on its upper half, NaNs are kept quiet
+    static uint16_t round_bits(float f) {
+        uint32_t u;
+        memcpy(&u, &f, sizeof(u));
+        uint32_t rounded = (u + 0x7FFF + ((u >> 16) & 1)) >> 16;
+        return (u & 0x7FFFFFFF) > 0x7F800000 ? uint16_t((u >> 16) | 0x40) : uint16_t(rounded);
+    }
+
+    uint16_t data_;     // Binary representation
+};
+
+#endif /* SRC_BFLOAT16_H_ */
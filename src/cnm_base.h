@@ -17,6 +17,7 @@
 #include "defs.h"
 #include "opcodes.h"
 #include "datatypes.h"
+#include "self_profile.h"
 
 // RoBaBgRaCoCh mapping
 #define CH_END          GLOBAL_OFFSET
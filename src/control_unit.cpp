@@ -9,5 +9,6 @@
 #include "control_unit.h"
 
 void control_unit::comb_method() {
+    PROFILE_METHOD("control_unit::comb_method");
     pc_out->write(pc);
 }
@@ -24,6 +24,10 @@ public:
     sc_in<bool>                     AB_mode;	// Signals if the All-Banks mode is enabled
     sc_in<bool>                     pim_mode;	// Signals if the PIM mode is enabled
     sc_in<sc_uint<BANK_BITS> >      bank_addr;	// Address of the bank
+#if UNICAST_RF
+    sc_in<sc_uint<BG_BITS> >        bg_addr;    // Address of the bank group
+    sc_in<sc_uint<CORE_ID_BITS> >   core_id;    // Index of the core in the pseudo-channel
+#endif
     sc_in<sc_uint<ROW_BITS> >       row_addr;	// Address of the bank row
     sc_in<sc_uint<COL_BITS> >       col_addr;	// Address of the bank column
     sc_in<sc_uint<DQ_BITS> >        DQ;	        // Data input from DRAM controller (output makes no sense)
@@ -34,6 +38,8 @@ public:
     // CRF Control
     sc_out<bool>    crf_wr_en;		//Enables writing of a received instruction
     sc_out<uint>    crf_wr_addr;    //Index for writing the received instructions from processor
+    sc_out<bool>    crf_wr_sh;      // Writes to the CRF bank that is not executing
+    sc_out<bool>    crf_swap;       // Swaps the executing CRF bank
 
     // SRF Control
     sc_out<uint>    srf_rd_addr;	// Index read
@@ -42,6 +48,9 @@ public:
     sc_out<uint>    srf_wr_addr;	// Index the address to be written
     sc_out<bool>    srf_wr_a_nm;    // Signals if writing to SRF_A (high) or SRF_M (low)
     sc_out<uint8_t> srf_wr_from;	// Index the MUX for input data
+    sc_out<bool>    srf_wr_pack;    // Signals a packed write of consecutive entries from the DQ burst or bank
+    sc_out<uint8_t> srf_wr_lane;    // Lane of the bank column written to the SRF, first one if packed
+    sc_out<int>     fill_imm;       // Immediate of a FILL, broadcast by the GRFs and the SRF
 
     // GRF_A Control
     sc_out<uint>    grfa_rd_addr1;	// Index read at port 1
@@ -59,6 +68,13 @@ public:
     sc_out<uint>    grfb_wr_addr;	// Index the address to be written
     sc_out<uint8_t> grfb_wr_from;	// Index the MUX for input data
 
+#if LANE_PERM
+    // Lane permutation Control
+    sc_out<uint8_t> grfa_perm_sel;  // Lane permutation of the entry written to GRF_A
+    sc_out<uint8_t> grfb_perm_sel;  // Lane permutation of the entry written to GRF_B
+    sc_out<uint8_t> perm_k;         // Lanes shifted or rotated, or lane broadcast, by both GRFs
+#endif
+
     // FPU Control
     sc_out<bool>    fpu_mult_en;        // Signals that a multiplication computation step should be performed
     sc_out<bool>    fpu_add_en;         // Signals that an addition computation step should be performed
@@ -67,6 +83,12 @@ public:
     sc_out<uint8_t> fpu_add_in1_sel;    // Selects input 1 for addition
     sc_out<uint8_t> fpu_add_in2_sel;    // Selects input 2 for addition
     sc_out<bool>    fpu_out_sel;        // Selects the output: 0 for adder output, 1 for multiplier output
+    sc_out<bool>    fpu_red_en;         // Signals that a reduction step should be performed
+    sc_out<bool>    fpu_red_max;        // Reduces to the maximum of the lanes instead of their sum
+    sc_out<bool>    fpu_red_sel;        // Selects the reduction result as the output of the FPU
+#if HAZARD_FWD
+    sc_out<uint8_t> fpu_fwd_sel;        // FPU inputs taking the FPU output as it is written back
+#endif
 
     // BANKS Control
     sc_out<bool> even_out_en;	// Enables the even bank tri-state buffer
@@ -96,6 +118,10 @@ public:
         iu->AB_mode(AB_mode);
         iu->pim_mode(pim_mode);
         iu->bank_addr(bank_addr);
+#if UNICAST_RF
+        iu->bg_addr(bg_addr);
+        iu->core_id(core_id);
+#endif
         iu->row_addr(row_addr);
         iu->col_addr(col_addr);
         iu->DQ(DQ);
@@ -114,6 +140,9 @@ public:
         id->bank_addr(bank_addr);
         id->row_addr(row_addr);
         id->col_addr(col_addr);
+#if AAM_REGS
+        id->rf_data(data_out);
+#endif
         // Program Counter Control
         id->pc_rst(pc_rst);
         id->count_en(count_en);
@@ -122,6 +151,8 @@ public:
         // CRF Control
         id->crf_wr_en(crf_wr_en);
         id->crf_wr_addr(crf_wr_addr);
+        id->crf_wr_sh(crf_wr_sh);
+        id->crf_swap(crf_swap);
         // SRF Control
         id->srf_rd_addr(srf_rd_addr);
         id->srf_rd_a_nm(srf_rd_a_nm);
@@ -129,6 +160,9 @@ public:
         id->srf_wr_addr(srf_wr_addr);
         id->srf_wr_a_nm(srf_wr_a_nm);
         id->srf_wr_from(srf_wr_from);
+        id->srf_wr_pack(srf_wr_pack);
+        id->srf_wr_lane(srf_wr_lane);
+        id->fill_imm(fill_imm);
         // GRF_A Control
         id->grfa_rd_addr1(grfa_rd_addr1);
         id->grfa_rd_addr2(grfa_rd_addr2);
@@ -143,6 +177,12 @@ public:
         id->grfb_relu_en(grfb_relu_en);
         id->grfb_wr_addr(grfb_wr_addr);
         id->grfb_wr_from(grfb_wr_from);
+#if LANE_PERM
+        // Lane permutation Control
+        id->grfa_perm_sel(grfa_perm_sel);
+        id->grfb_perm_sel(grfb_perm_sel);
+        id->perm_k(perm_k);
+#endif
         // FPU Control
         id->fpu_mult_en(fpu_mult_en);
         id->fpu_add_en(fpu_add_en);
@@ -151,6 +191,12 @@ public:
         id->fpu_add_in1_sel(fpu_add_in1_sel);
         id->fpu_add_in2_sel(fpu_add_in2_sel);
         id->fpu_out_sel(fpu_out_sel);
+        id->fpu_red_en(fpu_red_en);
+        id->fpu_red_max(fpu_red_max);
+        id->fpu_red_sel(fpu_red_sel);
+#if HAZARD_FWD
+        id->fpu_fwd_sel(fpu_fwd_sel);
+#endif
         // BANKS Control
         id->even_out_en(even_out_en);
         id->odd_out_en(odd_out_en);
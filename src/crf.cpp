@@ -8,6 +8,33 @@
 
 #include "crf.h"
 
+void crf::clk_thread() {
+    // Reset
+    bank_reg = false;
+
+    wait();
+
+    // Clocked behaviour
+    while (1) {
+        PROFILE_BEGIN("crf::clk_thread");
+        bank_reg = bank_nxt;
+
+        PROFILE_END();
+        wait();
+    }
+}
+
 void crf::comb_method() {
+    PROFILE_METHOD("crf::comb_method");
+#if CRF_DBUF
+    // The PC reads the executing bank, the host writes either of them
+    bool wr_bank = bank_reg ^ wr_sh;
+    PC_casted = (uint) PC + (bank_reg ? CRF_ENTRIES : 0);
+    wr_addr_casted = wr_addr + (wr_bank ? CRF_ENTRIES : 0);
+    bank_nxt = swap ? !bank_reg : bank_reg;
+#else
     PC_casted = (uint) PC;
+    wr_addr_casted = wr_addr;
+    bank_nxt = false;
+#endif
 }
@@ -23,29 +23,44 @@ public:
     sc_in<bool>         wr_en;      // Enables writing of a received instruction
     sc_in<uint>         wr_addr;    // Index for writing the received instructions from processor
     sc_in<uint32_t>     wr_port;	// Port for writing instructions
+    sc_in<bool>         wr_sh;      // Writes to the bank that is not executing
+    sc_in<bool>         swap;       // Swaps the executing and the written banks
 
-    // Internal RFs
-    rf_twoport<uint32_t, CRF_ENTRIES> *rf;
+    // Internal RFs, the two banks one after the other if double buffered
+    rf_twoport<uint32_t, CRF_ENTRIES * (CRF_DBUF + 1), 1> *rf;
 
     sc_signal<uint> PC_casted;
+    sc_signal<uint> wr_addr_casted;
+    sc_signal<bool> ld_off;     // Instructions are never loaded packed
+    sc_signal<bool> bank_nxt, bank_reg; // Bank being executed
 
     SC_CTOR(crf) {
 
         // Instantiate the two RFs
-        rf = new rf_twoport<uint32_t, CRF_ENTRIES>("CRF");
+        rf = new rf_twoport<uint32_t, CRF_ENTRIES * (CRF_DBUF + 1), 1>("CRF");
         rf->clk(clk);
         rf->rst(rst);
         rf->rd_addr(PC_casted);
         rf->rd_port(instr);
         rf->wr_en(wr_en);
-        rf->wr_addr(wr_addr);
+        rf->wr_addr(wr_addr_casted);
         rf->wr_port(wr_port);
+        rf->ld_en(ld_off);
+        rf->ld_port[0](wr_port);
+
+        SC_THREAD(clk_thread);
+        sensitive << clk.pos();
+        async_reset_signal_is(rst, false);
 
         SC_METHOD(comb_method);
-        sensitive << PC;
+        sensitive << PC << wr_addr << wr_sh << swap << bank_reg;
+
+        bank_nxt = false;
+        bank_reg = false;
     }
 
-    void comb_method();	// Casts the PC to the necessary format
+    void clk_thread();	// Keeps the executing bank
+    void comb_method();	// Casts the PC and write index to the selected banks
 };
 
 #endif
@@ -20,33 +20,52 @@
 #include <ac_sc.h>
 #else
 #include "half.hpp"
+#include "bfloat16.h"
+#include "fp8.h"
+#include <cstring>
 using half_float::half;
 #endif
 
-#if (DATA_TYPE > 3)
+#if (DATA_TYPE > 3 && DATA_TYPE < 8)
 #define INT_TYPE    1       // 1 if Integer data type, 0 otherwise
 #else
 #define INT_TYPE    0       // 1 if Integer data type, 0 otherwise
 #endif
 
-#if (DATA_TYPE == 0 || DATA_TYPE == 3) // TODO until bfloat is implemented
+#if (DATA_TYPE == 0)
 #define HALF_FLOAT  1       // 1 if Half Precision Floating Point data type, 0 otherwise
 #else
 #define HALF_FLOAT  0
 #endif
 
+#if (DATA_TYPE == 3)
+#define BFLOAT      1       // 1 if Brain Floating Point data type, 0 otherwise
+#else
+#define BFLOAT      0
+#endif
+
+#if (DATA_TYPE == 8 || DATA_TYPE == 9)
+#define FP8         1       // 1 if 8-bit Floating Point data type, 0 otherwise
+#else
+#define FP8         0
+#endif
+
+#define SOFT_FLOAT  (BFLOAT || FP8)     // Floating point lanes modelled by a class with from_bits() and bin_word()
+
 /*
 Data Formats for All Data Types:
 =========Not Synthesis=========
 half16                 =>   half
 integer data types     =>   sc_int<WORD_BITS>
-brain float 16         =>   only synthesis simulation
+brain float 16         =>   bfloat16
+floating point 8       =>   fp8_e4m3, fp8_e5m2
 floating point 32      =>   float
 floating point 64      =>   double
-===========Synthesis===========
+===========Synthesis============
 half16                 =>   ac_ieee_float16
 integer data types     => intX_t X = number of bits
 brain float 16         => ac:: bfloat16
+floating point 8       => ac_std_float<8,4>, ac_std_float<8,5>
 floating point 32  => ac_ieee_float32
 floating point 64  => ac_ieee_float64
 */
@@ -86,7 +105,7 @@ floating point 64  => ac_ieee_float64
 #elif (DATA_TYPE == 3)  // bfloat
     #define WORD_BITS   16
     #ifndef __SYNTHESIS__
-        typedef half        cnm_t;
+        typedef bfloat16    cnm_t;
         typedef uint16_t    rfBin_t;
     #else
         typedef ac_std_float<16,8>  cnm_synth;
@@ -119,6 +138,97 @@ floating point 64  => ac_ieee_float64
     #else
         typedef int64_t             cnm_synth;
     #endif
+#elif (DATA_TYPE == 8)  // fp8 E4M3
+    #define WORD_BITS 8
+    #ifndef __SYNTHESIS__
+        typedef fp8_e4m3            cnm_t;
+        typedef uint8_t             rfBin_t;
+    #else
+        typedef ac_std_float<8,4>   cnm_synth;
+    #endif
+#elif (DATA_TYPE == 9)  // fp8 E5M2
+    #define WORD_BITS 8
+    #ifndef __SYNTHESIS__
+        typedef fp8_e5m2            cnm_t;
+        typedef uint8_t             rfBin_t;
+    #else
+        typedef ac_std_float<8,5>   cnm_synth;
+    #endif
+#endif
+
+#if !defined(__SYNTHESIS__) && (HALF_FLOAT || SOFT_FLOAT)
+// Lane value from its binary representation
+inline cnm_t cnm_from_bits(rfBin_t bits) {
+#if HALF_FLOAT
+    return half(half_float::detail::binary, bits);
+#else
+    return cnm_t::from_bits(bits);
+#endif
+}
+#endif
+
+// Wide accumulators of MACW, every one spans ACC_RATIO neighbouring lanes of a GRF_B entry
+#if WIDE_ACC
+    #if (WIDE_ACC == 1 && (HALF_FLOAT || FP8))
+        #define ACC_BITS    32
+        #ifndef __SYNTHESIS__
+            typedef float       cnm_acc_t;
+        #else
+            #error "MACW on floating point lanes is only modelled in simulation"
+        #endif
+    #elif (WIDE_ACC == 2 && FP8)
+        #define ACC_BITS    16
+        #ifndef __SYNTHESIS__
+            typedef half        cnm_acc_t;
+        #else
+            #error "MACW on floating point lanes is only modelled in simulation"
+        #endif
+    #elif (WIDE_ACC == 1 && DATA_TYPE == 4)
+        #define ACC_BITS    32
+        #ifndef __SYNTHESIS__
+            typedef sc_int<ACC_BITS>    cnm_acc_t;
+        #else
+            typedef int32_t             cnm_acc_synth;
+        #endif
+    #else
+        #error "WIDE_ACC 1 needs half, int8 or FP8 lanes, WIDE_ACC 2 needs FP8 lanes"
+    #endif
+    #define ACC_RATIO   (ACC_BITS / WORD_BITS)      // Lanes of a wide accumulator
+    #define ACC_LANES   (SIMD_WIDTH / ACC_RATIO)    // Wide accumulators in a GRF_B entry
+
+    #ifndef __SYNTHESIS__
+    // Lane value widened to the accumulators
+    inline cnm_acc_t cnm_widen(cnm_t x) {
+    #if INT_TYPE
+        return cnm_acc_t(x);
+    #else
+        return cnm_acc_t(float(x));
+    #endif
+    }
+
+    #if !INT_TYPE
+    // Floating point accumulator from the bits of its lanes, and back
+    inline cnm_acc_t acc_from_bits(uint32_t bits) {
+    #if ACC_BITS == 16
+        return half(half_float::detail::binary, bits);
+    #else
+        cnm_acc_t acc;
+        memcpy(&acc, &bits, sizeof(acc));
+        return acc;
+    #endif
+    }
+
+    inline uint32_t acc_to_bits(cnm_acc_t acc) {
+    #if ACC_BITS == 16
+        return acc.bin_word();
+    #else
+        uint32_t bits;
+        memcpy(&bits, &acc, sizeof(bits));
+        return bits;
+    #endif
+    }
+    #endif  // !INT_TYPE
+    #endif  // __SYNTHESIS__
 #endif
 
 #if DQ_BITS == 16
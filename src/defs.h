@@ -12,6 +12,7 @@
 
 #define MIXED_SIM   0   // 0 if SystemC-only simulation, 1 if mixed SystemC + RTL
 #define DEBUG       0
+#define SELF_PROFILE 0  // 1 to count activations and time per SystemC process
 
 #define CLK_PERIOD 3333
 #define RESOLUTION SC_PS
@@ -19,12 +20,15 @@
 // 0: half
 // 1: float
 // 2: double
-// 3: bfloat (not implemented)
+// 3: bfloat
 // 4: int8
 // 5: int16
 // 6: int32
 // 7: int64
+// 8: fp8 E4M3
+// 9: fp8 E5M2
 #define DATA_TYPE   0
+#define WIDE_ACC    0   // 1 to add MACW, accumulating products of half, int8 or fp8 lanes into float or int32 lanes, 2 for fp8 into half
 
 // Address mapping constants
 #define CHANNEL_BITS    4
@@ -36,17 +40,42 @@
 #define GLOBAL_OFFSET   6
 
 // Sizing constants
+#define BG_CORES        0   // 1 to place a core per bank pair of every bank group, each bank group running its own stream
+#if BG_CORES
+#define CORES_PER_BG    (1 << (BANK_BITS - 1))
+#define CORES_PER_PCH   ((1 << BG_BITS) * CORES_PER_BG)
+#else
 #define CORES_PER_PCH   1
+#endif
+#define UNICAST_RF      (CORES_PER_PCH > 1) // RF writes with the bank LSB set only reach the core selected by the other bank and bank-group bits
+#define CORE_ID_BITS    (BG_BITS + BANK_BITS - 1)
+#define CORE_RING       0   // 1 to link the cores running in lockstep in a ring, MOV from RING reading GRF_B of the previous one
+#if BG_CORES
+#define RING_CORES      CORES_PER_BG        // Cores of a ring, those of a bank group
+#else
+#define RING_CORES      CORES_PER_PCH
+#endif
 #define SIMD_WIDTH      (256 / WORD_BITS)   // Compatible with HBM interface
 #define CRF_ENTRIES     32
+#define CRF_DBUF        0   // 1 to add a second CRF bank, written by the host while the other one executes
 #define SRF_A_ENTRIES   8
 #define SRF_M_ENTRIES   8
 #define GRF_ENTRIES     8
+#define LOOP_DEPTH      4   // Nesting levels of JUMP loops, one counter per level
+#define SRF_M_PACK      (SRF_M_ENTRIES < SIMD_WIDTH ? SRF_M_ENTRIES : SIMD_WIDTH)   // SRF entries written by a packed write
+#define SRF_A_PACK      (SRF_A_ENTRIES < SIMD_WIDTH ? SRF_A_ENTRIES : SIMD_WIDTH)
 #define ADD_STAGES      1
 #define MULT_STAGES     1
+#define SIMD_LOG        (SIMD_WIDTH >= 32 ? 5 : SIMD_WIDTH >= 16 ? 4 : SIMD_WIDTH >= 8 ? 3 : 2)  // Levels of the lane reduction tree
+#define RED_STAGES      (SIMD_LOG * ADD_STAGES)     // Latency of a lane reduction, one adder per tree level
+#define HAZARD_FWD      0   // 1 to forward FPU results to the operands read while they are written back, other RAW hazards are an error
+#define DUAL_ISSUE      0   // 1 to decode MULADD, a MUL and an ADD into different GRFs issued in the same cycle
+#define DUAL_BANK       0   // 1 so that a column RD can fill both banks of every pair, for instructions with an EVEN_BANK and an ODD_BANK operand
 #define RF_SEL_BITS     ROW_BITS-1
 #define RF_ADDR_BITS    COL_BITS
 #define AAM_ADDR_BITS   3
+#define AAM_REGS        0   // 1 to take the AAM GRF indices from base, stride and modulo registers written by the host instead of the column address
+#define LANE_PERM       0   // 1 to add PERM, shifting, rotating or broadcasting the lanes of a GRF entry as it is written to a GRF
 #define INSTR_BITS      32
 //#define WORD_BITS       16
 #define GRF_WIDTH       (WORD_BITS*SIMD_WIDTH)
@@ -0,0 +1,119 @@
+/*
+ * Copyright EPFL 2024
+ *
+ * 8-bit floating point datatypes for simulation, in the E4M3 and E5M2 formats
+ * of FP8 inference. E5M2 keeps the infinities and NaNs of IEEE 754, while E4M3
+ * only has a NaN and saturates to its maximum, 448, instead of overflowing.
+ * Conversions from float round to nearest even, and the arithmetic is done in
+ * float and rounded once, like bfloat16. It does not depend on SystemC, so the
+ * mapping tools share it.
+ *
+ */
+
+#ifndef SRC_FP8_H_
+#define SRC_FP8_H_
+
+#include <cstdint>
+#include <cmath>
+#include <ostream>
+#include <istream>
+#include <string>
+
+template <int EXP, int MAN, bool IEEE>
+class fp8 {
+public:
+    fp8() : data_(0) {}
+    fp8(float f) : data_(round_bits(f)) {}
+
+    // Builds the value from its binary representation
+    static fp8 from_bits(uint8_t bits) {
+        fp8 b;
+        b.data_ = bits;
+        return b;
+    }
+
+    // Binary representation, as bin_word() of half
+    uint8_t bin_word() const { return data_; }
+
+    explicit operator float() const {
+        int e = (data_ >> MAN) & EXP_MASK;
+        int m = data_ & MAN_MASK;
+        float v;
+
+        if (IEEE && e == EXP_MASK)
+            v = m ? NAN : INFINITY;
+        else if (!IEEE && e == EXP_MASK && m == MAN_MASK)
+            v = NAN;
+        else if (e)
+            v = ldexpf(float(m + (1 << MAN)), e - BIAS - MAN);
+        else
+            v = ldexpf(float(m), 1 - BIAS - MAN);   // Subnormal
+        return (data_ & 0x80) ? -v : v;
+    }
+
+    friend fp8 operator+(fp8 a, fp8 b) { return fp8(float(a) + float(b)); }
+    friend fp8 operator-(fp8 a, fp8 b) { return fp8(float(a) - float(b)); }
+    friend fp8 operator*(fp8 a, fp8 b) { return fp8(float(a) * float(b)); }
+    friend fp8 operator/(fp8 a, fp8 b) { return fp8(float(a) / float(b)); }
+    friend fp8 operator-(fp8 a) { return from_bits(a.data_ ^ 0x80); }
+    fp8& operator+=(fp8 rhs) { return *this = *this + rhs; }
+    fp8& operator-=(fp8 rhs) { return *this = *this - rhs; }
+    fp8& operator*=(fp8 rhs) { return *this = *this * rhs; }
+    fp8& operator/=(fp8 rhs) { return *this = *this / rhs; }
+
+    friend bool operator==(fp8 a, fp8 b) { return float(a) == float(b); }
+    friend bool operator!=(fp8 a, fp8 b) { return float(a) != float(b); }
+    friend bool operator<(fp8 a, fp8 b) { return float(a) < float(b); }
+    friend bool operator>(fp8 a, fp8 b) { return float(a) > float(b); }
+    friend bool operator<=(fp8 a, fp8 b) { return float(a) <= float(b); }
+    friend bool operator>=(fp8 a, fp8 b) { return float(a) >= float(b); }
+
+    friend std::ostream& operator<<(std::ostream &out, fp8 b) { return out << float(b); }
+    friend std::istream& operator>>(std::istream &in, fp8 &b) {
+        float f;
+        if (in >> f)
+            b = fp8(f);
+        return in;
+    }
+
+    // Integration into SystemC, only instantiated when an fp8 signal is traced
+    template <typename trace_file>
+    friend void sc_trace(trace_file *tf, const fp8 &b, const std::string &name) {
+        sc_trace(tf, b.data_, name);
+    }
+
+private:
+    static const int EXP_MASK = (1 << EXP) - 1;
+    static const int MAN_MASK = (1 << MAN) - 1;
+    static const int BIAS = (1 << (EXP - 1)) - 1;
+    static const int MAX_BITS = IEEE ? (EXP_MASK << MAN) - 1 : (EXP_MASK << MAN) | (MAN_MASK - 1);   // Largest finite value
+    static const int OVF_BITS = IEEE ? (EXP_MASK << MAN) : MAX_BITS;                                // Infinity or saturation
+
+    // Rounds a float to nearest even on the grid of the format
+    static uint8_t round_bits(float f) {
+        uint8_t sign = std::signbit(f) ? 0x80 : 0;
+        float a = std::fabs(f);
+        int e, bits;
+
+        if (std::isnan(f))
+            return sign | (IEEE ? (EXP_MASK << MAN) | (1 << (MAN - 1)) : 0x7F);
+        if (std::isinf(f))
+            return sign | OVF_BITS;
+        if (a == 0)
+            return sign;
+
+        std::frexp(a, &e);
+        e = e - 1 < 1 - BIAS ? 1 - BIAS : e - 1;                // Subnormals share the lowest exponent
+        bits = int(std::nearbyint(std::ldexp(a, MAN - e)));     // Mantissa with the hidden bit, rounded
+        if (bits >> MAN)                                        // Normal, a carry out of the mantissa
+            bits = ((e + BIAS) << MAN) + (bits - (1 << MAN));   // increments the exponent by itself
+        return sign | (bits > MAX_BITS ? OVF_BITS : bits);
+    }
+
+    uint8_t data_;      // Binary representation
+};
+
+typedef fp8<4, 3, false>    fp8_e4m3;
+typedef fp8<5, 2, true>     fp8_e5m2;
+
+#endif /* SRC_FP8_H_ */
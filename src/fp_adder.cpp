@@ -29,17 +29,20 @@ void fp_adder::clk_thread() {
 
     // Clocked behaviour
     while (1) {
+        PROFILE_BEGIN("fp_adder::clk_thread");
         if (compute_en->read()) {
             for (i = ADD_STAGES - 1; i > 0; i--) {
                 pipeline[i] = pipeline[i - 1];
             }
             pipeline[0] = add_res;
         }
+        PROFILE_END();
         wait();
     }
 }
 
 void fp_adder::comb_method() {
+    PROFILE_METHOD("fp_adder::comb_method");
     add_res = op1->read() + op2->read();
     output->write(pipeline[ADD_STAGES - 1]);
 }
@@ -22,24 +22,45 @@ void fp_multiplier::clk_thread() {
 #else
         pipeline[i] = cnm_t(0);
 #endif
-
+#if WIDE_ACC && __SYNTHESIS__
+        wide_pipeline[i] = cnm_acc_synth(0);
+#elif WIDE_ACC
+        wide_pipeline[i] = cnm_acc_t(0);
+#endif
     }
 
     wait();
 
     // Clocked behaviour
     while (1) {
+        PROFILE_BEGIN("fp_multiplier::clk_thread");
         if (compute_en->read()) {
             for (i = MULT_STAGES - 1; i > 0; i--) {
                 pipeline[i] = pipeline[i - 1];
             }
             pipeline[0] = mul_res;
+#if WIDE_ACC
+            for (i = MULT_STAGES - 1; i > 0; i--) {
+                wide_pipeline[i] = wide_pipeline[i - 1];
+            }
+            wide_pipeline[0] = wide_res;
+#endif
         }
+        PROFILE_END();
         wait();
     }
 }
 
 void fp_multiplier::comb_method() {
+    PROFILE_METHOD("fp_multiplier::comb_method");
     mul_res = op1->read() * op2->read();
     output->write(pipeline[MULT_STAGES - 1]);
+#if WIDE_ACC    // Operands widened before the product, so that it cannot overflow the lanes
+#ifdef __SYNTHESIS__
+    wide_res = cnm_acc_synth(op1->read()) * cnm_acc_synth(op2->read());
+#else
+    wide_res = cnm_widen(op1->read()) * cnm_widen(op2->read());
+#endif
+    wide_out->write(wide_pipeline[MULT_STAGES - 1]);
+#endif
 }
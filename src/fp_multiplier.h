@@ -32,9 +32,16 @@ public:
     sc_in<cnm_synth>    	op1;        // First operand
     sc_in<cnm_synth>    	op2;        // Second operand
     sc_out<cnm_synth>		output;     // Output of the multiplication
+#if WIDE_ACC
+    sc_out<cnm_acc_synth>	wide_out;   // Product widened to the accumulators of MACW
+#endif
 
     sc_signal<cnm_synth>	pipeline[MULT_STAGES];  // Pipelined multiplication results
     sc_signal<cnm_synth>	mul_res;
+#if WIDE_ACC
+    sc_signal<cnm_acc_synth>	wide_pipeline[MULT_STAGES];
+    sc_signal<cnm_acc_synth>	wide_res;
+#endif
 
     SC_CTOR(fp_multiplier) {
         SC_THREAD(clk_thread);
@@ -43,9 +50,15 @@ public:
 
         SC_METHOD(comb_method);
         sensitive << op1 << op2 << pipeline[MULT_STAGES-1];
+#if WIDE_ACC
+        sensitive << wide_pipeline[MULT_STAGES-1];
+#endif
 
         for (int i=0; i<MULT_STAGES; i++) {
             pipeline[i] = cnm_synth(0.0);
+#if WIDE_ACC
+            wide_pipeline[i] = cnm_acc_synth(0);
+#endif
         }
     }
 
@@ -65,9 +78,16 @@ public:
     sc_in<cnm_t>    op1;        // First operand
     sc_in<cnm_t>    op2;        // Second operand
     sc_out<cnm_t>   output;     // Output of the multiplication
+#if WIDE_ACC
+    sc_out<cnm_acc_t>   wide_out;   // Product widened to the accumulators of MACW
+#endif
 
     sc_signal<cnm_t>    pipeline[MULT_STAGES];  // Pipelined multiplication results
     sc_signal<cnm_t>    mul_res;
+#if WIDE_ACC
+    sc_signal<cnm_acc_t>    wide_pipeline[MULT_STAGES];
+    sc_signal<cnm_acc_t>    wide_res;
+#endif
 
     SC_CTOR(fp_multiplier) {
         SC_THREAD(clk_thread);
@@ -76,12 +96,18 @@ public:
 
         SC_METHOD(comb_method);
         sensitive << op1 << op2 << pipeline[MULT_STAGES - 1];
+#if WIDE_ACC
+        sensitive << wide_pipeline[MULT_STAGES - 1];
+#endif
 
         for (int i = 0; i < MULT_STAGES; i++) {
 #if HALF_FLOAT
             pipeline[i] = half_float::half_cast<half>(0.0);
 #else
             pipeline[i] = cnm_t(0);
+#endif
+#if WIDE_ACC
+            wide_pipeline[i] = cnm_acc_t(0);
 #endif
         }
     }
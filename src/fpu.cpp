@@ -9,6 +9,7 @@
 #include "fpu.h"
 
 void fpu::multiplex_method() {
+    PROFILE_METHOD("fpu::multiplex_method");
     int i;
 
     // Multiplication Input 1
@@ -117,6 +118,7 @@ void fpu::multiplex_method() {
             }
         break;
         case A_GRF_B1:
+        case A_GRF_B1_WIDE:
             for (i = 0; i < SIMD_WIDTH; i++) {
                 add_in1[i] = grfb_in1[i];
             }
@@ -191,18 +193,223 @@ void fpu::multiplex_method() {
             }
         break;
     }
+
+#if HAZARD_FWD
+    // Forwarded inputs take the result being written back, lane 0 of it if they read the SRF
+    if (fwd_sel->read() & FWD_M1) {
+        for (i = 0; i < SIMD_WIDTH; i++) {
+            mult_in1[i] = output[i]->read();
+        }
+    }
+    if (fwd_sel->read() & FWD_M2) {
+        for (i = 0; i < SIMD_WIDTH; i++) {
+            mult_in2[i] = output[mult_in2_sel->read() == M2_SRF ? 0 : i]->read();
+        }
+    }
+    if (fwd_sel->read() & FWD_A1) {
+        for (i = 0; i < SIMD_WIDTH; i++) {
+            add_in1[i] = output[add_in1_sel->read() == A_SRF ? 0 : i]->read();
+        }
+    }
+    if (fwd_sel->read() & FWD_A2) {
+        for (i = 0; i < SIMD_WIDTH; i++) {
+            add_in2[i] = output[add_in2_sel->read() == A_SRF ? 0 : i]->read();
+        }
+    }
+#endif
+}
+
+void fpu::reduce_method() {
+    PROFILE_METHOD("fpu::reduce_method");
+    int i, w;
+#ifdef __SYNTHESIS__
+    cnm_synth level[SIMD_WIDTH];
+#else
+    cnm_t level[SIMD_WIDTH];
+#endif
+
+    // Every level of the tree combines pairs of neighbouring lanes, halving them
+    for (i = 0; i < SIMD_WIDTH; i++) {
+        level[i] = add_in1[i];
+    }
+    for (w = SIMD_WIDTH / 2; w > 0; w /= 2) {
+        for (i = 0; i < w; i++) {
+            if (red_max->read())
+                level[i] = level[2 * i] < level[2 * i + 1] ? level[2 * i + 1] : level[2 * i];
+            else
+                level[i] = level[2 * i] + level[2 * i + 1];
+        }
+    }
+    red_res = level[0];
+}
+
+void fpu::red_thread() {
+    int i;
+
+    // Reset behaviour
+    for (i = 0; i < RED_STAGES; i++) {
+#ifdef __SYNTHESIS__
+        red_pipe[i] = cnm_synth(0);
+#elif HALF_FLOAT
+        red_pipe[i] = half_float::half_cast<half>(0.0);
+#else
+        red_pipe[i] = cnm_t(0);
+#endif
+    }
+
+    wait();
+
+    // Clocked behaviour
+    while (1) {
+        PROFILE_BEGIN("fpu::red_thread");
+        if (red_en->read()) {
+            for (i = RED_STAGES - 1; i > 0; i--) {
+                red_pipe[i] = red_pipe[i - 1];
+            }
+            red_pipe[0] = red_res;
+        }
+        PROFILE_END();
+        wait();
+    }
+}
+
+#if WIDE_ACC
+void fpu::wide_method() {
+    PROFILE_METHOD("fpu::wide_method");
+    int i, k;
+#ifdef __SYNTHESIS__
+    cnm_acc_synth acc;
+#elif !INT_TYPE
+    cnm_acc_t acc;
+    cnm_t lane;
+    uint32_t bits;
+#else
+    cnm_acc_t acc;
+#endif
+
+    // Every accumulator is rebuilt from the raw bits of its lanes, lowest lane first,
+    // and adds the products of the same lanes, widened by the multipliers
+    for (i = 0; i < ACC_LANES; i++) {
+#ifdef __SYNTHESIS__
+        acc = 0;
+        for (k = 0; k < ACC_RATIO; k++) {
+            acc |= (cnm_acc_synth(add_in1[i * ACC_RATIO + k].read()) & ((cnm_acc_synth(1) << WORD_BITS) - 1)) << (WORD_BITS * k);
+        }
+        for (k = 0; k < ACC_RATIO; k++) {
+            acc += wide_prod[i * ACC_RATIO + k];
+        }
+        wide_res[i] = acc;
+#elif !INT_TYPE
+        bits = 0;
+        for (k = 0; k < ACC_RATIO; k++) {
+            lane = add_in1[i * ACC_RATIO + k].read();
+            bits |= uint32_t(lane.bin_word()) << (WORD_BITS * k);
+        }
+        acc = acc_from_bits(bits);
+        for (k = 0; k < ACC_RATIO; k++) {
+            acc += wide_prod[i * ACC_RATIO + k].read();
+        }
+        wide_res[i] = acc;
+#else
+        for (k = 0; k < ACC_RATIO; k++) {
+            acc.range(WORD_BITS * (k + 1) - 1, WORD_BITS * k) = add_in1[i * ACC_RATIO + k].read().range(WORD_BITS - 1, 0);
+        }
+        for (k = 0; k < ACC_RATIO; k++) {
+            acc = acc + wide_prod[i * ACC_RATIO + k].read();
+        }
+        wide_res[i] = acc;
+#endif
+    }
+}
+
+void fpu::wide_thread() {
+    int i, j;
+
+    // Reset behaviour
+    for (i = 0; i < ADD_STAGES; i++) {
+        for (j = 0; j < ACC_LANES; j++) {
+#ifdef __SYNTHESIS__
+            wide_pipe[i][j] = cnm_acc_synth(0);
+#else
+            wide_pipe[i][j] = cnm_acc_t(0);
+#endif
+        }
+        wide_sel_pipe[i] = false;
+    }
+
+    wait();
+
+    // Clocked behaviour
+    while (1) {
+        PROFILE_BEGIN("fpu::wide_thread");
+        if (add_en->read()) {
+            for (i = ADD_STAGES - 1; i > 0; i--) {
+                for (j = 0; j < ACC_LANES; j++) {
+                    wide_pipe[i][j] = wide_pipe[i - 1][j];
+                }
+                wide_sel_pipe[i] = wide_sel_pipe[i - 1];
+            }
+            for (j = 0; j < ACC_LANES; j++) {
+                wide_pipe[0][j] = wide_res[j];
+            }
+            wide_sel_pipe[0] = (add_in1_sel->read() == A_GRF_B1_WIDE);
+        }
+        PROFILE_END();
+        wait();
+    }
 }
+#endif
 
 void fpu::update_output() {
+    PROFILE_METHOD("fpu::update_output");
     int i;
+#if WIDE_ACC
+    int k;
+#if !defined(__SYNTHESIS__) && !INT_TYPE
+    uint32_t bits;
+#endif
+#endif
 
-    if (out_sel->read()) {
+    if (red_sel->read()) {     // Reduction result in the first lane, the rest cleared
+        output[0]->write(red_pipe[RED_STAGES - 1]);
+        for (i = 1; i < SIMD_WIDTH; i++) {
+#ifdef __SYNTHESIS__
+            output[i]->write(cnm_synth(0));
+#elif HALF_FLOAT
+            output[i]->write(half_float::half_cast<half>(0.0));
+#else
+            output[i]->write(cnm_t(0));
+#endif
+        }
+    } else if (out_sel->read()) {
         for (i = 0; i < SIMD_WIDTH; i++) {
             output[i]->write(mult_out[i]);
         }
+#if WIDE_ACC
+    } else if (wide_sel_pipe[ADD_STAGES - 1]) {     // Wide accumulators split back into their lanes
+        for (i = 0; i < ACC_LANES; i++) {
+            for (k = 0; k < ACC_RATIO; k++) {
+#ifdef __SYNTHESIS__
+                output[i * ACC_RATIO + k]->write(cnm_synth(wide_pipe[ADD_STAGES - 1][i].read() >> (WORD_BITS * k)));
+#elif !INT_TYPE
+                bits = acc_to_bits(wide_pipe[ADD_STAGES - 1][i]);
+                output[i * ACC_RATIO + k]->write(cnm_from_bits(rfBin_t(bits >> (WORD_BITS * k))));
+#else
+                output[i * ACC_RATIO + k]->write(cnm_t(wide_pipe[ADD_STAGES - 1][i].read().range(WORD_BITS * (k + 1) - 1, WORD_BITS * k).to_int64()));
+#endif
+            }
+        }
+#endif
     } else {
         for (i = 0; i < SIMD_WIDTH; i++) {
             output[i]->write(add_out[i]);
         }
     }
+
+#if DUAL_ISSUE
+    // The adder output stays available for the ADD issued along with the MUL
+    for (i = 0; i < SIMD_WIDTH; i++) {
+        mult_output[i]->write(mult_out[i]);
+    }
+#endif
 }
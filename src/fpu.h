@@ -38,7 +38,16 @@ public:
     sc_in<uint8_t>    			add_in1_sel;            // Selects input 1 for addition
     sc_in<uint8_t>				add_in2_sel;            // Selects input 2 for addition
     sc_in<bool>					out_sel;				// Selects the output: 0 for adder output, 1 for multiplier output
+    sc_in<bool>					red_en;					// Signals that a reduction step should be performed
+    sc_in<bool>					red_max;				// Reduces to the maximum of the lanes instead of their sum
+    sc_in<bool>					red_sel;				// Selects the reduction result, in lane 0 of the output
+#if HAZARD_FWD
+    sc_in<uint8_t>				fwd_sel;				// Inputs taking the output, as it is written back, instead of their select
+#endif
     sc_out<cnm_synth>		output[SIMD_WIDTH];     // Output of the Floating Point Unit
+#if DUAL_ISSUE
+    sc_out<cnm_synth>		mult_output[SIMD_WIDTH];	// Multiplier output, written back by the MUL of a MULADD
+#endif
 
     // Internal signals
     sc_signal<cnm_synth>	mult_in1[SIMD_WIDTH];   // Input 1 for multiplication
@@ -47,6 +56,14 @@ public:
     sc_signal<cnm_synth> 	add_in1[SIMD_WIDTH];    // Input 1 for addition
     sc_signal<cnm_synth> 	add_in2[SIMD_WIDTH];    // Input 2 for addition
     sc_signal<cnm_synth> 	add_out[SIMD_WIDTH];    // Multiplication output
+    sc_signal<cnm_synth>	red_res;                // Result of the reduction tree over the lanes of input 1 for addition
+    sc_signal<cnm_synth>	red_pipe[RED_STAGES];   // Pipelined reduction results
+#if WIDE_ACC
+    sc_signal<cnm_acc_synth>	wide_prod[SIMD_WIDTH];              // Widened products of the lanes
+    sc_signal<cnm_acc_synth>	wide_res[ACC_LANES];                // Wide accumulators plus the products of their lanes
+    sc_signal<cnm_acc_synth>	wide_pipe[ADD_STAGES][ACC_LANES];   // Pipelined wide accumulations
+    sc_signal<bool>				wide_sel_pipe[ADD_STAGES];          // Signals a MACW result in the pipeline
+#endif
     
     SC_CTOR(fpu) {
 
@@ -63,6 +80,9 @@ public:
 			multipliers[i]->op1(mult_in1[i]);
 			multipliers[i]->op2(mult_in2[i]);
 			multipliers[i]->output(mult_out[i]);
+#if WIDE_ACC
+			multipliers[i]->wide_out(wide_prod[i]);
+#endif
 
 			adders[i] = new fp_adder(sc_gen_unique_name("adder"));
 			adders[i]->clk(clk);
@@ -91,7 +111,16 @@ public:
     sc_in<uint8_t>  add_in1_sel;            // Selects input 1 for addition
     sc_in<uint8_t>  add_in2_sel;            // Selects input 2 for addition
     sc_in<bool>     out_sel;                // Selects the output: 0 for adder output, 1 for multiplier output
+    sc_in<bool>     red_en;                 // Signals that a reduction step should be performed
+    sc_in<bool>     red_max;                // Reduces to the maximum of the lanes instead of their sum
+    sc_in<bool>     red_sel;                // Selects the reduction result, in lane 0 of the output
+#if HAZARD_FWD
+    sc_in<uint8_t>  fwd_sel;                // Inputs taking the output, as it is written back, instead of their select
+#endif
     sc_out<cnm_t>   output[SIMD_WIDTH];     // Output of the Floating Point Unit
+#if DUAL_ISSUE
+    sc_out<cnm_t>   mult_output[SIMD_WIDTH];    // Multiplier output, written back by the MUL of a MULADD
+#endif
 
     // Internal signals
     sc_signal<cnm_t>    mult_in1[SIMD_WIDTH];   // Input 1 for multiplication
@@ -100,6 +129,14 @@ public:
     sc_signal<cnm_t>    add_in1[SIMD_WIDTH];    // Input 1 for addition
     sc_signal<cnm_t>    add_in2[SIMD_WIDTH];    // Input 2 for addition
     sc_signal<cnm_t>    add_out[SIMD_WIDTH];    // Multiplication output
+    sc_signal<cnm_t>    red_res;                // Result of the reduction tree over the lanes of input 1 for addition
+    sc_signal<cnm_t>    red_pipe[RED_STAGES];   // Pipelined reduction results
+#if WIDE_ACC
+    sc_signal<cnm_acc_t>    wide_prod[SIMD_WIDTH];              // Widened products of the lanes
+    sc_signal<cnm_acc_t>    wide_res[ACC_LANES];                // Wide accumulators plus the products of their lanes
+    sc_signal<cnm_acc_t>    wide_pipe[ADD_STAGES][ACC_LANES];   // Pipelined wide accumulations
+    sc_signal<bool>         wide_sel_pipe[ADD_STAGES];          // Signals a MACW result in the pipeline
+#endif
 
     // Submodules
     sc_vector<fp_multiplier>    multipliers;    // Vector of FP Multipliers
@@ -117,6 +154,9 @@ public:
             multipliers[i].op1(mult_in1[i]);
             multipliers[i].op2(mult_in2[i]);
             multipliers[i].output(mult_out[i]);
+#if WIDE_ACC
+            multipliers[i].wide_out(wide_prod[i]);
+#endif
 
             adders[i].clk(clk);
             adders[i].rst(rst);
@@ -135,12 +175,54 @@ public:
             sensitive << grfa_in1[i] << grfa_in2[i] << grfb_in1[i] << grfb_in2[i] << mult_out[i];
             sensitive << even_in[i] << odd_in[i];
         }
+#if HAZARD_FWD
+        sensitive << fwd_sel;
+        for (i = 0; i < SIMD_WIDTH; i++) {
+            sensitive << output[i];
+        }
+#endif
+
+        SC_THREAD(red_thread);
+        sensitive << clk.pos();
+        async_reset_signal_is(rst, false);
+
+        SC_METHOD(reduce_method);
+        sensitive << red_max;
+        for (i = 0; i < SIMD_WIDTH; i++) {
+            sensitive << add_in1[i];
+        }
+
+#if WIDE_ACC
+        SC_METHOD(wide_method);
+        for (i = 0; i < SIMD_WIDTH; i++) {
+            sensitive << add_in1[i] << wide_prod[i];
+        }
+
+        SC_THREAD(wide_thread);
+        sensitive << clk.pos();
+        async_reset_signal_is(rst, false);
+#endif
 
         SC_METHOD(update_output);
-        sensitive << out_sel;
+        sensitive << out_sel << red_sel << red_pipe[RED_STAGES - 1];
         for (i = 0; i < SIMD_WIDTH; i++) {
             sensitive << mult_out[i] << add_out[i];
         }
+#if WIDE_ACC
+        sensitive << wide_sel_pipe[ADD_STAGES - 1];
+        for (i = 0; i < ACC_LANES; i++) {
+            sensitive << wide_pipe[ADD_STAGES - 1][i];
+        }
+#endif
+
+        for (i = 0; i < RED_STAGES; i++)
+#ifdef __SYNTHESIS__
+            red_pipe[i] = cnm_synth(0);
+#elif HALF_FLOAT
+            red_pipe[i] = half_float::half_cast<half>(0.0);
+#else
+            red_pipe[i] = cnm_t(0);
+#endif
     }
 
     // ~fpu() {
@@ -149,7 +231,13 @@ public:
     // }
 
     void multiplex_method(); // Handles multiplexing of the inputs of the adders and multipliers
-    void update_output();       // Handles connection from add_out to output
+    void reduce_method();       // Reduces the lanes of input 1 for addition with a tree of log2(SIMD_WIDTH) levels
+    void red_thread();          // Advances the pipeline of the reduction tree
+#if WIDE_ACC
+    void wide_method();         // Adds the widened products of the lanes of every wide accumulator to it
+    void wide_thread();         // Advances the pipeline of the wide accumulations
+#endif
+    void update_output();       // Handles connection from add_out and mult_out to the outputs
 };
 
 #endif
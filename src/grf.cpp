@@ -10,55 +10,98 @@
 
 #include "grf.h"
 
+#if LANE_PERM
+// Lane of the multiplexed entry that lane i of the written entry takes, -1 for a zero
+static int perm_lane(uint8_t sel, uint k, int i) {
+    switch (sel) {
+        case PERM_SHL:      return i >= int(k) ? i - int(k) : -1;
+        case PERM_SHR:      return i + int(k) < SIMD_WIDTH ? i + int(k) : -1;
+        case PERM_ROT:      return (i + k) % SIMD_WIDTH;
+        case PERM_BCAST:    return k % SIMD_WIDTH;
+        default:            return i;
+    }
+}
+#endif
+
 void grf::comb_method() {
+    PROFILE_METHOD("grf::comb_method");
     int i;
 
 #ifdef __SYNTHESIS__
 
     cnm_synth intN_zero(0);
+    cnm_synth lanes[SIMD_WIDTH];    // Output of the MUX, before the lane permutation
 
     switch (wr_from->read()) {
 		case MUX_EXT:
 			for (i=0; i<SIMD_WIDTH; i++)
-				wr_mux_out[i] = (relu_en->read() && ext_in[i]->read() < intN_zero) ? intN_zero : ext_in[i]->read();
+				lanes[i] = (relu_en->read() && ext_in[i]->read() < intN_zero) ? intN_zero : ext_in[i]->read();
 		break;
 		case MUX_SRF:
 			for (i=0; i<SIMD_WIDTH; i++)
-				wr_mux_out[i] = (relu_en->read() && srf_in[i]->read() < intN_zero) ? intN_zero : srf_in[i]->read();
+				lanes[i] = (relu_en->read() && srf_in[i]->read() < intN_zero) ? intN_zero : srf_in[i]->read();
 		break;
 		case MUX_GRF_A:
 			for (i=0; i<SIMD_WIDTH; i++)
-				wr_mux_out[i] = (relu_en->read() && grfa_in[i]->read() < intN_zero) ? intN_zero : grfa_in[i]->read();
+				lanes[i] = (relu_en->read() && grfa_in[i]->read() < intN_zero) ? intN_zero : grfa_in[i]->read();
 		break;
 		case MUX_GRF_B:
 			for (i=0; i<SIMD_WIDTH; i++)
-				wr_mux_out[i] = (relu_en->read() && grfb_in[i]->read() < intN_zero) ? intN_zero : grfb_in[i]->read();
+				lanes[i] = (relu_en->read() && grfb_in[i]->read() < intN_zero) ? intN_zero : grfb_in[i]->read();
 		break;
 		// TODO for now, we'll say if any of both happen, it will read from bank input and trust controller to do it well
 		case MUX_EVEN_BANK:
 			for (i=0; i<SIMD_WIDTH; i++)
-				wr_mux_out[i] = (relu_en->read() && bank_in[i]->read() < intN_zero) ? intN_zero : bank_in[i]->read();
+				lanes[i] = (relu_en->read() && bank_in[i]->read() < intN_zero) ? intN_zero : bank_in[i]->read();
 		break;
 		case MUX_ODD_BANK:
 			for (i=0; i<SIMD_WIDTH; i++)
-				wr_mux_out[i] = (relu_en->read() && bank_in[i]->read() < intN_zero) ? intN_zero : bank_in[i]->read();
+				lanes[i] = (relu_en->read() && bank_in[i]->read() < intN_zero) ? intN_zero : bank_in[i]->read();
 		break;
 		case MUX_FPU:
 			for (i=0; i<SIMD_WIDTH; i++)
-				wr_mux_out[i] = (relu_en->read() && fpu_in[i]->read() < intN_zero) ? intN_zero : fpu_in[i]->read();
+				lanes[i] = (relu_en->read() && fpu_in[i]->read() < intN_zero) ? intN_zero : fpu_in[i]->read();
+		break;
+#if DUAL_ISSUE
+		case MUX_FPU_MULT:
+			for (i=0; i<SIMD_WIDTH; i++)
+				lanes[i] = fpu_mult_in[i]->read();
+		break;
+#endif
+#if CORE_RING
+		case MUX_RING:
+			for (i=0; i<SIMD_WIDTH; i++)
+				lanes[i] = ring_in[i]->read();
+		break;
+#endif
+		case MUX_IMM:
+			for (i=0; i<SIMD_WIDTH; i++)
+				lanes[i] = cnm_synth(imm_in->read());
 		break;
 		default:
 			for (i=0; i<SIMD_WIDTH; i++)
-				wr_mux_out[i] = intN_zero;
+				lanes[i] = intN_zero;
 		break;
 	}
 
+#if LANE_PERM
+	for (i=0; i<SIMD_WIDTH; i++) {
+		int src = perm_lane(perm_sel->read(), perm_k->read(), i);
+		wr_mux_out[i] = src < 0 ? intN_zero : lanes[src];
+	}
 #else
+	for (i=0; i<SIMD_WIDTH; i++)
+		wr_mux_out[i] = lanes[i];
+#endif
+
+#else
+
+    cnm_t lanes[SIMD_WIDTH];    // Output of the MUX, before the lane permutation
 
     switch (wr_from->read()) {
     case MUX_EXT:
         for (i = 0; i < SIMD_WIDTH; i++)
-            wr_mux_out[i] = (relu_en->read() && ext_in[i]->read() < 0) ?
+            lanes[i] = (relu_en->read() && ext_in[i]->read() < 0) ?
 #if HALF_FLOAT
                             half_float::half_cast<half>(0.0) :
 #else
@@ -68,7 +111,7 @@ void grf::comb_method() {
         break;
     case MUX_SRF:
         for (i = 0; i < SIMD_WIDTH; i++)
-            wr_mux_out[i] = (relu_en->read() && srf_in[i]->read() < 0) ?
+            lanes[i] = (relu_en->read() && srf_in[i]->read() < 0) ?
 #if HALF_FLOAT
                             half_float::half_cast<half>(0.0) :
 #else
@@ -78,7 +121,7 @@ void grf::comb_method() {
         break;
     case MUX_GRF_A:
         for (i = 0; i < SIMD_WIDTH; i++)
-            wr_mux_out[i] = (relu_en->read() && grfa_in[i]->read() < 0) ?
+            lanes[i] = (relu_en->read() && grfa_in[i]->read() < 0) ?
 #if HALF_FLOAT
                             half_float::half_cast<half>(0.0) :
 #else
@@ -88,7 +131,7 @@ void grf::comb_method() {
         break;
     case MUX_GRF_B:
         for (i = 0; i < SIMD_WIDTH; i++)
-            wr_mux_out[i] = (relu_en->read() && grfb_in[i]->read() < 0) ?
+            lanes[i] = (relu_en->read() && grfb_in[i]->read() < 0) ?
 #if HALF_FLOAT
                             half_float::half_cast<half>(0.0) :
 #else
@@ -99,7 +142,7 @@ void grf::comb_method() {
         // TODO for now, we'll say if any of both happen, it will read from bank input and trust controller to do it well
     case MUX_EVEN_BANK:
         for (i = 0; i < SIMD_WIDTH; i++)
-            wr_mux_out[i] = (relu_en->read() && bank_in[i]->read() < 0) ?
+            lanes[i] = (relu_en->read() && bank_in[i]->read() < 0) ?
 #if HALF_FLOAT
                             half_float::half_cast<half>(0.0) :
 #else
@@ -109,7 +152,7 @@ void grf::comb_method() {
         break;
     case MUX_ODD_BANK:
         for (i = 0; i < SIMD_WIDTH; i++)
-            wr_mux_out[i] = (relu_en->read() && bank_in[i]->read() < 0) ?
+            lanes[i] = (relu_en->read() && bank_in[i]->read() < 0) ?
 #if HALF_FLOAT
                             half_float::half_cast<half>(0.0) :
 #else
@@ -119,7 +162,7 @@ void grf::comb_method() {
         break;
     case MUX_FPU:
         for (i = 0; i < SIMD_WIDTH; i++)
-            wr_mux_out[i] = (relu_en->read() && fpu_in[i]->read() < 0) ?
+            lanes[i] = (relu_en->read() && fpu_in[i]->read() < 0) ?
 #if HALF_FLOAT
                             half_float::half_cast<half>(0.0) :
 #else
@@ -127,16 +170,51 @@ void grf::comb_method() {
 #endif
                             fpu_in[i]->read();
         break;
+#if DUAL_ISSUE
+    case MUX_FPU_MULT:
+        for (i = 0; i < SIMD_WIDTH; i++)
+            lanes[i] = fpu_mult_in[i]->read();
+        break;
+#endif
+#if CORE_RING
+    case MUX_RING:
+        for (i = 0; i < SIMD_WIDTH; i++)
+            lanes[i] = ring_in[i]->read();
+        break;
+#endif
+    case MUX_IMM:
+        for (i = 0; i < SIMD_WIDTH; i++)
+#if HALF_FLOAT
+            lanes[i] = half_float::half_cast<half>(imm_in->read());
+#else
+            lanes[i] = cnm_t(imm_in->read());
+#endif
+        break;
     default:
         for (i = 0; i < SIMD_WIDTH; i++)
 #if HALF_FLOAT
-            wr_mux_out[i] = half_float::half_cast<half>(0.0);
+            lanes[i] = half_float::half_cast<half>(0.0);
 #else
-            wr_mux_out[i] = cnm_t(0);
+            lanes[i] = cnm_t(0);
 #endif
         break;
     }
 
+#if LANE_PERM
+#if HALF_FLOAT
+    cnm_t zero = half_float::half_cast<half>(0.0);
+#else
+    cnm_t zero = cnm_t(0);
+#endif
+    for (i = 0; i < SIMD_WIDTH; i++) {
+        int src = perm_lane(perm_sel->read(), perm_k->read(), i);
+        wr_mux_out[i] = src < 0 ? zero : lanes[src];
+    }
+#else
+    for (i = 0; i < SIMD_WIDTH; i++)
+        wr_mux_out[i] = lanes[i];
+#endif
+
 #endif
 
 }
@@ -33,10 +33,21 @@ public:
     sc_in<uint8_t>			wr_from;				// Index the MUX for input data
     sc_in<cnm_synth>	ext_in[SIMD_WIDTH];		// Data input from external DQ
     sc_in<cnm_synth>  fpu_in[SIMD_WIDTH];		// Data input from FPU
+#if DUAL_ISSUE
+    sc_in<cnm_synth>  fpu_mult_in[SIMD_WIDTH];	// Data input from the FPU multipliers
+#endif
     sc_in<cnm_synth>  srf_in[SIMD_WIDTH];     // Data input from SRF
 	sc_in<cnm_synth>  grfa_in[SIMD_WIDTH];    // Data input from GRF_A
 	sc_in<cnm_synth>  grfb_in[SIMD_WIDTH];    // Data input from GRF_B
 	sc_in<cnm_synth>  bank_in[SIMD_WIDTH];    // Data input from corresponding bank
+	sc_in<int>				imm_in;					// Immediate of a FILL, broadcast to every lane
+#if LANE_PERM
+	sc_in<uint8_t>			perm_sel;				// Lane permutation of the written entry
+	sc_in<uint8_t>			perm_k;					// Lanes shifted or rotated, or lane broadcast
+#endif
+#if CORE_RING
+	sc_in<cnm_synth>  ring_in[SIMD_WIDTH];    // Data input from GRF_B of the previous core
+#endif
 
 	// Internal RFs
 //	sc_vector<grf_word> rf;
@@ -68,10 +79,21 @@ public:
     sc_in<uint8_t>  wr_from;				// Index the MUX for input data
     sc_in<cnm_t>    ext_in[SIMD_WIDTH];		// Data input from external DQ
     sc_in<cnm_t>    fpu_in[SIMD_WIDTH];		// Data input from FPU
+#if DUAL_ISSUE
+    sc_in<cnm_t>    fpu_mult_in[SIMD_WIDTH];    // Data input from the FPU multipliers
+#endif
     sc_in<cnm_t>    srf_in[SIMD_WIDTH];     // Data input from SRF
     sc_in<cnm_t>    grfa_in[SIMD_WIDTH];    // Data input from GRF_A
     sc_in<cnm_t>    grfb_in[SIMD_WIDTH];    // Data input from GRF_B
     sc_in<cnm_t>    bank_in[SIMD_WIDTH];    // Data input from corresponding bank
+    sc_in<int>      imm_in;                 // Immediate of a FILL, broadcast to every lane
+#if LANE_PERM
+    sc_in<uint8_t>  perm_sel;               // Lane permutation of the written entry
+    sc_in<uint8_t>  perm_k;                 // Lanes shifted or rotated, or lane broadcast
+#endif
+#if CORE_RING
+    sc_in<cnm_t>    ring_in[SIMD_WIDTH];    // Data input from GRF_B of the previous core
+#endif
 
     // Internal RFs
 //	sc_vector<grf_word> rf;
@@ -105,14 +127,27 @@ public:
         }
 
         SC_METHOD(comb_method);
-        sensitive << wr_from << relu_en;
+        sensitive << wr_from << relu_en << imm_in;
         for (i = 0; i < SIMD_WIDTH; i++) {
             sensitive << ext_in[i] << fpu_in[i] << srf_in[i] << grfa_in[i] << grfb_in[i] << bank_in[i];
         }
+#if DUAL_ISSUE
+        for (i = 0; i < SIMD_WIDTH; i++) {
+            sensitive << fpu_mult_in[i];
+        }
+#endif
+#if LANE_PERM
+        sensitive << perm_sel << perm_k;
+#endif
+#if CORE_RING
+        for (i = 0; i < SIMD_WIDTH; i++) {
+            sensitive << ring_in[i];
+        }
+#endif
 
     }
 
-    void comb_method();	// Performs the necessary multiplexing and ReLU
+    void comb_method();	// Performs the necessary multiplexing, ReLU and lane permutation
 };
 
 #endif
@@ -148,9 +148,16 @@ void imc_core::comb_method() {
 		}
 	}
 
+#if CORE_RING
+	// GRF_B read port 1 to the next core in the ring
+	for (int i=0; i<SIMD_WIDTH; i++)
+		ring_out[i] = grfb_out1[i];
+#endif
+
 #else
 
 void imc_core::comb_method() {
+    PROFILE_METHOD("imc_core::comb_method");
 
 
 
@@ -165,7 +172,7 @@ void imc_core::comb_method() {
     sc_int<WORD_BITS> grfa_tmp[SIMD_WIDTH], grfb_tmp[SIMD_WIDTH];  
     sc_lv<GRF_WIDTH> grfa2even_tmp, grfb2odd_tmp;
 
-#if (!(HALF_FLOAT) && !(INT_TYPE))
+#if (!(HALF_FLOAT) && !(SOFT_FLOAT) && !(INT_TYPE))
     // Union variables for conversion between FP and binary
     cnm_union union_aux, union_ext2grf[SIMD_WIDTH];
     cnm_union union_even2grfa[SIMD_WIDTH], union_odd2grfb[SIMD_WIDTH];
@@ -180,6 +187,8 @@ void imc_core::comb_method() {
 #if HALF_FLOAT
     ext2srf = half_float::half(half_float::detail::binary,
             ext2srf_tmp.to_uint());
+#elif SOFT_FLOAT
+    ext2srf = cnm_t::from_bits(ext2srf_tmp.to_uint());
 #else
         #if INT_TYPE
                 ext2srf = (cnm_t) ext2srf_tmp.to_uint64();
@@ -194,6 +203,8 @@ void imc_core::comb_method() {
 #if HALF_FLOAT
         ext2grf[i] = half_float::half(half_float::detail::binary,
                 ext2grf_tmp[i].to_uint());
+#elif SOFT_FLOAT
+        ext2grf[i] = cnm_t::from_bits(ext2grf_tmp[i].to_uint());
 #else
         #if INT_TYPE
                 ext2grf[i] = ext2grf_tmp[i].to_uint64();
@@ -214,6 +225,9 @@ void imc_core::comb_method() {
                 even2grfa_tmp[i].to_uint());
         odd2grfb[i] = half_float::half(half_float::detail::binary,
                 odd2grfb_tmp[i].to_uint());
+#elif SOFT_FLOAT
+        even2grfa[i] = cnm_t::from_bits(even2grfa_tmp[i].to_uint());
+        odd2grfb[i] = cnm_t::from_bits(odd2grfb_tmp[i].to_uint());
 #else
         #if INT_TYPE
                 even2grfa[i] = even2grfa_tmp[i].to_uint64();
@@ -229,7 +243,7 @@ void imc_core::comb_method() {
 
     // Adapt GRFs to bank buses
     for (int i = 0; i < SIMD_WIDTH; i++) {
-#if HALF_FLOAT
+#if HALF_FLOAT || SOFT_FLOAT
         cnm_aux = grfa_out1[i];
         grfa_tmp[i] = cnm_aux.bin_word();
 #else
@@ -242,7 +256,7 @@ void imc_core::comb_method() {
 #endif
         grfa2even_tmp.range(WORD_BITS * (i + 1) - 1, WORD_BITS * i) =
                 grfa_tmp[i];
-#if HALF_FLOAT
+#if HALF_FLOAT || SOFT_FLOAT
         cnm_aux = grfb_out1[i];
         grfb_tmp[i] = cnm_aux.bin_word();
 #else
@@ -259,6 +273,12 @@ void imc_core::comb_method() {
     grfa2even = grfa2even_tmp;
     grfb2odd = grfb2odd_tmp;
 
+#if CORE_RING
+    // GRF_B read port 1 to the next core in the ring
+    for (int i = 0; i < SIMD_WIDTH; i++)
+        ring_out[i] = grfb_out1[i];
+#endif
+
 #endif
 
 }
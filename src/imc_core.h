@@ -32,6 +32,10 @@ public:
 	sc_in<bool>						AB_mode;	// Signals if the All-Banks mode is enabled
 	sc_in<bool>						pim_mode;	// Signals if the PIM mode is enabled
 	sc_in<sc_uint<BANK_BITS> >		bank_addr;	// Address of the bank
+#if UNICAST_RF
+	sc_in<sc_uint<BG_BITS> >		bg_addr;	// Address of the bank group
+	sc_in<sc_uint<CORE_ID_BITS> >	core_id;	// Index of the core in the pseudo-channel
+#endif
 	sc_in<sc_uint<ROW_BITS> >		row_addr;	// Address of the bank row
 	sc_in<sc_uint<COL_BITS> >		col_addr;	// Address of the bank column
 	sc_in<sc_uint<DQ_BITS> >		DQ;			// Data input from DRAM controller (output makes no sense)
@@ -39,6 +43,10 @@ public:
 	sc_in<sc_biguint<GRF_WIDTH> >	odd_in;		// Direct data in/out to the odd bank
 	sc_out<sc_biguint<GRF_WIDTH> >	even_out;	// Direct data in/out to the even bank
 	sc_out<sc_biguint<GRF_WIDTH> >	odd_out;	// Direct data in/out to the odd bank
+#if CORE_RING
+	sc_in<cnm_synth>				ring_in[SIMD_WIDTH];	// GRF_B read port 1 of the previous core in the ring
+	sc_out<cnm_synth>				ring_out[SIMD_WIDTH];	// GRF_B read port 1, to the next core in the ring
+#endif
 
 	// ** INTERNAL SIGNALS AND VARIABLES **
 	// Basic control
@@ -48,10 +56,14 @@ public:
 	// CRF
 	sc_signal<bool>		crf_wr_en;
 	sc_signal<uint>		crf_wr_addr;
+	sc_signal<bool>		crf_wr_sh, crf_swap;
 	// SRF
 	sc_signal<uint>				srf_rd_addr, srf_wr_addr;
 	sc_signal<bool>				srf_rd_a_nm, srf_wr_a_nm, srf_wr_en;
 	sc_signal<uint8_t>			srf_wr_from;
+	sc_signal<bool>				srf_wr_pack;
+	sc_signal<uint8_t>			srf_wr_lane;
+	sc_signal<int>				fill_imm;
 	sc_signal<cnm_synth>	srf_out;
 	// GRF_A
 	sc_signal<uint>				grfa_rd_addr1, grfa_rd_addr2, grfa_wr_addr;
@@ -63,10 +75,21 @@ public:
 	sc_signal<bool>				grfb_wr_en, grfb_relu_en;
 	sc_signal<uint8_t>			grfb_wr_from;
 	sc_signal<cnm_synth>	grfb_out1[SIMD_WIDTH], grfb_out2[SIMD_WIDTH];
+#if LANE_PERM
+	// Lane permutation
+	sc_signal<uint8_t>			grfa_perm_sel, grfb_perm_sel, perm_k;
+#endif
 	// FPU
 	sc_signal<bool>				fpu_mult_en, fpu_add_en, fpu_out_sel;
+	sc_signal<bool>				fpu_red_en, fpu_red_max, fpu_red_sel;
+#if HAZARD_FWD
+	sc_signal<uint8_t>			fpu_fwd_sel;
+#endif
 	sc_signal<uint8_t>			fpu_mult_in1_sel, fpu_mult_in2_sel, fpu_add_in1_sel, fpu_add_in2_sel;
 	sc_signal<cnm_synth>	fpu_out[SIMD_WIDTH];
+#if DUAL_ISSUE
+	sc_signal<cnm_synth>	fpu_mult_out[SIMD_WIDTH];
+#endif
 	// BANKS
 	sc_signal<bool>	even_out_en, odd_out_en;
 
@@ -124,6 +147,10 @@ public:
 		cu->AB_mode(AB_mode);
 		cu->pim_mode(pim_mode);
 		cu->bank_addr(bank_addr);
+#if UNICAST_RF
+		cu->bg_addr(bg_addr);
+		cu->core_id(core_id);
+#endif
 		cu->row_addr(row_addr);
 		cu->col_addr(col_addr);
 		cu->DQ(DQ);
@@ -133,6 +160,8 @@ public:
 		// CRF Control
 		cu->crf_wr_en(crf_wr_en);
 		cu->crf_wr_addr(crf_wr_addr);
+		cu->crf_wr_sh(crf_wr_sh);
+		cu->crf_swap(crf_swap);
 		// SRF Control
 		cu->srf_rd_addr(srf_rd_addr);
 		cu->srf_rd_a_nm(srf_rd_a_nm);
@@ -140,6 +169,9 @@ public:
 		cu->srf_wr_addr(srf_wr_addr);
 		cu->srf_wr_a_nm(srf_wr_a_nm);
 		cu->srf_wr_from(srf_wr_from);
+		cu->srf_wr_pack(srf_wr_pack);
+		cu->srf_wr_lane(srf_wr_lane);
+		cu->fill_imm(fill_imm);
 		// GRF_A Control
 		cu->grfa_rd_addr1(grfa_rd_addr1);
 		cu->grfa_rd_addr2(grfa_rd_addr2);
@@ -154,6 +186,12 @@ public:
 		cu->grfb_relu_en(grfb_relu_en);
 		cu->grfb_wr_addr(grfb_wr_addr);
 		cu->grfb_wr_from(grfb_wr_from);
+#if LANE_PERM
+		// Lane permutation Control
+		cu->grfa_perm_sel(grfa_perm_sel);
+		cu->grfb_perm_sel(grfb_perm_sel);
+		cu->perm_k(perm_k);
+#endif
 		// FPU Control
 		cu->fpu_mult_en(fpu_mult_en);
 		cu->fpu_add_en(fpu_add_en);
@@ -162,6 +200,12 @@ public:
 		cu->fpu_add_in1_sel(fpu_add_in1_sel);
 		cu->fpu_add_in2_sel(fpu_add_in2_sel);
 		cu->fpu_out_sel(fpu_out_sel);
+		cu->fpu_red_en(fpu_red_en);
+		cu->fpu_red_max(fpu_red_max);
+		cu->fpu_red_sel(fpu_red_sel);
+#if HAZARD_FWD
+		cu->fpu_fwd_sel(fpu_fwd_sel);
+#endif
 		// BANKS Control
 		cu->even_out_en(even_out_en);
 		cu->odd_out_en(odd_out_en);
@@ -177,6 +221,12 @@ public:
 		fpunit->add_in1_sel(fpu_add_in1_sel);
 		fpunit->add_in2_sel(fpu_add_in2_sel);
 		fpunit->out_sel(fpu_out_sel);
+		fpunit->red_en(fpu_red_en);
+		fpunit->red_max(fpu_red_max);
+		fpunit->red_sel(fpu_red_sel);
+#if HAZARD_FWD
+		fpunit->fwd_sel(fpu_fwd_sel);
+#endif
 		for (i=0; i<SIMD_WIDTH; i++) {
 			fpunit->grfa_in1[i](grfa_out1[i]);
 			fpunit->grfa_in2[i](grfa_out2[i]);
@@ -185,6 +235,9 @@ public:
 			fpunit->even_in[i](even2grfa[i]);
 			fpunit->odd_in[i](odd2grfb[i]);
 			fpunit->output[i](fpu_out[i]);
+#if DUAL_ISSUE
+			fpunit->mult_output[i](fpu_mult_out[i]);
+#endif
 		}
 
 		controlrf = new crf("CRF");
@@ -194,6 +247,8 @@ public:
 		controlrf->instr(instr);
 		controlrf->wr_en(crf_wr_en);
 		controlrf->wr_addr(crf_wr_addr);
+		controlrf->wr_sh(crf_wr_sh);
+		controlrf->swap(crf_swap);
 		controlrf->wr_port(ext2crf);
 
 		grfa = new grf("GRF_A");
@@ -205,15 +260,26 @@ public:
 		grfa->relu_en(grfa_relu_en);
 		grfa->wr_addr(grfa_wr_addr);
 		grfa->wr_from(grfa_wr_from);
+		grfa->imm_in(fill_imm);
+#if LANE_PERM
+		grfa->perm_sel(grfa_perm_sel);
+		grfa->perm_k(perm_k);
+#endif
 		for (i=0; i<SIMD_WIDTH; i++) {
 			grfa->rd_port1[i](grfa_out1[i]);
 			grfa->rd_port2[i](grfa_out2[i]);
 			grfa->ext_in[i](ext2grf[i]);
 			grfa->fpu_in[i](fpu_out[i]);
+#if DUAL_ISSUE
+			grfa->fpu_mult_in[i](fpu_mult_out[i]);
+#endif
 			grfa->srf_in[i](srf_out);
 			grfa->grfa_in[i](grfa_out1[i]);
 			grfa->grfb_in[i](grfb_out1[i]);
 			grfa->bank_in[i](even2grfa[i]);
+#if CORE_RING
+			grfa->ring_in[i](ring_in[i]);
+#endif
 		}
 
 		grfb = new grf("GRF_B");
@@ -225,15 +291,26 @@ public:
 		grfb->relu_en(grfb_relu_en);
 		grfb->wr_addr(grfb_wr_addr);
 		grfb->wr_from(grfb_wr_from);
+		grfb->imm_in(fill_imm);
+#if LANE_PERM
+		grfb->perm_sel(grfb_perm_sel);
+		grfb->perm_k(perm_k);
+#endif
 		for (i=0; i<SIMD_WIDTH; i++) {
 			grfb->rd_port1[i](grfb_out1[i]);
 			grfb->rd_port2[i](grfb_out2[i]);
 			grfb->ext_in[i](ext2grf[i]);
 			grfb->fpu_in[i](fpu_out[i]);
+#if DUAL_ISSUE
+			grfb->fpu_mult_in[i](fpu_mult_out[i]);
+#endif
 			grfb->srf_in[i](srf_out);
 			grfb->grfa_in[i](grfa_out1[i]);
 			grfb->grfb_in[i](grfb_out1[i]);
 			grfb->bank_in[i](odd2grfb[i]);
+#if CORE_RING
+			grfb->ring_in[i](ring_in[i]);
+#endif
 		}
 
 		scalarrf = new srf("SRF");
@@ -246,10 +323,19 @@ public:
 		scalarrf->wr_addr(srf_wr_addr);
 		scalarrf->wr_a_nm(srf_wr_a_nm);
 		scalarrf->wr_from(srf_wr_from);
+		scalarrf->wr_pack(srf_wr_pack);
+		scalarrf->wr_lane(srf_wr_lane);
 		scalarrf->ext_in(ext2srf);
+		for (i = 0; i < SIMD_WIDTH; i++) {
+			scalarrf->ext_pack_in[i](ext2grf[i]);
+			scalarrf->even_in[i](even2grfa[i]);
+			scalarrf->odd_in[i](odd2grfb[i]);
+		}
 		scalarrf->srf_in(srf_out);
 		scalarrf->grfa_in(grfa_out1[0]);
 		scalarrf->grfb_in(grfb_out1[0]);
+		scalarrf->fpu_in(fpu_out[0]);
+		scalarrf->imm_in(fill_imm);
 
 //		even_buf = new tristate_buffer<GRF_WIDTH>("Even_tristate_buffer");
 //		even_buf->input(grfa2even);
@@ -283,11 +369,19 @@ public:
     sc_in<bool>                 AB_mode;	// Signals if the All-Banks mode is enabled
     sc_in<bool>                 pim_mode;	// Signals if the PIM mode is enabled
     sc_in<sc_uint<BANK_BITS> >  bank_addr;	// Address of the bank
+#if UNICAST_RF
+    sc_in<sc_uint<BG_BITS> >        bg_addr;    // Address of the bank group
+    sc_in<sc_uint<CORE_ID_BITS> >   core_id;    // Index of the core in the pseudo-channel
+#endif
     sc_in<sc_uint<ROW_BITS> >   row_addr;	// Address of the bank row
     sc_in<sc_uint<COL_BITS> >   col_addr;	// Address of the bank column
     sc_in<sc_uint<DQ_BITS> >    DQ;	        // Data input from DRAM controller (output makes no sense)
     sc_inout_rv<GRF_WIDTH>      even_bus;	// Direct data in/out to the even bank
     sc_inout_rv<GRF_WIDTH>      odd_bus;	// Direct data in/out to the odd bank
+#if CORE_RING
+    sc_in<cnm_t>                ring_in[SIMD_WIDTH];    // GRF_B read port 1 of the previous core in the ring
+    sc_out<cnm_t>               ring_out[SIMD_WIDTH];   // GRF_B read port 1, to the next core in the ring
+#endif
 
     // ** INTERNAL SIGNALS AND VARIABLES **
     // Basic control
@@ -297,10 +391,14 @@ public:
     // CRF
     sc_signal<bool> crf_wr_en;
     sc_signal<uint> crf_wr_addr;
+    sc_signal<bool> crf_wr_sh, crf_swap;
     // SRF
     sc_signal<uint>     srf_rd_addr, srf_wr_addr;
     sc_signal<bool>     srf_rd_a_nm, srf_wr_a_nm, srf_wr_en;
     sc_signal<uint8_t>  srf_wr_from;
+    sc_signal<bool>     srf_wr_pack;
+    sc_signal<uint8_t>  srf_wr_lane;
+    sc_signal<int>      fill_imm;
     sc_signal<cnm_t>    srf_out;
     // GRF_A
     sc_signal<uint>     grfa_rd_addr1, grfa_rd_addr2, grfa_wr_addr;
@@ -312,10 +410,21 @@ public:
     sc_signal<bool>     grfb_wr_en, grfb_relu_en;
     sc_signal<uint8_t>  grfb_wr_from;
     sc_signal<cnm_t>    grfb_out1[SIMD_WIDTH], grfb_out2[SIMD_WIDTH];
+#if LANE_PERM
+    // Lane permutation
+    sc_signal<uint8_t>  grfa_perm_sel, grfb_perm_sel, perm_k;
+#endif
     // FPU
     sc_signal<bool>     fpu_mult_en, fpu_add_en, fpu_out_sel;
+    sc_signal<bool>     fpu_red_en, fpu_red_max, fpu_red_sel;
+#if HAZARD_FWD
+    sc_signal<uint8_t>  fpu_fwd_sel;
+#endif
     sc_signal<uint8_t>  fpu_mult_in1_sel, fpu_mult_in2_sel, fpu_add_in1_sel, fpu_add_in2_sel;
     sc_signal<cnm_t>    fpu_out[SIMD_WIDTH];
+#if DUAL_ISSUE
+    sc_signal<cnm_t>    fpu_mult_out[SIMD_WIDTH];
+#endif
     // BANKS
     sc_signal<bool> even_out_en, odd_out_en;
 
@@ -348,6 +457,10 @@ public:
         cu->AB_mode(AB_mode);
         cu->pim_mode(pim_mode);
         cu->bank_addr(bank_addr);
+#if UNICAST_RF
+        cu->bg_addr(bg_addr);
+        cu->core_id(core_id);
+#endif
         cu->row_addr(row_addr);
         cu->col_addr(col_addr);
         cu->DQ(DQ);
@@ -357,6 +470,8 @@ public:
         // CRF Control
         cu->crf_wr_en(crf_wr_en);
         cu->crf_wr_addr(crf_wr_addr);
+        cu->crf_wr_sh(crf_wr_sh);
+        cu->crf_swap(crf_swap);
         // SRF Control
         cu->srf_rd_addr(srf_rd_addr);
         cu->srf_rd_a_nm(srf_rd_a_nm);
@@ -364,6 +479,9 @@ public:
         cu->srf_wr_addr(srf_wr_addr);
         cu->srf_wr_a_nm(srf_wr_a_nm);
         cu->srf_wr_from(srf_wr_from);
+        cu->srf_wr_pack(srf_wr_pack);
+        cu->srf_wr_lane(srf_wr_lane);
+        cu->fill_imm(fill_imm);
         // GRF_A Control
         cu->grfa_rd_addr1(grfa_rd_addr1);
         cu->grfa_rd_addr2(grfa_rd_addr2);
@@ -378,6 +496,12 @@ public:
         cu->grfb_relu_en(grfb_relu_en);
         cu->grfb_wr_addr(grfb_wr_addr);
         cu->grfb_wr_from(grfb_wr_from);
+#if LANE_PERM
+        // Lane permutation Control
+        cu->grfa_perm_sel(grfa_perm_sel);
+        cu->grfb_perm_sel(grfb_perm_sel);
+        cu->perm_k(perm_k);
+#endif
         // FPU Control
         cu->fpu_mult_en(fpu_mult_en);
         cu->fpu_add_en(fpu_add_en);
@@ -386,6 +510,12 @@ public:
         cu->fpu_add_in1_sel(fpu_add_in1_sel);
         cu->fpu_add_in2_sel(fpu_add_in2_sel);
         cu->fpu_out_sel(fpu_out_sel);
+        cu->fpu_red_en(fpu_red_en);
+        cu->fpu_red_max(fpu_red_max);
+        cu->fpu_red_sel(fpu_red_sel);
+#if HAZARD_FWD
+        cu->fpu_fwd_sel(fpu_fwd_sel);
+#endif
         // BANKS Control
         cu->even_out_en(even_out_en);
         cu->odd_out_en(odd_out_en);
@@ -401,6 +531,12 @@ public:
         fpunit->add_in1_sel(fpu_add_in1_sel);
         fpunit->add_in2_sel(fpu_add_in2_sel);
         fpunit->out_sel(fpu_out_sel);
+        fpunit->red_en(fpu_red_en);
+        fpunit->red_max(fpu_red_max);
+        fpunit->red_sel(fpu_red_sel);
+#if HAZARD_FWD
+        fpunit->fwd_sel(fpu_fwd_sel);
+#endif
         for (i = 0; i < SIMD_WIDTH; i++) {
             fpunit->grfa_in1[i](grfa_out1[i]);
             fpunit->grfa_in2[i](grfa_out2[i]);
@@ -409,6 +545,9 @@ public:
             fpunit->even_in[i](even2grfa[i]);
             fpunit->odd_in[i](odd2grfb[i]);
             fpunit->output[i](fpu_out[i]);
+#if DUAL_ISSUE
+            fpunit->mult_output[i](fpu_mult_out[i]);
+#endif
         }
 
         controlrf = new crf("CRF");
@@ -418,6 +557,8 @@ public:
         controlrf->instr(instr);
         controlrf->wr_en(crf_wr_en);
         controlrf->wr_addr(crf_wr_addr);
+        controlrf->wr_sh(crf_wr_sh);
+        controlrf->swap(crf_swap);
         controlrf->wr_port(ext2crf);
 
         grfa = new grf("GRF_A");
@@ -429,15 +570,26 @@ public:
         grfa->relu_en(grfa_relu_en);
         grfa->wr_addr(grfa_wr_addr);
         grfa->wr_from(grfa_wr_from);
+        grfa->imm_in(fill_imm);
+#if LANE_PERM
+        grfa->perm_sel(grfa_perm_sel);
+        grfa->perm_k(perm_k);
+#endif
         for (i = 0; i < SIMD_WIDTH; i++) {
             grfa->rd_port1[i](grfa_out1[i]);
             grfa->rd_port2[i](grfa_out2[i]);
             grfa->ext_in[i](ext2grf[i]);
             grfa->fpu_in[i](fpu_out[i]);
+#if DUAL_ISSUE
+            grfa->fpu_mult_in[i](fpu_mult_out[i]);
+#endif
             grfa->srf_in[i](srf_out);
             grfa->grfa_in[i](grfa_out1[i]);
             grfa->grfb_in[i](grfb_out1[i]);
             grfa->bank_in[i](even2grfa[i]);
+#if CORE_RING
+            grfa->ring_in[i](ring_in[i]);
+#endif
         }
 
         grfb = new grf("GRF_B");
@@ -449,15 +601,26 @@ public:
         grfb->relu_en(grfb_relu_en);
         grfb->wr_addr(grfb_wr_addr);
         grfb->wr_from(grfb_wr_from);
+        grfb->imm_in(fill_imm);
+#if LANE_PERM
+        grfb->perm_sel(grfb_perm_sel);
+        grfb->perm_k(perm_k);
+#endif
         for (i = 0; i < SIMD_WIDTH; i++) {
             grfb->rd_port1[i](grfb_out1[i]);
             grfb->rd_port2[i](grfb_out2[i]);
             grfb->ext_in[i](ext2grf[i]);
             grfb->fpu_in[i](fpu_out[i]);
+#if DUAL_ISSUE
+            grfb->fpu_mult_in[i](fpu_mult_out[i]);
+#endif
             grfb->srf_in[i](srf_out);
             grfb->grfa_in[i](grfa_out1[i]);
             grfb->grfb_in[i](grfb_out1[i]);
             grfb->bank_in[i](odd2grfb[i]);
+#if CORE_RING
+            grfb->ring_in[i](ring_in[i]);
+#endif
         }
 
         scalarrf = new srf("SRF");
@@ -470,10 +633,19 @@ public:
         scalarrf->wr_addr(srf_wr_addr);
         scalarrf->wr_a_nm(srf_wr_a_nm);
         scalarrf->wr_from(srf_wr_from);
+        scalarrf->wr_pack(srf_wr_pack);
+        scalarrf->wr_lane(srf_wr_lane);
         scalarrf->ext_in(ext2srf);
+        for (i = 0; i < SIMD_WIDTH; i++) {
+            scalarrf->ext_pack_in[i](ext2grf[i]);
+            scalarrf->even_in[i](even2grfa[i]);
+            scalarrf->odd_in[i](odd2grfb[i]);
+        }
         scalarrf->srf_in(srf_out);
         scalarrf->grfa_in(grfa_out1[0]);
         scalarrf->grfb_in(grfb_out1[0]);
+        scalarrf->fpu_in(fpu_out[0]);
+        scalarrf->imm_in(fill_imm);
 
         even_buf = new tristate_buffer<GRF_WIDTH>("Even_tristate_buffer");
         even_buf->input(grfa2even);
@@ -7,3 +7,13 @@
  */
 
 #include "imc_pch.h"
+
+#if UNICAST_RF
+void imc_pch::core_id_method() {
+    uint i;
+
+    for (i = 0; i < CORES_PER_PCH; i++) {
+        core_ids[i].write(i);
+    }
+}
+#endif
@@ -25,6 +25,9 @@ public:
     sc_in<bool>                 	AB_mode;			        // Signals if the All-Banks mode is enabled
     sc_in<bool>                 	pim_mode;				    // Signals if the PIM mode is enabled
     sc_in<sc_uint<BANK_BITS> >  	bank_addr;				    // Address of the bank
+#if UNICAST_RF
+    sc_in<sc_uint<BG_BITS> >        bg_addr;                    // Address of the bank group
+#endif
     sc_in<sc_uint<ROW_BITS> >   	row_addr;				    // Address of the bank row
     sc_in<sc_uint<COL_BITS> >   	col_addr;			        // Address of the bank column
     sc_in<sc_uint<DQ_BITS> >        DQ;	                        // Data input from DRAM controller (output makes no sense)
@@ -37,6 +40,12 @@ public:
     // ** INTERNAL SIGNALS AND VARIABLES **
 
     // Auxiliar signals
+#if UNICAST_RF
+    sc_signal<sc_uint<CORE_ID_BITS> >   core_ids[CORES_PER_PCH];    // Constant index of every core
+#endif
+#if CORE_RING
+    sc_signal<cnm_synth>                ring_bus[CORES_PER_PCH][SIMD_WIDTH];    // GRF_B read port 1 of every core
+#endif
 
     // Internal modules
 
@@ -57,6 +66,11 @@ public:
             imc_cores[i]->AB_mode(AB_mode);
             imc_cores[i]->pim_mode(pim_mode);
             imc_cores[i]->bank_addr(bank_addr);
+#if UNICAST_RF
+            // With BG_CORES, consecutive cores share bank group, one per bank pair
+            imc_cores[i]->bg_addr(bg_addr);
+            imc_cores[i]->core_id(core_ids[i]);
+#endif
             imc_cores[i]->row_addr(row_addr);
             imc_cores[i]->col_addr(col_addr);
             imc_cores[i]->DQ(DQ);
@@ -64,8 +78,18 @@ public:
             imc_cores[i]->odd_in(odd_in[i]);
             imc_cores[i]->even_out(even_out[i]);
             imc_cores[i]->odd_out(odd_out[i]);
+#if CORE_RING
+            // Every core reads the previous one of its ring, the cores running in lockstep
+            for (uint j = 0; j < SIMD_WIDTH; j++) {
+                imc_cores[i]->ring_out[j](ring_bus[i][j]);
+                imc_cores[i]->ring_in[j](ring_bus[i - i % RING_CORES + (i + RING_CORES - 1) % RING_CORES][j]);
+            }
+#endif
         }
 
+#if UNICAST_RF
+        SC_METHOD(core_id_method);
+#endif
     }
 
 #else
@@ -79,6 +103,9 @@ public:
     sc_in<bool>                 AB_mode;			        // Signals if the All-Banks mode is enabled
     sc_in<bool>                 pim_mode;				    // Signals if the PIM mode is enabled
     sc_in<sc_uint<BANK_BITS> >  bank_addr;				    // Address of the bank
+#if UNICAST_RF
+    sc_in<sc_uint<BG_BITS> >    bg_addr;                    // Address of the bank group
+#endif
     sc_in<sc_uint<ROW_BITS> >   row_addr;				    // Address of the bank row
     sc_in<sc_uint<COL_BITS> >   col_addr;			        // Address of the bank column
     sc_in<sc_uint<DQ_BITS> >    DQ;	                        // Data input from DRAM controller (output makes no sense)
@@ -88,6 +115,12 @@ public:
     // ** INTERNAL SIGNALS AND VARIABLES **
 
     // Auxiliar signals
+#if UNICAST_RF
+    sc_signal<sc_uint<CORE_ID_BITS> >   core_ids[CORES_PER_PCH];    // Constant index of every core
+#endif
+#if CORE_RING
+    sc_signal<cnm_t>                    ring_bus[CORES_PER_PCH][SIMD_WIDTH];    // GRF_B read port 1 of every core
+#endif
 
     // Internal modules
     imc_core *imc_cores[CORES_PER_PCH];	// Vector of IMC cores
@@ -107,18 +140,34 @@ public:
             imc_cores[i]->AB_mode(AB_mode);
             imc_cores[i]->pim_mode(pim_mode);
             imc_cores[i]->bank_addr(bank_addr);
+#if UNICAST_RF
+            // With BG_CORES, consecutive cores share bank group, one per bank pair
+            imc_cores[i]->bg_addr(bg_addr);
+            imc_cores[i]->core_id(core_ids[i]);
+#endif
             imc_cores[i]->row_addr(row_addr);
             imc_cores[i]->col_addr(col_addr);
             imc_cores[i]->DQ(DQ);
             imc_cores[i]->even_bus(even_buses[i]);
             imc_cores[i]->odd_bus(odd_buses[i]);
+#if CORE_RING
+            // Every core reads the previous one of its ring, the cores running in lockstep
+            for (uint j = 0; j < SIMD_WIDTH; j++) {
+                imc_cores[i]->ring_out[j](ring_bus[i][j]);
+                imc_cores[i]->ring_in[j](ring_bus[i - i % RING_CORES + (i + RING_CORES - 1) % RING_CORES][j]);
+            }
+#endif
         }
 
+#if UNICAST_RF
+        SC_METHOD(core_id_method);
+#endif
     }
 
 #endif
-#if __SYNTHESIS__
 
+#if UNICAST_RF
+    void core_id_method();  // Drives the index of every core, only runs at initialization
 #endif
 
 };
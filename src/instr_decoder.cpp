@@ -18,8 +18,17 @@ void instr_decoder::clk_thread() {
     // Reset all registers and pipelines
     nop_cnt_reg = false;
 
-    jmp_act_reg = false;
-    jmp_cnt_reg = false;
+    jmp_top_reg = 0;
+    for (i = 0; i < LOOP_DEPTH; i++) {
+        jmp_pc_reg[i] = 0;
+        jmp_cnt_reg[i] = 0;
+    }
+
+#if AAM_REGS
+    aam_cfg_reg = AAM_CFG_RST;
+    aam_src_off_reg = 0;
+    aam_dst_off_reg = 0;
+#endif
 
     grfa_rd_addr2_reg = 0;
     grfa_relu_en_reg = 0;
@@ -31,6 +40,8 @@ void instr_decoder::clk_thread() {
     srf_wr_from_reg = 0;
     srf_wr_addr_reg = 0;
     srf_wr_a_nm_reg = false;
+    srf_wr_pack_reg = false;
+    srf_wr_lane_reg = 0;
 
     fpu_mult_in1_sel_reg = 0;
     fpu_mult_in2_sel_reg = 0;
@@ -39,6 +50,12 @@ void instr_decoder::clk_thread() {
         mul_en_pipe[i] = false;
     }
 
+#if HAZARD_FWD
+    for (i = 0; i < (1 + MULT_STAGES); i++) {
+        fwd_sel_pipe[i] = 0;
+    }
+#endif
+
     for (i = 0; i < (1 + MULT_STAGES); i++) {
         grfa_rd_addr1_pipe[i] = 0;
         grfb_rd_addr1_pipe[i] = 0;
@@ -65,17 +82,52 @@ void instr_decoder::clk_thread() {
         grfb_wr_from_pipe[i] = 0;
     }
 
+    for (i = 0; i < RED_STAGES; i++) {
+        red_wr_en_pipe[i] = false;
+        red_wr_dst_pipe[i] = 0;
+        red_wr_addr_pipe[i] = 0;
+    }
+
+#ifndef __SYNTHESIS__
+    perf.reset();
+#endif
+
     wait();
 
     // Update registers and advance pipelines
     while (1) {
+        PROFILE_BEGIN("instr_decoder::clk_thread");
+
+#ifndef __SYNTHESIS__
+        perf_count();
+        if (tl.enabled())
+            tl_record();
+#if HAZARD_FWD
+        // The host sends a command per slot, a stalled one would leave the rest of the stream out of step
+        if (hazard_stall.read()) {
+            std::ostringstream msg;
+            msg << "RAW hazard not covered by NOPs at CRF" << int(pc_in->read()) << ", the instruction would stall";
+            SC_REPORT_ERROR(name(), msg.str().c_str());
+        }
+#endif
+#endif
 
         // NOP
         nop_cnt_reg = nop_cnt_nxt;
 
         // JUMP
-        jmp_act_reg = jmp_act_nxt;
-        jmp_cnt_reg = jmp_cnt_nxt;
+        jmp_top_reg = jmp_top_nxt;
+        for (i = 0; i < LOOP_DEPTH; i++) {
+            jmp_pc_reg[i] = jmp_pc_nxt[i];
+            jmp_cnt_reg[i] = jmp_cnt_nxt[i];
+        }
+
+#if AAM_REGS
+        // AAM
+        aam_cfg_reg = aam_cfg_nxt;
+        aam_src_off_reg = aam_src_off_nxt;
+        aam_dst_off_reg = aam_dst_off_nxt;
+#endif
 
         // GRF_A
         grfa_rd_addr1_pipe[0] = grfa_rd_addr1_toAddAftLoad;
@@ -210,6 +262,8 @@ void instr_decoder::clk_thread() {
         srf_wr_from_reg = srf_wr_from_nxt;
         srf_wr_addr_reg = srf_wr_addr_nxt;
         srf_wr_a_nm_reg = srf_wr_a_nm_nxt;
+        srf_wr_pack_reg = srf_wr_pack_nxt;
+        srf_wr_lane_reg = srf_wr_lane_nxt;
 
         // FPU
         fpu_add_in1_sel_pipe[0] = fpu_add_in1_sel_toAddAftLoad;
@@ -274,11 +328,31 @@ void instr_decoder::clk_thread() {
 		}
 #endif
 
+        // Lane reductions
+        red_wr_en_pipe[0] = red_wr_en_comb;
+        red_wr_dst_pipe[0] = red_wr_dst_comb;
+        red_wr_addr_pipe[0] = red_wr_addr_comb;
+        for (i = 1; i < RED_STAGES; i++) {
+            red_wr_en_pipe[i] = red_wr_en_pipe[i - 1];
+            red_wr_dst_pipe[i] = red_wr_dst_pipe[i - 1];
+            red_wr_addr_pipe[i] = red_wr_addr_pipe[i - 1];
+        }
+
+#if HAZARD_FWD
+        // Forwarded operands, one cycle closer to their read
+        for (i = 0; i < MULT_STAGES; i++) {
+            fwd_sel_pipe[i] = fwd_sel_pipe[i + 1] | fwd_sel_nxt[i];
+        }
+        fwd_sel_pipe[MULT_STAGES] = fwd_sel_nxt[MULT_STAGES];
+#endif
+
+        PROFILE_END();
         wait();
     }
 }
 
 void instr_decoder::comb_method() {
+    PROFILE_METHOD("instr_decoder::comb_method");
 
     // Break the instruction word into the different fields
     sc_uint<32> instruction = instr->read();
@@ -297,12 +371,40 @@ void instr_decoder::comb_method() {
     SRC2_END);
     bool RELU = instruction.range(RELU_BIT, RELU_BIT);
     bool AAM = instruction.range(AAM_BIT, AAM_BIT);
+    bool MOV_AAM = AAM_REGS && OPCODE == OP_MOV && instruction.range(MOV_AAM_BIT, MOV_AAM_BIT);
+    bool MAX = instruction.range(MAX_BIT, MAX_BIT);
+    bool IMM = instruction.range(IMM_BIT, IMM_BIT);
     sc_uint<DST_N_STA - DST_N_END + 1> DST_N = instruction.range(DST_N_STA,
     DST_N_END);
     sc_uint<SRC0_N_STA - SRC0_N_END + 1> SRC0_N = instruction.range(SRC0_N_STA,
     SRC0_N_END);
     sc_uint<SRC1_N_STA - SRC1_N_END + 1> SRC1_N = instruction.range(SRC1_N_STA,
     SRC1_N_END);
+    sc_int<FILL_IMM_STA - FILL_IMM_END + 1> FILL_IMM = instruction.range(FILL_IMM_STA,
+    FILL_IMM_END);
+#if LANE_PERM
+    sc_uint<PERM_SEL_STA - PERM_SEL_END + 1> PERM = instruction.range(PERM_SEL_STA,
+    PERM_SEL_END);
+    sc_uint<PERM_K_STA - PERM_K_END + 1> PERM_K = instruction.range(PERM_K_STA,
+    PERM_K_END);
+#endif
+#if DUAL_ISSUE
+    // Operands of a MULADD: the inputs 1 and 2 of the multipliers, then those of the adders
+    uint8_t di_rf[4] = {uint8_t(instruction.range(DI_MSRC0_STA, DI_MSRC0_END)), uint8_t(instruction.range(DI_MSRC1_STA, DI_MSRC1_END)),
+            uint8_t(instruction.range(DI_ASRC0_STA, DI_ASRC0_END)), uint8_t(instruction.range(DI_ASRC1_STA, DI_ASRC1_END))};
+    uint di_idx[4] = {uint(instruction.range(DI_MSRC0_N_STA, DI_MSRC0_N_END)), uint(instruction.range(DI_MSRC1_N_STA, DI_MSRC1_N_END)),
+            uint(instruction.range(DI_ASRC0_N_STA, DI_ASRC0_N_END)), uint(instruction.range(DI_ASRC1_N_STA, DI_ASRC1_N_END))};
+    bool M_DST = instruction.range(DI_MDST_BIT, DI_MDST_BIT);
+    uint M_DST_N = instruction.range(DI_MDST_N_STA, DI_MDST_N_END);
+    uint A_DST_N = instruction.range(DI_ADST_N_STA, DI_ADST_N_END);
+    uint8_t di_port[4];     // GRF read port of every operand, 0 for port 1 and 1 for port 2
+    bool port_busy[2][2] = {{false, false}, {false, false}};    // Ports of GRF_A and GRF_B in use, and their index
+    uint port_idx[2][2] = {{0, 0}, {0, 0}};
+    uint8_t g;
+#endif
+    int i;
+    uint8_t top;    // Number of active loops
+    bool stall = false; // Operand still in flight, the instruction waits for it
 
     // ** DEFAULT VALUES FOR SIGNALS **
 
@@ -313,11 +415,21 @@ void instr_decoder::comb_method() {
         nop_cnt_nxt = nop_cnt_reg - 1;
 
     // Jump signals
-    jmp_act_nxt = jmp_act_reg;
-    jmp_cnt_nxt = jmp_cnt_reg;
+    jmp_top_nxt = jmp_top_reg;
+    for (i = 0; i < LOOP_DEPTH; i++) {
+        jmp_pc_nxt[i] = jmp_pc_reg[i];
+        jmp_cnt_nxt[i] = jmp_cnt_reg[i];
+    }
     jump_en->write(false);
     jump_num->write(0);
 
+#if AAM_REGS
+    // AAM registers
+    aam_cfg_nxt = aam_cfg_reg;
+    aam_src_off_nxt = aam_src_off_reg;
+    aam_dst_off_nxt = aam_dst_off_reg;
+#endif
+
     // GRF_A signals and pipelines
     grfa_rd_addr1_comb = 0;
     grfa_rd_addr1_toAddAftLoad = 0;
@@ -404,6 +516,17 @@ void instr_decoder::comb_method() {
     srf_wr_addr_nxt = 0;
     srf_wr_a_nm_comb = false;
     srf_wr_a_nm_nxt = false;
+    srf_wr_pack_comb = false;
+    srf_wr_pack_nxt = false;
+    srf_wr_lane_nxt = 0;
+    fill_imm->write(0);
+
+#if LANE_PERM
+    // Lane permutation signals
+    grfa_perm_sel->write(PERM_NONE);
+    grfb_perm_sel->write(PERM_NONE);
+    perm_k->write(0);
+#endif
 
     // FPU signals and pipeline
     fpu_add_in1_sel_comb = 0;
@@ -427,6 +550,12 @@ void instr_decoder::comb_method() {
     fpu_out_sel_fromMulAftLoad = false;
     fpu_out_sel_fromMul = false;
 
+    // Lane reduction signals
+    red_max_comb = false;
+    red_wr_en_comb = false;
+    red_wr_dst_comb = 0;
+    red_wr_addr_comb = 0;
+
     // Ports
     pc_rst->write(false);
     count_en->write(false);
@@ -434,6 +563,8 @@ void instr_decoder::comb_method() {
     jump_num->write(0);
     crf_wr_en->write(false);
     crf_wr_addr->write(0);
+    crf_wr_sh->write(false);
+    crf_swap->write(false);
     even_out_en->write(false);
     odd_out_en->write(false);
 
@@ -452,11 +583,20 @@ void instr_decoder::comb_method() {
     crf_addr.range(RF_ADDR_BITS-1, 0) = rf_addr;
     crf_addr.range(BANK_BITS+RF_ADDR_BITS-1, RF_ADDR_BITS) = bank_addr;
 #endif
+#if AAM_REGS
+    // AAM indices, the offsets from the bases are advanced by the instructions that take them
+    sc_uint<32> aam_cfg = aam_cfg_reg.read();
+    sc_uint<AAM_ADDR_BITS> aam_src_addr = aam_cfg.range(AAM_SRC_BASE_STA, AAM_SRC_BASE_END) + aam_src_off_reg.read();
+    sc_uint<AAM_ADDR_BITS> aam_dst_addr = aam_cfg.range(AAM_DST_BASE_STA, AAM_DST_BASE_END) + aam_dst_off_reg.read();
+    bool aam_src_adv = false, aam_dst_adv = false;
+    uint8_t aam_off;
+#else
     // TODO check this assumption (aam signals grfa and grfb idx vs signals src0-1 and src2-dst idx)
 //	sc_uint<AAM_ADDR_BITS> aam_grfa_addr = rowcol_addr.range(AAM_ADDR_BITS-1,0);
 //	sc_uint<AAM_ADDR_BITS> aam_grfb_addr = rowcol_addr.range(2*AAM_ADDR_BITS-1,AAM_ADDR_BITS);
     sc_uint<AAM_ADDR_BITS> aam_src_addr = rowcol_addr.range(AAM_ADDR_BITS - 1, 0);
     sc_uint<AAM_ADDR_BITS> aam_dst_addr = rowcol_addr.range(2 * AAM_ADDR_BITS - 1, AAM_ADDR_BITS);
+#endif
 
     // Write to RFs when not in PIM mode (I don't see the need for read)
     // Signal width adaptation in the interface unit
@@ -472,6 +612,25 @@ void instr_decoder::comb_method() {
 #endif
 //				}
             break;
+            case RF_CRF_SH:
+                crf_wr_en->write(true);
+                crf_wr_sh->write(true);
+#if CRF_BANK_ADDR
+                crf_wr_addr->write(crf_addr.to_uint());
+#else
+                crf_wr_addr->write(rf_addr.to_uint());
+#endif
+            break;
+            case RF_CRF_SWAP:
+                crf_swap->write(true);
+            break;
+#if AAM_REGS
+            case RF_AAM:    // New configuration, the indices start again from the bases
+                aam_cfg_nxt = rf_data->read().range(31, 0).to_uint();
+                aam_src_off_nxt = 0;
+                aam_dst_off_nxt = 0;
+            break;
+#endif
             case RF_SRF_M:
     //				if (!rf_wr_nrd) {
     //					srf_rd_addr_comb = rf_addr.to_uint();
@@ -494,6 +653,20 @@ void instr_decoder::comb_method() {
                 srf_wr_from_comb = MUX_EXT;
     //				}
             break;
+            case RF_SRF_M_PK:
+                srf_wr_en_comb = true;
+                srf_wr_addr_comb = rf_addr.to_uint();
+                srf_wr_a_nm_comb = false;
+                srf_wr_from_comb = MUX_EXT;
+                srf_wr_pack_comb = true;
+            break;
+            case RF_SRF_A_PK:
+                srf_wr_en_comb = true;
+                srf_wr_addr_comb = rf_addr.to_uint();
+                srf_wr_a_nm_comb = true;
+                srf_wr_from_comb = MUX_EXT;
+                srf_wr_pack_comb = true;
+            break;
             case RF_GRF_A:
     //				if (!rf_wr_nrd) {
     //					grfa_rd_addr1_comb = rf_addr.to_uint();
@@ -515,8 +688,111 @@ void instr_decoder::comb_method() {
         }
     }
 
-    // Decode new instruction when signaled, if there is no current NOP
+#if HAZARD_FWD
+    // ** SCOREBOARD **
+    // RF operands still to be written by an instruction in flight. Those written back from the FPU in the cycle
+    // they reach an FPU input are forwarded from its output, any other one stalls the decoder until it is written.
+    // The host does not hold its commands back, so a stall is reported as an error: NOPs must cover those hazards
+    uint8_t opd_rf[4];      // Storage, index, read cycle and forwarded FPU input of each operand
+    uint opd_idx[4];
+    uint opd_cycle[4];
+    uint8_t opd_fwd[4];
+    int opd_num = 0;
+    uint8_t fwd[2 + MULT_STAGES];   // FPU inputs forwarded in this and the next cycles
+    uint8_t hz;
+    uint ld = (SRC0 == OPC_EVEN_BANK || SRC0 == OPC_ODD_BANK
+            || SRC1 == OPC_EVEN_BANK || SRC1 == OPC_ODD_BANK) ? 1 : 0; // A bank operand delays the reads a cycle
+    uint src0_idx = AAM ? aam_src_addr.to_uint() : SRC0_N.to_uint();
+    uint src1_idx = AAM ? aam_src_addr.to_uint() : SRC1_N.to_uint();
+
+    for (i = 0; i < 2 + MULT_STAGES; i++) {
+        fwd[i] = 0;
+    }
+
     if (decode_en->read() && !nop_cnt_reg) {
+        switch (OPCODE) {
+            case OP_MOV:
+            case OP_FILL:
+            case OP_PERM:
+                if (SRC0 != OPC_EVEN_BANK && SRC0 != OPC_ODD_BANK && !(OPCODE == OP_FILL && IMM)) {
+                    opd_rf[opd_num] = SRC0 == OPC_RING ? OPC_GRF_B : SRC0;     // The ring reads GRF_B in every core
+                    opd_idx[opd_num] = (MOV_AAM && SRC0 <= OPC_GRF_B) ? aam_src_addr.to_uint() : SRC0_N.to_uint();
+                    opd_cycle[opd_num] = 0;
+                    opd_fwd[opd_num++] = 0;
+                }
+            break;
+            case OP_RED:
+                opd_rf[opd_num] = SRC0;
+                opd_idx[opd_num] = SRC0_N.to_uint();
+                opd_cycle[opd_num] = 0;
+                opd_fwd[opd_num++] = FWD_A1;
+            break;
+            case OP_ADD:
+                opd_rf[opd_num] = SRC0;
+                opd_idx[opd_num] = src0_idx;
+                opd_cycle[opd_num] = ld;
+                opd_fwd[opd_num++] = FWD_A1;
+                opd_rf[opd_num] = SRC1;
+                opd_idx[opd_num] = src1_idx;
+                opd_cycle[opd_num] = ld;
+                opd_fwd[opd_num++] = FWD_A2;
+            break;
+            case OP_MUL:
+            case OP_MAD:
+            case OP_MAC:
+            case OP_MACW:
+                opd_rf[opd_num] = SRC0;
+                opd_idx[opd_num] = src0_idx;
+                opd_cycle[opd_num] = ld;
+                opd_fwd[opd_num++] = FWD_M1;
+                opd_rf[opd_num] = SRC1;
+                opd_idx[opd_num] = src1_idx;
+                opd_cycle[opd_num] = ld;
+                opd_fwd[opd_num++] = FWD_M2;
+                if (OPCODE != OP_MUL) {     // Accumulated operand, read by the adder after the multiplication
+                    opd_rf[opd_num] = OPCODE == OP_MAD ? SRC2 : DST;
+                    opd_idx[opd_num] = AAM ? aam_dst_addr.to_uint() : OPCODE == OP_MAD ? SRC1_N.to_uint() : DST_N.to_uint();
+                    opd_cycle[opd_num] = MULT_STAGES + ld;
+                    opd_fwd[opd_num++] = FWD_A1;
+                }
+            break;
+#if DUAL_ISSUE
+            case OP_MULADD:
+                for (i = 0; i < 4; i++) {
+                    opd_rf[opd_num] = di_rf[i];
+                    opd_idx[opd_num] = di_idx[i];
+                    opd_cycle[opd_num] = 0;
+                    opd_fwd[opd_num++] = FWD_M1 << i;
+                }
+            break;
+#endif
+            default:
+            break;
+        }
+
+        for (i = 0; i < opd_num; i++) {
+            hz = raw_hazard(opd_rf[i], opd_idx[i], opd_cycle[i], opd_fwd[i] != 0);
+            if (hz & HZ_STALL)
+                stall = true;
+            else if (hz & HZ_FWD)
+                fwd[opd_cycle[i]] |= opd_fwd[i];
+        }
+        if (stall) {
+            for (i = 0; i < 2 + MULT_STAGES; i++) {
+                fwd[i] = 0;
+            }
+        }
+    }
+
+    hazard_stall = stall;
+    fwd_sel_comb = fwd[0];
+    for (i = 0; i < 1 + MULT_STAGES; i++) {
+        fwd_sel_nxt[i] = fwd[i + 1];
+    }
+#endif
+
+    // Decode new instruction when signaled, if there is no current NOP nor an operand in flight
+    if (decode_en->read() && !nop_cnt_reg && !stall) {
         // Signal a increase in the PC for the next cycle
         count_en->write(true);
 
@@ -528,22 +804,26 @@ void instr_decoder::comb_method() {
                 nop_cnt_nxt = IMM0 - 1;	// The FETCH already counts as a NOP cycle
             break;
 
-            // JUMP with zero-cycles execution stage and only one register for number of loops
+            // JUMP with zero-cycles execution stage and a stack of loop counters, so that loops can nest.
+            // The innermost active loop is on top, any other JUMP seen is the start of a nested one
             case OP_JUMP:
-                if (!jmp_act_reg) {			// First sight of this jump
-                    count_en->write(false);
-                    jmp_act_nxt = true;
-                    jmp_cnt_nxt = IMM1 - 1;
-                    jump_en->write(true);
-                    jump_num->write(IMM0);
-                } else if (jmp_cnt_reg) {	// Still more jumps to make
+                top = jmp_top_reg;
+                if (!top || jmp_pc_reg[top-1] != pc_in->read()) {	// First sight of this jump
+                    if (top < LOOP_DEPTH) {	// Deeper nesting than the stack is ignored
+                        count_en->write(false);
+                        jmp_top_nxt = top + 1;
+                        jmp_pc_nxt[top] = pc_in->read();
+                        jmp_cnt_nxt[top] = IMM1 - 1;
+                        jump_en->write(true);
+                        jump_num->write(IMM0);
+                    }
+                } else if (jmp_cnt_reg[top-1]) {	// Still more jumps to make
                     count_en->write(false);
-                    jmp_act_nxt = true;
-                    jmp_cnt_nxt = jmp_cnt_reg - 1;
+                    jmp_cnt_nxt[top-1] = jmp_cnt_reg[top-1] - 1;
                     jump_en->write(true);
                     jump_num->write(IMM0);
-                } else {					// Last jump made
-                    jmp_act_nxt = false;
+                } else {					// Last jump made, back to the enclosing loop
+                    jmp_top_nxt = top - 1;
                 }
             break;
 
@@ -551,45 +831,81 @@ void instr_decoder::comb_method() {
             case OP_EXIT:
                 // Only reset PC, we allow for further instructions if triggered by DRAM commands
                 pc_rst->write(true);
+#if AAM_REGS
+                // The next program takes the AAM indices from the bases again
+                aam_src_off_nxt = 0;
+                aam_dst_off_nxt = 0;
+#endif
             break;
 
             // DST(DST_N) <- SRC0(SRC0_N), with optional ReLU
+            // With CORE_RING, SRC0 can be the ring, GRF_B(SRC0_N) of the previous core, read into a GRF
             case OP_MOV:
                 if (SRC0 == OPC_EVEN_BANK) {	// Loading from even bank
                     rd_from_mux = MUX_EVEN_BANK;
-                    switch (DST) {	// Only even_bank to GRF_A allowed
+                    switch (DST) {	// Only even_bank to GRF_A or SRF allowed
                         case OPC_GRF_A:
                             grfa_wr_en_fromLoad = true;
                             grfa_wr_from_fromLoad = rd_from_mux;
-                            grfa_wr_addr_fromLoad = DST_N.to_uint();
+                            grfa_wr_addr_fromLoad = MOV_AAM ? aam_dst_addr.to_uint() : DST_N.to_uint();
+#if AAM_REGS
+                            aam_dst_adv = MOV_AAM;
+#endif
                             if (RELU)
                                 grfa_relu_en_nxt = true;
                         break;
+                        case OPC_SRF_M:
+                        case OPC_SRF_A:	// Lane SRC0_N, or a block of lanes from SRC0_N if RELU is set
+                            srf_wr_en_nxt = true;
+                            srf_wr_from_nxt = rd_from_mux;
+                            srf_wr_addr_nxt = DST_N.to_uint();
+                            srf_wr_a_nm_nxt = (DST == OPC_SRF_A);
+                            srf_wr_pack_nxt = RELU;
+                            srf_wr_lane_nxt = SRC0_N.to_uint();
+                        break;
                         default:
                         break;
                     }
                 } else if (SRC0 == OPC_ODD_BANK) {
                     rd_from_mux = MUX_ODD_BANK;
-                    switch (DST) {	// Only odd_bank to GRF_B allowed
+                    switch (DST) {	// Only odd_bank to GRF_B or SRF allowed
                         case OPC_GRF_B:
                             grfb_wr_en_fromLoad = true;
                             grfb_wr_from_fromLoad = rd_from_mux;
-                            grfb_wr_addr_fromLoad = DST_N.to_uint();
+                            grfb_wr_addr_fromLoad = MOV_AAM ? aam_dst_addr.to_uint() : DST_N.to_uint();
+#if AAM_REGS
+                            aam_dst_adv = MOV_AAM;
+#endif
                             if (RELU)
                                 grfb_relu_en_nxt = true;
                         break;
+                        case OPC_SRF_M:
+                        case OPC_SRF_A:	// Lane SRC0_N, or a block of lanes from SRC0_N if RELU is set
+                            srf_wr_en_nxt = true;
+                            srf_wr_from_nxt = rd_from_mux;
+                            srf_wr_addr_nxt = DST_N.to_uint();
+                            srf_wr_a_nm_nxt = (DST == OPC_SRF_A);
+                            srf_wr_pack_nxt = RELU;
+                            srf_wr_lane_nxt = SRC0_N.to_uint();
+                        break;
                         default:
                         break;
                     }
                 } else {	// Reading from RFs
                     switch (SRC0) {
                         case OPC_GRF_A:
-                            grfa_rd_addr1_comb = SRC0_N.to_uint();
+                            grfa_rd_addr1_comb = MOV_AAM ? aam_src_addr.to_uint() : SRC0_N.to_uint();
                             rd_from_mux = MUX_GRF_A;
+#if AAM_REGS
+                            aam_src_adv = MOV_AAM;
+#endif
                         break;
                         case OPC_GRF_B:
-                            grfb_rd_addr1_comb = SRC0_N.to_uint();
+                            grfb_rd_addr1_comb = MOV_AAM ? aam_src_addr.to_uint() : SRC0_N.to_uint();
                             rd_from_mux = MUX_GRF_B;
+#if AAM_REGS
+                            aam_src_adv = MOV_AAM;
+#endif
                         break;
                         case OPC_SRF_M:
                             srf_rd_addr_comb = SRC0_N.to_uint();
@@ -601,6 +917,12 @@ void instr_decoder::comb_method() {
                             srf_rd_a_nm_comb = true;
                             rd_from_mux = MUX_SRF;
                         break;
+#if CORE_RING
+                        case OPC_RING:	// Every core drives GRF_B(SRC0_N) to the next one and writes the one of the previous core
+                            grfb_rd_addr1_comb = SRC0_N.to_uint();
+                            rd_from_mux = MUX_RING;
+                        break;
+#endif
                         default:
                         break;
                     }
@@ -608,16 +930,22 @@ void instr_decoder::comb_method() {
                         case OPC_GRF_A:
                             grfa_wr_en_comb = true;
                             grfa_wr_from_comb = rd_from_mux;
-                            grfa_wr_addr_comb = DST_N.to_uint();
+                            grfa_wr_addr_comb = MOV_AAM ? aam_dst_addr.to_uint() : DST_N.to_uint();
                             if (RELU)
                                 grfa_relu_en_comb = true;
+#if AAM_REGS
+                            aam_dst_adv = MOV_AAM;
+#endif
                         break;
                         case OPC_GRF_B:
                             grfb_wr_en_comb = true;
                             grfb_wr_from_comb = rd_from_mux;
-                            grfb_wr_addr_comb = DST_N.to_uint();
+                            grfb_wr_addr_comb = MOV_AAM ? aam_dst_addr.to_uint() : DST_N.to_uint();
                             if (RELU)
                                 grfb_relu_en_comb = true;
+#if AAM_REGS
+                            aam_dst_adv = MOV_AAM;
+#endif
                         break;
                         case OPC_SRF_M:
                             srf_wr_en_comb = true;
@@ -645,9 +973,95 @@ void instr_decoder::comb_method() {
                 }
             break;
 
-            // DST(DST_N) <- SRC0(SRC0_N) ?
+#if LANE_PERM
+            // DST(DST_N) <- SRC0(SRC0_N) with its lanes shifted or rotated by PERM_K, or lane PERM_K broadcast
+            // Only between GRFs, written in the same cycle as an RF MOV through the permutation in front of the GRF
+            case OP_PERM:
+                switch (SRC0) {
+                    case OPC_GRF_A:
+                        grfa_rd_addr1_comb = SRC0_N.to_uint();
+                        rd_from_mux = MUX_GRF_A;
+                    break;
+                    case OPC_GRF_B:
+                        grfb_rd_addr1_comb = SRC0_N.to_uint();
+                        rd_from_mux = MUX_GRF_B;
+                    break;
+                    default:
+                    break;
+                }
+                switch (DST) {
+                    case OPC_GRF_A:
+                        grfa_wr_en_comb = true;
+                        grfa_wr_from_comb = rd_from_mux;
+                        grfa_wr_addr_comb = DST_N.to_uint();
+                        grfa_perm_sel->write(PERM.to_uint());
+                    break;
+                    case OPC_GRF_B:
+                        grfb_wr_en_comb = true;
+                        grfb_wr_from_comb = rd_from_mux;
+                        grfb_wr_addr_comb = DST_N.to_uint();
+                        grfb_perm_sel->write(PERM.to_uint());
+                    break;
+                    default:
+                    break;
+                }
+                perm_k->write(PERM_K.to_uint());
+            break;
+#endif
+
+            // DST(DST_N) <- sum of the lanes of SRC0(SRC0_N), or their maximum if MAX is set
+            // The result leaves the tree after RED_STAGES cycles, into lane 0 of a GRF entry or into an SRF entry
+            case OP_RED:
+                switch (SRC0) {	// Only GRFs can be reduced
+                    case OPC_GRF_A:
+                        grfa_rd_addr1_comb = SRC0_N.to_uint();
+                        fpu_add_in1_sel_comb = A_GRF_A1;
+                    break;
+                    case OPC_GRF_B:
+                        grfb_rd_addr1_comb = SRC0_N.to_uint();
+                        fpu_add_in1_sel_comb = A_GRF_B1;
+                    break;
+                    default:
+                    break;
+                }
+                red_max_comb = MAX;
+                red_wr_en_comb = true;
+                red_wr_dst_comb = DST;
+                red_wr_addr_comb = DST_N.to_uint();
+            break;
+
+            // DST(DST_N) <- IMM broadcast to every lane if IMM is set, or SRC0(SRC0_N) from the SRF otherwise
+            // Written in the same cycle as an RF MOV, bank columns are left to MOV from a GRF
             case OP_FILL:
-                // TODO left unimplemented, then we'll see
+                if (IMM) {
+                    rd_from_mux = MUX_IMM;
+                    fill_imm->write(FILL_IMM.to_int());
+                } else {
+                    srf_rd_addr_comb = SRC0_N.to_uint();
+                    srf_rd_a_nm_comb = (SRC0 == OPC_SRF_A);
+                    rd_from_mux = MUX_SRF;
+                }
+                switch (DST) {
+                    case OPC_GRF_A:
+                        grfa_wr_en_comb = true;
+                        grfa_wr_from_comb = rd_from_mux;
+                        grfa_wr_addr_comb = DST_N.to_uint();
+                    break;
+                    case OPC_GRF_B:
+                        grfb_wr_en_comb = true;
+                        grfb_wr_from_comb = rd_from_mux;
+                        grfb_wr_addr_comb = DST_N.to_uint();
+                    break;
+                    case OPC_SRF_M:
+                    case OPC_SRF_A:
+                        srf_wr_en_comb = true;
+                        srf_wr_from_comb = rd_from_mux;
+                        srf_wr_addr_comb = DST_N.to_uint();
+                        srf_wr_a_nm_comb = (DST == OPC_SRF_A);
+                    break;
+                    default:
+                    break;
+                }
             break;
 
             // DST(DST_N) = SRC0(SRC0_N) + SRC1(SRC1_N)
@@ -938,6 +1352,60 @@ void instr_decoder::comb_method() {
                 }
             break;
 
+#if DUAL_ISSUE
+            // GRF(M_DST_N) = MSRC0(MSRC0_N) * MSRC1(MSRC1_N), and in the same cycle
+            // the other GRF(A_DST_N) = ASRC0(ASRC0_N) + ASRC1(ASRC1_N), from the RFs only
+            case OP_MULADD:
+                // Every GRF has two read ports, an entry read by both halves takes a single one
+                for (i = 0; i < 4; i++) {
+                    if (di_rf[i] == OPC_GRF_A || di_rf[i] == OPC_GRF_B) {
+                        g = di_rf[i];
+                        di_port[i] = (port_busy[g][0] && port_idx[g][0] != di_idx[i]) ? 1 : 0;
+                        port_busy[g][di_port[i]] = true;
+                        port_idx[g][di_port[i]] = di_idx[i];
+                    } else {    // The SRF has a single read port
+                        di_port[i] = 0;
+                        srf_rd_addr_comb = di_idx[i];
+                        srf_rd_a_nm_comb = (di_rf[i] == OPC_SRF_A);
+                    }
+                }
+                if (port_busy[OPC_GRF_A][0])
+                    grfa_rd_addr1_comb = port_idx[OPC_GRF_A][0];
+                if (port_busy[OPC_GRF_A][1])
+                    grfa_rd_addr2_comb = port_idx[OPC_GRF_A][1];
+                if (port_busy[OPC_GRF_B][0])
+                    grfb_rd_addr1_comb = port_idx[OPC_GRF_B][0];
+                if (port_busy[OPC_GRF_B][1])
+                    grfb_rd_addr2_comb = port_idx[OPC_GRF_B][1];
+
+                // The GRF inputs of the multipliers and adders are ordered as GRF_A1, GRF_A2, GRF_B1, GRF_B2
+                fpu_mult_in1_sel_comb = M1_GRF_A1 + 2 * di_rf[0] + di_port[0];
+                fpu_mult_in2_sel_comb = (di_rf[1] == OPC_SRF_M) ? uint8_t(M2_SRF) : uint8_t(M2_GRF_A1 + 2 * di_rf[1] + di_port[1]);
+                fpu_add_in1_sel_comb = (di_rf[2] == OPC_SRF_A) ? uint8_t(A_SRF) : uint8_t(A_GRF_A1 + 2 * di_rf[2] + di_port[2]);
+                fpu_add_in2_sel_comb = (di_rf[3] == OPC_SRF_A) ? uint8_t(A_SRF) : uint8_t(A_GRF_A1 + 2 * di_rf[3] + di_port[3]);
+
+                mul_en_toMoA = true;
+                add_en_toMoA = true;
+
+                // The product is written back from the multiplier output, so the adder output keeps the sum
+                if (M_DST == OPC_GRF_A) {
+                    grfa_wr_en_fromMul = true;
+                    grfa_wr_from_fromMul = MUX_FPU_MULT;
+                    grfa_wr_addr_fromMul = M_DST_N;
+                    grfb_wr_en_fromAdd = true;
+                    grfb_wr_from_fromAdd = MUX_FPU;
+                    grfb_wr_addr_fromAdd = A_DST_N;
+                } else {
+                    grfb_wr_en_fromMul = true;
+                    grfb_wr_from_fromMul = MUX_FPU_MULT;
+                    grfb_wr_addr_fromMul = M_DST_N;
+                    grfa_wr_en_fromAdd = true;
+                    grfa_wr_from_fromAdd = MUX_FPU;
+                    grfa_wr_addr_fromAdd = A_DST_N;
+                }
+            break;
+#endif
+
             // DST(DST_N) = SRC0(SRC0_N) * SRC1(SRC1_N) + SRC2(SRC1_N)
             case OP_MAD:
                 if (SRC0 == OPC_EVEN_BANK || SRC0 == OPC_ODD_BANK
@@ -1138,6 +1606,7 @@ void instr_decoder::comb_method() {
 
             // DST(DST_N) = SRC0(SRC0_N) * SRC1(SRC1_N) + DST(DST_N)
             case OP_MAC:
+            case OP_MACW:   // Same operands, accumulating into the wide lanes of DST
                 if (SRC0 == OPC_EVEN_BANK || SRC0 == OPC_ODD_BANK
                         || SRC1 == OPC_EVEN_BANK || SRC1 == OPC_ODD_BANK) {	// Loading from bank
                     switch (SRC0) {	// Select first input to multiplier
@@ -1196,7 +1665,7 @@ void instr_decoder::comb_method() {
         //							grfb_rd_addr1_toAddAftLoad = AAM ? aam_grfb_addr.to_uint() : DST_N.to_uint();
                             grfb_rd_addr1_toAddAftLoad =
                                     AAM ? aam_dst_addr.to_uint() : DST_N.to_uint();
-                            fpu_add_in1_sel_toAddAftLoad = A_GRF_B1;
+                            fpu_add_in1_sel_toAddAftLoad = OPCODE == OP_MACW ? A_GRF_B1_WIDE : A_GRF_B1;
                         break;
                         default:
                         break;
@@ -1260,7 +1729,7 @@ void instr_decoder::comb_method() {
         //							grfb_rd_addr1_toAdd = DST_N.to_uint();
                             grfb_rd_addr1_toAdd =
                                     AAM ? aam_dst_addr.to_uint() : DST_N.to_uint();
-                            fpu_add_in1_sel_toAdd = A_GRF_B1;
+                            fpu_add_in1_sel_toAdd = OPCODE == OP_MACW ? A_GRF_B1_WIDE : A_GRF_B1;
                         break;
                         default:
                         break;
@@ -1282,47 +1751,78 @@ void instr_decoder::comb_method() {
                 }
             break;
         }
+
+#if AAM_REGS
+        // Every AAM instruction advances the offsets of the indices it takes by their strides, wrapping around
+        // at their modulos. The FPU instructions take the destination index and the source one of their RF operands
+        if (AAM && OPCODE >= OP_ADD && OPCODE <= OP_MACW) {
+            aam_src_adv = SRC0 < OPC_EVEN_BANK || SRC1 < OPC_EVEN_BANK;
+            aam_dst_adv = true;
+        }
+        if (aam_src_adv) {
+            aam_off = aam_src_off_reg.read() + aam_cfg.range(AAM_SRC_STRIDE_STA, AAM_SRC_STRIDE_END);
+            aam_src_off_nxt = aam_off > aam_cfg.range(AAM_SRC_MOD_STA, AAM_SRC_MOD_END) ?
+                    aam_off - aam_cfg.range(AAM_SRC_MOD_STA, AAM_SRC_MOD_END) - 1 : aam_off;
+        }
+        if (aam_dst_adv) {
+            aam_off = aam_dst_off_reg.read() + aam_cfg.range(AAM_DST_STRIDE_STA, AAM_DST_STRIDE_END);
+            aam_dst_off_nxt = aam_off > aam_cfg.range(AAM_DST_MOD_STA, AAM_DST_MOD_END) ?
+                    aam_off - aam_cfg.range(AAM_DST_MOD_STA, AAM_DST_MOD_END) - 1 : aam_off;
+        }
+#endif
     }
 
 }
 
 void instr_decoder::out_method() {
+    PROFILE_METHOD("instr_decoder::out_method");
 
     uint i = 0;
     add_en_or = false;
     mul_en_or = false;
+    bool red_en_or = false;
+
+    // Lane reduction leaving the tree, written back to its destination
+    bool red_wr = red_wr_en_pipe[RED_STAGES - 1];
+    uint8_t red_dst = red_wr_dst_pipe[RED_STAGES - 1];
+    uint red_addr = red_wr_addr_pipe[RED_STAGES - 1];
+    bool red_grfa = red_wr && red_dst == OPC_GRF_A;
+    bool red_grfb = red_wr && red_dst == OPC_GRF_B;
+    bool red_srf = red_wr && (red_dst == OPC_SRF_M || red_dst == OPC_SRF_A);
 
     // ** Resolve all outputs not yet written **
 
     // SRF control
     srf_rd_addr->write(srf_rd_addr_comb | srf_rd_addr_pipe[MULT_STAGES]);
     srf_rd_a_nm->write(srf_rd_a_nm_comb | srf_rd_a_nm_pipe[MULT_STAGES]);
-    srf_wr_en->write(srf_wr_en_comb | srf_wr_en_reg);
-    srf_wr_addr->write(srf_wr_addr_comb | srf_wr_addr_reg);
-    srf_wr_a_nm->write(srf_wr_a_nm_comb | srf_wr_a_nm_reg);
-    srf_wr_from->write(srf_wr_from_comb | srf_wr_from_reg);
+    srf_wr_en->write(srf_wr_en_comb | srf_wr_en_reg | red_srf);
+    srf_wr_addr->write(srf_wr_addr_comb | srf_wr_addr_reg | (red_srf ? red_addr : 0));
+    srf_wr_a_nm->write(srf_wr_a_nm_comb | srf_wr_a_nm_reg | (red_srf && red_dst == OPC_SRF_A));
+    srf_wr_from->write(srf_wr_from_comb | srf_wr_from_reg | (red_srf ? MUX_FPU : 0));
+    srf_wr_pack->write(srf_wr_pack_comb | srf_wr_pack_reg);
+    srf_wr_lane->write(srf_wr_lane_reg);
 
     // GRF_A control
     grfa_rd_addr1->write(grfa_rd_addr1_comb | grfa_rd_addr1_pipe[MULT_STAGES]);
     grfa_rd_addr2->write(grfa_rd_addr2_comb | grfa_rd_addr2_reg);
     grfa_wr_en->write(
-            grfa_wr_en_comb | grfa_wr_en_pipe[MULT_STAGES + ADD_STAGES]);
+            grfa_wr_en_comb | grfa_wr_en_pipe[MULT_STAGES + ADD_STAGES] | red_grfa);
     grfa_relu_en->write(grfa_relu_en_comb | grfa_relu_en_reg);
     grfa_wr_addr->write(
-            grfa_wr_addr_comb | grfa_wr_addr_pipe[MULT_STAGES + ADD_STAGES]);
+            grfa_wr_addr_comb | grfa_wr_addr_pipe[MULT_STAGES + ADD_STAGES] | (red_grfa ? red_addr : 0));
     grfa_wr_from->write(
-            grfa_wr_from_comb | grfa_wr_from_pipe[MULT_STAGES + ADD_STAGES]);
+            grfa_wr_from_comb | grfa_wr_from_pipe[MULT_STAGES + ADD_STAGES] | (red_grfa ? MUX_FPU : 0));
 
     // GRF_B control
     grfb_rd_addr1->write(grfb_rd_addr1_comb | grfb_rd_addr1_pipe[MULT_STAGES]);
     grfb_rd_addr2->write(grfb_rd_addr2_comb | grfb_rd_addr2_reg);
     grfb_wr_en->write(
-            grfb_wr_en_comb | grfb_wr_en_pipe[MULT_STAGES + ADD_STAGES]);
+            grfb_wr_en_comb | grfb_wr_en_pipe[MULT_STAGES + ADD_STAGES] | red_grfb);
     grfb_relu_en->write(grfb_relu_en_comb | grfb_relu_en_reg);
     grfb_wr_addr->write(
-            grfb_wr_addr_comb | grfb_wr_addr_pipe[MULT_STAGES + ADD_STAGES]);
+            grfb_wr_addr_comb | grfb_wr_addr_pipe[MULT_STAGES + ADD_STAGES] | (red_grfb ? red_addr : 0));
     grfb_wr_from->write(
-            grfb_wr_from_comb | grfb_wr_from_pipe[MULT_STAGES + ADD_STAGES]);
+            grfb_wr_from_comb | grfb_wr_from_pipe[MULT_STAGES + ADD_STAGES] | (red_grfb ? MUX_FPU : 0));
 
     // FPU control
     for (i = 0; i < MULT_STAGES; i++) {
@@ -1340,4 +1840,285 @@ void instr_decoder::out_method() {
     fpu_add_in2_sel->write(
             fpu_add_in2_sel_comb | fpu_add_in2_sel_pipe[MULT_STAGES]);
     fpu_out_sel->write(fpu_out_sel_pipe[MULT_STAGES]);
+    for (i = 0; i < RED_STAGES - 1; i++) {  // The tree advances until the result reaches its last stage
+        red_en_or |= red_wr_en_pipe[i];
+    }
+    fpu_red_en->write(red_wr_en_comb | red_en_or);
+    fpu_red_max->write(red_max_comb);
+    fpu_red_sel->write(red_wr);
+#if HAZARD_FWD
+    fpu_fwd_sel->write(fwd_sel_comb | fwd_sel_pipe[0]);
+#endif
+}
+
+#if HAZARD_FWD
+uint8_t instr_decoder::raw_hazard(uint8_t rf, uint idx, uint rd_cycle, bool to_fpu) {
+    int i;
+    uint wr_cycle;
+    uint pack = (rf == OPC_SRF_A) ? SRF_A_PACK : SRF_M_PACK;
+    uint8_t hz = HZ_NONE;
+
+    // GRF writes going through the FPU, the last stage of the pipelines is written back in this cycle
+    for (i = 0; i < 1 + MULT_STAGES + ADD_STAGES; i++) {
+        wr_cycle = MULT_STAGES + ADD_STAGES - i;
+        if (wr_cycle < rd_cycle)    // Already written when it is read
+            continue;
+        if (rf == OPC_GRF_A && grfa_wr_en_pipe[i] && grfa_wr_addr_pipe[i] == idx)
+            hz |= (wr_cycle == rd_cycle && to_fpu && grfa_wr_from_pipe[i] == MUX_FPU) ? HZ_FWD : HZ_STALL;
+        if (rf == OPC_GRF_B && grfb_wr_en_pipe[i] && grfb_wr_addr_pipe[i] == idx)
+            hz |= (wr_cycle == rd_cycle && to_fpu && grfb_wr_from_pipe[i] == MUX_FPU) ? HZ_FWD : HZ_STALL;
+    }
+
+    // Lane reductions still in the tree, into a GRF or the SRF
+    for (i = 0; i < RED_STAGES; i++) {
+        wr_cycle = RED_STAGES - 1 - i;
+        if (wr_cycle >= rd_cycle && red_wr_en_pipe[i] && red_wr_dst_pipe[i] == rf && red_wr_addr_pipe[i] == idx)
+            hz |= (wr_cycle == rd_cycle && to_fpu) ? HZ_FWD : HZ_STALL;
+    }
+
+    // SRF loads, written in this cycle over consecutive entries if packed
+    if (rd_cycle == 0 && srf_wr_en_reg && (rf == OPC_SRF_M || rf == OPC_SRF_A)
+            && srf_wr_a_nm_reg == (rf == OPC_SRF_A) && idx >= srf_wr_addr_reg
+            && idx < srf_wr_addr_reg + (srf_wr_pack_reg ? pack : 1))
+        hz |= HZ_STALL;
+
+    return hz;
+}
+#endif
+
+#ifndef __SYNTHESIS__
+void instr_decoder::perf_count() {
+
+    sc_uint<32> instruction = instr->read();
+    uint8_t OPCODE = instruction.range(OPCODE_STA, OPCODE_END);
+    uint8_t DST = instruction.range(DST_STA, DST_END);
+    uint8_t SRC0 = instruction.range(SRC0_STA, SRC0_END);
+    uint8_t SRC1 = instruction.range(SRC1_STA, SRC1_END);
+    uint8_t SRC2 = instruction.range(SRC2_STA, SRC2_END);
+    uint8_t src[4] = {OPC_GRF_A, OPC_GRF_A, OPC_GRF_A, OPC_GRF_A};
+    uint src_num = 0;
+    uint i;
+
+    bool decoding = decode_en->read() && !nop_cnt_reg.read();
+    bool grf_wr = grfa_wr_en->read() || grfb_wr_en->read();
+    bool fpu_busy = fpu_mult_en->read() || fpu_add_en->read() || fpu_red_en->read();
+
+    perf.cycles++;
+
+    // Idle if nothing is being issued, written or computed
+    if (!decode_en->read() && !rf_access->read() && !nop_cnt_reg.read()
+            && !grf_wr && !srf_wr_en->read() && !fpu_busy)
+        perf.idle_cycles++;
+
+    // Host writes to the RFs, which occupy the DQ for one or more cycles
+    if (rf_access->read()) {
+        uint8_t rf_sel = rf_sel_of_access();
+        if (rf_sel == RF_CRF_SWAP)
+            perf.rf_dq_cycles++;
+        else if (rf_sel >= RF_GRF_A && rf_sel < RF_CRF_SH)
+            perf.rf_dq_cycles += DQ_CLK;
+        else if ((rf_sel == RF_CRF || rf_sel == RF_CRF_SH) && INSTR_CLK > 1)
+            perf.rf_dq_cycles += INSTR_CLK;
+        else
+            perf.rf_dq_cycles++;
+    }
+
+    // RF and bank writes, as seen at the outputs of the decoder
+    if (crf_wr_en->read())
+        perf.crf_wr++;
+    if (srf_wr_en->read())
+        perf.srf_wr++;
+    if (grfa_wr_en->read())
+        perf.grfa_wr++;
+    if (grfb_wr_en->read())
+        perf.grfb_wr++;
+    if (even_out_en->read() || odd_out_en->read())
+        perf.bank_wr++;
+
+    // FPU occupancy, all the lanes compute in lockstep
+    if (fpu_mult_en->read())
+        perf.mul_cycles++;
+    if (fpu_add_en->read())
+        perf.add_cycles++;
+
+    // NOPs occupy the decoder while their counter drains
+    if (nop_cnt_reg.read()) {
+        perf.nop_cycles++;
+        if (decode_en->read())
+            perf.nop_stalls++;
+    }
+
+#if HAZARD_FWD
+    // Operands forwarded from the FPU output, and commands waiting for one still in flight
+    for (i = 0; i < 4; i++) {
+        if (fpu_fwd_sel->read() & (1 << i))
+            perf.fwd_operands++;
+    }
+    if (hazard_stall.read()) {
+        perf.hazard_stalls++;
+        decoding = false;
+    }
+#endif
+
+    if (!decoding)
+        return;
+
+    // Instruction issue
+    perf.pim_dq_cycles++;
+    perf.op_cycles[OPCODE]++;
+
+    switch (OPCODE) {
+        case OP_NOP:
+            perf.nop_cycles++;
+        break;
+        case OP_JUMP:
+            if (jump_en->read())
+                perf.jump_iters++;
+        break;
+        case OP_MOV:
+        case OP_RED:
+        case OP_PERM:
+            src[src_num++] = SRC0;
+        break;
+        case OP_FILL:
+            if (!instruction[IMM_BIT])
+                src[src_num++] = SRC0;
+        break;
+        case OP_ADD:
+        case OP_MUL:
+            src[src_num++] = SRC0;
+            src[src_num++] = SRC1;
+        break;
+        case OP_MAD:
+            src[src_num++] = SRC0;
+            src[src_num++] = SRC1;
+            src[src_num++] = SRC2;
+        break;
+        case OP_MAC:
+        case OP_MACW:
+            src[src_num++] = SRC0;
+            src[src_num++] = SRC1;
+            src[src_num++] = DST;
+        break;
+#if DUAL_ISSUE
+        case OP_MULADD:
+            src[src_num++] = instruction.range(DI_MSRC0_STA, DI_MSRC0_END);
+            src[src_num++] = instruction.range(DI_MSRC1_STA, DI_MSRC1_END);
+            src[src_num++] = instruction.range(DI_ASRC0_STA, DI_ASRC0_END);
+            src[src_num++] = instruction.range(DI_ASRC1_STA, DI_ASRC1_END);
+        break;
+#endif
+        default:
+        break;
+    }
+
+    // Operand reads, from the RFs or from the banks
+    for (i = 0; i < src_num; i++) {
+        switch (src[i]) {
+            case OPC_GRF_A:     perf.grfa_rd++;     break;
+            case OPC_GRF_B:
+            case OPC_RING:      perf.grfb_rd++;     break;
+            case OPC_SRF_M:
+            case OPC_SRF_A:     perf.srf_rd++;      break;
+            case OPC_EVEN_BANK:
+            case OPC_ODD_BANK:  perf.bank_rd++;     break;
+            default:                                break;
+        }
+    }
 }
+
+uint8_t instr_decoder::rf_sel_of_access() {
+    sc_uint<ROW_BITS> row = row_addr->read();
+    sc_uint<ROW_BITS - 1 + COL_BITS> rowcol_addr;
+    rowcol_addr.range(ROW_BITS - 1 + COL_BITS - 1, COL_BITS) = row.range(ROW_BITS - 2, 0);
+    rowcol_addr.range(COL_BITS - 1, 0) = col_addr->read();
+    return rowcol_addr.range(RF_SEL_BITS + RF_ADDR_BITS - 1, RF_ADDR_BITS);
+}
+
+void instr_decoder::tl_record() {
+
+    sc_uint<32> instruction = instr->read();
+    uint8_t OPCODE = instruction.range(OPCODE_STA, OPCODE_END);
+    uint8_t SRC0 = instruction.range(SRC0_STA, SRC0_END);
+    uint8_t SRC1 = instruction.range(SRC1_STA, SRC1_END);
+    uint8_t SRC2 = instruction.range(SRC2_STA, SRC2_END);
+    uint64_t cycle = timeline::now();
+    bool decoding = decode_en->read() && !nop_cnt_reg.read();
+    bool bank_rd = false;
+    std::ostringstream args;
+
+    // Phases, an EXEC window stays open until the host starts writing the RFs again
+    if (rf_access->read()) {
+        uint8_t rf_sel = rf_sel_of_access();
+        // Writes that took the DQ for the last DQ_CLK cycles, or INSTR_CLK for an instruction, none before the start
+        uint64_t dq_start = cycle + 1 - std::min<uint64_t>(cycle + 1, DQ_CLK);
+        uint64_t instr_start = cycle + 1 - std::min<uint64_t>(cycle + 1, INSTR_CLK > 1 ? INSTR_CLK : 1);
+        if (rf_sel == RF_GRF_A || rf_sel == RF_GRF_B)
+            tl.span(TL_PHASE, "GRF load", dq_start, cycle + 1, TL_STICKY);
+        else if (rf_sel == RF_SRF_M_PK || rf_sel == RF_SRF_A_PK)
+            tl.span(TL_PHASE, "SRF load", dq_start, cycle + 1, TL_STICKY);
+        else if (rf_sel == RF_CRF)
+            tl.span(TL_PHASE, "CRF write", instr_start, cycle + 1, TL_STICKY);
+        else if (rf_sel == RF_CRF_SH)   // Overlapped with the execution, not a phase of its own
+            tl.span(TL_INSTR, "CRF prefetch", instr_start, cycle + 1, 0);
+        else if (rf_sel == RF_CRF_SWAP)
+            tl.span(TL_INSTR, "CRF swap", cycle, cycle + 1, 0);
+        else if (rf_sel == RF_AAM)
+            tl.span(TL_INSTR, "AAM config", cycle, cycle + 1, 0);
+        else
+            tl.span(TL_PHASE, "SRF load", cycle, cycle + 1, TL_STICKY);
+    } else if (decode_en->read() || nop_cnt_reg.read() || fpu_mult_en->read() || fpu_add_en->read()
+            || fpu_red_en->read()) {
+        tl.span(TL_PHASE, "EXEC", cycle, cycle + 1, TL_STICKY);
+    }
+
+    // NOPs last until their counter drains, PIM commands arriving meanwhile are stalled
+    if (nop_cnt_reg.read()) {
+        tl.span(TL_INSTR, "NOP", cycle, cycle + 1, 0);
+        if (decode_en->read())
+            tl.instant(TL_INSTR, "NOP stall", cycle);
+    }
+
+#if HAZARD_FWD
+    // Commands waiting for an operand still in flight
+    if (hazard_stall.read()) {
+        tl.instant(TL_INSTR, "Hazard stall", cycle);
+        decoding = false;
+    }
+#endif
+
+    // Instruction issue
+    if (decoding) {
+        if (OPCODE == OP_NOP) {
+            tl.span(TL_INSTR, "NOP", cycle, cycle + 1, 0);
+        } else {
+            auto op = OPCODE_STRING.find(OPCODE);
+            args << ",\"instr\":\"0x" << std::hex << instruction.to_uint() << "\"";
+            tl.event(TL_INSTR, op != OPCODE_STRING.end() ? op->second : "UNKNOWN", cycle, args.str());
+        }
+
+        switch (OPCODE) {
+            case OP_MAD:
+                bank_rd |= SRC2 == OPC_EVEN_BANK || SRC2 == OPC_ODD_BANK;
+            // fall through
+            case OP_ADD:
+            case OP_MUL:
+            case OP_MAC:
+            case OP_MACW:
+                bank_rd |= SRC1 == OPC_EVEN_BANK || SRC1 == OPC_ODD_BANK;
+            // fall through
+            case OP_MOV:
+                bank_rd |= SRC0 == OPC_EVEN_BANK || SRC0 == OPC_ODD_BANK;
+            break;
+            default:
+            break;
+        }
+    }
+
+    // Bank transfers
+    if (bank_rd)
+        tl.span(TL_BANK, "bank RD", cycle, cycle + 1, 0);
+    if (even_out_en->read() || odd_out_en->read())
+        tl.span(TL_BANK, "bank WR", cycle, cycle + 1, 0);
+}
+#endif
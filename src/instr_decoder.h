@@ -12,6 +12,23 @@
 #include "systemc.h"
 
 #include "cnm_base.h"
+#include "perf_counters.h"
+#include "timeline.h"
+
+#if HAZARD_FWD
+// Outcome of the scoreboard check of an operand
+enum RAW_HAZARD {
+    HZ_NONE = 0,
+    HZ_FWD = 1,     // Written back in the cycle it is read, taken from the FPU output
+    HZ_STALL = 2    // Written later, or by a load or a move, the decoder waits for it
+};
+#endif
+
+#if AAM_REGS
+// AAM configuration after reset, both indices sweep the whole GRF from entry 0
+#define AAM_CFG_RST ((1 << AAM_SRC_STRIDE_END) | ((GRF_ENTRIES - 1) << AAM_SRC_MOD_END) \
+                    | (1 << AAM_DST_STRIDE_END) | ((GRF_ENTRIES - 1) << AAM_DST_MOD_END))
+#endif
 
 class instr_decoder: public sc_module {
 public:
@@ -24,6 +41,9 @@ public:
     sc_in<sc_uint<BANK_BITS> >  bank_addr;   // Address of the bank row
     sc_in<sc_uint<ROW_BITS> >   row_addr;	// Address of the bank row
     sc_in<sc_uint<COL_BITS> >   col_addr;	// Address of the bank column
+#if AAM_REGS
+    sc_in<sc_biguint<GRF_WIDTH> >   rf_data;    // Data written to the RFs by the host, the AAM configuration
+#endif
 
     // Program Counter Control
     sc_out<bool>    pc_rst;     // Synchronous reset when end of CRF or EXIT instruction
@@ -34,6 +54,8 @@ public:
     // CRF Control
     sc_out<bool>    crf_wr_en;		//Enables writing of a received instruction
     sc_out<uint>    crf_wr_addr;    //Index for writing the received instructions from processor
+    sc_out<bool>    crf_wr_sh;      // Writes to the CRF bank that is not executing
+    sc_out<bool>    crf_swap;       // Swaps the executing CRF bank
 
     // SRF Control
     sc_out<uint>    srf_rd_addr;	// Index read
@@ -42,6 +64,9 @@ public:
     sc_out<uint>    srf_wr_addr;	// Index the address to be written
     sc_out<bool>    srf_wr_a_nm;    // Signals if writing to SRF_A (high) or SRF_M (low)
     sc_out<uint8_t> srf_wr_from;	// Index the MUX for input data
+    sc_out<bool>    srf_wr_pack;    // Signals a packed write of consecutive entries from the DQ burst or bank
+    sc_out<uint8_t> srf_wr_lane;    // Lane of the bank column written to the SRF, first one if packed
+    sc_out<int>     fill_imm;       // Immediate of a FILL, broadcast by the GRFs and the SRF
 
     // GRF_A Control
     sc_out<uint>    grfa_rd_addr1;	// Index read at port 1
@@ -59,6 +84,13 @@ public:
     sc_out<uint>    grfb_wr_addr;	// Index the address to be written
     sc_out<uint8_t> grfb_wr_from;	// Index the MUX for input data
 
+#if LANE_PERM
+    // Lane permutation Control
+    sc_out<uint8_t> grfa_perm_sel;  // Lane permutation of the entry written to GRF_A
+    sc_out<uint8_t> grfb_perm_sel;  // Lane permutation of the entry written to GRF_B
+    sc_out<uint8_t> perm_k;         // Lanes shifted or rotated, or lane broadcast, by both GRFs
+#endif
+
     // FPU Control
     sc_out<bool>    fpu_mult_en;        // Signals that a multiplication computation step should be performed
     sc_out<bool>    fpu_add_en;         // Signals that an addition computation step should be performed
@@ -67,6 +99,12 @@ public:
     sc_out<uint8_t> fpu_add_in1_sel;    // Selects input 1 for addition
     sc_out<uint8_t> fpu_add_in2_sel;    // Selects input 2 for addition
     sc_out<bool>    fpu_out_sel;        // Selects the output: 0 for adder output, 1 for multiplier output
+    sc_out<bool>    fpu_red_en;         // Signals that a reduction step should be performed
+    sc_out<bool>    fpu_red_max;        // Reduces to the maximum of the lanes instead of their sum
+    sc_out<bool>    fpu_red_sel;        // Selects the reduction result as the output of the FPU
+#if HAZARD_FWD
+    sc_out<uint8_t> fpu_fwd_sel;        // FPU inputs taking the FPU output as it is written back
+#endif
 
     // BANKS Control
     sc_out<bool> even_out_en;	// Enables the even bank tri-state buffer
@@ -87,9 +125,10 @@ public:
     // NOP signals and variables
     sc_signal<uint8_t> nop_cnt_nxt, nop_cnt_reg;
 
-    // Jump signals and variables
-    sc_signal<bool> jmp_act_nxt, jmp_act_reg;
-    sc_signal<uint> jmp_cnt_nxt, jmp_cnt_reg;
+    // Jump signals and variables, a stack with the PC and remaining iterations of every active loop
+    sc_signal<uint8_t>  jmp_top_nxt, jmp_top_reg;
+    sc_signal<uint8_t>  jmp_pc_nxt[LOOP_DEPTH], jmp_pc_reg[LOOP_DEPTH];
+    sc_signal<uint>     jmp_cnt_nxt[LOOP_DEPTH], jmp_cnt_reg[LOOP_DEPTH];
 
     // GRF_A signals, variables and pipelines
     sc_signal<uint>     grfa_rd_addr1_comb, grfa_rd_addr1_toAddAftLoad, grfa_rd_addr1_toAdd;
@@ -136,6 +175,8 @@ public:
     sc_signal<uint8_t>  srf_wr_from_comb, srf_wr_from_nxt, srf_wr_from_reg;
     sc_signal<uint>     srf_wr_addr_comb, srf_wr_addr_nxt, srf_wr_addr_reg;
     sc_signal<bool>     srf_wr_a_nm_comb, srf_wr_a_nm_nxt, srf_wr_a_nm_reg;
+    sc_signal<bool>     srf_wr_pack_comb, srf_wr_pack_nxt, srf_wr_pack_reg;
+    sc_signal<uint8_t>  srf_wr_lane_nxt, srf_wr_lane_reg;
 
     // FPU signals, variables and pipelines
     sc_signal<uint8_t>  fpu_add_in1_sel_comb, fpu_add_in1_sel_toAddAftLoad, fpu_add_in1_sel_toAdd;
@@ -151,6 +192,32 @@ public:
     sc_signal<bool>     mul_en_toMoA, mul_en_toMoAAftLoad, mul_en_pipe[MULT_STAGES];
     sc_signal<bool>     fpu_out_sel_fromMulAftLoad, fpu_out_sel_fromMul, fpu_out_sel_pipe[1 + MULT_STAGES];
 
+    // Lane reduction signals and pipelines, as long as the reduction tree
+    sc_signal<bool>     red_max_comb;
+    sc_signal<bool>     red_wr_en_comb, red_wr_en_pipe[RED_STAGES];
+    sc_signal<uint8_t>  red_wr_dst_comb, red_wr_dst_pipe[RED_STAGES];
+    sc_signal<uint>     red_wr_addr_comb, red_wr_addr_pipe[RED_STAGES];
+
+#if AAM_REGS
+    // AAM registers, the configuration written by the host and the offsets from the source and destination bases
+    sc_signal<uint32_t> aam_cfg_nxt, aam_cfg_reg;
+    sc_signal<uint8_t>  aam_src_off_nxt, aam_src_off_reg;
+    sc_signal<uint8_t>  aam_dst_off_nxt, aam_dst_off_reg;
+#endif
+
+#if HAZARD_FWD
+    // Scoreboard signals, the operands forwarded in this and the next cycles, up to an adder input after a load
+    sc_signal<uint8_t>  fwd_sel_comb, fwd_sel_nxt[1 + MULT_STAGES], fwd_sel_pipe[1 + MULT_STAGES];
+    sc_signal<bool>     hazard_stall;   // The instruction waits for an operand still in flight
+#endif
+
+#ifndef __SYNTHESIS__
+    // Activity counters, sampled every cycle and dumped at the end of the simulation
+    perf_counters perf;
+    // Timeline of the activity, only recorded if opened by the testbench
+    timeline tl;
+#endif
+
     SC_CTOR(instr_decoder) {
 
         int i;
@@ -160,9 +227,25 @@ public:
         async_reset_signal_is(rst, false);
 
         SC_METHOD(comb_method);
-        sensitive << instr << rf_access << decode_en << bank_addr << row_addr << col_addr;
+        sensitive << instr << rf_access << decode_en << pc_in << bank_addr << row_addr << col_addr;
         sensitive << nop_cnt_reg;
-        sensitive << jmp_act_reg << jmp_cnt_reg;
+        sensitive << jmp_top_reg;
+        for (i = 0; i < LOOP_DEPTH; i++) {
+            sensitive << jmp_pc_reg[i] << jmp_cnt_reg[i];
+        }
+#if HAZARD_FWD
+        for (i = 0; i < 1 + MULT_STAGES + ADD_STAGES; i++) {
+            sensitive << grfa_wr_en_pipe[i] << grfa_wr_addr_pipe[i] << grfa_wr_from_pipe[i];
+            sensitive << grfb_wr_en_pipe[i] << grfb_wr_addr_pipe[i] << grfb_wr_from_pipe[i];
+        }
+        for (i = 0; i < RED_STAGES; i++) {
+            sensitive << red_wr_en_pipe[i] << red_wr_dst_pipe[i] << red_wr_addr_pipe[i];
+        }
+        sensitive << srf_wr_en_reg << srf_wr_addr_reg << srf_wr_a_nm_reg << srf_wr_pack_reg;
+#endif
+#if AAM_REGS
+        sensitive << rf_data << aam_cfg_reg << aam_src_off_reg << aam_dst_off_reg;
+#endif
 
         SC_METHOD(out_method);
         sensitive << srf_rd_addr_comb << srf_rd_addr_pipe[MULT_STAGES];
@@ -171,6 +254,7 @@ public:
         sensitive << srf_wr_addr_comb << srf_wr_addr_reg;
         sensitive << srf_wr_a_nm_comb << srf_wr_a_nm_reg;
         sensitive << srf_wr_from_comb << srf_wr_from_reg;
+        sensitive << srf_wr_pack_comb << srf_wr_pack_reg << srf_wr_lane_reg;
         sensitive << grfa_rd_addr1_comb << grfa_rd_addr1_pipe[MULT_STAGES];
         sensitive << grfa_rd_addr2_comb << grfa_rd_addr2_reg;
         sensitive << grfa_wr_en_comb
@@ -201,11 +285,28 @@ public:
         sensitive << fpu_add_in1_sel_comb << fpu_add_in1_sel_pipe[MULT_STAGES];
         sensitive << fpu_add_in2_sel_comb << fpu_add_in2_sel_pipe[MULT_STAGES];
         sensitive << fpu_out_sel_pipe[MULT_STAGES];
+        sensitive << red_max_comb << red_wr_en_comb;
+        for (i = 0; i < RED_STAGES; i++) {
+            sensitive << red_wr_en_pipe[i];
+        }
+        sensitive << red_wr_dst_pipe[RED_STAGES - 1] << red_wr_addr_pipe[RED_STAGES - 1];
+#if HAZARD_FWD
+        sensitive << fwd_sel_comb << fwd_sel_pipe[0];
+#endif
 
         nop_cnt_reg = false;
 
-        jmp_act_reg = false;
-        jmp_cnt_reg = false;
+        jmp_top_reg = 0;
+        for (i = 0; i < LOOP_DEPTH; i++) {
+            jmp_pc_reg[i] = 0;
+            jmp_cnt_reg[i] = 0;
+        }
+
+#if AAM_REGS
+        aam_cfg_reg = AAM_CFG_RST;
+        aam_src_off_reg = 0;
+        aam_dst_off_reg = 0;
+#endif
 
         grfa_rd_addr1_comb = 0;
         grfa_rd_addr2_comb = 0;
@@ -235,6 +336,9 @@ public:
         srf_wr_addr_reg = 0;
         srf_wr_a_nm_comb = false;
         srf_wr_a_nm_reg = false;
+        srf_wr_pack_comb = false;
+        srf_wr_pack_reg = false;
+        srf_wr_lane_reg = 0;
 
         fpu_add_in1_sel_comb = 0;
         fpu_add_in2_sel_comb = 0;
@@ -247,10 +351,29 @@ public:
         add_en_toMoA = false;
         add_en_or = false;
 
+        red_max_comb = false;
+        red_wr_en_comb = false;
+        red_wr_dst_comb = 0;
+        red_wr_addr_comb = 0;
+        for (i = 0; i < RED_STAGES; i++) {
+            red_wr_en_pipe[i] = false;
+            red_wr_dst_pipe[i] = 0;
+            red_wr_addr_pipe[i] = 0;
+        }
+
         for (i = 0; i < MULT_STAGES; i++) {
             mul_en_pipe[i] = false;
         }
 
+#if HAZARD_FWD
+        fwd_sel_comb = 0;
+        hazard_stall = false;
+        for (i = 0; i < (1 + MULT_STAGES); i++) {
+            fwd_sel_nxt[i] = 0;
+            fwd_sel_pipe[i] = 0;
+        }
+#endif
+
         for (i = 0; i < (1 + MULT_STAGES); i++) {
             grfa_rd_addr1_pipe[i] = 0;
 
@@ -280,6 +403,14 @@ public:
     void clk_thread();	// Performs sequential logic (and resets)
     void comb_method(); // Performs the combinational logic
     void out_method();	// Performs output combinational logic
+#if HAZARD_FWD
+    uint8_t raw_hazard(uint8_t rf, uint idx, uint rd_cycle, bool to_fpu);  // Scoreboard check of an operand read rd_cycle cycles after the decoding
+#endif
+#ifndef __SYNTHESIS__
+    void perf_count();  // Updates the performance counters with the activity of the current cycle
+    void tl_record();   // Records the activity of the current cycle in the timeline
+    uint8_t rf_sel_of_access(); // RF targeted by the current host write in RF mode
+#endif
 };
 
 #endif /* INSTR_DECODER_H_ */
@@ -22,6 +22,7 @@ void interface_unit::clk_thread() {
 
     // Clocked behaviour
     while (1) {
+        PROFILE_BEGIN("interface_unit::clk_thread");
         grf_wr_cnt_reg = grf_wr_cnt_nxt;
         grf_ser2par_reg = grf_ser2par_nxt;
 #if DQ_BITS == 16
@@ -29,17 +30,38 @@ void interface_unit::clk_thread() {
         crf_ser2par_reg = crf_ser2par_nxt;
 #endif
 
+        PROFILE_END();
         wait();
     }
 }
 #endif
 
 void interface_unit::comb_method() {
+    PROFILE_METHOD("interface_unit::comb_method");
     // Separate row address in MSB and rest
     sc_uint<ROW_BITS> row = row_addr->read();
     bool rmsb = row.range(ROW_BITS - 1, ROW_BITS - 1);
     sc_uint<ROW_BITS - 1> rlsb = row.range(ROW_BITS - 2, 0);
 
+    // Commands, only seen by the core if they target its bank group
+    bool rd = RD, wr = WR;
+#if BG_CORES
+    if (bg_addr->read() != core_id->read().range(CORE_ID_BITS - 1, BANK_BITS - 1)) {
+        rd = false;
+        wr = false;
+    }
+#endif
+#if UNICAST_RF
+    // Writes to the SRF or GRF with the bank LSB set are only taken by the core
+    // selected by the rest of the bank and bank group bits
+    sc_uint<CORE_ID_BITS> target = (bg_addr->read() << (BANK_BITS - 1)) | (bank_addr->read() >> 1);
+    if (rmsb && rlsb != RF_CRF && rlsb != RF_CRF_SH && rlsb != RF_CRF_SWAP
+            && bank_addr->read()[0] && target != core_id->read()) {
+        rd = false;
+        wr = false;
+    }
+#endif
+
     // Defaults
     rf_access->write(false);
     decode_en->write(false);
@@ -57,7 +79,7 @@ void interface_unit::comb_method() {
 
     if (pim_mode) {
         if (!rmsb) { // PIM mode, enable instruction decoding if RD/WR command and Row MSB = 0
-            if (RD || WR) {
+            if (rd || wr) {
                 decode_en->write(true);
             }
 #if VAR_DQ_CLK
@@ -72,18 +94,18 @@ void interface_unit::comb_method() {
                                       // TODO check if this complies with JEDEC
 #endif
             // Write to RFs
-            if (rlsb <= RF_GRF_B) {
+            if (rlsb <= (AAM_REGS ? RF_AAM : RF_CRF_SWAP)) {
 #if DQ_BITS == 16
-                if (rlsb == RF_CRF && WR && !RD) {
+                if ((rlsb == RF_CRF || rlsb == RF_CRF_SH) && wr && !rd) {
                     crf_wr_cnt_nxt = crf_wr_cnt_reg + 1;
                     crf_ser2par_nxt = DQ;
                 } else
 #endif
-                if (rlsb < RF_GRF_A) {	// Write to CRF or SRF
+                if (rlsb < RF_GRF_A || rlsb >= RF_CRF_SH) {	// Write to CRF or SRF, CRF swap or AAM registers
                     data_out_aux.range(DQ_BITS - 1, 0) = DQ;
                     data_out->write(data_out_aux);
-                    rf_access->write(WR && !RD);
-                } else if (WR && !RD) {	// Write to GRF
+                    rf_access->write(wr && !rd);
+                } else if (wr && !rd) {	// Write to GRF or packed write to SRF
                     grf_wr_cnt_nxt = grf_wr_cnt_reg + 1;
                     grf_ser2par_aux.range(DQ_BITS - 1, 0) = DQ;
                     grf_ser2par_nxt = grf_ser2par_aux;
@@ -135,10 +157,10 @@ void interface_unit::comb_method() {
         }
 #else
         } else {// Write to RFs
-            if (rlsb <= RF_GRF_B) {
+            if (rlsb <= (AAM_REGS ? RF_AAM : RF_CRF_SWAP)) {
                 data_out_aux.range(DQ_BITS - 1, 0) = DQ;
                 data_out->write(data_out_aux);
-                rf_access->write(WR && !RD);
+                rf_access->write(wr && !rd);
             }
         }
 #endif
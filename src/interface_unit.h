@@ -26,6 +26,10 @@ public:
     sc_in<bool>                 AB_mode;	// Signals if the All-Banks mode is enabled
     sc_in<bool>                 pim_mode;	// Signals if the PIM mode is enabled
     sc_in<sc_uint<BANK_BITS> >  bank_addr;	// Address of the bank
+#if UNICAST_RF
+    sc_in<sc_uint<BG_BITS> >        bg_addr;    // Address of the bank group
+    sc_in<sc_uint<CORE_ID_BITS> >   core_id;    // Index of the core, selects the commands it takes
+#endif
     sc_in<sc_uint<ROW_BITS> >   row_addr;	// Address of the bank row
     sc_in<sc_uint<COL_BITS> >   col_addr;	// Address of the bank column
     sc_in<sc_uint<DQ_BITS> >    DQ;	        // Data input from DRAM controller (output makes no sense here)
@@ -63,6 +67,9 @@ public:
         SC_METHOD(comb_method);
         sensitive << RD << WR << ACT << AB_mode << pim_mode;
         sensitive << bank_addr << row_addr << col_addr << DQ;
+#if UNICAST_RF
+        sensitive << bg_addr << core_id;
+#endif
 #if VAR_DQ_CLK
         sensitive << grf_wr_cnt_reg << grf_ser2par_reg;
 #endif
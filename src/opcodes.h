@@ -29,12 +29,61 @@
 #define SRC2_END    16
 #define RELU_BIT    15
 #define AAM_BIT     15
+#define MAX_BIT     15  // Lane reductions compute the maximum instead of the sum
+#define IMM_BIT     15  // FILL broadcasts its immediate instead of an SRF entry
 #define DST_N_STA   14
 #define DST_N_END   10
 #define SRC0_N_STA  9
 #define SRC0_N_END  5
 #define SRC1_N_STA  4
 #define SRC1_N_END  0
+#define FILL_IMM_STA    9   // Signed immediate of FILL, over the SRC0_N and SRC1_N fields
+#define FILL_IMM_END    0
+#define MOV_AAM_BIT 16  // MOV takes its GRF indices from the AAM registers, over the unused SRC2 field
+#define PERM_SEL_STA    21  // Lane permutation of PERM, over the SRC1 field
+#define PERM_SEL_END    19
+#define PERM_K_STA      4   // Lanes shifted or rotated, or lane broadcast, over the SRC1_N field
+#define PERM_K_END      0
+
+// AAM configuration word, written to RF_AAM with AAM_REGS. The source and destination GRF indices of the AAM
+// instructions are base + offset, and every instruction advances the offset of the indices it uses by the stride,
+// wrapping around at the modulo. The modulo is stored minus one, and the stride must be smaller than it
+#define AAM_SRC_BASE_STA    2
+#define AAM_SRC_BASE_END    0
+#define AAM_SRC_STRIDE_STA  5
+#define AAM_SRC_STRIDE_END  3
+#define AAM_SRC_MOD_STA     8
+#define AAM_SRC_MOD_END     6
+#define AAM_DST_BASE_STA    11
+#define AAM_DST_BASE_END    9
+#define AAM_DST_STRIDE_STA  14
+#define AAM_DST_STRIDE_END  12
+#define AAM_DST_MOD_STA     17
+#define AAM_DST_MOD_END     15
+
+// MULADD format, a MUL and an ADD over the first 8 entries of the RFs, issued together with DUAL_ISSUE.
+// The sources are OPC storages, the MUL writes GRF_A or GRF_B and the ADD writes the other one
+#define DI_MDST_BIT     27
+#define DI_MDST_N_STA   26
+#define DI_MDST_N_END   24
+#define DI_MSRC0_STA    23
+#define DI_MSRC0_END    22
+#define DI_MSRC0_N_STA  21
+#define DI_MSRC0_N_END  19
+#define DI_MSRC1_STA    18
+#define DI_MSRC1_END    17
+#define DI_MSRC1_N_STA  16
+#define DI_MSRC1_N_END  14
+#define DI_ADST_N_STA   13
+#define DI_ADST_N_END   11
+#define DI_ASRC0_STA    10
+#define DI_ASRC0_END    9
+#define DI_ASRC0_N_STA  8
+#define DI_ASRC0_N_END  6
+#define DI_ASRC1_STA    5
+#define DI_ASRC1_END    4
+#define DI_ASRC1_N_STA  3
+#define DI_ASRC1_N_END  1
 
 // OPCODES operation identifiers
 enum OPCODE_VALUES {
@@ -43,10 +92,14 @@ enum OPCODE_VALUES {
     OP_EXIT = 2,
     OP_MOV = 4,
     OP_FILL = 5,
+    OP_RED = 6,
+    OP_PERM = 7,    // MOV between GRFs through the lane permutation, with LANE_PERM
     OP_ADD = 8,
     OP_MUL = 9,
     OP_MAD = 10,
-    OP_MAC = 11
+    OP_MAC = 11,
+    OP_MACW = 12,   // MAC into wide accumulators, with WIDE_ACC
+    OP_MULADD = 13  // MUL and ADD issued together, with DUAL_ISSUE
 };
 
 const std::map<uint8_t, std::string> OPCODE_STRING = {
@@ -57,8 +110,12 @@ const std::map<uint8_t, std::string> OPCODE_STRING = {
     { OP_MUL, "OP_MUL" },
     { OP_MAD, "OP_MAD" },
     { OP_MAC, "OP_MAC" },
+    { OP_MACW, "OP_MACW" },
+    { OP_MULADD, "OP_MULADD" },
     { OP_MOV, "OP_MOV" },
     { OP_FILL, "OP_FILL" },
+    { OP_RED, "OP_RED" },
+    { OP_PERM, "OP_PERM" },
 };
 
 // OPCODES storage identifiers
@@ -68,7 +125,8 @@ enum OPC_STORAGE {
     OPC_SRF_M = 2,
     OPC_SRF_A = 3,
     OPC_EVEN_BANK = 4,
-    OPC_ODD_BANK = 5
+    OPC_ODD_BANK = 5,
+    OPC_RING = 6        // GRF_B entry of the previous core in the ring, MOV source only
 };
 
 const std::map<uint8_t, std::string> OPC_STORAGE_STRING = {
@@ -78,6 +136,7 @@ const std::map<uint8_t, std::string> OPC_STORAGE_STRING = {
     { OPC_SRF_A, "SRF_A" },
     { OPC_EVEN_BANK, "EVEN_BANK" },
     { OPC_ODD_BANK, "ODD_BANK" },
+    { OPC_RING, "RING" },
 };
 
 // MUX select signals
@@ -88,7 +147,10 @@ enum MUX_STORAGE {
     MUX_GRF_B = 3,
     MUX_SRF = 4,
     MUX_EVEN_BANK = 5,
-    MUX_ODD_BANK = 6
+    MUX_ODD_BANK = 6,
+    MUX_IMM = 7,        // Immediate of a FILL, broadcast to every lane
+    MUX_FPU_MULT = 8,   // Multiplier output, for the MUL of a MULADD
+    MUX_RING = 9        // GRF_B read port 1 of the previous core in the ring
 };
 
 const std::map<uint8_t, std::string> MUX_STORAGE_STRING = {
@@ -99,6 +161,9 @@ const std::map<uint8_t, std::string> MUX_STORAGE_STRING = {
     { MUX_SRF, "SRF" },
     { MUX_EVEN_BANK, "EVEN_BANK" },
     { MUX_ODD_BANK, "ODD_BANK" },
+    { MUX_IMM, "IMM" },
+    { MUX_FPU_MULT, "MUX_FPU_MULT" },
+    { MUX_RING, "RING" },
 };
 
 enum MUL1_SEL {
@@ -147,7 +212,8 @@ enum ADD_SEL {
     A_GRF_B1 = 4,
     A_GRF_B2 = 5,
     A_EVEN_BANK = 6,
-    A_ODD_BANK = 7
+    A_ODD_BANK = 7,
+    A_GRF_B1_WIDE = 8   // GRF_B1 holding the wide accumulators of a MACW
 };
 
 const std::map<uint8_t, std::string> ADD_SEL_STRING = {
@@ -158,7 +224,33 @@ const std::map<uint8_t, std::string> ADD_SEL_STRING = {
     { A_GRF_B1, "GRF_B1" },
     { A_GRF_B2, "GRF_B2" },
     { A_EVEN_BANK, "EVEN_BANK" },
-    { A_ODD_BANK, "ODD_BANK" }
+    { A_ODD_BANK, "ODD_BANK" },
+    { A_GRF_B1_WIDE, "GRF_B1_WIDE" }
+};
+
+// FPU inputs taking the FPU output as it is written back, with HAZARD_FWD
+enum FWD_SEL {
+    FWD_M1 = 1,
+    FWD_M2 = 2,
+    FWD_A1 = 4,
+    FWD_A2 = 8
+};
+
+// Lane permutations on the GRF write path, lane i of the written entry takes the lane of the source shown
+enum PERM_SEL {
+    PERM_NONE = 0,      // i
+    PERM_SHL = 1,       // i - k, zero for the first k lanes
+    PERM_SHR = 2,       // i + k, zero for the last k lanes
+    PERM_ROT = 3,       // (i + k) mod SIMD_WIDTH
+    PERM_BCAST = 4      // k
+};
+
+const std::map<uint8_t, std::string> PERM_SEL_STRING = {
+    { PERM_NONE, "NONE" },
+    { PERM_SHL, "SHL" },
+    { PERM_SHR, "SHR" },
+    { PERM_ROT, "ROT" },
+    { PERM_BCAST, "BCAST" },
 };
 
 enum RF_SEL {
@@ -166,7 +258,12 @@ enum RF_SEL {
     RF_SRF_M = 1,
     RF_SRF_A = 2,
     RF_GRF_A = 3,
-    RF_GRF_B = 4
+    RF_GRF_B = 4,
+    RF_SRF_M_PK = 5,    // Packed writes, a GRF-wide burst fills consecutive SRF entries
+    RF_SRF_A_PK = 6,
+    RF_CRF_SH = 7,      // Writes to the CRF bank that is not executing
+    RF_CRF_SWAP = 8,    // Swaps the executing and the written CRF banks, no data
+    RF_AAM = 9          // AAM base, stride and modulo registers, with AAM_REGS
 };
 
 const std::map<uint8_t, std::string> RF_SEL_STRING = {
@@ -175,6 +272,11 @@ const std::map<uint8_t, std::string> RF_SEL_STRING = {
     { RF_SRF_A, "RF_SRF_A" },
     { RF_GRF_A, "RF_GRF_A" },
     { RF_GRF_B, "RF_GRF_B" },
+    { RF_SRF_M_PK, "RF_SRF_M_PK" },
+    { RF_SRF_A_PK, "RF_SRF_A_PK" },
+    { RF_CRF_SH, "RF_CRF_SH" },
+    { RF_CRF_SWAP, "RF_CRF_SWAP" },
+    { RF_AAM, "RF_AAM" },
 };
 
 #endif /* SRC_OPCODES_H_ */
@@ -16,13 +16,16 @@ void pc_unit::clk_thread() {
 
     // Clocked behaviour
     while (1) {
+        PROFILE_BEGIN("pc_unit::clk_thread");
         pc_reg = pc_nxt;
 
+        PROFILE_END();
         wait();
     }
 }
 
 void pc_unit::comb_method() {
+    PROFILE_METHOD("pc_unit::comb_method");
     pc_nxt = pc_reg;
 
     if (pc_rst) {
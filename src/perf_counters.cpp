@@ -0,0 +1,68 @@
+/*
+ * Copyright EPFL 2024
+ *
+ * Implementation of the performance counters gathered by an IMC core during
+ * simulation.
+ *
+ */
+
+#include "perf_counters.h"
+
+#ifndef __SYNTHESIS__
+
+#include "datatypes.h"
+
+void perf_counters::reset() {
+    int i;
+
+    cycles = 0;
+    idle_cycles = 0;
+    for (i = 0; i < OPCODE_NUM; i++) {
+        op_cycles[i] = 0;
+    }
+    nop_cycles = 0;
+    nop_stalls = 0;
+    hazard_stalls = 0;
+    fwd_operands = 0;
+    jump_iters = 0;
+    mul_cycles = 0;
+    add_cycles = 0;
+    grfa_rd = 0;
+    grfa_wr = 0;
+    grfb_rd = 0;
+    grfb_wr = 0;
+    srf_rd = 0;
+    srf_wr = 0;
+    crf_wr = 0;
+    bank_rd = 0;
+    bank_wr = 0;
+    rf_dq_cycles = 0;
+    pim_dq_cycles = 0;
+}
+
+void perf_counters::dump_header(std::ostream &os) {
+    os << "core,cycles,idle_cycles";
+    for (auto const &op : OPCODE_STRING) {
+        os << "," << op.second;
+    }
+    os << ",nop_cycles,nop_stalls,hazard_stalls,fwd_operands,jump_iters";
+    os << ",mul_cycles,add_cycles,mul_lane_ops,add_lane_ops";
+    os << ",grfa_rd,grfa_wr,grfb_rd,grfb_wr,srf_rd,srf_wr,crf_wr";
+    os << ",bank_rd,bank_wr,rf_dq_cycles,pim_dq_cycles" << std::endl;
+}
+
+void perf_counters::dump(std::ostream &os, uint core) const {
+    os << std::dec << core << "," << cycles << "," << idle_cycles;
+    for (auto const &op : OPCODE_STRING) {
+        os << "," << op_cycles[op.first];
+    }
+    os << "," << nop_cycles << "," << nop_stalls << "," << hazard_stalls << "," << fwd_operands << "," << jump_iters;
+    os << "," << mul_cycles << "," << add_cycles;
+    os << "," << mul_cycles * SIMD_WIDTH << "," << add_cycles * SIMD_WIDTH;
+    os << "," << grfa_rd << "," << grfa_wr << "," << grfb_rd << "," << grfb_wr;
+    os << "," << srf_rd << "," << srf_wr << "," << crf_wr;
+    os << "," << bank_rd << "," << bank_wr;
+    os << "," << rf_dq_cycles << "," << pim_dq_cycles << std::endl;
+}
+
+#endif
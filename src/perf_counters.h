@@ -0,0 +1,51 @@
+/*
+ * Copyright EPFL 2024
+ *
+ * Description of the performance counters gathered by an IMC core during
+ * simulation. They are not part of the hardware, so they are excluded from
+ * synthesis.
+ *
+ */
+
+#ifndef PERF_COUNTERS_H_
+#define PERF_COUNTERS_H_
+
+#ifndef __SYNTHESIS__
+
+#include <ostream>
+#include <stdint.h>
+
+#include "defs.h"
+#include "opcodes.h"
+
+#define OPCODE_NUM  (1 << (OPCODE_STA - OPCODE_END + 1))    // Number of encodable opcodes
+
+struct perf_counters {
+    uint64_t cycles;                    // Cycles elapsed since the last reset
+    uint64_t idle_cycles;               // Cycles without commands, RF writes or FPU activity
+    uint64_t op_cycles[OPCODE_NUM];     // Issue cycles spent on each opcode
+    uint64_t nop_cycles;                // Cycles spent inside a NOP, including its fetch
+    uint64_t nop_stalls;                // PIM commands that arrived while a NOP was draining
+    uint64_t hazard_stalls;             // PIM commands stalled by the scoreboard, waiting for an operand in flight
+    uint64_t fwd_operands;              // FPU operands forwarded from the FPU output
+    uint64_t jump_iters;                // Taken JUMP iterations
+    uint64_t mul_cycles;                // Cycles with the multipliers enabled
+    uint64_t add_cycles;                // Cycles with the adders enabled
+    uint64_t grfa_rd, grfa_wr;          // GRF_A reads and writes
+    uint64_t grfb_rd, grfb_wr;          // GRF_B reads and writes
+    uint64_t srf_rd, srf_wr;            // SRF reads and writes
+    uint64_t crf_wr;                    // CRF writes
+    uint64_t bank_rd, bank_wr;          // Bank column transfers to and from the core
+    uint64_t rf_dq_cycles;              // DQ cycles spent writing the RFs from the host
+    uint64_t pim_dq_cycles;             // Command cycles triggering PIM execution
+
+    perf_counters() { reset(); }
+
+    void reset();                                       // Clears all the counters
+    static void dump_header(std::ostream &os);          // Writes the CSV header
+    void dump(std::ostream &os, uint core) const;       // Writes the counters as a CSV row
+};
+
+#endif
+
+#endif /* PERF_COUNTERS_H_ */
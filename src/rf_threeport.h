@@ -10,6 +10,7 @@
 #define RF_THREEPORT_H_
 
 #include "systemc.h"
+#include "self_profile.h"
 
 template<class T, uint size>
 class rf_threeport: public sc_module {
@@ -44,6 +45,7 @@ public:
 
     // Shows the indexed contents for reading
     void read_method() {
+        PROFILE_METHOD("rf_threeport::read_method");
         if (rd_addr1->read() < size)
             rd_port1->write(reg[rd_addr1->read()]);
         else
@@ -65,10 +67,12 @@ public:
 
         // Clocked behaviour
         while (1) {
+            PROFILE_BEGIN("rf_threeport::write_update_thread");
             if (wr_en->read() && wr_addr->read() < size) {
                 reg[wr_addr->read()] = wr_port;
             }
 
+            PROFILE_END();
             wait();
         }
     }
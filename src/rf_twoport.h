@@ -2,7 +2,8 @@
  * Copyright EPFL 2021
  * Rafael Medina Morillas
  *
- * Description of a generic 2 port (read and write) register file.
+ * Description of a generic 2 port (read and write) register file, which can
+ * also load ld_size consecutive entries in a single cycle.
  *
  */
 
@@ -10,8 +11,9 @@
 #define RF_TWOPORT_H_
 
 #include "systemc.h"
+#include "self_profile.h"
 
-template<class T, uint size>
+template<class T, uint size, uint ld_size>
 class rf_twoport: public sc_module {
 public:
     sc_in_clk   clk;
@@ -21,6 +23,8 @@ public:
     sc_in<bool> wr_en;		// Enable writing
     sc_in<uint> wr_addr;	// Index the address to be written
     sc_in<T>    wr_port;    // Write port
+    sc_in<bool> ld_en;      // Enables loading ld_size entries starting at wr_addr
+    sc_in<T>    ld_port[ld_size];   // Load ports
 
     //Internal signals and variables
     sc_signal<T> reg[size];		// Register file contents
@@ -42,6 +46,7 @@ public:
 
     // Shows the indexed contents for reading
     void read_method() {
+        PROFILE_METHOD("rf_twoport::read_method");
         if (rd_addr->read() < size)
             rd_port->write(reg[rd_addr->read()]);
         else
@@ -59,10 +64,17 @@ public:
 
         // Clocked behaviour
         while (1) {
-            if (wr_en->read() && wr_addr->read() < size) {
+            PROFILE_BEGIN("rf_twoport::write_update_thread");
+            if (ld_en->read()) {
+                for (uint i = 0; i < ld_size; i++) {
+                    if (wr_addr->read() + i < size)
+                        reg[wr_addr->read() + i] = ld_port[i];
+                }
+            } else if (wr_en->read() && wr_addr->read() < size) {
                 reg[wr_addr->read()] = wr_port;
             }
 
+            PROFILE_END();
             wait();
         }
     }
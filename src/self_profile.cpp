@@ -0,0 +1,70 @@
+/*
+ * Copyright EPFL 2024
+ *
+ * Implementation of the simulator self-profiling.
+ *
+ */
+
+#include "self_profile.h"
+
+#if SELF_PROFILE && !defined(__SYNTHESIS__)
+
+#include "systemc.h"
+#include <algorithm>
+#include <iomanip>
+#include <map>
+#include <vector>
+
+// Process statistics, a map keeps the references valid while it grows
+static std::map<std::string, self_profile::process_stats> &processes() {
+    static std::map<std::string, self_profile::process_stats> procs;
+    return procs;
+}
+
+static uint64_t timed_cycles = 0;   // Timed cycles sampled
+static uint64_t last_deltas = 0;    // Delta count at the last sample
+static uint64_t max_deltas = 0;     // Maximum delta cycles in a timed cycle
+
+self_profile::process_stats &self_profile::get(const std::string &name) {
+    return processes()[name];
+}
+
+void self_profile::timed_cycle() {
+    uint64_t deltas = sc_delta_count();
+
+    if (timed_cycles)
+        max_deltas = std::max(max_deltas, deltas - last_deltas);
+    last_deltas = deltas;
+    timed_cycles++;
+}
+
+void self_profile::dump(std::ostream &os, uint64_t cycles, double seconds) {
+    std::vector<std::pair<std::string, process_stats> > procs(processes().begin(), processes().end());
+    double total = 0;
+
+    // Most expensive processes first
+    std::sort(procs.begin(), procs.end(),
+            [](const std::pair<std::string, process_stats> &a, const std::pair<std::string, process_stats> &b) {
+                return a.second.time > b.second.time;
+            });
+    for (auto const &p : procs)
+        total += std::chrono::duration<double>(p.second.time).count();
+
+    os << "process,activations,seconds,percent,ns_per_activation" << std::endl;
+    for (auto const &p : procs) {
+        double t = std::chrono::duration<double>(p.second.time).count();
+        os << p.first << "," << p.second.activations << "," << t << ","
+           << (total > 0 ? 100 * t / total : 0) << ","
+           << (p.second.activations ? 1e9 * t / p.second.activations : 0) << std::endl;
+    }
+    os << std::endl;
+    os << "simulated_cycles," << cycles << std::endl;
+    os << "wall_seconds," << seconds << std::endl;
+    os << "seconds_in_processes," << total << std::endl;
+    os << "cycles_per_second," << (seconds > 0 ? cycles / seconds : 0) << std::endl;
+    os << "delta_cycles," << sc_delta_count() << std::endl;
+    os << "deltas_per_cycle," << (cycles ? double(sc_delta_count()) / cycles : 0) << std::endl;
+    os << "max_deltas_per_cycle," << max_deltas << std::endl;
+}
+
+#endif
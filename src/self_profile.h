@@ -0,0 +1,68 @@
+/*
+ * Copyright EPFL 2024
+ *
+ * Description of the simulator self-profiling, which counts the activations
+ * and the wall-clock time spent in every kind of SystemC process, and the
+ * delta cycles per timed cycle. It is enabled at build time with SELF_PROFILE,
+ * otherwise the profiling macros expand to nothing.
+ *
+ */
+
+#ifndef SELF_PROFILE_H_
+#define SELF_PROFILE_H_
+
+#include "defs.h"
+
+#if SELF_PROFILE && !defined(__SYNTHESIS__)
+
+#include <chrono>
+#include <ostream>
+#include <string>
+#include <stdint.h>
+
+class self_profile {
+public:
+    typedef std::chrono::steady_clock clock;
+
+    // Statistics of all the instances of a process
+    struct process_stats {
+        uint64_t activations;
+        clock::duration time;
+        clock::time_point start;
+
+        void begin() { activations++; start = clock::now(); }
+        void end() { time += clock::now() - start; }
+    };
+
+    // Times a method activation until it goes out of scope
+    struct scope {
+        process_stats &stats;
+        scope(process_stats &stats_) : stats(stats_) { stats.begin(); }
+        ~scope() { stats.end(); }
+    };
+
+    static process_stats &get(const std::string &name);    // Statistics of a process, created on first use
+    static void timed_cycle();                              // Samples the delta cycles of the last timed cycle
+    static void dump(std::ostream &os, uint64_t cycles, double seconds);   // Writes the report
+};
+
+// To be placed at the start of an SC_METHOD
+#define PROFILE_METHOD(name)    static self_profile::process_stats &prof_stats_ = self_profile::get(name); \
+                                self_profile::scope prof_scope_(prof_stats_)
+// To be placed around the body of the loop of an SC_THREAD, excluding the wait
+#define PROFILE_BEGIN(name)     static self_profile::process_stats &prof_stats_ = self_profile::get(name); \
+                                prof_stats_.begin()
+#define PROFILE_END()           prof_stats_.end()
+// To be called once per clock cycle
+#define PROFILE_TIMED_CYCLE()   self_profile::timed_cycle()
+
+#else
+
+#define PROFILE_METHOD(name)
+#define PROFILE_BEGIN(name)
+#define PROFILE_END()
+#define PROFILE_TIMED_CYCLE()
+
+#endif
+
+#endif /* SELF_PROFILE_H_ */
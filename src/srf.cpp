@@ -11,6 +11,16 @@
 #include "srf.h"
 
 void srf::comb_method() {
+    PROFILE_METHOD("srf::comb_method");
+    uint i;
+    uint lane = wr_lane->read();
+#ifdef __SYNTHESIS__
+    cnm_synth zero = cnm_synth(0);
+#elif HALF_FLOAT
+    cnm_t zero = half_float::half_cast<half>(0.0);
+#else
+    cnm_t zero = cnm_t(0);
+#endif
     // Choose the read RF
     if (rd_a_nm) {
         rd_port->write(rd_port_a);
@@ -18,9 +28,11 @@ void srf::comb_method() {
         rd_port->write(rd_port_m);
     }
 
-    // Choose the RF to be written to
-    wr_en_m = wr_en && !wr_a_nm;
-    wr_en_a = wr_en && wr_a_nm;
+    // Choose the RF to be written to, entry by entry or packed
+    wr_en_m = wr_en && !wr_a_nm && !wr_pack;
+    wr_en_a = wr_en && wr_a_nm && !wr_pack;
+    ld_en_m = wr_en && !wr_a_nm && wr_pack;
+    ld_en_a = wr_en && wr_a_nm && wr_pack;
 
     // Select the write input
     switch (wr_from->read()) {
@@ -36,18 +48,41 @@ void srf::comb_method() {
     case MUX_GRF_B:
         wr_mux_out = grfb_in->read();
         break;
-//		case MUX_EVEN_BANK:	wr_mux_out = even_in->read();  break;
-//		case MUX_ODD_BANK:  wr_mux_out = odd_in->read();   break;
+    case MUX_FPU:
+        wr_mux_out = fpu_in->read();
+        break;
+    case MUX_IMM:
 #ifdef __SYNTHESIS__
-		default:        	wr_mux_out = cnm_synth(0);	break;
+        wr_mux_out = cnm_synth(imm_in->read());
+#elif HALF_FLOAT
+        wr_mux_out = half_float::half_cast<half>(imm_in->read());
 #else
-    default:
-#if HALF_FLOAT
-        wr_mux_out = half_float::half_cast<half>(0.0);
-#else
-        wr_mux_out = cnm_t(0);
+        wr_mux_out = cnm_t(imm_in->read());
 #endif
         break;
-#endif
+    case MUX_EVEN_BANK:
+        wr_mux_out = lane < SIMD_WIDTH ? even_in[lane]->read() : zero;
+        break;
+    case MUX_ODD_BANK:
+        wr_mux_out = lane < SIMD_WIDTH ? odd_in[lane]->read() : zero;
+        break;
+    default:
+        wr_mux_out = zero;
+        break;
+    }
+
+    // Select the inputs of packed writes, the DQ burst or the lanes of a bank column from wr_lane on
+    for (i = 0; i < SIMD_WIDTH; i++) {
+        switch (wr_from->read()) {
+        case MUX_EVEN_BANK:
+            ld_mux_out[i] = i + lane < SIMD_WIDTH ? even_in[i + lane]->read() : zero;
+            break;
+        case MUX_ODD_BANK:
+            ld_mux_out[i] = i + lane < SIMD_WIDTH ? odd_in[i + lane]->read() : zero;
+            break;
+        default:
+            ld_mux_out[i] = ext_pack_in[i]->read();
+            break;
+        }
     }
 }
@@ -30,25 +30,30 @@ public:
 	sc_in<uint>				wr_addr;		// Index the address to be written
 	sc_in<bool>				wr_a_nm;		// Signals if writing to SRF_A (high) or SRF_M (low)
 	sc_in<uint8_t>			wr_from;		// Index the MUX for input data
+	sc_in<bool>				wr_pack;		// Signals a packed write of consecutive entries from ext_pack_in or a bank
+	sc_in<uint8_t>			wr_lane;		// Lane of the bank input written, first one for packed writes
 	sc_in<cnm_synth>	ext_in;			// Data input from external DQ
+	sc_in<cnm_synth>	ext_pack_in[SIMD_WIDTH];	// Burst input from external DQ for packed writes
 	sc_in<cnm_synth>  srf_in;         // Data input from SRF
 	sc_in<cnm_synth>  grfa_in;        // Data input from GRF_A
 	sc_in<cnm_synth>  grfb_in;        // Data input from GRF_B
-	// sc_in<cnm_synth>     even_in;        // Internal data input from EVEN_BANK
-	// sc_in<cnm_synth>     odd_in;         // Internal data input from ODD_BANK
+	sc_in<cnm_synth>  fpu_in;         // Data input from the first lane of the FPU, for lane reductions
+	sc_in<int>				imm_in;			// Immediate of a FILL
+	sc_in<cnm_synth>	even_in[SIMD_WIDTH];	// Internal data input from EVEN_BANK
+	sc_in<cnm_synth>	odd_in[SIMD_WIDTH];		// Internal data input from ODD_BANK
 
 	// Internal RFs
-	rf_twoport<cnm_synth,SRF_M_ENTRIES> *srf_m;
-	rf_twoport<cnm_synth,SRF_A_ENTRIES> *srf_a;
+	rf_twoport<cnm_synth,SRF_M_ENTRIES,SRF_M_PACK> *srf_m;
+	rf_twoport<cnm_synth,SRF_A_ENTRIES,SRF_A_PACK> *srf_a;
 
 	// Internal signals
-	sc_signal<cnm_synth>	rd_port_m, rd_port_a, wr_mux_out;
-	sc_signal<bool>	wr_en_m, wr_en_a;
+	sc_signal<cnm_synth>	rd_port_m, rd_port_a, wr_mux_out, ld_mux_out[SIMD_WIDTH];
+	sc_signal<bool>	wr_en_m, wr_en_a, ld_en_m, ld_en_a;
 
 	SC_CTOR(srf) {
 
 		// Instantiate the two RFs
-		srf_m = new rf_twoport<cnm_synth,SRF_M_ENTRIES>("SRF_M");
+		srf_m = new rf_twoport<cnm_synth,SRF_M_ENTRIES,SRF_M_PACK>("SRF_M");
 		srf_m->clk(clk);
 		srf_m->rst(rst);
 		srf_m->rd_addr(rd_addr);
@@ -56,8 +61,11 @@ public:
 		srf_m->wr_en(wr_en_m);
 		srf_m->wr_addr(wr_addr);
 		srf_m->wr_port(wr_mux_out);
+		srf_m->ld_en(ld_en_m);
+		for (int i = 0; i < SRF_M_PACK; i++)
+			srf_m->ld_port[i](ld_mux_out[i]);
 
-		srf_a = new rf_twoport<cnm_synth,SRF_A_ENTRIES>("SRF_A");
+		srf_a = new rf_twoport<cnm_synth,SRF_A_ENTRIES,SRF_A_PACK>("SRF_A");
 		srf_a->clk(clk);
 		srf_a->rst(rst);
 		srf_a->rd_addr(rd_addr);
@@ -65,6 +73,9 @@ public:
 		srf_a->wr_en(wr_en_a);
 		srf_a->wr_addr(wr_addr);
 		srf_a->wr_port(wr_mux_out);
+		srf_a->ld_en(ld_en_a);
+		for (int i = 0; i < SRF_A_PACK; i++)
+			srf_a->ld_port[i](ld_mux_out[i]);
 
 #else
 
@@ -77,25 +88,30 @@ public:
     sc_in<uint>     wr_addr;	// Index the address to be written
     sc_in<bool>     wr_a_nm;    // Signals if writing to SRF_A (high) or SRF_M (low)
     sc_in<uint8_t>  wr_from;	// Index the MUX for input data
+    sc_in<bool>     wr_pack;    // Signals a packed write of consecutive entries from ext_pack_in or a bank
+    sc_in<uint8_t>  wr_lane;    // Lane of the bank input written, first one for packed writes
     sc_in<cnm_t>    ext_in;		// Data input from external DQ
+    sc_in<cnm_t>    ext_pack_in[SIMD_WIDTH];    // Burst input from external DQ for packed writes
     sc_in<cnm_t>    srf_in;     // Data input from SRF
     sc_in<cnm_t>    grfa_in;    // Data input from GRF_A
     sc_in<cnm_t>    grfb_in;    // Data input from GRF_B
-    // sc_in<cnm_t>    even_in; // Internal data input from EVEN_BANK
-    // sc_in<cnm_t>    odd_in;  // Internal data input from ODD_BANK
+    sc_in<cnm_t>    fpu_in;     // Data input from the first lane of the FPU, for lane reductions
+    sc_in<int>      imm_in;     // Immediate of a FILL
+    sc_in<cnm_t>    even_in[SIMD_WIDTH];    // Internal data input from EVEN_BANK
+    sc_in<cnm_t>    odd_in[SIMD_WIDTH];     // Internal data input from ODD_BANK
 
     // Internal RFs
-    rf_twoport<cnm_t, SRF_M_ENTRIES> *srf_m;
-    rf_twoport<cnm_t, SRF_A_ENTRIES> *srf_a;
+    rf_twoport<cnm_t, SRF_M_ENTRIES, SRF_M_PACK> *srf_m;
+    rf_twoport<cnm_t, SRF_A_ENTRIES, SRF_A_PACK> *srf_a;
 
     // Internal signals
-    sc_signal<cnm_t> rd_port_m, rd_port_a, wr_mux_out;
-    sc_signal<bool> wr_en_m, wr_en_a;
+    sc_signal<cnm_t> rd_port_m, rd_port_a, wr_mux_out, ld_mux_out[SIMD_WIDTH];
+    sc_signal<bool> wr_en_m, wr_en_a, ld_en_m, ld_en_a;
 
     SC_CTOR(srf) {
 
         // Instantiate the two RFs
-        srf_m = new rf_twoport<cnm_t, SRF_M_ENTRIES>("SRF_M");
+        srf_m = new rf_twoport<cnm_t, SRF_M_ENTRIES, SRF_M_PACK>("SRF_M");
         srf_m->clk(clk);
         srf_m->rst(rst);
         srf_m->rd_addr(rd_addr);
@@ -103,8 +119,11 @@ public:
         srf_m->wr_en(wr_en_m);
         srf_m->wr_addr(wr_addr);
         srf_m->wr_port(wr_mux_out);
+        srf_m->ld_en(ld_en_m);
+        for (int i = 0; i < SRF_M_PACK; i++)
+            srf_m->ld_port[i](ld_mux_out[i]);
 
-        srf_a = new rf_twoport<cnm_t, SRF_A_ENTRIES>("SRF_A");
+        srf_a = new rf_twoport<cnm_t, SRF_A_ENTRIES, SRF_A_PACK>("SRF_A");
         srf_a->clk(clk);
         srf_a->rst(rst);
         srf_a->rd_addr(rd_addr);
@@ -112,13 +131,18 @@ public:
         srf_a->wr_en(wr_en_a);
         srf_a->wr_addr(wr_addr);
         srf_a->wr_port(wr_mux_out);
+        srf_a->ld_en(ld_en_a);
+        for (int i = 0; i < SRF_A_PACK; i++)
+            srf_a->ld_port[i](ld_mux_out[i]);
 
 #endif
 
         SC_METHOD(comb_method);
         sensitive << rd_a_nm << rd_port_m << rd_port_a;
-        sensitive << wr_en << wr_a_nm << wr_from;
-        sensitive << ext_in << srf_in << grfa_in << grfb_in;// << even_in << odd_in;
+        sensitive << wr_en << wr_a_nm << wr_from << wr_pack << wr_lane;
+        sensitive << ext_in << srf_in << grfa_in << grfb_in << fpu_in << imm_in;
+        for (int i = 0; i < SIMD_WIDTH; i++)
+            sensitive << ext_pack_in[i] << even_in[i] << odd_in[i];
     }
 
     void comb_method();	// Performs the necessary multiplexing
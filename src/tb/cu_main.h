@@ -144,6 +144,8 @@ SC_MODULE(top) {
 	// CRF Control
 	sc_signal<bool>    	crf_wr_en;		//Enables writing of a received instruction
 	sc_signal<uint>    	crf_wr_addr;	//Index for writing the received instructions from processor
+	sc_signal<bool>		crf_wr_sh;		// Writes to the CRF bank that is not executing
+	sc_signal<bool>		crf_swap;		// Swaps the executing CRF bank
 	// SRF Control
 	sc_signal<uint>		srf_rd_addr;	// Index read
 	sc_signal<bool>		srf_rd_a_nm;    // Signals if reading from SRF_A (high) or SRF_M (low)
@@ -151,6 +153,9 @@ SC_MODULE(top) {
 	sc_signal<uint>		srf_wr_addr;	// Index the address to be written
 	sc_signal<bool>		srf_wr_a_nm;	// Signals if writing to SRF_A (high) or SRF_M (low)
 	sc_signal<uint8_t>	srf_wr_from;	// Index the MUX for input data
+	sc_signal<bool>		srf_wr_pack;	// Signals a packed write of consecutive entries
+	sc_signal<uint8_t>	srf_wr_lane;	// Lane of the bank column written to the SRF
+	sc_signal<int>		fill_imm;		// Immediate of a FILL
 	// GRF_A Control
 	sc_signal<uint>		grfa_rd_addr1;	// Index read at port 1
 	sc_signal<uint>		grfa_rd_addr2;	// Index read at port 2
@@ -173,6 +178,12 @@ SC_MODULE(top) {
 	sc_signal<uint8_t> 	fpu_add_in1_sel;    // Selects input 1 for addition
 	sc_signal<uint8_t>	fpu_add_in2_sel;    // Selects input 2 for addition
 	sc_signal<bool>		fpu_out_sel;		// Selects the output: 0 for adder output, 1 for multiplier output
+	sc_signal<bool>		fpu_red_en;			// Signals that a reduction step should be performed
+	sc_signal<bool>		fpu_red_max;		// Reduces to the maximum of the lanes instead of their sum
+	sc_signal<bool>		fpu_red_sel;		// Selects the reduction result as the output of the FPU
+#if HAZARD_FWD
+	sc_signal<uint8_t>	fpu_fwd_sel;		// FPU inputs taking the FPU output as it is written back
+#endif
 
 	control_unit dut;
 	cu_driver driver;
@@ -199,6 +210,8 @@ SC_MODULE(top) {
 		// CRF Control
 		dut.crf_wr_en(crf_wr_en);
 		dut.crf_wr_addr(crf_wr_addr);
+		dut.crf_wr_sh(crf_wr_sh);
+		dut.crf_swap(crf_swap);
 		// SRF Control
 		dut.srf_rd_addr(srf_rd_addr);
 		dut.srf_rd_a_nm(srf_rd_a_nm);
@@ -206,6 +219,9 @@ SC_MODULE(top) {
 		dut.srf_wr_addr(srf_wr_addr);
 		dut.srf_wr_a_nm(srf_wr_a_nm);
 		dut.srf_wr_from(srf_wr_from);
+		dut.srf_wr_pack(srf_wr_pack);
+		dut.srf_wr_lane(srf_wr_lane);
+		dut.fill_imm(fill_imm);
 		// GRF_A Control
 		dut.grfa_rd_addr1(grfa_rd_addr1);
 		dut.grfa_rd_addr2(grfa_rd_addr2);
@@ -228,6 +244,12 @@ SC_MODULE(top) {
 		dut.fpu_add_in1_sel(fpu_add_in1_sel);
 		dut.fpu_add_in2_sel(fpu_add_in2_sel);
 		dut.fpu_out_sel(fpu_out_sel);
+		dut.fpu_red_en(fpu_red_en);
+		dut.fpu_red_max(fpu_red_max);
+		dut.fpu_red_sel(fpu_red_sel);
+#if HAZARD_FWD
+		dut.fpu_fwd_sel(fpu_fwd_sel);
+#endif
 
 #endif
 
@@ -178,8 +178,8 @@ int sc_main(int argc, char *argv[]) {
     sc_trace(tracefile, jump_en, "jump_en");
     sc_trace(tracefile, jump_num, "jump_num");
     sc_trace(tracefile, dut.nop_cnt_reg, "nop_cnt_reg");
-    sc_trace(tracefile, dut.jmp_act_reg, "jmp_act_reg");
-    sc_trace(tracefile, dut.jmp_cnt_reg, "jmp_cnt_reg");
+    sc_trace(tracefile, dut.jmp_top_reg, "jmp_top_reg");
+    sc_trace(tracefile, dut.jmp_cnt_reg[0], "jmp_cnt_reg");
     // CRF Control
     sc_trace(tracefile, crf_wr_en, "crf_wr_en");
     sc_trace(tracefile, crf_wr_addr, "crf_wr_addr");
@@ -16,10 +16,66 @@
 
 using namespace std;
 
+// Cores that exchange data with the banks in a command, only the ones of the
+// addressed bank group if every bank group runs its own stream
+#if BG_CORES
+#define CMD_CORES   CORES_PER_BG
+#else
+#define CMD_CORES   CORES_PER_PCH
+#endif
+
 void pch_driver::driver_thread() {
 
+    int i;
+    uint t;
+    sc_lv<GRF_WIDTH> allzs(SC_LOGIC_Z);
+
+    // Run the traces one after the other, resetting the design before each of them
+    for (t = 0; t < traces.size(); t++) {
+        filename = traces[t].out;
+
+        rst->write(false);
+        RD->write(false);
+        WR->write(false);
+        ACT->write(false);
+        AB_mode->write(false);
+        pim_mode->write(false);
+        bank_addr->write(0);
+#if UNICAST_RF
+        bg_addr->write(0);
+#endif
+        row_addr->write(0);
+        col_addr->write(0);
+        DQ->write(0);
+        for (i = 0; i < CORES_PER_PCH; i++) {
+            even_buses[i]->write(allzs);
+            odd_buses[i]->write(allzs);
+        }
+
+        // Between traces, hold the reset over a rising edge and keep the same clock phase
+        if (t)
+            wait(CLK_PERIOD + CLK_PERIOD / 2 - 1, RESOLUTION);
+        else
+            wait(CLK_PERIOD / 2, RESOLUTION);
+        rst->write(1);
+        wait(0, RESOLUTION);
+
+        wait(CLK_PERIOD / 2 + 1, RESOLUTION);
+
+        // A trace that cannot be read is skipped, the design is reset anyway for the next one
+        if (trace_start)
+            trace_start(filename);
+        if (run_trace(traces[t]) && trace_end)
+            trace_end(filename);
+    }
+
+    // Stop simulation
+    sc_stop();
+}
 
-    int i, j, DQCycle;
+bool pch_driver::run_trace(const pch_trace &trace) {
+
+    int i, j, DQCycle, firstCore;
     uint curCycle;
 #if INSTR_CLK > 1
     int instrCycle;
@@ -28,6 +84,9 @@ void pch_driver::driver_thread() {
     sc_uint<DQ_BITS> bank2out;
     sc_lv<GRF_WIDTH> allzs(SC_LOGIC_Z);
     bool lastCmd, bankRead, bankWrite;
+#if DUAL_BANK
+    bool bankReadDual;      // The RD carries the data of both banks of every pair
+#endif
 
     sc_uint<ADDR_TOTAL_BITS> addrAux;
 
@@ -45,8 +104,9 @@ void pch_driver::driver_thread() {
     deque<dq_type> readData;
     deque<sc_biguint<GRF_WIDTH> > data2bankBuffer;
 
-    // Initial reset
-    curCycle = 0;
+    // The design was just reset, so the trace starts at the first cycle
+    curCycle = 1;
+    firstCore = 0;
     DQCycle = 0;
 #if INSTR_CLK > 1
     instrCycle = 0;
@@ -54,41 +114,22 @@ void pch_driver::driver_thread() {
     lastCmd = false;
     bankRead = false;
     bankWrite = false;
-    rst->write(false);
-    RD->write(false);
-    WR->write(false);
-    ACT->write(false);
-    AB_mode->write(false);
-    pim_mode->write(false);
-    bank_addr->write(0);
-    row_addr->write(0);
-    col_addr->write(0);
-    DQ->write(0);
-    for (i = 0; i < CORES_PER_PCH; i++) {
-        even_buses[i]->write(allzs);
-        odd_buses[i]->write(allzs);
-    }
-
-    wait(CLK_PERIOD / 2, RESOLUTION);
-    rst->write(1);
-    wait(0, RESOLUTION);
-
-    wait(CLK_PERIOD / 2 + 1, RESOLUTION);
-    curCycle++;
+#if DUAL_BANK
+    bankReadDual = false;
+#endif
 
     // Open input file
 #ifdef MTI_SYSTEMC
-    string fi = "../TB_FILES/input/" + filename + ".sci0";  // Input file name, located in pim-cores folder
+    string fi = "../TB_FILES/input/" + trace.name + ".sci" + to_string(trace.channel);  // Input file name, located in pim-cores folder
 #else
-    string fi = "inputs/SystemC/" + filename + ".sci0";		// Input file name, located in pim-cores folder
+    string fi = "inputs/SystemC/" + trace.name + ".sci" + to_string(trace.channel);	// Input file name, located in pim-cores folder
 #endif
     ifstream input;
     input.open(fi);
     if (!input.is_open())   {
         cout << "Error when opening input file " << endl;
-        cout << filename << endl;
-        sc_stop();
-        return;
+        cout << fi << endl;
+        return false;
     }
 
     // Open output file
@@ -97,8 +138,7 @@ void pch_driver::driver_thread() {
     output.open(fo);
     if (!output.is_open())   {
         cout << "Error when opening output file" << endl;
-        sc_stop();
-        return;
+        return false;
     }
 
     // Read first line
@@ -109,8 +149,7 @@ void pch_driver::driver_thread() {
         readData.clear();
         if (!(iss >> dec >> readCycle >> hex >> readAddr >> readCmd)) {
             cout << "Error when reading input" << endl;
-            sc_stop();
-            return;
+            return false;
         }
         while (iss >> hex >> dataAux) {
             readData.push_back(dataAux);
@@ -118,13 +157,13 @@ void pch_driver::driver_thread() {
 
     } else {
         cout << "No lines in the input file" << endl;
-        sc_stop();
-        return;
+        return false;
     }
 
 
     // Simulation loop
     while (1) {
+        PROFILE_BEGIN("pch_driver::driver_thread");
 
         // Default values
         RD->write(false);
@@ -153,13 +192,25 @@ void pch_driver::driver_thread() {
 
         // Fill the banks' sense amplifiers with the corresponding data
         if (bankRead) {
+#if DUAL_BANK
+            if (bankReadDual) {     // Even banks first, then odd banks
+                for (i = firstCore; i < firstCore + CMD_CORES; i++) {
+                    even_buses[i]->write(data2bankBuffer.front());
+                    data2bankBuffer.pop_front();
+                }
+                for (i = firstCore; i < firstCore + CMD_CORES; i++) {
+                    odd_buses[i]->write(data2bankBuffer.front());
+                    data2bankBuffer.pop_front();
+                }
+            } else
+#endif
             if (addrAux.range(BA_END, BA_END)) {
-                for (i = 0; i < CORES_PER_PCH; i++) {
+                for (i = firstCore; i < firstCore + CMD_CORES; i++) {
                     odd_buses[i]->write(data2bankBuffer.front());
                     data2bankBuffer.pop_front();
                 }
             } else {
-                for (i = 0; i < CORES_PER_PCH; i++) {
+                for (i = firstCore; i < firstCore + CMD_CORES; i++) {
                     even_buses[i]->write(data2bankBuffer.front());
                     data2bankBuffer.pop_front();
                 }
@@ -182,6 +233,12 @@ void pch_driver::driver_thread() {
             // Check first the MSB of the row address to see which mode we're in
             // (writing to RFs or PIM execution)
             addrAux = readAddr;
+#if UNICAST_RF
+            bg_addr->write(addrAux.range(BG_STA, BG_END));
+#endif
+#if BG_CORES
+            firstCore = addrAux.range(BG_STA, BG_END) * CORES_PER_BG;
+#endif
             if (addrAux.range(RO_STA, RO_STA)) {
                 // Writing to the RFs
 
@@ -197,7 +254,7 @@ void pch_driver::driver_thread() {
                     // If writing to RFs and WR, format data to DQ
 
 #if INSTR_CLK > 1
-                    if(addrAux.range(RO_STA - 1, RO_END) == RF_CRF) {
+                    if(addrAux.range(RO_STA - 1, RO_END) == RF_CRF || addrAux.range(RO_STA - 1, RO_END) == RF_CRF_SH) {
                         assert(readData.size() == INSTR_CLK);
                         for (i = 0; i < INSTR_CLK; i++) {
                             instr2DQAux[i] = readData.front();
@@ -211,7 +268,8 @@ void pch_driver::driver_thread() {
                         instrCycle++;// Increase Instr cycle to know a write to  CRF is ongoing
                     } else
 #endif
-                    if (addrAux.range(RO_STA - 1, RO_END) < RF_GRF_A) {	// Writing to CRF or SRF, one cycle is enough
+                    if (addrAux.range(RO_STA - 1, RO_END) < RF_GRF_A
+                            || addrAux.range(RO_STA - 1, RO_END) >= RF_CRF_SH) {	// Writing to CRF or SRF, one cycle is enough
                     	// removed this since I pass 4 datas but only the first one is valid so it should be okay for now
                         //assert(readData.size() == 1);   // Check it is only one piece of data
                         data2DQ = readData.front();
@@ -222,7 +280,7 @@ void pch_driver::driver_thread() {
                         col_addr->write(addrAux.range(CO_STA, CO_END));
                         DQ->write(data2DQ);
 
-                    } else {	// Writing to GRF, DQ_CLK cycles are needed
+                    } else {	// Writing to GRF or packed to SRF, DQ_CLK cycles are needed
 
                         assert(readData.size() == DQ_CLK);   // Check it is only one piece of data, in 4 ints
                         for (i = 0; i < DQ_CLK; i++) {
@@ -252,9 +310,16 @@ void pch_driver::driver_thread() {
 
                     // If PIM execution and RD with input data, send to the corresponding bank buses in the next cycle
                     if (!readData.empty()){
-						assert(readData.size() == DQ_CLK*CORES_PER_PCH);// Check if there are enough pieces of data
+#if DUAL_BANK
+						// Twice the data fills the even and the odd bank of every pair
+						bankReadDual = readData.size() == 2*DQ_CLK*CMD_CORES;
+						assert(readData.size() == DQ_CLK*CMD_CORES || bankReadDual);
+						for (i = 0; i < (bankReadDual ? 2 : 1)*CMD_CORES; i++) {
+#else
+						assert(readData.size() == DQ_CLK*CMD_CORES);// Check if there are enough pieces of data
 
-						for (i = 0; i < CORES_PER_PCH; i++) {
+						for (i = 0; i < CMD_CORES; i++) {
+#endif
 							for (j = 0; j < DQ_CLK; j++){
 								data2bankAux = readData.front();
 								readData.pop_front();
@@ -282,6 +347,12 @@ void pch_driver::driver_thread() {
                 }
             }
 
+            if (tl.enabled()) {
+                ostringstream args;
+                args << ",\"addr\":\"0x" << hex << readAddr << "\"";
+                tl.event(TL_INSTR, readCmd, timeline::now(), args.str());
+            }
+
             // Read next line
             if (getline(input, line)) {
 
@@ -296,6 +367,18 @@ void pch_driver::driver_thread() {
                     readData.push_back(dataAux);
                 }
 
+                // Cycles the DQ stays idle until Ramulator issues the next command
+                if (tl.enabled()) {
+                    uint busyCycles = DQCycle ? DQ_CLK : 1;
+#if INSTR_CLK > 1
+                    if (instrCycle)
+                        busyCycles = INSTR_CLK;
+#endif
+                    if (readCycle > curCycle + busyCycles)
+                        tl.span(TL_PHASE, "Ramulator gap", timeline::now() + busyCycles,
+                                timeline::now() + readCycle - curCycle, 0);
+                }
+
             } else {// Wait for enough time for the last instruction to be completed
                 input.close();
                 lastCmd = true;
@@ -320,11 +403,13 @@ void pch_driver::driver_thread() {
         }
 #endif
 
+        PROFILE_END();
+
         if (bankWrite) {	// TODO translate hex to half
             for (i = 0; i < 10; i++)    // More than one deltas are needed
                 wait(0, RESOLUTION);    // We need to wait for a delta to solve the bank buses
             if (addrAux.range(BA_END, BA_END)) {
-                for (i = 0; i < CORES_PER_PCH; i++) {
+                for (i = firstCore; i < firstCore + CMD_CORES; i++) {
                     bankAux = odd_buses[i]->read();
                     for (j = 0; j < DQ_CLK; j++) {
                         bank2out = bankAux.range(DQ_BITS*(j+1)-1,DQ_BITS*j);
@@ -332,7 +417,7 @@ void pch_driver::driver_thread() {
                     }
                 }
             } else {
-                for (i = 0; i < CORES_PER_PCH; i++) {
+                for (i = firstCore; i < firstCore + CMD_CORES; i++) {
                     bankAux = even_buses[i]->read();
                     for (j = 0; j < DQ_CLK; j++) {
                         bank2out = bankAux.range(DQ_BITS*(j+1)-1,DQ_BITS*j);
@@ -345,14 +430,13 @@ void pch_driver::driver_thread() {
             bankWrite = false;
         }
 
+        PROFILE_TIMED_CYCLE();
         wait(CLK_PERIOD, RESOLUTION);
         curCycle++;
     }
 
     cout << "Simulation finished at cycle " << dec << curCycle << endl;
 
-    // Stop simulation
-    sc_stop();
-
+    return true;
 }
 #endif
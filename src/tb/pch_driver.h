@@ -1,5 +1,16 @@
 #include "systemc.h"
 #include "../cnm_base.h"
+#include "../timeline.h"
+#include <functional>
+#include <string>
+#include <vector>
+
+// Trace to simulate, read from <name>.sci<channel> and with outputs named after out
+struct pch_trace {
+    std::string name;
+    uint channel;
+    std::string out;
+};
 
 class pch_driver: public sc_module {
 public:
@@ -32,6 +43,9 @@ public:
     sc_out<bool>                AB_mode;			        // Signals if the All-Banks mode is enabled
     sc_out<bool>                pim_mode;				    // Signals if the PIM mode is enabled
     sc_out<sc_uint<BANK_BITS> > bank_addr;				    // Address of the bank
+#if UNICAST_RF
+    sc_out<sc_uint<BG_BITS> >   bg_addr;                    // Address of the bank group
+#endif
     sc_out<sc_uint<ROW_BITS> >  row_addr;			        // Address of the bank row
     sc_out<sc_uint<COL_BITS> >  col_addr;		            // Address of the bank column
     sc_out<sc_uint<DQ_BITS> >   DQ;                         // Data input from DRAM controller (output makes no sense)
@@ -40,12 +54,20 @@ public:
 
 #endif
 
-    std::string filename;
+    std::string filename;                   // Output name of the trace being simulated
+    std::vector<pch_trace> traces;          // Traces to simulate, with a reset in between
+    std::function<void(const std::string &)> trace_start, trace_end;  // Called around every trace
+    timeline tl;                            // Commands and Ramulator gaps, only recorded if opened by pch_main
 
     SC_HAS_PROCESS(pch_driver);
-    pch_driver(sc_module_name name_, std::string filename_) : sc_module(name_), filename(filename_) {
+    pch_driver(sc_module_name name_, std::string filename_) : sc_module(name_), filename(filename_),
+            traces(1, pch_trace{filename_, 0, filename_}) {
+        SC_THREAD(driver_thread);
+    }
+    pch_driver(sc_module_name name_, const std::vector<pch_trace> &traces_) : sc_module(name_), traces(traces_) {
         SC_THREAD(driver_thread);
     }
 
     void driver_thread();
+    bool run_trace(const pch_trace &trace);     // Simulates a trace, returns false if it could not be opened
 };
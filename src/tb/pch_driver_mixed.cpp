@@ -30,6 +30,9 @@ void pch_driver::driver_thread() {
     sc_uint<DQ_BITS> bank2out;
     sc_lv<GRF_WIDTH> allzs(SC_LOGIC_Z);
     sc_logic lastCmd, bankRead, bankWrite;
+#if DUAL_BANK
+    bool bankReadDual = false;  // The RD carries the data of both banks of every pair
+#endif
 
     sc_uint<ADDR_TOTAL_BITS> addrAux;
 
@@ -156,6 +159,18 @@ void pch_driver::driver_thread() {
 
         // Fill the banks' sense amplifiers with the corresponding data
         if (bankRead == SC_LOGIC_1) {
+#if DUAL_BANK
+            if (bankReadDual) {     // Even banks first, then odd banks
+                for (i = 0; i < CORES_PER_PCH; i++) {
+                    even_in[i]->write(data2bankBuffer.front());
+                    data2bankBuffer.pop_front();
+                }
+                for (i = 0; i < CORES_PER_PCH; i++) {
+                    odd_in[i]->write(data2bankBuffer.front());
+                    data2bankBuffer.pop_front();
+                }
+            } else
+#endif
             if (addrAux.range(BA_END, BA_END)) {
                 for (i = 0; i < CORES_PER_PCH; i++) {
                     odd_in[i]->write(data2bankBuffer.front());
@@ -199,7 +214,7 @@ void pch_driver::driver_thread() {
                     // If writing to RFs and WR, format data to DQ
 
 #if INSTR_CLK > 1
-                    if(addrAux.range(RO_STA - 1, RO_END) == RF_CRF) {
+                    if(addrAux.range(RO_STA - 1, RO_END) == RF_CRF || addrAux.range(RO_STA - 1, RO_END) == RF_CRF_SH) {
                         assert(readData.size() == INSTR_CLK);
                         for (i = 0; i < INSTR_CLK; i++) {
                             instr2DQAux[i] = readData.front();
@@ -216,7 +231,8 @@ void pch_driver::driver_thread() {
                         instrCycle++;// Increase Instr cycle to know a write to  CRF is ongoing
                     } else
 #endif
-                    if (addrAux.range(RO_STA - 1, RO_END) < RF_GRF_A) {	// Writing to CRF or SRF, one cycle is enough
+                    if (addrAux.range(RO_STA - 1, RO_END) < RF_GRF_A
+                            || addrAux.range(RO_STA - 1, RO_END) >= RF_CRF_SH) {	// Writing to CRF or SRF, one cycle is enough
 
                         assert(readData.size() == 1);   // Check it is only one piece of data
                         data2DQ = readData.front();
@@ -231,7 +247,7 @@ void pch_driver::driver_thread() {
                         col_addr->write(col_aux);
                         DQ->write(data2DQ);
 
-                    } else {	// Writing to GRF, 4 cycles are needed
+                    } else {	// Writing to GRF or packed to SRF, 4 cycles are needed
 
                         assert(readData.size() == DQ_CLK);   // Check it is only one piece of data, in 4 ints
                         for (i = 0; i < DQ_CLK; i++) {
@@ -267,9 +283,16 @@ void pch_driver::driver_thread() {
                     col_addr->write(col_aux);
                     // If PIM execution and RD with input data, send to the corresponding bank buses in the next cycle
                     if (!readData.empty()){
+#if DUAL_BANK
+						// Twice the data fills the even and the odd bank of every pair
+						bankReadDual = readData.size() == 2*DQ_CLK*CORES_PER_PCH;
+						assert(readData.size() == DQ_CLK*CORES_PER_PCH || bankReadDual);
+						for (i = 0; i < (bankReadDual ? 2 : 1)*CORES_PER_PCH; i++) {
+#else
 						assert(readData.size() == DQ_CLK*CORES_PER_PCH);// Check if there are enough pieces of data
 
 						for (i = 0; i < CORES_PER_PCH; i++) {
+#endif
 							for (j = 0; j < DQ_CLK; j++){
 								data2bankAux = readData.front();
 //								cout << "data pop " << showbase << hex << data2bankAux << endl;
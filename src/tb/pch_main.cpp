@@ -14,8 +14,161 @@
 
 #else
 
+// Splits the traces round-robin across worker processes, before the design is
+// elaborated. Returns the worker index in the workers, which continue with their
+// share of the traces, and -1 in the parent once all of them have finished
+static int fork_workers(std::vector<pch_trace> &traces, uint workers, int &status) {
+    std::vector<pid_t> pids;
+    uint w, t;
+    int wstatus;
+
+    status = 0;
+    for (w = 0; w < workers; w++) {
+        pid_t pid = fork();
+        if (pid == 0) {
+            std::vector<pch_trace> share;
+            for (t = w; t < traces.size(); t += workers) {
+                share.push_back(traces[t]);
+            }
+            traces = share;
+            return w;
+        } else if (pid < 0) {
+            cout << "Error when creating worker process" << endl;
+            status = 1;
+            break;
+        }
+        pids.push_back(pid);
+    }
+
+    for (auto const &pid : pids) {
+        if (waitpid(pid, &wstatus, 0) < 0 || !WIFEXITED(wstatus) || WEXITSTATUS(wstatus))
+            status = 1;
+    }
+    return -1;
+}
+
+// Merges the outputs of the channels of a trace, simulated independently, and
+// reports the makespan, i.e. the execution time of the slowest channel
+static void merge_channels(const std::string &name, uint channels) {
+    std::string fr = "inputs/results/" + name + ".results";
+    std::string fs = "inputs/results/" + name + ".stats";
+    std::ofstream results, stats;
+    std::string line, field;
+    uint64_t cycles, makespan = 0;
+    uint ch, slowest = 0, col, cyclesCol = 1;
+
+    results.open(fr);
+    stats.open(fs);
+    if (!results.is_open() || !stats.is_open()) {
+        cout << "Error when opening merged output files" << endl;
+        return;
+    }
+
+    for (ch = 0; ch < channels; ch++) {
+        std::string chName = "inputs/results/" + name + "_ch" + std::to_string(ch);
+        std::ifstream chResults(chName + ".results"), chStats(chName + ".stats");
+
+        if (!chResults.is_open() || !chStats.is_open()) {
+            cout << "Error when opening outputs of channel " << ch << endl;
+            continue;
+        }
+
+        // The writebacks of every channel keep their own addresses
+        results << chResults.rdbuf();
+
+        // Cores are numbered globally, channel by channel
+        cycles = 0;
+        if (getline(chStats, line) && !ch) {
+            std::istringstream iss(line);
+            for (col = 0; getline(iss, field, ','); col++) {
+                if (!field.compare("cycles"))
+                    cyclesCol = col;
+            }
+            stats << line << endl;
+        }
+        while (getline(chStats, line)) {
+            std::istringstream iss(line);
+            getline(iss, field, ',');
+            stats << ch * CORES_PER_PCH + atoi(field.c_str());
+            for (col = 1; getline(iss, field, ','); col++) {
+                stats << "," << field;
+                if (col == cyclesCol)
+                    cycles = std::max<uint64_t>(cycles, strtoull(field.c_str(), NULL, 10));
+            }
+            stats << endl;
+        }
+
+        cout << "Channel " << ch << " finished at cycle " << cycles << endl;
+        if (cycles > makespan) {
+            makespan = cycles;
+            slowest = ch;
+        }
+    }
+
+    results.close();
+    stats.close();
+
+    cout << "Makespan across " << channels << " channels: " << makespan << " cycles ("
+         << makespan * CLK_PERIOD / 1000.0 << " ns), slowest channel " << slowest << endl;
+}
+
 int sc_main(int argc, char *argv[]) {
 
+    // Traces given as arguments or listed in a batch file, one per line
+    std::vector<std::string> names;
+    std::vector<pch_trace> traces;
+    std::string line;
+    bool timeline_en = false;
+    uint workers = 1, channels = 1, ch;
+    int worker = -1, status;
+
+    for (int a = 1; a < argc; a++) {
+        std::string arg = argv[a];
+        if (!arg.compare("--timeline")) {
+            timeline_en = true;
+        } else if (!arg.compare("--channels") && a + 1 < argc) {
+            channels = std::max(atoi(argv[++a]), 1);
+        } else if (!arg.compare("--workers") && a + 1 < argc) {
+            workers = std::max(atoi(argv[++a]), 1);
+        } else if (!arg.compare("--batch") && a + 1 < argc) {
+            std::ifstream batch(argv[++a]);
+            if (!batch.is_open()) {
+                cout << "Error when opening batch file" << endl;
+                return 1;
+            }
+            while (getline(batch, line)) {
+                if (!line.empty() && line[0] != '#')
+                    names.push_back(line);
+            }
+        } else {
+            names.push_back(arg);
+        }
+    }
+    if (names.empty()) {
+        cout << "Usage: " << argv[0] << " <trace>... [--batch <trace-list>] [--channels <n>] [--workers <n>] [--timeline]" << endl;
+        return 1;
+    }
+
+    // Every channel of a trace is simulated independently from its own .sci file
+    for (auto const &name : names) {
+        for (ch = 0; ch < channels; ch++) {
+            traces.push_back(pch_trace{name, ch, channels > 1 ? name + "_ch" + std::to_string(ch) : name});
+        }
+    }
+
+    // Every worker elaborates its own design and runs its share of the traces
+    if (workers > 1 && traces.size() > 1) {
+        worker = fork_workers(traces, std::min<uint>(workers, traces.size()), status);
+        if (worker < 0) {
+            if (channels > 1) {
+                for (auto const &name : names) {
+                    merge_channels(name, channels);
+                }
+            }
+            return status;
+        }
+    }
+
     sc_clock                        clk("clk", CLK_PERIOD, RESOLUTION);
     sc_signal<bool>                 rst;
     sc_signal<bool>                 RD;							// DRAM read command
@@ -25,6 +178,9 @@ int sc_main(int argc, char *argv[]) {
     sc_signal<bool>                 AB_mode;		            // Signals if the All-Banks mode is enabled
     sc_signal<bool>                 pim_mode;			        // Signals if the PIM mode is enabled
     sc_signal<sc_uint<BANK_BITS> >  bank_addr;			        // Address of the bank
+#if UNICAST_RF
+    sc_signal<sc_uint<BG_BITS> >    bg_addr;                    // Address of the bank group
+#endif
     sc_signal<sc_uint<ROW_BITS> >   row_addr;			        // Address of the bank row
     sc_signal<sc_uint<COL_BITS> >   col_addr;		            // Address of the bank column
     sc_signal<sc_uint<DQ_BITS> >    DQ;	                        // Data input from DRAM controller (output makes no sense
@@ -43,6 +199,9 @@ int sc_main(int argc, char *argv[]) {
     dut.AB_mode(AB_mode);
     dut.pim_mode(pim_mode);
     dut.bank_addr(bank_addr);
+#if UNICAST_RF
+    dut.bg_addr(bg_addr);
+#endif
     dut.row_addr(row_addr);
     dut.col_addr(col_addr);
     dut.DQ(DQ);
@@ -51,7 +210,7 @@ int sc_main(int argc, char *argv[]) {
         dut.odd_buses[i](odd_buses[i]);
     }
 
-    pch_driver driver("Driver", std::string(argv[1]));
+    pch_driver driver("Driver", traces);
     driver.rst(rst);
     driver.RD(RD);
     driver.WR(WR);
@@ -60,6 +219,9 @@ int sc_main(int argc, char *argv[]) {
     driver.AB_mode(AB_mode);
     driver.pim_mode(pim_mode);
     driver.bank_addr(bank_addr);
+#if UNICAST_RF
+    driver.bg_addr(bg_addr);
+#endif
     driver.row_addr(row_addr);
     driver.col_addr(col_addr);
     driver.DQ(DQ);
@@ -91,7 +253,7 @@ int sc_main(int argc, char *argv[]) {
     sc_report_handler::set_actions (SC_WARNING, SC_DO_NOTHING);
 
     sc_trace_file *tracefile;
-    tracefile = sc_create_vcd_trace_file("pch_wave");
+    tracefile = sc_create_vcd_trace_file(worker < 0 ? "pch_wave" : ("pch_wave_w" + std::to_string(worker)).c_str());
 
     sc_trace(tracefile, clk, "clk");
     sc_trace(tracefile, rst, "rst");
@@ -102,6 +264,9 @@ int sc_main(int argc, char *argv[]) {
     sc_trace(tracefile, AB_mode, "AB_mode");
     sc_trace(tracefile, pim_mode, "pim_mode");
     sc_trace(tracefile, bank_addr, "bank_addr");
+#if UNICAST_RF
+    sc_trace(tracefile, bg_addr, "bg_addr");
+#endif
     sc_trace(tracefile, row_addr, "row_addr");
     sc_trace(tracefile, col_addr, "col_addr");
     sc_trace(tracefile, DQ, "DQ");
@@ -152,10 +317,85 @@ int sc_main(int argc, char *argv[]) {
     }
 
 
+    // Optional timeline of the execution, in Chrome trace JSON format
+    const char *const core_tracks[TL_TRACKS] = {"Phase", "Instructions", "Bank transfers"};
+    const char *const driver_tracks[TL_TRACKS] = {"Ramulator gaps", "Commands", "Unused"};
+    std::ofstream tlfile;
+    driver.trace_start = [&](const std::string &name) {
+        if (!timeline_en)
+            return;
+        if (tlfile.is_open())
+            tlfile.close();     // Left open by a trace that could not be read
+        std::string ft = "inputs/results/" + name + ".json";
+        tlfile.open(ft);
+        if (tlfile.is_open()) {
+            timeline::begin(tlfile);
+            for (uint c = 0; c < CORES_PER_PCH; c++) {
+                dut.imc_cores[c]->cu->id->tl.open(&tlfile, c, "Core " + std::to_string(c), core_tracks);
+            }
+            driver.tl.open(&tlfile, CORES_PER_PCH, "Driver", driver_tracks);
+        } else {
+            cout << "Error when opening timeline file" << endl;
+        }
+    };
+
+    // Dump the activity counters of every core before the design is reset for the next trace
+    driver.trace_end = [&](const std::string &name) {
+        std::string fs = "inputs/results/" + name + ".stats";
+        std::ofstream stats;
+        stats.open(fs);
+        if (stats.is_open()) {
+            perf_counters::dump_header(stats);
+            for (uint c = 0; c < CORES_PER_PCH; c++) {
+                dut.imc_cores[c]->cu->id->perf.dump(stats, c);
+            }
+            stats.close();
+        } else {
+            cout << "Error when opening stats file" << endl;
+        }
+
+        if (tlfile.is_open()) {
+            for (uint c = 0; c < CORES_PER_PCH; c++) {
+                dut.imc_cores[c]->cu->id->tl.close();
+            }
+            driver.tl.close();
+            timeline::end(tlfile);
+            tlfile.close();
+        }
+    };
+
+#if SELF_PROFILE
+    self_profile::clock::time_point wall_start = self_profile::clock::now();
+#endif
+
     sc_start();
 
+#if SELF_PROFILE
+    double wall_seconds = std::chrono::duration<double>(self_profile::clock::now() - wall_start).count();
+    uint64_t sim_cycles = sc_time_stamp() / sc_time(CLK_PERIOD, RESOLUTION);
+    std::string fp = "inputs/results/" + (traces.size() == 1 ? traces[0].out :
+            "batch" + (worker < 0 ? std::string() : std::to_string(worker))) + ".prof";
+    std::ofstream prof;
+    prof.open(fp);
+    if (prof.is_open()) {
+        self_profile::dump(prof, sim_cycles, wall_seconds);
+        prof.close();
+    } else {
+        cout << "Error when opening profiling file" << endl;
+    }
+    cout << "Simulated " << sim_cycles << " cycles in " << wall_seconds << " s, "
+         << sim_cycles / wall_seconds << " cycles/s" << endl;
+#endif
+
     sc_close_vcd_trace_file(tracefile);
 
+    // Without workers, the channels were all simulated by this process
+    if (worker < 0 && channels > 1) {
+        for (auto const &name : names) {
+            merge_channels(name, channels);
+        }
+    }
+
     return 0;
 }
 
@@ -4,6 +4,12 @@
 #include "pch_driver.h"
 #include "pch_monitor.h"
 #include <string>
+#include <fstream>
+#include <vector>
+#include <sstream>
+#include <algorithm>
+#include <sys/wait.h>
+#include <unistd.h>
 
 #if MIXED_SIM
 #if SIMD_WIDTH == 2
@@ -0,0 +1,101 @@
+/*
+ * Copyright EPFL 2024
+ *
+ * Implementation of the timeline exporter. Every span is written as a complete
+ * ("X") event, with timestamps in microseconds as required by the format.
+ *
+ */
+
+#include "timeline.h"
+
+#ifndef __SYNTHESIS__
+
+// Cycles to trace timestamp, in us
+static double cyc2us(uint64_t cycle) {
+    return cycle * sc_time(CLK_PERIOD, RESOLUTION).to_seconds() * 1e6;
+}
+
+void timeline::open(std::ostream *os_, uint pid_, const std::string &name, const char *const track_names[TL_TRACKS]) {
+    uint i;
+
+    os = os_;
+    pid = pid_;
+    for (i = 0; i < TL_TRACKS; i++) {
+        cur[i].name.clear();
+        cur[i].start = cur[i].end = 0;
+    }
+
+    *os << ",\n{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":" << pid
+        << ",\"args\":{\"name\":\"" << name << "\"}}";
+    for (i = 0; i < TL_TRACKS; i++) {
+        *os << ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":" << pid << ",\"tid\":" << i
+            << ",\"args\":{\"name\":\"" << track_names[i] << "\"}}";
+    }
+}
+
+void timeline::span(uint track, const std::string &name, uint64_t start, uint64_t end, uint64_t max_gap) {
+    open_span &s = cur[track];
+
+    if (!enabled())
+        return;
+
+    if (!s.name.empty() && !s.name.compare(name) && (max_gap == TL_STICKY || start <= s.end + max_gap)) {
+        if (end > s.end)
+            s.end = end;
+        return;
+    }
+
+    if (!s.name.empty())
+        write(track, s.name, s.start, s.end, "");
+    s.name = name;
+    s.start = start;
+    s.end = end;
+}
+
+void timeline::event(uint track, const std::string &name, uint64_t cycle, const std::string &args) {
+    if (enabled())
+        write(track, name, cycle, cycle + 1, args);
+}
+
+void timeline::instant(uint track, const std::string &name, uint64_t cycle) {
+    if (!enabled())
+        return;
+
+    *os << ",\n{\"name\":\"" << name << "\",\"ph\":\"i\",\"s\":\"t\",\"pid\":" << pid << ",\"tid\":" << track
+        << ",\"ts\":" << cyc2us(cycle) << ",\"args\":{\"cycle\":" << cycle << "}}";
+}
+
+void timeline::close() {
+    uint i;
+
+    if (!enabled())
+        return;
+
+    for (i = 0; i < TL_TRACKS; i++) {
+        if (!cur[i].name.empty())
+            write(i, cur[i].name, cur[i].start, cur[i].end, "");
+        cur[i].name.clear();
+    }
+}
+
+uint64_t timeline::now() {
+    return (uint64_t) (sc_time_stamp() / sc_time(CLK_PERIOD, RESOLUTION));
+}
+
+void timeline::begin(std::ostream &os) {
+    os.precision(15);   // Timestamps are fractions of us
+    os << "{\"displayTimeUnit\":\"ns\",\"otherData\":{\"clk_period\":" << CLK_PERIOD << "},\"traceEvents\":[\n";
+    os << "{\"name\":\"process_sort_index\",\"ph\":\"M\",\"pid\":0,\"args\":{\"sort_index\":0}}";
+}
+
+void timeline::end(std::ostream &os) {
+    os << "\n]}" << std::endl;
+}
+
+void timeline::write(uint track, const std::string &name, uint64_t start, uint64_t end, const std::string &args) {
+    *os << ",\n{\"name\":\"" << name << "\",\"ph\":\"X\",\"pid\":" << pid << ",\"tid\":" << track
+        << ",\"ts\":" << cyc2us(start) << ",\"dur\":" << cyc2us(end - start)
+        << ",\"args\":{\"cycle\":" << start << ",\"cycles\":" << end - start << args << "}}";
+}
+
+#endif
@@ -0,0 +1,71 @@
+/*
+ * Copyright EPFL 2024
+ *
+ * Description of the timeline exporter, which records the activity of the
+ * simulation as spans in Chrome trace JSON format so it can be inspected in a
+ * trace viewer. Like the performance counters, it is not part of the hardware
+ * and is excluded from synthesis.
+ *
+ */
+
+#ifndef TIMELINE_H_
+#define TIMELINE_H_
+
+#ifndef __SYNTHESIS__
+
+#include "systemc.h"
+#include <ostream>
+#include <sstream>
+#include <string>
+#include <stdint.h>
+
+#include "defs.h"
+
+#define TL_STICKY   (~(uint64_t) 0)     // Gap that merges spans of the same name no matter how far apart
+
+// Tracks (threads in the trace) shown for every process
+enum TL_TRACK {
+    TL_PHASE,   // CRF writes, SRF/GRF loads and EXEC windows, or Ramulator gaps for the driver
+    TL_INSTR,   // Instruction issue and NOPs
+    TL_BANK,    // Bank transfers
+    TL_TRACKS
+};
+
+class timeline {
+public:
+    timeline() : os(NULL), pid(0) {}
+
+    bool enabled() const { return os != NULL; }
+
+    // Starts recording to os as process pid, named name, with the given track names
+    void open(std::ostream *os_, uint pid_, const std::string &name, const char *const track_names[TL_TRACKS]);
+    // Marks track as busy with name during [start, end), merging it with the current
+    // span if it has the same name and is at most max_gap cycles away
+    void span(uint track, const std::string &name, uint64_t start, uint64_t end, uint64_t max_gap);
+    // Records a single-cycle event in track that is never merged
+    void event(uint track, const std::string &name, uint64_t cycle, const std::string &args = "");
+    // Records an instantaneous marker in track
+    void instant(uint track, const std::string &name, uint64_t cycle);
+    // Writes the spans that are still open
+    void close();
+
+    static uint64_t now();                      // Current simulation cycle
+    static void begin(std::ostream &os);        // Writes the start of the trace file
+    static void end(std::ostream &os);          // Writes the end of the trace file
+
+private:
+    struct open_span {
+        std::string name;
+        uint64_t start, end;    // Cycles, end is exclusive
+    };
+
+    std::ostream *os;
+    uint pid;
+    open_span cur[TL_TRACKS];
+
+    void write(uint track, const std::string &name, uint64_t start, uint64_t end, const std::string &args);
+};
+
+#endif
+
+#endif /* TIMELINE_H_ */
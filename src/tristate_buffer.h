@@ -12,6 +12,7 @@
 #ifndef __SYNTHESIS__
 
 #include "systemc.h"
+#include "self_profile.h"
 
 template<uint width>
 class tristate_buffer: public sc_module {
@@ -27,6 +28,7 @@ public:
 
     // Controls the buffer
     void comb_method() {
+        PROFILE_METHOD("tristate_buffer::comb_method");
         sc_lv<width> allzs(SC_LOGIC_Z);
 
         if (enable->read())